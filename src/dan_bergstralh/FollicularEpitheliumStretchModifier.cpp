@@ -1,4 +1,5 @@
 #include "FollicularEpitheliumStretchModifier.hpp"
+#include <cfloat>
 
 template<unsigned DIM>
 FollicularEpitheliumStretchModifier<DIM>::FollicularEpitheliumStretchModifier()
@@ -6,7 +7,8 @@ FollicularEpitheliumStretchModifier<DIM>::FollicularEpitheliumStretchModifier()
       mApplyExtrinsicPullToAllNodes(true),
       mPinAnteriorMostCells(false),
       mSpeed(1.0),
-      mIncreaseStretchOverTime(false)
+      mIncreaseStretchOverTime(false),
+      mpGeometryCache(new PopulationGeometryCache<DIM>())
 {
 }
 
@@ -25,39 +27,48 @@ void FollicularEpitheliumStretchModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCel
         mSpeed *= (1.0 + 0.1*dt);
     }
 
-    unsigned num_nodes = rCellPopulation.GetNumNodes();
-
-    ChasteCuboid<DIM> bounds = rCellPopulation.rGetMesh().CalculateBoundingBox();
+    ChasteCuboid<DIM> bounds = mpGeometryCache->GetBoundingBox(rCellPopulation);
     double x_min = bounds.rGetLowerCorner()[0];
     double x_max = bounds.rGetUpperCorner()[0];
     double width = x_max - x_min;
 
     if (mApplyExtrinsicPullToAllNodes)
     {
-        for (unsigned node_index=0; node_index<num_nodes; node_index++)
-        {
-            Node<DIM>* p_node = rCellPopulation.GetNode(node_index);
-            double scaled_width = p_node->rGetLocation()[0] - x_min;
+        c_matrix<double, DIM, DIM> strain_rate = zero_matrix<double>(DIM, DIM);
+        strain_rate(0,0) = mSpeed/width;
 
-            if (mPinAnteriorMostCells)
+        // Hold still the nodes of the anterior-most (left-most) cells, within one cell width of the left-hand edge
+        mDeformation.ClearPinnedRegions();
+        if (mPinAnteriorMostCells)
+        {
+            c_vector<double, DIM> pinned_lower_corner;
+            c_vector<double, DIM> pinned_upper_corner;
+            for (unsigned d=0; d<DIM; d++)
             {
-                ///\todo something
+                pinned_lower_corner[d] = -DBL_MAX;
+                pinned_upper_corner[d] = DBL_MAX;
             }
-
-            p_node->rGetModifiableLocation()[0] += (scaled_width/width)*mSpeed*dt;
+            pinned_upper_corner[0] = x_min + 1.0;
+            mDeformation.AddPinnedRegion(pinned_lower_corner, pinned_upper_corner);
         }
+
+        mDeformation.Apply(rCellPopulation, strain_rate, bounds.rGetLowerCorner().rGetLocation(), dt);
     }
     else
     {
-        for (unsigned node_index=0; node_index<num_nodes; node_index++)
+        // The right-most nodes all lie on the boundary; this pull never moves the anterior-most cells, so they need no pinning
+        const std::vector<unsigned>& r_boundary_nodes = mpGeometryCache->rGetBoundaryNodeIndices(rCellPopulation);
+        for (unsigned i=0; i<r_boundary_nodes.size(); i++)
         {
-            Node<DIM>* p_node = rCellPopulation.GetNode(node_index);
+            Node<DIM>* p_node = rCellPopulation.GetNode(r_boundary_nodes[i]);
             if (fabs(p_node->rGetLocation()[0] - x_max) < 0.1)
             {
                 p_node->rGetModifiableLocation()[0] += mSpeed*dt;
             }
         }
     }
+
+    mpGeometryCache->InvalidateBoundingBox();
 }
 
 template<unsigned DIM>
@@ -100,6 +111,18 @@ void FollicularEpitheliumStretchModifier<DIM>::OutputSimulationModifierParameter
     AbstractCellBasedSimulationModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
 }
 
+template<unsigned DIM>
+void FollicularEpitheliumStretchModifier<DIM>::SetGeometryCache(boost::shared_ptr<PopulationGeometryCache<DIM> > pGeometryCache)
+{
+    mpGeometryCache = pGeometryCache;
+}
+
+template<unsigned DIM>
+boost::shared_ptr<PopulationGeometryCache<DIM> > FollicularEpitheliumStretchModifier<DIM>::GetGeometryCache()
+{
+    return mpGeometryCache;
+}
+
 // Explicit instantiation
 template class FollicularEpitheliumStretchModifier<1>;
 template class FollicularEpitheliumStretchModifier<2>;
@@ -5,6 +5,8 @@
 #include <boost/serialization/base_object.hpp>
 
 #include "AbstractCellBasedSimulationModifier.hpp"
+#include "PopulationGeometryCache.hpp"
+#include "PrescribedStrainRateDeformation.hpp"
 
 ///\todo allow for non-uniform stretching
 
@@ -29,6 +31,12 @@ private:
     double mSpeed;
     bool mIncreaseStretchOverTime;
 
+    /** The boundary nodes and bounding box of the cell population. Not archived. */
+    boost::shared_ptr<PopulationGeometryCache<DIM> > mpGeometryCache;
+
+    /** Applies the stretch when the pull acts on all nodes. Not archived. */
+    PrescribedStrainRateDeformation<DIM> mDeformation;
+
 public:
 
     FollicularEpitheliumStretchModifier();
@@ -40,6 +48,8 @@ public:
     void SetSpeed(double speed);
     void IncreaseStretchOverTime(bool increaseStretchOverTime);
     void OutputSimulationModifierParameters(out_stream& rParamsFile);
+    void SetGeometryCache(boost::shared_ptr<PopulationGeometryCache<DIM> > pGeometryCache);
+    boost::shared_ptr<PopulationGeometryCache<DIM> > GetGeometryCache();
 };
 
 #include "SerializationExportWrapper.hpp"
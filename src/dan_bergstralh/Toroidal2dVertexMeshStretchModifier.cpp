@@ -19,13 +19,12 @@ void Toroidal2dVertexMeshStretchModifier::UpdateAtEndOfTimeStep(AbstractCellPopu
 
     double dt = SimulationTime::Instance()->GetTimeStep();
 
-    double old_width = p_mesh->GetWidth(0);
-    double new_width = old_width + mSpeed*dt;
-    p_mesh->SetWidth(0, new_width);
+    // Stretch the nodes with the periodic box, which grows by mSpeed*dt in width and mSpeed*dt/sqrt(3) in height
+    c_matrix<double, 2, 2> strain_rate = zero_matrix<double>(2, 2);
+    strain_rate(0,0) = mSpeed/p_mesh->GetWidth(0);
+    strain_rate(1,1) = mSpeed/(sqrt(3.0)*p_mesh->GetWidth(1));
 
-    double old_height = p_mesh->GetWidth(1);
-    double new_height = old_height + mSpeed*dt/sqrt(3.0);
-    p_mesh->SetWidth(1, new_height);
+    mDeformation.Apply(rCellPopulation, strain_rate, zero_vector<double>(2), dt);
 }
 
 void Toroidal2dVertexMeshStretchModifier::SetupSolve(AbstractCellPopulation<2,2>& rCellPopulation, std::string outputDirectory)
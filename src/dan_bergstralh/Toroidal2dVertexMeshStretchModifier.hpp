@@ -5,6 +5,7 @@
 #include <boost/serialization/base_object.hpp>
 
 #include "AbstractCellBasedSimulationModifier.hpp"
+#include "PrescribedStrainRateDeformation.hpp"
 
 class Toroidal2dVertexMeshStretchModifier : public AbstractCellBasedSimulationModifier<2,2>
 {
@@ -19,6 +20,7 @@ private:
     }
 
     double mSpeed;
+    PrescribedStrainRateDeformation<2> mDeformation;
 
 public:
 
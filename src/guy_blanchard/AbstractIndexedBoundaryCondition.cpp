@@ -0,0 +1,105 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "AbstractIndexedBoundaryCondition.hpp"
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+AbstractIndexedBoundaryCondition<ELEMENT_DIM, SPACE_DIM>::AbstractIndexedBoundaryCondition(AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>* pCellPopulation)
+    : AbstractCellPopulationBoundaryCondition<ELEMENT_DIM, SPACE_DIM>(pCellPopulation)
+{
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractIndexedBoundaryCondition<ELEMENT_DIM, SPACE_DIM>::ImposeBoundaryCondition(const std::map<Node<SPACE_DIM>*, c_vector<double, SPACE_DIM> >& rOldLocations)
+{
+    if (!UsesOldLocations())
+    {
+        mIndexedOldLocations.clear();
+        ImposeIndexedBoundaryCondition(mIndexedOldLocations);
+        return;
+    }
+
+    for (typename std::map<Node<SPACE_DIM>*, c_vector<double, SPACE_DIM> >::const_iterator iter = rOldLocations.begin();
+         iter != rOldLocations.end();
+         ++iter)
+    {
+        unsigned node_index = iter->first->GetIndex();
+        if (node_index >= mIndexedOldLocations.size())
+        {
+            mIndexedOldLocations.resize(node_index + 1);
+        }
+        mIndexedOldLocations[node_index] = iter->second;
+    }
+
+    ImposeIndexedBoundaryCondition(mIndexedOldLocations);
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractIndexedBoundaryCondition<ELEMENT_DIM, SPACE_DIM>::RecordOldLocations(AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>& rCellPopulation,
+                                                                                 std::vector<c_vector<double, SPACE_DIM> >& rOldLocations)
+{
+    unsigned num_nodes = rCellPopulation.GetNumNodes();
+    if (rOldLocations.size() < num_nodes)
+    {
+        rOldLocations.resize(num_nodes);
+    }
+
+    // Node indices need not be contiguous (for example in a NodesOnlyMesh), so use the node iterator
+    for (typename AbstractMesh<ELEMENT_DIM, SPACE_DIM>::NodeIterator node_iter = rCellPopulation.rGetMesh().GetNodeIteratorBegin();
+         node_iter != rCellPopulation.rGetMesh().GetNodeIteratorEnd();
+         ++node_iter)
+    {
+        unsigned node_index = node_iter->GetIndex();
+        if (node_index >= rOldLocations.size())
+        {
+            rOldLocations.resize(node_index + 1);
+        }
+        rOldLocations[node_index] = node_iter->rGetLocation();
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool AbstractIndexedBoundaryCondition<ELEMENT_DIM, SPACE_DIM>::UsesOldLocations() const
+{
+    return true;
+}
+
+// Explicit instantiation
+template class AbstractIndexedBoundaryCondition<1,1>;
+template class AbstractIndexedBoundaryCondition<1,2>;
+template class AbstractIndexedBoundaryCondition<2,2>;
+template class AbstractIndexedBoundaryCondition<1,3>;
+template class AbstractIndexedBoundaryCondition<2,3>;
+template class AbstractIndexedBoundaryCondition<3,3>;
@@ -0,0 +1,130 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef ABSTRACTINDEXEDBOUNDARYCONDITION_HPP_
+#define ABSTRACTINDEXEDBOUNDARYCONDITION_HPP_
+
+#include <map>
+#include <vector>
+#include "AbstractCellPopulationBoundaryCondition.hpp"
+
+#include "ChasteSerialization.hpp"
+#include "ClassIsAbstract.hpp"
+#include <boost/serialization/base_object.hpp>
+
+/**
+ * An abstract cell population boundary condition that receives the node locations from
+ * before the current move as a contiguous array indexed by node index, rather than as a
+ * map keyed by node pointer.
+ *
+ * Concrete classes implement ImposeIndexedBoundaryCondition(). The inherited map-based
+ * ImposeBoundaryCondition() is implemented here as an adaptor, which copies the map into
+ * the array in a single pass, so that these boundary conditions may be used with any
+ * simulation. Concrete classes that only act on the current node locations should
+ * override UsesOldLocations() to return false, so that the adaptor skips this copy. A simulation that records the old locations itself, using RecordOldLocations(),
+ * may call ImposeIndexedBoundaryCondition() directly and avoid building the map at all.
+ */
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM=ELEMENT_DIM>
+class AbstractIndexedBoundaryCondition : public AbstractCellPopulationBoundaryCondition<ELEMENT_DIM, SPACE_DIM>
+{
+private:
+
+    /** Workspace holding the old node locations, indexed by node index, when called through the map adaptor. Not archived. */
+    std::vector<c_vector<double, SPACE_DIM> > mIndexedOldLocations;
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Serialize the object.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractCellPopulationBoundaryCondition<ELEMENT_DIM, SPACE_DIM> >(*this);
+    }
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param pCellPopulation pointer to the cell population
+     */
+    AbstractIndexedBoundaryCondition(AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>* pCellPopulation);
+
+    /**
+     * Overridden ImposeBoundaryCondition() method.
+     *
+     * Copies the old node locations into an array indexed by node index, if UsesOldLocations()
+     * returns true, then calls ImposeIndexedBoundaryCondition().
+     *
+     * @param rOldLocations the node locations before any boundary conditions are applied
+     */
+    void ImposeBoundaryCondition(const std::map<Node<SPACE_DIM>*, c_vector<double, SPACE_DIM> >& rOldLocations);
+
+    /**
+     * Apply the cell population boundary conditions.
+     *
+     * As this method is pure virtual, it must be overridden in subclasses.
+     *
+     * @param rOldLocations the node locations before any boundary conditions are applied,
+     *     indexed by node index
+     */
+    virtual void ImposeIndexedBoundaryCondition(const std::vector<c_vector<double, SPACE_DIM> >& rOldLocations)=0;
+
+    /**
+     * @return whether ImposeIndexedBoundaryCondition() reads the old node locations. If not,
+     *     the map adaptor passes an empty array rather than copying the map. Returns true
+     *     unless overridden.
+     */
+    virtual bool UsesOldLocations() const;
+
+    /**
+     * Record the current location of each node of a cell population, indexed by node index,
+     * in the form expected by ImposeIndexedBoundaryCondition().
+     *
+     * @param rCellPopulation the cell population
+     * @param rOldLocations the array to fill, which is resized as required
+     */
+    static void RecordOldLocations(AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>& rCellPopulation,
+                                   std::vector<c_vector<double, SPACE_DIM> >& rOldLocations);
+};
+
+TEMPLATED_CLASS_IS_ABSTRACT_2_UNSIGNED(AbstractIndexedBoundaryCondition)
+
+#endif /*ABSTRACTINDEXEDBOUNDARYCONDITION_HPP_*/
@@ -0,0 +1,303 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "AdaptiveTimestepOffLatticeSimulation.hpp"
+#include "AbstractIndexedBoundaryCondition.hpp"
+#include "CellBasedEventHandler.hpp"
+#include "Exception.hpp"
+
+template<unsigned DIM>
+AdaptiveTimestepOffLatticeSimulation<DIM>::AdaptiveTimestepOffLatticeSimulation(AbstractCellPopulation<DIM>& rCellPopulation,
+                                                                                bool deleteCellPopulationInDestructor,
+                                                                                bool initialiseCells)
+    : OffLatticeSimulation<DIM>(rCellPopulation, deleteCellPopulationInDestructor, initialiseCells),
+      mMaxDisplacementFraction(0.25),
+      mSubstepGrowthFactor(1.2),
+      mMinSubstep(1e-8),
+      mCurrentSubstep(DOUBLE_UNSET),
+      mPreviousMaxSpeed(DOUBLE_UNSET),
+      mNumSubsteps(0),
+      mNumRejectedSubsteps(0)
+{
+    if (dynamic_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation) == NULL)
+    {
+        EXCEPTION("AdaptiveTimestepOffLatticeSimulation is to be used with a VertexBasedCellPopulation only");
+    }
+}
+
+template<unsigned DIM>
+double AdaptiveTimestepOffLatticeSimulation<DIM>::ComputeForces()
+{
+    VertexBasedCellPopulation<DIM>* p_population = static_cast<VertexBasedCellPopulation<DIM>*>(&(this->mrCellPopulation));
+
+    for (unsigned node_index=0; node_index<p_population->GetNumNodes(); node_index++)
+    {
+        p_population->GetNode(node_index)->ClearAppliedForce();
+    }
+
+    for (typename std::vector<boost::shared_ptr<AbstractForce<DIM> > >::iterator iter = this->mForceCollection.begin();
+         iter != this->mForceCollection.end();
+         ++iter)
+    {
+        (*iter)->AddForceContribution(this->mrCellPopulation);
+    }
+
+    double max_speed = 0.0;
+    for (unsigned node_index=0; node_index<p_population->GetNumNodes(); node_index++)
+    {
+        double speed = norm_2(p_population->GetNode(node_index)->rGetAppliedForce())/p_population->GetDampingConstant(node_index);
+        max_speed = std::max(max_speed, speed);
+    }
+    return max_speed;
+}
+
+template<unsigned DIM>
+unsigned AdaptiveTimestepOffLatticeSimulation<DIM>::GetInvertedElementIndex()
+{
+    // Element inversion is only detected in 2D, where elements are polygons ordered anticlockwise
+    if (DIM != 2)
+    {
+        return UNSIGNED_UNSET;
+    }
+
+    MutableVertexMesh<DIM,DIM>& r_mesh = static_cast<VertexBasedCellPopulation<DIM>*>(&(this->mrCellPopulation))->rGetMesh();
+
+    for (typename VertexMesh<DIM,DIM>::VertexElementIterator elem_iter = r_mesh.GetElementIteratorBegin();
+         elem_iter != r_mesh.GetElementIteratorEnd();
+         ++elem_iter)
+    {
+        // Use positions relative to the first node, so that periodic meshes are handled correctly
+        unsigned num_nodes = elem_iter->GetNumNodes();
+        const c_vector<double, DIM>& r_first_location = elem_iter->GetNode(0)->rGetLocation();
+
+        double twice_signed_area = 0.0;
+        c_vector<double, DIM> current = zero_vector<double>(DIM);
+        for (unsigned local_index=1; local_index<=num_nodes; local_index++)
+        {
+            c_vector<double, DIM> next = zero_vector<double>(DIM);
+            if (local_index < num_nodes)
+            {
+                next = r_mesh.GetVectorFromAtoB(r_first_location, elem_iter->GetNode(local_index)->rGetLocation());
+            }
+            twice_signed_area += current[0]*next[1] - current[1]*next[0];
+            current = next;
+        }
+
+        if (twice_signed_area <= 0.0)
+        {
+            return elem_iter->GetIndex();
+        }
+    }
+    return UNSIGNED_UNSET;
+}
+
+template<unsigned DIM>
+void AdaptiveTimestepOffLatticeSimulation<DIM>::UpdateCellLocationsAndTopology()
+{
+    CellBasedEventHandler::BeginEvent(CellBasedEventHandler::POSITION);
+
+    VertexBasedCellPopulation<DIM>* p_population = static_cast<VertexBasedCellPopulation<DIM>*>(&(this->mrCellPopulation));
+    double displacement_limit = mMaxDisplacementFraction*p_population->rGetMesh().GetCellRearrangementThreshold();
+
+    if (mCurrentSubstep == DOUBLE_UNSET)
+    {
+        mCurrentSubstep = this->mDt;
+    }
+
+    // The node locations at the start of each substep, indexed by node index
+    std::vector<c_vector<double, DIM> > old_node_locations;
+
+    double time_remaining = this->mDt;
+    bool finished = false;
+    while (!finished)
+    {
+        // Shortening the substep cannot undo an inversion that is already present, for example one introduced by remeshing
+        unsigned inverted_element_index = GetInvertedElementIndex();
+        if (inverted_element_index != UNSIGNED_UNSET)
+        {
+            EXCEPTION("Element " << inverted_element_index << " is inverted at the start of a substep, before any node has been moved; adaptive substepping cannot recover from this");
+        }
+
+        double max_speed = ComputeForces();
+
+        // Grow the substep while the largest vertex speed is not increasing, and halve it if the speed is growing quickly
+        double substep = mCurrentSubstep;
+        if (mPreviousMaxSpeed != DOUBLE_UNSET)
+        {
+            if (max_speed <= mPreviousMaxSpeed)
+            {
+                substep *= mSubstepGrowthFactor;
+            }
+            else if (max_speed > mSubstepGrowthFactor*mPreviousMaxSpeed)
+            {
+                substep *= 0.5;
+            }
+        }
+        mPreviousMaxSpeed = max_speed;
+
+        // Never take substeps longer than the time step, or that move a vertex too far
+        substep = std::min(substep, this->mDt);
+        if (max_speed*substep > displacement_limit)
+        {
+            substep = displacement_limit/max_speed;
+        }
+
+        bool accepted = false;
+        while (!accepted)
+        {
+            if (substep < mMinSubstep)
+            {
+                EXCEPTION("Adaptive substep has fallen below the minimum substep " << mMinSubstep << "; the vertex dynamics are too stiff to resolve");
+            }
+
+            // Stop exactly at the end of the time step, so that output lands on the requested sampling times
+            double step = substep;
+            if (step >= time_remaining*(1.0 - 1e-10))
+            {
+                step = time_remaining;
+            }
+
+            AbstractIndexedBoundaryCondition<DIM>::RecordOldLocations(*p_population, old_node_locations);
+
+            p_population->UpdateNodeLocations(step);
+
+            // Boundary conditions that accept the indexed old locations are passed them directly; a map is built only for any others
+            std::map<Node<DIM>*, c_vector<double, DIM> > old_node_location_map;
+            for (typename std::vector<boost::shared_ptr<AbstractCellPopulationBoundaryCondition<DIM> > >::iterator bcs_iter = this->mBoundaryConditions.begin();
+                 bcs_iter != this->mBoundaryConditions.end();
+                 ++bcs_iter)
+            {
+                AbstractIndexedBoundaryCondition<DIM>* p_indexed_bc = dynamic_cast<AbstractIndexedBoundaryCondition<DIM>*>(bcs_iter->get());
+                if (p_indexed_bc)
+                {
+                    p_indexed_bc->ImposeIndexedBoundaryCondition(old_node_locations);
+                }
+                else
+                {
+                    if (old_node_location_map.empty())
+                    {
+                        for (unsigned node_index=0; node_index<p_population->GetNumNodes(); node_index++)
+                        {
+                            Node<DIM>* p_node = p_population->GetNode(node_index);
+                            old_node_location_map[p_node] = old_node_locations[p_node->GetIndex()];
+                        }
+                    }
+                    (*bcs_iter)->ImposeBoundaryCondition(old_node_location_map);
+                }
+            }
+
+            if (GetInvertedElementIndex() != UNSIGNED_UNSET)
+            {
+                // Restore the node positions and retry with a shorter substep
+                for (unsigned node_index=0; node_index<p_population->GetNumNodes(); node_index++)
+                {
+                    Node<DIM>* p_node = p_population->GetNode(node_index);
+                    p_node->rGetModifiableLocation() = old_node_locations[p_node->GetIndex()];
+                }
+                substep *= 0.5;
+                mNumRejectedSubsteps++;
+            }
+            else
+            {
+                accepted = true;
+                mNumSubsteps++;
+                mCurrentSubstep = substep;
+                finished = (step == time_remaining);
+                time_remaining -= step;
+            }
+        }
+
+        // Remesh between substeps, so that T1 swaps are resolved on the substep time scale, unless updates are switched off
+        if (!finished && this->mUpdateCellPopulation)
+        {
+            p_population->Update();
+        }
+    }
+
+    CellBasedEventHandler::EndEvent(CellBasedEventHandler::POSITION);
+}
+
+template<unsigned DIM>
+void AdaptiveTimestepOffLatticeSimulation<DIM>::SetMaxDisplacementFraction(double maxDisplacementFraction)
+{
+    assert(maxDisplacementFraction > 0.0);
+    mMaxDisplacementFraction = maxDisplacementFraction;
+}
+
+template<unsigned DIM>
+void AdaptiveTimestepOffLatticeSimulation<DIM>::SetSubstepGrowthFactor(double substepGrowthFactor)
+{
+    assert(substepGrowthFactor >= 1.0);
+    mSubstepGrowthFactor = substepGrowthFactor;
+}
+
+template<unsigned DIM>
+void AdaptiveTimestepOffLatticeSimulation<DIM>::SetMinSubstep(double minSubstep)
+{
+    assert(minSubstep > 0.0);
+    mMinSubstep = minSubstep;
+}
+
+template<unsigned DIM>
+unsigned AdaptiveTimestepOffLatticeSimulation<DIM>::GetNumSubsteps() const
+{
+    return mNumSubsteps;
+}
+
+template<unsigned DIM>
+unsigned AdaptiveTimestepOffLatticeSimulation<DIM>::GetNumRejectedSubsteps() const
+{
+    return mNumRejectedSubsteps;
+}
+
+template<unsigned DIM>
+void AdaptiveTimestepOffLatticeSimulation<DIM>::OutputSimulationParameters(out_stream& rParamsFile)
+{
+    *rParamsFile << "\t\t<MaxDisplacementFraction>" << mMaxDisplacementFraction << "</MaxDisplacementFraction>\n";
+    *rParamsFile << "\t\t<SubstepGrowthFactor>" << mSubstepGrowthFactor << "</SubstepGrowthFactor>\n";
+    *rParamsFile << "\t\t<MinSubstep>" << mMinSubstep << "</MinSubstep>\n";
+
+    // Call method on direct parent class
+    OffLatticeSimulation<DIM>::OutputSimulationParameters(rParamsFile);
+}
+
+// Explicit instantiation
+template class AdaptiveTimestepOffLatticeSimulation<1>;
+template class AdaptiveTimestepOffLatticeSimulation<2>;
+template class AdaptiveTimestepOffLatticeSimulation<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(AdaptiveTimestepOffLatticeSimulation)
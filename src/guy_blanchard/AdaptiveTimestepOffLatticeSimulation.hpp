@@ -0,0 +1,221 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef ADAPTIVETIMESTEPOFFLATTICESIMULATION_HPP_
+#define ADAPTIVETIMESTEPOFFLATTICESIMULATION_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+
+#include "OffLatticeSimulation.hpp"
+#include "VertexBasedCellPopulation.hpp"
+
+/**
+ * An OffLatticeSimulation for vertex-based cell populations in which the node positions are
+ * advanced over each time step by a sequence of adaptive forward Euler substeps.
+ *
+ * The time step set by SetDt() remains the interval at which cell births and deaths, remeshing,
+ * simulation modifiers and output happen, so output still lands on the requested sampling times;
+ * it should be set to the coarsest interval required (for example the output interval). Within
+ * each time step, a substep is chosen so that no vertex moves further than a fraction
+ * (mMaxDisplacementFraction) of the cell rearrangement threshold. The substep grows by
+ * mSubstepGrowthFactor while the largest vertex speed is not increasing, and is halved if the
+ * largest vertex speed grows faster than this (a sign of instability). If a substep would invert
+ * an element, the node positions are restored and the substep is halved and retried; an element
+ * that is already inverted before a substep, which no substep can undo, causes an exception. Unless
+ * SetUpdateCellPopulationRule(false) has been called, the mesh is remeshed between substeps, so
+ * that T1 swaps happen on the substep time scale.
+ */
+template<unsigned DIM>
+class AdaptiveTimestepOffLatticeSimulation : public OffLatticeSimulation<DIM>
+{
+private:
+
+    /** Largest vertex displacement in a substep, as a fraction of the cell rearrangement threshold. Defaults to 0.25. */
+    double mMaxDisplacementFraction;
+
+    /** Factor by which the substep grows when the dynamics are smooth. Defaults to 1.2. */
+    double mSubstepGrowthFactor;
+
+    /** Smallest allowed substep; an exception is thrown below this. Defaults to 1e-8. */
+    double mMinSubstep;
+
+    /** The current substep. Set to the time step at the start of the simulation. */
+    double mCurrentSubstep;
+
+    /** The largest vertex speed at the start of the previous substep. */
+    double mPreviousMaxSpeed;
+
+    /** The number of substeps accepted so far. */
+    unsigned mNumSubsteps;
+
+    /** The number of substeps rejected so far because an element would invert. */
+    unsigned mNumRejectedSubsteps;
+
+    friend class boost::serialization::access;
+    /**
+     * Boost Serialization method for archiving/checkpointing.
+     * Archives the object and its member variables.
+     *
+     * @param archive  The boost archive.
+     * @param version  The current version of this class.
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<OffLatticeSimulation<DIM> >(*this);
+        archive & mMaxDisplacementFraction;
+        archive & mSubstepGrowthFactor;
+        archive & mMinSubstep;
+        archive & mCurrentSubstep;
+        archive & mPreviousMaxSpeed;
+        archive & mNumSubsteps;
+        archive & mNumRejectedSubsteps;
+    }
+
+    /**
+     * Clear the applied force on each node and add the contribution of each force.
+     *
+     * @return the largest speed (force divided by damping constant) of any node.
+     */
+    double ComputeForces();
+
+    /**
+     * @return the global index of the first element of the mesh with non-positive signed area,
+     *     or UNSIGNED_UNSET if there is none.
+     */
+    unsigned GetInvertedElementIndex();
+
+protected:
+
+    /**
+     * Overridden UpdateCellLocationsAndTopology() method.
+     *
+     * Advances the node positions over one time step using adaptive substeps.
+     */
+    virtual void UpdateCellLocationsAndTopology();
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param rCellPopulation reference to the cell population (must be a VertexBasedCellPopulation)
+     * @param deleteCellPopulationInDestructor whether to delete the cell population on destruction to
+     *     free up memory (defaults to false)
+     * @param initialiseCells whether to initialise cells (defaults to true, set to false when loading
+     *     from an archive)
+     */
+    AdaptiveTimestepOffLatticeSimulation(AbstractCellPopulation<DIM>& rCellPopulation,
+                                         bool deleteCellPopulationInDestructor=false,
+                                         bool initialiseCells=true);
+
+    /**
+     * Set mMaxDisplacementFraction.
+     *
+     * @param maxDisplacementFraction the new value of mMaxDisplacementFraction
+     */
+    void SetMaxDisplacementFraction(double maxDisplacementFraction);
+
+    /**
+     * Set mSubstepGrowthFactor.
+     *
+     * @param substepGrowthFactor the new value of mSubstepGrowthFactor
+     */
+    void SetSubstepGrowthFactor(double substepGrowthFactor);
+
+    /**
+     * Set mMinSubstep.
+     *
+     * @param minSubstep the new value of mMinSubstep
+     */
+    void SetMinSubstep(double minSubstep);
+
+    /**
+     * @return mNumSubsteps
+     */
+    unsigned GetNumSubsteps() const;
+
+    /**
+     * @return mNumRejectedSubsteps
+     */
+    unsigned GetNumRejectedSubsteps() const;
+
+    /**
+     * Overridden OutputSimulationParameters() method.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    void OutputSimulationParameters(out_stream& rParamsFile);
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(AdaptiveTimestepOffLatticeSimulation)
+
+namespace boost
+{
+namespace serialization
+{
+/**
+ * Serialize information required to construct an AdaptiveTimestepOffLatticeSimulation.
+ */
+template<class Archive, unsigned DIM>
+inline void save_construct_data(
+    Archive & ar, const AdaptiveTimestepOffLatticeSimulation<DIM> * t, const unsigned int file_version)
+{
+    // Save data required to construct instance
+    const AbstractCellPopulation<DIM>* p_cell_population = &(t->rGetCellPopulation());
+    ar & p_cell_population;
+}
+
+/**
+ * De-serialize constructor parameters and initialise an AdaptiveTimestepOffLatticeSimulation.
+ */
+template<class Archive, unsigned DIM>
+inline void load_construct_data(
+    Archive & ar, AdaptiveTimestepOffLatticeSimulation<DIM> * t, const unsigned int file_version)
+{
+    // Retrieve data from archive required to construct new instance
+    AbstractCellPopulation<DIM>* p_cell_population;
+    ar >> p_cell_population;
+
+    // Invoke inplace constructor to initialise instance, middle two variables set extra
+    // member variables to be deleted as they are loaded from archive and to not initialise sells.
+    ::new(t)AdaptiveTimestepOffLatticeSimulation<DIM>(*p_cell_population, true, false);
+}
+}
+} // namespace
+
+#endif /*ADAPTIVETIMESTEPOFFLATTICESIMULATION_HPP_*/
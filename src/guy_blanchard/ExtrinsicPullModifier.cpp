@@ -1,10 +1,13 @@
 #include "ExtrinsicPullModifier.hpp"
 
+#include <cfloat>
+
 template<unsigned DIM>
 ExtrinsicPullModifier<DIM>::ExtrinsicPullModifier()
     : AbstractCellBasedSimulationModifier<DIM>(),
       mApplyExtrinsicPullToAllNodes(true),
-      mSpeed(1.0)
+      mSpeed(1.0),
+      mpGeometryCache(new PopulationGeometryCache<DIM>())
 {
 }
 
@@ -19,42 +22,46 @@ void ExtrinsicPullModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DI
     double epsilon = 0.8;
 
     double dt = SimulationTime::Instance()->GetTimeStep();
-    unsigned num_nodes = rCellPopulation.GetNumNodes();
-    ChasteCuboid<DIM> bounds = rCellPopulation.rGetMesh().CalculateBoundingBox();
+    ChasteCuboid<DIM> bounds = mpGeometryCache->GetBoundingBox(rCellPopulation);
     double x_min = bounds.rGetLowerCorner()[0];
     double x_max = bounds.rGetUpperCorner()[0];
 
     if (mApplyExtrinsicPullToAllNodes)
     {
-        // Pull on all nodes, with a constant strain rate
-        double width = x_max - x_min;
-        for (unsigned node_index=0; node_index<num_nodes; node_index++)
-        {
-            Node<DIM>* p_node = rCellPopulation.GetNode(node_index);
-            double speed = mSpeed * (p_node->rGetLocation()[0] - x_min) / width;
+        // Pull on all nodes, with a constant strain rate that moves the right-most nodes at mSpeed
+        c_matrix<double, DIM, DIM> strain_rate = zero_matrix<double>(DIM, DIM);
+        strain_rate(0,0) = mSpeed/(x_max - x_min);
 
-            // Respect the SidekickBoundaryCondition...
-            if (p_node->rGetLocation()[0] > x_min + epsilon)
-            {
-//                if (p_node->rGetLocation()[0] < x_max - epsilon)
-//                {
-                    p_node->rGetModifiableLocation()[0] += speed*dt;
-//                }
-            }
+        // Respect the SidekickBoundaryCondition by pinning the nodes near the left-hand boundary
+        c_vector<double, DIM> pinned_lower_corner;
+        c_vector<double, DIM> pinned_upper_corner;
+        for (unsigned d=0; d<DIM; d++)
+        {
+            pinned_lower_corner[d] = -DBL_MAX;
+            pinned_upper_corner[d] = DBL_MAX;
         }
+        pinned_upper_corner[0] = x_min + epsilon;
+        mDeformation.ClearPinnedRegions();
+        mDeformation.AddPinnedRegion(pinned_lower_corner, pinned_upper_corner);
+
+        mDeformation.Apply(rCellPopulation, strain_rate, bounds.rGetLowerCorner().rGetLocation(), dt);
     }
     else
     {
-        // Pull on the right-most nodes only, with a constant speed
-        for (unsigned node_index=0; node_index<num_nodes; node_index++)
+        // Pull on the right-most nodes only, with a constant speed; these all lie on the boundary
+        const std::vector<unsigned>& r_boundary_nodes = mpGeometryCache->rGetBoundaryNodeIndices(rCellPopulation);
+        for (unsigned i=0; i<r_boundary_nodes.size(); i++)
         {
-            Node<DIM>* p_node = rCellPopulation.GetNode(node_index);
+            Node<DIM>* p_node = rCellPopulation.GetNode(r_boundary_nodes[i]);
             if (fabs(p_node->rGetLocation()[0] - x_max) < 0.1)
             {
                 p_node->rGetModifiableLocation()[0] += mSpeed*dt;
             }
         }
     }
+
+    // Nodes have moved, so the bounding box must be found again by the next class to use it
+    mpGeometryCache->InvalidateBoundingBox();
 }
 
 template<unsigned DIM>
@@ -84,6 +91,18 @@ void ExtrinsicPullModifier<DIM>::OutputSimulationModifierParameters(out_stream&
     AbstractCellBasedSimulationModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
 }
 
+template<unsigned DIM>
+void ExtrinsicPullModifier<DIM>::SetGeometryCache(boost::shared_ptr<PopulationGeometryCache<DIM> > pGeometryCache)
+{
+    mpGeometryCache = pGeometryCache;
+}
+
+template<unsigned DIM>
+boost::shared_ptr<PopulationGeometryCache<DIM> > ExtrinsicPullModifier<DIM>::GetGeometryCache()
+{
+    return mpGeometryCache;
+}
+
 // Explicit instantiation
 template class ExtrinsicPullModifier<1>;
 template class ExtrinsicPullModifier<2>;
@@ -5,6 +5,8 @@
 #include <boost/serialization/base_object.hpp>
 
 #include "AbstractCellBasedSimulationModifier.hpp"
+#include "PopulationGeometryCache.hpp"
+#include "PrescribedStrainRateDeformation.hpp"
 
 template<unsigned DIM>
 class ExtrinsicPullModifier : public AbstractCellBasedSimulationModifier<DIM,DIM>
@@ -33,6 +35,12 @@ private:
     bool mPinAnteriorMostCells;
     double mSpeed;
 
+    /** The boundary nodes and bounding box of the cell population. Not archived. */
+    boost::shared_ptr<PopulationGeometryCache<DIM> > mpGeometryCache;
+
+    /** Applies the stretch when the pull acts on all nodes. Not archived, as its pinned region is reset each time step. */
+    PrescribedStrainRateDeformation<DIM> mDeformation;
+
 public:
 
     /**
@@ -81,6 +89,18 @@ public:
      * @param rParamsFile the file stream to which the parameters are output
      */
     void OutputSimulationModifierParameters(out_stream& rParamsFile);
+
+    /**
+     * Set the geometry cache, so that it may be shared with other classes acting on the same cell population.
+     *
+     * @param pGeometryCache the geometry cache
+     */
+    void SetGeometryCache(boost::shared_ptr<PopulationGeometryCache<DIM> > pGeometryCache);
+
+    /**
+     * @return the geometry cache.
+     */
+    boost::shared_ptr<PopulationGeometryCache<DIM> > GetGeometryCache();
 };
 
 #include "SerializationExportWrapper.hpp"
@@ -3,7 +3,9 @@
 
 template<unsigned DIM>
 FarhadifarForceWithTimeDependentCoefficients<DIM>::FarhadifarForceWithTimeDependentCoefficients()
-   : FarhadifarForce<DIM>()
+   : ParallelFarhadifarForce<DIM>(),
+     mCoefficientIncreaseInterval(50.0),
+     mCoefficientIncreasePerInterval(0.1)
 {
 }
 
@@ -12,30 +14,47 @@ FarhadifarForceWithTimeDependentCoefficients<DIM>::~FarhadifarForceWithTimeDepen
 {
 }
 
+template<unsigned DIM>
+double FarhadifarForceWithTimeDependentCoefficients<DIM>::GetCoefficientIncrease()
+{
+	double num_rounds = floor(SimulationTime::Instance()->GetTimeStepsElapsed()*SimulationTime::Instance()->GetTimeStep()/mCoefficientIncreaseInterval);
+	return mCoefficientIncreasePerInterval*num_rounds;
+}
+
 template<unsigned DIM>
 double FarhadifarForceWithTimeDependentCoefficients<DIM>::GetAreaElasticityParameter()
 {
-	double area_elasticity_parameter = this->mAreaElasticityParameter;
-	double num_rounds = floor(SimulationTime::Instance()->GetTimeStepsElapsed()*SimulationTime::Instance()->GetTimeStep()/50.0);
-	double increase_per_round = 0.1;
-	area_elasticity_parameter += increase_per_round*num_rounds;
-    return area_elasticity_parameter;
+	// This is called once per time step by ParallelFarhadifarForce, not once per node
+	return this->mAreaElasticityParameter + GetCoefficientIncrease();
 }
 
 template<unsigned DIM>
 double FarhadifarForceWithTimeDependentCoefficients<DIM>::GetPerimeterContractilityParameter()
 {
-	double perimeter_contractility_parameter = this->mPerimeterContractilityParameter;
-	double num_rounds = floor(SimulationTime::Instance()->GetTimeStepsElapsed()*SimulationTime::Instance()->GetTimeStep()/50.0);
-	double increase_per_round = 0.1;
-	perimeter_contractility_parameter += increase_per_round*num_rounds;
-	return perimeter_contractility_parameter;
+	return this->mPerimeterContractilityParameter + GetCoefficientIncrease();
+}
+
+template<unsigned DIM>
+void FarhadifarForceWithTimeDependentCoefficients<DIM>::SetCoefficientIncreaseInterval(double coefficientIncreaseInterval)
+{
+    assert(coefficientIncreaseInterval > 0.0);
+    mCoefficientIncreaseInterval = coefficientIncreaseInterval;
+}
+
+template<unsigned DIM>
+void FarhadifarForceWithTimeDependentCoefficients<DIM>::SetCoefficientIncreasePerInterval(double coefficientIncreasePerInterval)
+{
+    mCoefficientIncreasePerInterval = coefficientIncreasePerInterval;
 }
 
 template<unsigned DIM>
 void FarhadifarForceWithTimeDependentCoefficients<DIM>::OutputForceParameters(out_stream& rParamsFile)
 {
-    FarhadifarForce<DIM>::OutputForceParameters(rParamsFile);
+    // Output member variables then call method on direct parent class
+    *rParamsFile << "\t\t\t<CoefficientIncreaseInterval>" << mCoefficientIncreaseInterval << "</CoefficientIncreaseInterval> \n";
+    *rParamsFile << "\t\t\t<CoefficientIncreasePerInterval>" << mCoefficientIncreasePerInterval << "</CoefficientIncreasePerInterval> \n";
+
+    ParallelFarhadifarForce<DIM>::OutputForceParameters(rParamsFile);
 }
 
 // Explicit instantiation
@@ -6,18 +6,33 @@
 #include <boost/serialization/base_object.hpp>
 #include "Exception.hpp"
 
-#include "FarhadifarForce.hpp"
+#include "ParallelFarhadifarForce.hpp"
 #include "VertexBasedCellPopulation.hpp"
 
 #include <iostream>
 
+/**
+ * A ParallelFarhadifarForce whose area elasticity and perimeter contractility parameters
+ * increase in steps over time: each parameter is increased by mCoefficientIncreasePerInterval
+ * after every mCoefficientIncreaseInterval units of time elapsed in the simulation (by default,
+ * by 0.1 every 50 units of time). The parameters are evaluated once per time step.
+ *
+ * The increase is added to the parameter values, whether these are set directly or by a
+ * ForceCoefficientSchedule; set mCoefficientIncreasePerInterval to zero to use a schedule alone.
+ */
 template<unsigned DIM>
-class FarhadifarForceWithTimeDependentCoefficients : public FarhadifarForce<DIM>
+class FarhadifarForceWithTimeDependentCoefficients : public ParallelFarhadifarForce<DIM>
 {
 friend class TestForces;
 
 private:
 
+    /** The interval of time after which the parameters increase. Defaults to 50. */
+    double mCoefficientIncreaseInterval;
+
+    /** The amount by which the parameters increase after each interval. Defaults to 0.1. */
+    double mCoefficientIncreasePerInterval;
+
     friend class boost::serialization::access;
     /**
      * Boost Serialization method for archiving/checkpointing.
@@ -29,9 +44,16 @@ private:
     template<class Archive>
     void serialize(Archive & archive, const unsigned int version)
     {
-        archive & boost::serialization::base_object<FarhadifarForce<DIM> >(*this);
+        archive & boost::serialization::base_object<ParallelFarhadifarForce<DIM> >(*this);
+        archive & mCoefficientIncreaseInterval;
+        archive & mCoefficientIncreasePerInterval;
     }
 
+    /**
+     * @return the total increase in the parameters at the current simulation time.
+     */
+    double GetCoefficientIncrease();
+
 public:
 
     /**
@@ -45,15 +67,29 @@ public:
     virtual ~FarhadifarForceWithTimeDependentCoefficients();
 
     /**
-     * @return mAreaElasticityParameter
+     * @return mAreaElasticityParameter plus the increase at the current simulation time
      */
     virtual double GetAreaElasticityParameter();
 
     /**
-     * @return mPerimeterContractilityParameter
+     * @return mPerimeterContractilityParameter plus the increase at the current simulation time
      */
     virtual double GetPerimeterContractilityParameter();
 
+    /**
+     * Set mCoefficientIncreaseInterval.
+     *
+     * @param coefficientIncreaseInterval the new value of mCoefficientIncreaseInterval
+     */
+    void SetCoefficientIncreaseInterval(double coefficientIncreaseInterval);
+
+    /**
+     * Set mCoefficientIncreasePerInterval.
+     *
+     * @param coefficientIncreasePerInterval the new value of mCoefficientIncreasePerInterval
+     */
+    void SetCoefficientIncreasePerInterval(double coefficientIncreasePerInterval);
+
     /**
      * Overridden OutputForceParameters() method.
      *
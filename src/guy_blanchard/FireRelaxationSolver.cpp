@@ -0,0 +1,358 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "FireRelaxationSolver.hpp"
+#include "VertexBasedCellPopulation.hpp"
+#include "AbstractIndexedBoundaryCondition.hpp"
+#include "ChastePoint.hpp"
+
+/** Number of steps with positive power before the FIRE time step may grow. */
+static const unsigned FIRE_NUM_STEPS_BEFORE_GROWTH = 5;
+
+/** Factor by which the FIRE time step grows. */
+static const double FIRE_TIME_STEP_INCREASE = 1.1;
+
+/** Factor by which the FIRE time step shrinks when the power becomes negative. */
+static const double FIRE_TIME_STEP_DECREASE = 0.5;
+
+/** Initial FIRE velocity mixing parameter. */
+static const double FIRE_INITIAL_MIXING = 0.1;
+
+/** Factor by which the FIRE velocity mixing parameter decays. */
+static const double FIRE_MIXING_DECREASE = 0.99;
+
+/** Largest displacement of a probe step used to project the forces through the boundary conditions, as a fraction of the largest displacement of an iteration. */
+static const double FIRE_PROBE_FRACTION = 1e-3;
+
+template<unsigned DIM>
+FireRelaxationSolver<DIM>::FireRelaxationSolver(AbstractOffLatticeCellPopulation<DIM>& rCellPopulation)
+    : mrCellPopulation(rCellPopulation),
+      mForceTolerance(1e-6),
+      mMaxIterations(100000),
+      mInitialTimeStep(0.01),
+      mMaxTimeStep(0.1),
+      mMaxDisplacement(DOUBLE_UNSET),
+      mRemeshInterval(100),
+      mNumIterations(0),
+      mFinalForceNorm(DOUBLE_UNSET)
+{
+}
+
+template<unsigned DIM>
+void FireRelaxationSolver<DIM>::AddForce(boost::shared_ptr<AbstractForce<DIM> > pForce)
+{
+    mForceCollection.push_back(pForce);
+}
+
+template<unsigned DIM>
+void FireRelaxationSolver<DIM>::AddCellPopulationBoundaryCondition(boost::shared_ptr<AbstractCellPopulationBoundaryCondition<DIM> > pBoundaryCondition)
+{
+    mBoundaryConditions.push_back(pBoundaryCondition);
+}
+
+template<unsigned DIM>
+double FireRelaxationSolver<DIM>::ComputeForces()
+{
+    unsigned num_nodes = mrCellPopulation.GetNumNodes();
+    for (unsigned node_index=0; node_index<num_nodes; node_index++)
+    {
+        mrCellPopulation.GetNode(node_index)->ClearAppliedForce();
+    }
+
+    for (unsigned i=0; i<mForceCollection.size(); i++)
+    {
+        mForceCollection[i]->AddForceContribution(mrCellPopulation);
+    }
+
+    double max_force = 0.0;
+    for (unsigned node_index=0; node_index<num_nodes; node_index++)
+    {
+        max_force = std::max(max_force, norm_2(mrCellPopulation.GetNode(node_index)->rGetAppliedForce()));
+    }
+
+    if (!mBoundaryConditions.empty() && (max_force > 0.0))
+    {
+        ProjectForcesOntoBoundaryConditions(max_force);
+
+        max_force = 0.0;
+        for (unsigned node_index=0; node_index<num_nodes; node_index++)
+        {
+            max_force = std::max(max_force, norm_2(mrCellPopulation.GetNode(node_index)->rGetAppliedForce()));
+        }
+    }
+    return max_force;
+}
+
+template<unsigned DIM>
+void FireRelaxationSolver<DIM>::ApplyBoundaryConditions()
+{
+    // Boundary conditions that accept the indexed old locations are passed them directly; a map is built only for any others
+    std::map<Node<DIM>*, c_vector<double, DIM> > old_node_location_map;
+    for (unsigned i=0; i<mBoundaryConditions.size(); i++)
+    {
+        AbstractIndexedBoundaryCondition<DIM>* p_indexed_bc = dynamic_cast<AbstractIndexedBoundaryCondition<DIM>*>(mBoundaryConditions[i].get());
+        if (p_indexed_bc)
+        {
+            p_indexed_bc->ImposeIndexedBoundaryCondition(mOldNodeLocations);
+        }
+        else
+        {
+            if (old_node_location_map.empty())
+            {
+                for (unsigned node_index=0; node_index<mrCellPopulation.GetNumNodes(); node_index++)
+                {
+                    Node<DIM>* p_node = mrCellPopulation.GetNode(node_index);
+                    old_node_location_map[p_node] = mOldNodeLocations[p_node->GetIndex()];
+                }
+            }
+            mBoundaryConditions[i]->ImposeBoundaryCondition(old_node_location_map);
+        }
+    }
+
+    for (unsigned i=0; i<mBoundaryConditions.size(); i++)
+    {
+        if (!mBoundaryConditions[i]->VerifyBoundaryCondition())
+        {
+            EXCEPTION("The cell population boundary conditions are incompatible.");
+        }
+    }
+}
+
+template<unsigned DIM>
+void FireRelaxationSolver<DIM>::ProjectForcesOntoBoundaryConditions(double maxForce)
+{
+    double probe_step = FIRE_PROBE_FRACTION*GetMaxDisplacementInUse()/maxForce;
+
+    AbstractIndexedBoundaryCondition<DIM>::RecordOldLocations(mrCellPopulation, mOldNodeLocations);
+    unsigned num_nodes = mrCellPopulation.GetNumNodes();
+    for (unsigned node_index=0; node_index<num_nodes; node_index++)
+    {
+        Node<DIM>* p_node = mrCellPopulation.GetNode(node_index);
+        p_node->rGetModifiableLocation() += probe_step*p_node->rGetAppliedForce();
+    }
+
+    ApplyBoundaryConditions();
+
+    // Take the realised displacement as the force, and restore the node locations
+    for (unsigned node_index=0; node_index<num_nodes; node_index++)
+    {
+        Node<DIM>* p_node = mrCellPopulation.GetNode(node_index);
+        const c_vector<double, DIM>& r_old_location = mOldNodeLocations[p_node->GetIndex()];
+        c_vector<double, DIM> projected_force = (p_node->rGetLocation() - r_old_location)/probe_step;
+        p_node->ClearAppliedForce();
+        p_node->AddAppliedForceContribution(projected_force);
+        p_node->rGetModifiableLocation() = r_old_location;
+    }
+}
+
+template<unsigned DIM>
+double FireRelaxationSolver<DIM>::GetMaxDisplacementInUse()
+{
+    if (mMaxDisplacement != DOUBLE_UNSET)
+    {
+        return mMaxDisplacement;
+    }
+    if (dynamic_cast<VertexBasedCellPopulation<DIM>*>(&mrCellPopulation))
+    {
+        return 0.5*static_cast<VertexBasedCellPopulation<DIM>*>(&mrCellPopulation)->rGetMesh().GetCellRearrangementThreshold();
+    }
+    return 0.05;
+}
+
+template<unsigned DIM>
+bool FireRelaxationSolver<DIM>::Relax()
+{
+    if (mForceCollection.empty())
+    {
+        EXCEPTION("FireRelaxationSolver requires at least one force");
+    }
+
+    double max_displacement = GetMaxDisplacementInUse();
+    double time_step = mInitialTimeStep;
+    double mixing = FIRE_INITIAL_MIXING;
+    unsigned num_steps_with_positive_power = 0;
+
+    unsigned num_nodes = mrCellPopulation.GetNumNodes();
+    std::vector<c_vector<double, DIM> > velocities(num_nodes, zero_vector<double>(DIM));
+    std::vector<c_vector<double, DIM> > displacements(num_nodes);
+
+    mNumIterations = 0;
+    mFinalForceNorm = ComputeForces();
+    while ((mFinalForceNorm >= mForceTolerance) && (mNumIterations < mMaxIterations))
+    {
+        // Stop if moving uphill, otherwise mix the velocity towards the force
+        double power = 0.0;
+        double velocity_norm_squared = 0.0;
+        double force_norm_squared = 0.0;
+        for (unsigned node_index=0; node_index<num_nodes; node_index++)
+        {
+            const c_vector<double, DIM>& r_force = mrCellPopulation.GetNode(node_index)->rGetAppliedForce();
+            power += inner_prod(r_force, velocities[node_index]);
+            velocity_norm_squared += inner_prod(velocities[node_index], velocities[node_index]);
+            force_norm_squared += inner_prod(r_force, r_force);
+        }
+
+        if (power < 0.0)
+        {
+            for (unsigned node_index=0; node_index<num_nodes; node_index++)
+            {
+                velocities[node_index] = zero_vector<double>(DIM);
+            }
+            time_step *= FIRE_TIME_STEP_DECREASE;
+            mixing = FIRE_INITIAL_MIXING;
+            num_steps_with_positive_power = 0;
+        }
+        else
+        {
+            double scale = mixing*sqrt(velocity_norm_squared/force_norm_squared);
+            for (unsigned node_index=0; node_index<num_nodes; node_index++)
+            {
+                velocities[node_index] = (1.0 - mixing)*velocities[node_index] + scale*mrCellPopulation.GetNode(node_index)->rGetAppliedForce();
+            }
+
+            num_steps_with_positive_power++;
+            if (num_steps_with_positive_power > FIRE_NUM_STEPS_BEFORE_GROWTH)
+            {
+                time_step = std::min(time_step*FIRE_TIME_STEP_INCREASE, mMaxTimeStep);
+                mixing *= FIRE_MIXING_DECREASE;
+            }
+        }
+
+        // Semi-implicit Euler step, with the largest displacement capped
+        double largest_displacement = 0.0;
+        for (unsigned node_index=0; node_index<num_nodes; node_index++)
+        {
+            velocities[node_index] += time_step*mrCellPopulation.GetNode(node_index)->rGetAppliedForce();
+            displacements[node_index] = time_step*velocities[node_index];
+            largest_displacement = std::max(largest_displacement, norm_2(displacements[node_index]));
+        }
+        double displacement_scale = (largest_displacement > max_displacement) ? max_displacement/largest_displacement : 1.0;
+
+        if (!mBoundaryConditions.empty())
+        {
+            AbstractIndexedBoundaryCondition<DIM>::RecordOldLocations(mrCellPopulation, mOldNodeLocations);
+        }
+
+        for (unsigned node_index=0; node_index<num_nodes; node_index++)
+        {
+            ChastePoint<DIM> new_point(mrCellPopulation.GetNode(node_index)->rGetLocation() + displacement_scale*displacements[node_index]);
+            mrCellPopulation.SetNode(node_index, new_point);
+        }
+
+        if (!mBoundaryConditions.empty())
+        {
+            ApplyBoundaryConditions();
+
+            // Keep only the part of each velocity that the boundary conditions allowed
+            for (unsigned node_index=0; node_index<num_nodes; node_index++)
+            {
+                Node<DIM>* p_node = mrCellPopulation.GetNode(node_index);
+                velocities[node_index] = (p_node->rGetLocation() - mOldNodeLocations[p_node->GetIndex()])/time_step;
+            }
+        }
+        mNumIterations++;
+
+        // Allow the topology to change; node indices are only preserved if the number of nodes is
+        if ((mRemeshInterval > 0) && (mNumIterations%mRemeshInterval == 0))
+        {
+            mrCellPopulation.Update();
+            if (mrCellPopulation.GetNumNodes() != num_nodes)
+            {
+                num_nodes = mrCellPopulation.GetNumNodes();
+                velocities.assign(num_nodes, zero_vector<double>(DIM));
+                displacements.resize(num_nodes);
+                mixing = FIRE_INITIAL_MIXING;
+                num_steps_with_positive_power = 0;
+            }
+        }
+
+        mFinalForceNorm = ComputeForces();
+    }
+
+    return (mFinalForceNorm < mForceTolerance);
+}
+
+template<unsigned DIM>
+void FireRelaxationSolver<DIM>::SetForceTolerance(double forceTolerance)
+{
+    mForceTolerance = forceTolerance;
+}
+
+template<unsigned DIM>
+void FireRelaxationSolver<DIM>::SetMaxIterations(unsigned maxIterations)
+{
+    mMaxIterations = maxIterations;
+}
+
+template<unsigned DIM>
+void FireRelaxationSolver<DIM>::SetInitialTimeStep(double initialTimeStep)
+{
+    mInitialTimeStep = initialTimeStep;
+}
+
+template<unsigned DIM>
+void FireRelaxationSolver<DIM>::SetMaxTimeStep(double maxTimeStep)
+{
+    mMaxTimeStep = maxTimeStep;
+}
+
+template<unsigned DIM>
+void FireRelaxationSolver<DIM>::SetMaxDisplacement(double maxDisplacement)
+{
+    mMaxDisplacement = maxDisplacement;
+}
+
+template<unsigned DIM>
+void FireRelaxationSolver<DIM>::SetRemeshInterval(unsigned remeshInterval)
+{
+    mRemeshInterval = remeshInterval;
+}
+
+template<unsigned DIM>
+unsigned FireRelaxationSolver<DIM>::GetNumIterations() const
+{
+    return mNumIterations;
+}
+
+template<unsigned DIM>
+double FireRelaxationSolver<DIM>::GetFinalForceNorm() const
+{
+    return mFinalForceNorm;
+}
+
+// Explicit instantiation
+template class FireRelaxationSolver<1>;
+template class FireRelaxationSolver<2>;
+template class FireRelaxationSolver<3>;
@@ -0,0 +1,224 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef FIRERELAXATIONSOLVER_HPP_
+#define FIRERELAXATIONSOLVER_HPP_
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include "AbstractOffLatticeCellPopulation.hpp"
+#include "AbstractForce.hpp"
+#include "AbstractCellPopulationBoundaryCondition.hpp"
+
+/**
+ * A quasi-static relaxation driver that moves the nodes of a cell population towards a
+ * local minimum of the energy whose negative gradient is given by a collection of forces,
+ * using the Fast Inertial Relaxation Engine (FIRE) of Bitzek et al (Phys. Rev. Lett., 2006,
+ * 97, 170201).
+ *
+ * This is intended to replace the long explicit runs used to relax an initial honeycomb before
+ * an experiment: relax the population with this class, then construct an OffLatticeSimulation
+ * on the same population and solve as usual. Simulation time is not advanced, and any target
+ * areas required by the forces must already be set (for example by calling UpdateTargetAreas()
+ * on a target area modifier).
+ *
+ * Relaxation stops when the largest force on any node falls below a tolerance. To allow the
+ * topology to change as it would during an explicit relaxation, the population is updated
+ * (for vertex populations, remeshed) every mRemeshInterval iterations. The displacement of any
+ * node in one iteration is capped, by default at half the cell rearrangement threshold for vertex
+ * populations, as in VertexBasedCellPopulation::UpdateNodeLocations().
+ *
+ * Cell population boundary conditions may be added, and are imposed after every iteration
+ * exactly as OffLatticeSimulation imposes them after every time step. So that a node held by
+ * a boundary condition does not prevent convergence, the force used by FIRE and in the
+ * convergence test is the force projected through the boundary conditions, that is the
+ * displacement a small step along the force would produce once they are imposed.
+ */
+template<unsigned DIM>
+class FireRelaxationSolver
+{
+private:
+
+    /** The cell population to relax. */
+    AbstractOffLatticeCellPopulation<DIM>& mrCellPopulation;
+
+    /** The forces whose energy is minimised. */
+    std::vector<boost::shared_ptr<AbstractForce<DIM> > > mForceCollection;
+
+    /** The boundary conditions imposed after each iteration. */
+    std::vector<boost::shared_ptr<AbstractCellPopulationBoundaryCondition<DIM> > > mBoundaryConditions;
+
+    /** Workspace holding the node locations before the current move, indexed by node index. */
+    std::vector<c_vector<double, DIM> > mOldNodeLocations;
+
+    /** Relaxation stops when the largest force on any node is below this value. Defaults to 1e-6. */
+    double mForceTolerance;
+
+    /** Maximum number of FIRE iterations. Defaults to 100000. */
+    unsigned mMaxIterations;
+
+    /** Initial FIRE time step. Defaults to 0.01. */
+    double mInitialTimeStep;
+
+    /** Largest FIRE time step. Defaults to 0.1. */
+    double mMaxTimeStep;
+
+    /**
+     * Largest displacement of any node in one iteration. Defaults to DOUBLE_UNSET, in which case
+     * half the cell rearrangement threshold is used for vertex populations and 0.05 otherwise.
+     */
+    double mMaxDisplacement;
+
+    /** Number of iterations between updates of the cell population, or 0 for none. Defaults to 100. */
+    unsigned mRemeshInterval;
+
+    /** Number of iterations taken by the last call to Relax(). */
+    unsigned mNumIterations;
+
+    /** Largest force on any node at the end of the last call to Relax(). */
+    double mFinalForceNorm;
+
+    /**
+     * Clear the applied force on each node and add the contribution of each force. If there
+     * are any boundary conditions, the applied forces are then projected through them.
+     *
+     * @return the largest force on any node.
+     */
+    double ComputeForces();
+
+    /**
+     * Impose each boundary condition, given the node locations before the current move in
+     * mOldNodeLocations, and check that each is satisfied.
+     */
+    void ApplyBoundaryConditions();
+
+    /**
+     * Replace the applied force on each node by the displacement, per unit step, produced by a
+     * small step along the applied forces once the boundary conditions are imposed. The node
+     * locations are left unchanged.
+     *
+     * @param maxForce the largest applied force on any node
+     */
+    void ProjectForcesOntoBoundaryConditions(double maxForce);
+
+    /**
+     * @return the largest displacement of any node in one iteration.
+     */
+    double GetMaxDisplacementInUse();
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param rCellPopulation the cell population to relax
+     */
+    FireRelaxationSolver(AbstractOffLatticeCellPopulation<DIM>& rCellPopulation);
+
+    /**
+     * Add a force to the collection whose energy is minimised.
+     *
+     * @param pForce pointer to the force
+     */
+    void AddForce(boost::shared_ptr<AbstractForce<DIM> > pForce);
+
+    /**
+     * Add a cell population boundary condition, to be imposed after each iteration.
+     *
+     * @param pBoundaryCondition pointer to the boundary condition
+     */
+    void AddCellPopulationBoundaryCondition(boost::shared_ptr<AbstractCellPopulationBoundaryCondition<DIM> > pBoundaryCondition);
+
+    /**
+     * Relax the cell population.
+     *
+     * @return whether the force tolerance was met within mMaxIterations iterations.
+     */
+    bool Relax();
+
+    /**
+     * Set mForceTolerance.
+     *
+     * @param forceTolerance the new value of mForceTolerance
+     */
+    void SetForceTolerance(double forceTolerance);
+
+    /**
+     * Set mMaxIterations.
+     *
+     * @param maxIterations the new value of mMaxIterations
+     */
+    void SetMaxIterations(unsigned maxIterations);
+
+    /**
+     * Set mInitialTimeStep.
+     *
+     * @param initialTimeStep the new value of mInitialTimeStep
+     */
+    void SetInitialTimeStep(double initialTimeStep);
+
+    /**
+     * Set mMaxTimeStep.
+     *
+     * @param maxTimeStep the new value of mMaxTimeStep
+     */
+    void SetMaxTimeStep(double maxTimeStep);
+
+    /**
+     * Set mMaxDisplacement.
+     *
+     * @param maxDisplacement the new value of mMaxDisplacement
+     */
+    void SetMaxDisplacement(double maxDisplacement);
+
+    /**
+     * Set mRemeshInterval.
+     *
+     * @param remeshInterval the new value of mRemeshInterval
+     */
+    void SetRemeshInterval(unsigned remeshInterval);
+
+    /**
+     * @return mNumIterations
+     */
+    unsigned GetNumIterations() const;
+
+    /**
+     * @return mFinalForceNorm
+     */
+    double GetFinalForceNorm() const;
+};
+
+#endif /*FIRERELAXATIONSOLVER_HPP_*/
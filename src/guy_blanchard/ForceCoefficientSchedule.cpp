@@ -0,0 +1,182 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "ForceCoefficientSchedule.hpp"
+#include "Exception.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+ForceCoefficientSchedule::ForceCoefficientSchedule(InterpolationType interpolationType)
+    : mInterpolationType(interpolationType)
+{
+}
+
+void ForceCoefficientSchedule::AddKnot(double time, double value)
+{
+    if (!mTimes.empty() && (time <= mTimes.back()))
+    {
+        EXCEPTION("Knots must be added to a ForceCoefficientSchedule in increasing order of time");
+    }
+    mTimes.push_back(time);
+    mValues.push_back(value);
+    ComputeSplineSecondDerivatives();
+}
+
+void ForceCoefficientSchedule::LoadFromFile(const FileFinder& rFile)
+{
+    if (!rFile.IsFile())
+    {
+        EXCEPTION("Unable to open force coefficient schedule file " << rFile.GetAbsolutePath());
+    }
+
+    std::ifstream file(rFile.GetAbsolutePath().c_str());
+    std::vector<double> times;
+    std::vector<double> values;
+    std::string line;
+    unsigned line_number = 0;
+    while (std::getline(file, line))
+    {
+        line_number++;
+
+        // Skip blank lines and comments
+        std::string::size_type first = line.find_first_not_of(" \t\r");
+        if ((first == std::string::npos) || (line[first] == '#'))
+        {
+            continue;
+        }
+
+        std::istringstream line_stream(line);
+        double time;
+        double value;
+        if (!(line_stream >> time >> value))
+        {
+            EXCEPTION("Unable to read a time and a value from line " << line_number << " of " << rFile.GetAbsolutePath());
+        }
+        if (!times.empty() && (time <= times.back()))
+        {
+            EXCEPTION("Times in " << rFile.GetAbsolutePath() << " must be in increasing order (line " << line_number << ")");
+        }
+        times.push_back(time);
+        values.push_back(value);
+    }
+
+    mTimes = times;
+    mValues = values;
+    ComputeSplineSecondDerivatives();
+}
+
+void ForceCoefficientSchedule::ComputeSplineSecondDerivatives()
+{
+    unsigned num_knots = mTimes.size();
+    mSecondDerivatives.assign(num_knots, 0.0);
+    if (num_knots < 3)
+    {
+        return;
+    }
+
+    // Solve the tridiagonal system for a natural spline (zero second derivative at each end) by the Thomas algorithm
+    std::vector<double> modified_upper(num_knots, 0.0);
+    for (unsigned i=1; i<num_knots-1; i++)
+    {
+        double h_left = mTimes[i] - mTimes[i-1];
+        double h_right = mTimes[i+1] - mTimes[i];
+        double rhs = 6.0*((mValues[i+1] - mValues[i])/h_right - (mValues[i] - mValues[i-1])/h_left);
+        double diagonal = 2.0*(h_left + h_right) - h_left*modified_upper[i-1];
+        modified_upper[i] = h_right/diagonal;
+        mSecondDerivatives[i] = (rhs - h_left*mSecondDerivatives[i-1])/diagonal;
+    }
+    for (unsigned i=num_knots-2; i>0; i--)
+    {
+        mSecondDerivatives[i] -= modified_upper[i]*mSecondDerivatives[i+1];
+    }
+}
+
+double ForceCoefficientSchedule::Evaluate(double time) const
+{
+    if (mTimes.empty())
+    {
+        EXCEPTION("A ForceCoefficientSchedule must have at least one knot before it is evaluated");
+    }
+
+    // Hold the end values outside the range of the knots
+    if (time <= mTimes.front())
+    {
+        return mValues.front();
+    }
+    if (time >= mTimes.back())
+    {
+        return mValues.back();
+    }
+
+    // Find the interval [mTimes[i], mTimes[i+1]) containing this time
+    unsigned i = (std::upper_bound(mTimes.begin(), mTimes.end(), time) - mTimes.begin()) - 1;
+    double h = mTimes[i+1] - mTimes[i];
+    double a = (mTimes[i+1] - time)/h;
+    double b = 1.0 - a;
+
+    double value = mValues[i];
+    switch (mInterpolationType)
+    {
+        case PIECEWISE_CONSTANT:
+            break;
+        case LINEAR:
+            value = a*mValues[i] + b*mValues[i+1];
+            break;
+        case CUBIC_SPLINE:
+            value = a*mValues[i] + b*mValues[i+1]
+                  + ((a*a*a - a)*mSecondDerivatives[i] + (b*b*b - b)*mSecondDerivatives[i+1])*h*h/6.0;
+            break;
+        default:
+            NEVER_REACHED;
+    }
+    return value;
+}
+
+unsigned ForceCoefficientSchedule::GetNumKnots() const
+{
+    return mTimes.size();
+}
+
+ForceCoefficientSchedule::InterpolationType ForceCoefficientSchedule::GetInterpolationType() const
+{
+    return mInterpolationType;
+}
+
+void ForceCoefficientSchedule::SetInterpolationType(InterpolationType interpolationType)
+{
+    mInterpolationType = interpolationType;
+}
@@ -0,0 +1,155 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef FORCECOEFFICIENTSCHEDULE_HPP_
+#define FORCECOEFFICIENTSCHEDULE_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/vector.hpp>
+
+#include <vector>
+#include "FileFinder.hpp"
+
+/**
+ * A force coefficient given as a function of time, defined by its values at a set of
+ * times ('knots') and interpolated between them.
+ *
+ * Three interpolation types are supported: piecewise constant (the value at the latest
+ * knot not after the given time), linear, and natural cubic spline. Before the first knot
+ * and after the last knot the coefficient takes the value at that knot.
+ *
+ * A schedule is intended to be evaluated once per time step by the force that uses it
+ * (see ParallelFarhadifarForce), so that the force's inner loops read plain member variables.
+ */
+class ForceCoefficientSchedule
+{
+public:
+
+    /** The type of interpolation between knots. */
+    enum InterpolationType
+    {
+        PIECEWISE_CONSTANT,
+        LINEAR,
+        CUBIC_SPLINE
+    };
+
+private:
+
+    /** The type of interpolation between knots. */
+    InterpolationType mInterpolationType;
+
+    /** The time of each knot, in increasing order. */
+    std::vector<double> mTimes;
+
+    /** The value of the coefficient at each knot. */
+    std::vector<double> mValues;
+
+    /** The second derivative of the natural cubic spline at each knot. Only used for CUBIC_SPLINE. */
+    std::vector<double> mSecondDerivatives;
+
+    friend class boost::serialization::access;
+    /**
+     * Boost Serialization method for archiving/checkpointing.
+     * Archives the object and its member variables.
+     *
+     * @param archive  The boost archive.
+     * @param version  The current version of this class.
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & mInterpolationType;
+        archive & mTimes;
+        archive & mValues;
+        archive & mSecondDerivatives;
+    }
+
+    /**
+     * Helper method to recompute mSecondDerivatives after the knots change.
+     */
+    void ComputeSplineSecondDerivatives();
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param interpolationType the type of interpolation between knots (defaults to PIECEWISE_CONSTANT)
+     */
+    ForceCoefficientSchedule(InterpolationType interpolationType=PIECEWISE_CONSTANT);
+
+    /**
+     * Add a knot to the schedule. Knots must be added in increasing order of time.
+     *
+     * @param time the time of the knot
+     * @param value the value of the coefficient at this time
+     */
+    void AddKnot(double time, double value);
+
+    /**
+     * Replace the knots of the schedule by those in a file. Each non-empty line of the file
+     * not starting with '#' must contain a time and a value, separated by whitespace, with
+     * the times in increasing order.
+     *
+     * @param rFile the file to read
+     */
+    void LoadFromFile(const FileFinder& rFile);
+
+    /**
+     * @return the value of the coefficient at a given time.
+     *
+     * @param time the time
+     */
+    double Evaluate(double time) const;
+
+    /**
+     * @return the number of knots.
+     */
+    unsigned GetNumKnots() const;
+
+    /**
+     * @return mInterpolationType
+     */
+    InterpolationType GetInterpolationType() const;
+
+    /**
+     * Set mInterpolationType.
+     *
+     * @param interpolationType the new value of mInterpolationType
+     */
+    void SetInterpolationType(InterpolationType interpolationType);
+};
+
+#endif /*FORCECOEFFICIENTSCHEDULE_HPP_*/
@@ -1,6 +1,6 @@
 /*
 
-Copyright (c) 2005-2016, University of Oxford.
+Copyright (c) 2005-2017, University of Oxford.
 All rights reserved.
 
 University of Oxford means the Chancellor, Masters and Scholars of the
@@ -36,72 +36,12 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef FORCEFORSCENARIO4_HPP_
 #define FORCEFORSCENARIO4_HPP_
 
-#include "ChasteSerialization.hpp"
-#include <boost/serialization/base_object.hpp>
-#include "FarhadifarForce.hpp"
-#include <iostream>
+#include "StripeLineTensionForce.hpp"
 
+/**
+ * The line tension used in scenario 4, which is that of BlanchardForce. See StripeLineTensionForce.
+ */
 template<unsigned DIM>
-class ForceForScenario4: public FarhadifarForce<DIM>
-{
-private:
-
-    double mCellBoundaryAdhesionParameter;
-    double mHomotypicLineTensionParameter;
-    double mHeterotypicLineTensionParameter;
-    double mSupercontractileLineTensionParameter;
-
-    unsigned mNumStripes;
-
-    bool mUseCombinedInterfacesForLineTension;
-    bool mUseDistinctStripeMismatchesForCombinedInterfaces;
-
-    friend class boost::serialization::access;
-    template<class Archive>
-    void serialize(Archive & archive, const unsigned int version)
-    {
-        archive & boost::serialization::base_object<FarhadifarForce<DIM> >(*this);
-        archive & mHomotypicLineTensionParameter;
-        archive & mHeterotypicLineTensionParameter;
-        archive & mSupercontractileLineTensionParameter;
-        archive & mNumStripes;
-        archive & mUseCombinedInterfacesForLineTension;
-        archive & mUseDistinctStripeMismatchesForCombinedInterfaces;
-    }
-
-    double GetCombinedInterfaceLength(Node<DIM>* pNode,
-                                      unsigned elemIndex,
-                                      unsigned cell1StripeIdentity,
-                                      unsigned cell2StripeIdentity,
-                                      VertexBasedCellPopulation<DIM>& rVertexCellPopulation);
-
-    double GetCombinedInterfaceScaleFactor(Node<DIM>* pNodeA,
-                                           Node<DIM>* pNodeB,
-                                           unsigned element1Index,
-                                           unsigned element2Index,
-                                           unsigned cell1StripeIdentity,
-                                           unsigned cell2StripeIdentity,
-                                           VertexBasedCellPopulation<DIM>& rVertexCellPopulation);
-
-public:
-
-    ForceForScenario4();
-
-    ~ForceForScenario4()
-    {}
-
-    double GetLineTensionParameter(Node<DIM>* pNodeA, Node<DIM>* pNodeB, VertexBasedCellPopulation<DIM>& rVertexCellPopulation);
-
-    void SetHomotypicLineTensionParameter(double homotypicLineTensionParameter);
-    void SetHeterotypicLineTensionParameter(double heterotypicLineTensionParameter);
-    void SetSupercontractileLineTensionParameter(double supercontractileLineTensionParameter);
-    void SetNumStripes(unsigned numStripes);
-    void SetUseCombinedInterfacesForLineTension(bool useCombinedInterfaceLineTension);
-    void SetUseDistinctStripeMismatchesForCombinedInterfaces(bool useDistinctStripeMismatchesForCombinedInterfaces);
-    void OutputForceParameters(out_stream& rParamsFile);
-};
-
-#include "SerializationExportWrapper.hpp"
-EXPORT_TEMPLATE_CLASS_SAME_DIMS(ForceForScenario4)
+using ForceForScenario4 = StripeLineTensionForce<DIM, ConstantStripeLineTension>;
 
 #endif /*FORCEFORSCENARIO4_HPP_*/
@@ -37,8 +37,12 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 template<unsigned DIM>
 LenneForce<DIM>::LenneForce()
-   : FarhadifarForce<DIM>()
+   : ParallelFarhadifarForce<DIM>()
 {
+    // By default, edges closer to the y axis than the x axis have 1.5 times the line tension
+    mOrientationTensionProfile.push_back(1.0);
+    mOrientationTensionProfile.push_back(1.5);
+    ComputeOrientationBinThresholds();
 }
 
 template<unsigned DIM>
@@ -46,19 +50,48 @@ LenneForce<DIM>::~LenneForce()
 {
 }
 
+template<unsigned DIM>
+void LenneForce<DIM>::ComputeOrientationBinThresholds()
+{
+    unsigned num_bins = mOrientationTensionProfile.size();
+    mOrientationBinThresholds.resize(num_bins - 1);
+    for (unsigned k=1; k<num_bins; k++)
+    {
+        // Use exactly 1 at pi/4, so that edges at 45 degrees are classified as in the original atan2() test
+        mOrientationBinThresholds[k-1] = (2*k == num_bins) ? 1.0 : tan(0.5*M_PI*k/num_bins);
+    }
+}
+
+template<unsigned DIM>
+double LenneForce<DIM>::GetOrientationTensionMultiplier(double absDx, double absDy)
+{
+    if (mOrientationBinThresholds.size() + 1 != mOrientationTensionProfile.size())
+    {
+        ComputeOrientationBinThresholds();
+    }
+
+    // The bin is the number of interior bin boundaries that the edge lies above
+    unsigned bin = 0;
+    for (unsigned k=0; k<mOrientationBinThresholds.size(); k++)
+    {
+        bin += (absDy > absDx*mOrientationBinThresholds[k]);
+    }
+    return mOrientationTensionProfile[bin];
+}
+
 template<unsigned DIM>
 double LenneForce<DIM>::GetLineTensionParameter(Node<DIM>* pNodeA, Node<DIM>* pNodeB, VertexBasedCellPopulation<DIM>& rVertexCellPopulation)
 {
     // Find the indices of the elements owned by each node
-    std::set<unsigned> elements_containing_nodeA = pNodeA->rGetContainingElementIndices();
-    std::set<unsigned> elements_containing_nodeB = pNodeB->rGetContainingElementIndices();
+    const std::set<unsigned>& r_elements_containing_nodeA = pNodeA->rGetContainingElementIndices();
+    const std::set<unsigned>& r_elements_containing_nodeB = pNodeB->rGetContainingElementIndices();
 
     // Find common elements
     std::set<unsigned> shared_elements;
-    std::set_intersection(elements_containing_nodeA.begin(),
-                          elements_containing_nodeA.end(),
-                          elements_containing_nodeB.begin(),
-                          elements_containing_nodeB.end(),
+    std::set_intersection(r_elements_containing_nodeA.begin(),
+                          r_elements_containing_nodeA.end(),
+                          r_elements_containing_nodeB.begin(),
+                          r_elements_containing_nodeB.end(),
                           std::inserter(shared_elements, shared_elements.begin()));
 
     // Check that the nodes have a common edge
@@ -75,23 +108,93 @@ double LenneForce<DIM>::GetLineTensionParameter(Node<DIM>* pNodeA, Node<DIM>* pN
     }
 
     // Get the vector between the two vertices
-    c_vector<double, 2> vector = pNodeB->rGetLocation() - pNodeA->rGetLocation();
-    double theta = atan2(fabs(vector(1)),fabs(vector(0)));
-    // Lengths ~0.6 to start with
-    //double line_length = sqrt(vector(0)*vector(0) + vector(1)*vector(1));
+    c_vector<double, DIM> vector = rVertexCellPopulation.rGetMesh().GetVectorFromAtoB(pNodeA->rGetLocation(), pNodeB->rGetLocation());
 
-    if ((theta > 0.25*M_PI) && (theta < 0.75*M_PI))
+    return line_tension_parameter_in_calculation*GetOrientationTensionMultiplier(fabs(vector(0)), fabs(vector(1)));
+}
+
+template<unsigned DIM>
+void LenneForce<DIM>::ComputeSlotLineTensions(VertexBasedCellPopulation<DIM>& rVertexCellPopulation)
+{
+    if (mOrientationBinThresholds.size() + 1 != mOrientationTensionProfile.size())
     {
-        line_tension_parameter_in_calculation *= 1.5;//(1.8 + (rand() % 3));
+        ComputeOrientationBinThresholds();
     }
-    return line_tension_parameter_in_calculation;
+
+    mEdgeTable.Build(rVertexCellPopulation.rGetMesh());
+    unsigned num_edges = mEdgeTable.GetNumEdges();
+    unsigned num_slots = mEdgeTable.GetNumSlots();
+    assert(num_slots == this->mGeometry.GetNumSlots());
+
+    // Gather the absolute components of the unit vector along each edge, and its base line tension
+    std::vector<double> abs_unit_x(num_edges);
+    std::vector<double> abs_unit_y(num_edges);
+    mEdgeLineTensions.resize(num_edges);
+    for (unsigned edge_index=0; edge_index<num_edges; edge_index++)
+    {
+        unsigned slot = mEdgeTable.GetEdgeSlot(edge_index, 0);
+        abs_unit_x[edge_index] = fabs(this->mGeometry.GetEdgeUnitX(slot));
+        abs_unit_y[edge_index] = fabs(this->mGeometry.GetEdgeUnitY(slot));
+
+        // Each internal edge is shared by two element slots, so each gets half the line tension parameter
+        mEdgeLineTensions[edge_index] = (mEdgeTable.GetNumElementsContainingEdge(edge_index) == 1) ?
+            this->mBoundaryLineTensionParameter : 0.5*(this->mLineTensionParameter);
+    }
+
+    // Classify the edges by orientation, one bin boundary at a time, then apply the multiplier of each edge's bin
+    std::vector<unsigned> edge_bins(num_edges, 0);
+    for (unsigned k=0; k<mOrientationBinThresholds.size(); k++)
+    {
+        double threshold = mOrientationBinThresholds[k];
+        for (unsigned edge_index=0; edge_index<num_edges; edge_index++)
+        {
+            edge_bins[edge_index] += (abs_unit_y[edge_index] > abs_unit_x[edge_index]*threshold);
+        }
+    }
+    for (unsigned edge_index=0; edge_index<num_edges; edge_index++)
+    {
+        mEdgeLineTensions[edge_index] *= mOrientationTensionProfile[edge_bins[edge_index]];
+    }
+
+    // The edge table and the geometry snapshot number the slots of the mesh in the same way
+    this->mSlotLineTensions.resize(num_slots);
+    for (unsigned slot=0; slot<num_slots; slot++)
+    {
+        this->mSlotLineTensions[slot] = mEdgeLineTensions[mEdgeTable.GetSlotEdge(slot)];
+    }
+}
+
+template<unsigned DIM>
+void LenneForce<DIM>::SetOrientationTensionProfile(const std::vector<double>& rOrientationTensionProfile)
+{
+    if (rOrientationTensionProfile.empty())
+    {
+        EXCEPTION("The orientation tension profile must have at least one bin");
+    }
+    mOrientationTensionProfile = rOrientationTensionProfile;
+    ComputeOrientationBinThresholds();
+    this->InvalidateSlotLineTensions();
+}
+
+template<unsigned DIM>
+const std::vector<double>& LenneForce<DIM>::rGetOrientationTensionProfile() const
+{
+    return mOrientationTensionProfile;
 }
 
 template<unsigned DIM>
 void LenneForce<DIM>::OutputForceParameters(out_stream& rParamsFile)
 {
-    // No further member variables are defined in this class, so call the method on the direct parent class
-    FarhadifarForce<DIM>::OutputForceParameters(rParamsFile);
+    // Output member variables
+    *rParamsFile << "\t\t\t<OrientationTensionProfile>";
+    for (unsigned i=0; i<mOrientationTensionProfile.size(); i++)
+    {
+        *rParamsFile << (i == 0 ? "" : ",") << mOrientationTensionProfile[i];
+    }
+    *rParamsFile << "</OrientationTensionProfile>\n";
+
+    // Call method on direct parent class
+    ParallelFarhadifarForce<DIM>::OutputForceParameters(rParamsFile);
 }
 
 // Explicit instantiation
@@ -38,8 +38,10 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "ChasteSerialization.hpp"
 #include <boost/serialization/base_object.hpp>
+#include <boost/serialization/vector.hpp>
 
-#include "FarhadifarForce.hpp"
+#include "ParallelFarhadifarForce.hpp"
+#include "VertexMeshEdgeTable.hpp"
 
 /**
  * A force class for use in vertex-based simulations. This force is based on the
@@ -50,14 +52,39 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * Nature Cell Biology 10(12):1401-1410.
  * doi:10.1038/ncb1798
  *
+ * The line tension of each edge is multiplied by a factor that depends on the orientation
+ * of the edge. The angle theta in [0, pi/2] between the edge and the x axis is divided into
+ * N equal bins, and the user supplies one multiplier per bin (by default two bins, with
+ * multipliers 1.0 and 1.5, so that edges closer to the y axis than the x axis have 1.5 times
+ * the line tension). Edges are classified without any trigonometric calls, by comparing |dy|
+ * with |dx|*tan(theta_k) for the interior bin boundaries theta_k.
+ *
+ * The line tension of every edge is found in a single pass over the edges once per time step,
+ * after which the force is assembled in parallel by ParallelFarhadifarForce.
+ *
  * \todo Say how this class differs from the FarhadifarForce class
  * \todo Say what each parameter and its default value is in the class
  */
 template<unsigned DIM>
-class LenneForce : public FarhadifarForce<DIM>
+class LenneForce : public ParallelFarhadifarForce<DIM>
 {
 private:
 
+    /** Line tension multiplier for each orientation bin. Defaults to {1.0, 1.5}. */
+    std::vector<double> mOrientationTensionProfile;
+
+    /**
+     * Values of tan(theta_k) at the interior boundaries theta_k = k*pi/(2N), k=1,...,N-1, of the
+     * orientation bins. Recomputed whenever the profile changes. Not archived.
+     */
+    std::vector<double> mOrientationBinThresholds;
+
+    /** Table of the unique edges of the mesh, built in each call to ComputeSlotLineTensions(). Not archived. */
+    VertexMeshEdgeTable<DIM> mEdgeTable;
+
+    /** Line tension of each edge of mEdgeTable, found in each call to ComputeSlotLineTensions(). Not archived. */
+    std::vector<double> mEdgeLineTensions;
+
     friend class boost::serialization::access;
     /**
      * Boost Serialization method for archiving/checkpointing.
@@ -69,9 +96,35 @@ private:
     template<class Archive>
     void serialize(Archive & archive, const unsigned int version)
     {
-        archive & boost::serialization::base_object<FarhadifarForce<DIM> >(*this);
+        archive & boost::serialization::base_object<ParallelFarhadifarForce<DIM> >(*this);
+        archive & mOrientationTensionProfile;
     }
 
+    /**
+     * Helper method to recompute mOrientationBinThresholds from mOrientationTensionProfile.
+     */
+    void ComputeOrientationBinThresholds();
+
+    /**
+     * @return the line tension multiplier for an edge with the given absolute components.
+     *
+     * @param absDx the absolute value of the x component of the edge
+     * @param absDy the absolute value of the y component of the edge
+     */
+    double GetOrientationTensionMultiplier(double absDx, double absDy);
+
+protected:
+
+    /**
+     * Overridden ComputeSlotLineTensions() method.
+     *
+     * Classifies every edge of the mesh by orientation in a single pass and copies the
+     * resulting line tension to each slot of the edge.
+     *
+     * @param rVertexCellPopulation reference to the cell population
+     */
+    virtual void ComputeSlotLineTensions(VertexBasedCellPopulation<DIM>& rVertexCellPopulation);
+
 public:
 
     /**
@@ -95,6 +148,19 @@ public:
      */
     virtual double GetLineTensionParameter(Node<DIM>* pNodeA, Node<DIM>* pNodeB, VertexBasedCellPopulation<DIM>& rVertexCellPopulation);
 
+    /**
+     * Set the line tension multiplier for each orientation bin. The angle between an edge and
+     * the x axis, in [0, pi/2], is divided into as many equal bins as there are multipliers.
+     *
+     * @param rOrientationTensionProfile the multiplier for each bin, starting from the x axis
+     */
+    void SetOrientationTensionProfile(const std::vector<double>& rOrientationTensionProfile);
+
+    /**
+     * @return mOrientationTensionProfile
+     */
+    const std::vector<double>& rGetOrientationTensionProfile() const;
+
     /**
      * Overridden OutputForceParameters() method.
      *
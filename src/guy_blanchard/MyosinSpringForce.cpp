@@ -34,6 +34,23 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "MyosinSpringForce.hpp"
+#include "CellLabel.hpp"
+#include "Cylindrical2dVertexMesh.hpp"
+#include "Toroidal2dVertexMesh.hpp"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*
+ * The loop over edges in ComputeEdgeForces() is written over raw arrays with no aliasing or
+ * branches, so that it can be vectorised. With OpenMP 4.0 or later we also request this explicitly.
+ */
+#if defined(_OPENMP) && (_OPENMP >= 201307)
+#define MYOSIN_SPRING_SIMD _Pragma("omp simd")
+#else
+#define MYOSIN_SPRING_SIMD
+#endif
 
 template<unsigned DIM>
 MyosinSpringForce<DIM>::MyosinSpringForce()
@@ -53,6 +70,150 @@ MyosinSpringForce<DIM>::~MyosinSpringForce()
 template<unsigned DIM>
 void MyosinSpringForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>& rCellPopulation)
 {
+    // Throw an exception message if not using a VertexBasedCellPopulation
+    if (dynamic_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation) == NULL)
+    {
+        EXCEPTION("MyosinSpringForce is to be used with a VertexBasedCellPopulation only");
+    }
+    if (DIM != 2)
+    {
+        EXCEPTION("MyosinSpringForce is only implemented in 2D");
+    }
+
+    VertexBasedCellPopulation<DIM>* p_cell_population = static_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation);
+    MutableVertexMesh<DIM,DIM>& r_mesh = p_cell_population->rGetMesh();
+
+    // The topology may have changed since the last time step, so find the unique edges afresh
+    mEdgeTable.Build(r_mesh);
+    ComputeEdgeSpringParameters(*p_cell_population);
+    ComputeEdgeVectors(r_mesh);
+    ComputeEdgeForces();
+
+    // Gather the force on each node from the edges containing it; each iteration only writes to its own node
+    int num_nodes = (int)r_mesh.GetNumNodes();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int node_index=0; node_index<num_nodes; node_index++)
+    {
+        c_vector<double, DIM> force_on_node = zero_vector<double>(DIM);
+
+        unsigned num_node_edges = mEdgeTable.GetNumNodeEdges(node_index);
+        for (unsigned i=0; i<num_node_edges; i++)
+        {
+            unsigned edge_index = mEdgeTable.GetNodeEdge(node_index, i);
+
+            // The stored force acts on the first node of the edge, and its negative on the second
+            double sign = (mEdgeTable.GetEdgeNodeIndex(edge_index, 0) == (unsigned)node_index) ? 1.0 : -1.0;
+            for (unsigned dim=0; dim<DIM; dim++)
+            {
+                force_on_node[dim] += sign*mEdgeForces[DIM*edge_index + dim];
+            }
+        }
+
+        p_cell_population->GetNode(node_index)->AddAppliedForceContribution(force_on_node);
+    }
+}
+
+template<unsigned DIM>
+void MyosinSpringForce<DIM>::ComputeEdgeSpringParameters(VertexBasedCellPopulation<DIM>& rVertexCellPopulation)
+{
+    // Look up each cell's label once, rather than once for each of its edges
+    mIsElementLabelled.assign(rVertexCellPopulation.rGetMesh().GetNumAllElements(), false);
+    for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rVertexCellPopulation.Begin();
+         cell_iter != rVertexCellPopulation.End();
+         ++cell_iter)
+    {
+        if (cell_iter->template HasCellProperty<CellLabel>())
+        {
+            mIsElementLabelled[rVertexCellPopulation.GetLocationIndexUsingCell(*cell_iter)] = true;
+        }
+    }
+
+    // Spring parameters indexed by the number of labelled cells (0, 1 or 2) on either side of the edge
+    double spring_constants[3] = {mNonMyosinSpringConstant,
+                                  sqrt(mMyosinSpringConstant*mNonMyosinSpringConstant),
+                                  mMyosinSpringConstant};
+    double rest_lengths[3] = {mNonMyosinSpringRestLength,
+                              sqrt(mMyosinSpringRestLength*mNonMyosinSpringRestLength),
+                              mMyosinSpringRestLength};
+
+    unsigned num_edges = mEdgeTable.GetNumEdges();
+    mEdgeSpringConstants.resize(num_edges);
+    mEdgeRestLengths.resize(num_edges);
+    for (unsigned edge_index=0; edge_index<num_edges; edge_index++)
+    {
+        // A boundary edge is contained in a single element, whose label counts for both sides
+        unsigned element_a = mEdgeTable.GetEdgeElementIndex(edge_index, 0);
+        unsigned element_b = (mEdgeTable.GetNumElementsContainingEdge(edge_index) > 1) ? mEdgeTable.GetEdgeElementIndex(edge_index, 1) : element_a;
+
+        unsigned spring_class = (unsigned)mIsElementLabelled[element_a] + (unsigned)mIsElementLabelled[element_b];
+        mEdgeSpringConstants[edge_index] = spring_constants[spring_class];
+        mEdgeRestLengths[edge_index] = rest_lengths[spring_class];
+    }
+}
+
+template<unsigned DIM>
+void MyosinSpringForce<DIM>::ComputeEdgeVectors(MutableVertexMesh<DIM,DIM>& rMesh)
+{
+    unsigned num_edges = mEdgeTable.GetNumEdges();
+    mEdgeVectors.resize(DIM*num_edges);
+
+    bool is_periodic = (dynamic_cast<Cylindrical2dVertexMesh*>(&rMesh) != NULL)
+                    || (dynamic_cast<Toroidal2dVertexMesh*>(&rMesh) != NULL);
+    for (unsigned edge_index=0; edge_index<num_edges; edge_index++)
+    {
+        const c_vector<double, DIM>& r_location_a = rMesh.GetNode(mEdgeTable.GetEdgeNodeIndex(edge_index, 0))->rGetLocation();
+        const c_vector<double, DIM>& r_location_b = rMesh.GetNode(mEdgeTable.GetEdgeNodeIndex(edge_index, 1))->rGetLocation();
+        if (is_periodic)
+        {
+            c_vector<double, DIM> edge_vector = rMesh.GetVectorFromAtoB(r_location_a, r_location_b);
+            for (unsigned dim=0; dim<DIM; dim++)
+            {
+                mEdgeVectors[DIM*edge_index + dim] = edge_vector[dim];
+            }
+        }
+        else
+        {
+            for (unsigned dim=0; dim<DIM; dim++)
+            {
+                mEdgeVectors[DIM*edge_index + dim] = r_location_b[dim] - r_location_a[dim];
+            }
+        }
+    }
+}
+
+template<unsigned DIM>
+void MyosinSpringForce<DIM>::ComputeEdgeForces()
+{
+    int num_edges = (int)mEdgeTable.GetNumEdges();
+    mEdgeForces.resize(DIM*num_edges);
+
+    const double* p_vectors = num_edges > 0 ? &mEdgeVectors[0] : NULL;
+    const double* p_spring_constants = num_edges > 0 ? &mEdgeSpringConstants[0] : NULL;
+    const double* p_rest_lengths = num_edges > 0 ? &mEdgeRestLengths[0] : NULL;
+    double* p_forces = num_edges > 0 ? &mEdgeForces[0] : NULL;
+
+    /*
+     * A spring of length l, rest length l0 and spring constant k pulls its first node towards
+     * its second with force k(l - l0) along the unit vector of the edge, so each component of
+     * the force is the corresponding component of the edge vector times k(l - l0)/l.
+     */
+    MYOSIN_SPRING_SIMD
+    for (int edge_index=0; edge_index<num_edges; edge_index++)
+    {
+        double length_squared = 0.0;
+        for (unsigned dim=0; dim<DIM; dim++)
+        {
+            length_squared += p_vectors[DIM*edge_index + dim]*p_vectors[DIM*edge_index + dim];
+        }
+        double length = sqrt(length_squared);
+        double coefficient = p_spring_constants[edge_index]*(length - p_rest_lengths[edge_index])/length;
+        for (unsigned dim=0; dim<DIM; dim++)
+        {
+            p_forces[DIM*edge_index + dim] = coefficient*p_vectors[DIM*edge_index + dim];
+        }
+    }
 }
 
 template<unsigned DIM>
@@ -42,9 +42,21 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "AbstractForce.hpp"
 #include "VertexBasedCellPopulation.hpp"
+#include "VertexMeshEdgeTable.hpp"
 
 #include <iostream>
-
+#include <vector>
+
+/**
+ * A force class for use in vertex-based simulations, in which each junction (edge) of the
+ * vertex mesh acts as a linear spring. A junction between two labelled cells uses the myosin
+ * spring constant and rest length; a junction between two unlabelled cells uses the non-myosin
+ * parameters; and a junction between a labelled and an unlabelled cell uses the geometric mean
+ * of the two. A boundary junction takes the parameters of the single cell containing it.
+ *
+ * The springs are evaluated over a flat list of the unique edges of the mesh, so that each
+ * junction is visited once per time step, and the resulting forces are gathered at each node.
+ */
 template<unsigned DIM>
 class MyosinSpringForce : public AbstractForce<DIM>
 {
@@ -66,10 +78,54 @@ private:
     double mNonMyosinSpringConstant;
     double mNonMyosinSpringRestLength;
 
+    /** The unique edges of the mesh, rebuilt each time step. Not archived. */
+    VertexMeshEdgeTable<DIM> mEdgeTable;
+
+    /** Whether the cell associated with each element is labelled. */
+    std::vector<bool> mIsElementLabelled;
+
+    /** The spring constant of each edge. */
+    std::vector<double> mEdgeSpringConstants;
+
+    /** The rest length of each edge. */
+    std::vector<double> mEdgeRestLengths;
+
+    /** The vector from the first to the second node of each edge, stored with stride DIM. */
+    std::vector<double> mEdgeVectors;
+
+    /** The spring force on the first node of each edge, stored with stride DIM. */
+    std::vector<double> mEdgeForces;
+
+    /**
+     * Classify each edge of mEdgeTable by the labels of the cells it separates, and store
+     * its spring constant and rest length.
+     *
+     * @param rVertexCellPopulation the cell population
+     */
+    void ComputeEdgeSpringParameters(VertexBasedCellPopulation<DIM>& rVertexCellPopulation);
+
+    /**
+     * Store the vector along each edge of mEdgeTable, accounting for periodicity if required.
+     *
+     * @param rMesh the vertex mesh
+     */
+    void ComputeEdgeVectors(MutableVertexMesh<DIM,DIM>& rMesh);
+
+    /**
+     * Evaluate the spring force along each edge in one pass over mEdgeVectors.
+     */
+    void ComputeEdgeForces();
+
 public:
 
     MyosinSpringForce();
     ~MyosinSpringForce();
+
+    /**
+     * Overridden AddForceContribution() method.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
     void AddForceContribution(AbstractCellPopulation<DIM>& rCellPopulation);
 
     double GetMyosinSpringConstant();
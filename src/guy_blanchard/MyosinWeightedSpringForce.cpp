@@ -7,8 +7,10 @@ MyosinWeightedSpringForce<ELEMENT_DIM,SPACE_DIM>::MyosinWeightedSpringForce()
      mMyosinSpringStiffness(1.0),
      mMyosinSpringNaturalLength(1.0),
      mNonMyosinSpringStiffness(1.0),
-     mNonMyosinSpringNaturalLength(1.0)
+     mNonMyosinSpringNaturalLength(1.0),
+     mUseLabelCache(false)
 {
+    UpdateSpringClassTable();
 }
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -16,6 +18,49 @@ MyosinWeightedSpringForce<ELEMENT_DIM,SPACE_DIM>::~MyosinWeightedSpringForce()
 {
 }
 
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MyosinWeightedSpringForce<ELEMENT_DIM,SPACE_DIM>::UpdateSpringClassTable()
+{
+    mSpringClassStiffnesses[0] = mNonMyosinSpringStiffness;
+    mSpringClassStiffnesses[1] = sqrt(mMyosinSpringStiffness*mNonMyosinSpringStiffness);
+    mSpringClassStiffnesses[2] = mMyosinSpringStiffness;
+
+    mSpringClassNaturalLengths[0] = mNonMyosinSpringNaturalLength;
+    mSpringClassNaturalLengths[1] = sqrt(mMyosinSpringNaturalLength*mNonMyosinSpringNaturalLength);
+    mSpringClassNaturalLengths[2] = mMyosinSpringNaturalLength;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MyosinWeightedSpringForce<ELEMENT_DIM,SPACE_DIM>::UpdateLabelCache(AbstractCellPopulation<ELEMENT_DIM,SPACE_DIM>& rCellPopulation)
+{
+    mIsLocationLabelled.assign(rCellPopulation.GetNumNodes(), false);
+
+    for (typename AbstractCellPopulation<ELEMENT_DIM,SPACE_DIM>::Iterator cell_iter = rCellPopulation.Begin();
+         cell_iter != rCellPopulation.End();
+         ++cell_iter)
+    {
+        if (cell_iter->template HasCellProperty<CellLabel>())
+        {
+            unsigned location_index = rCellPopulation.GetLocationIndexUsingCell(*cell_iter);
+            if (location_index >= mIsLocationLabelled.size())
+            {
+                mIsLocationLabelled.resize(location_index + 1, false);
+            }
+            mIsLocationLabelled[location_index] = true;
+        }
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MyosinWeightedSpringForce<ELEMENT_DIM,SPACE_DIM>::AddForceContribution(AbstractCellPopulation<ELEMENT_DIM,SPACE_DIM>& rCellPopulation)
+{
+    UpdateLabelCache(rCellPopulation);
+
+    mUseLabelCache = true;
+    AbstractTwoBodyInteractionForce<ELEMENT_DIM,SPACE_DIM>::AddForceContribution(rCellPopulation);
+    mUseLabelCache = false;
+}
+
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 c_vector<double, SPACE_DIM> MyosinWeightedSpringForce<ELEMENT_DIM,SPACE_DIM>::CalculateForceBetweenNodes(unsigned nodeAGlobalIndex,
                                                                                                          unsigned nodeBGlobalIndex,
@@ -33,26 +78,28 @@ c_vector<double, SPACE_DIM> MyosinWeightedSpringForce<ELEMENT_DIM,SPACE_DIM>::Ca
     double distance_between_nodes = norm_2(unit_difference);
     unit_difference /= distance_between_nodes;
 
-    // If neither cell is labelled, then use mMyosinSpringStiffness and mMyosinSpringNaturalLength
-    double spring_stiffness = mNonMyosinSpringStiffness;
-    double spring_rest_length = mNonMyosinSpringNaturalLength;
-
-    bool cell_A_labelled = rCellPopulation.GetCellUsingLocationIndex(nodeAGlobalIndex)->template HasCellProperty<CellLabel>();
-    bool cell_B_labelled = rCellPopulation.GetCellUsingLocationIndex(nodeBGlobalIndex)->template HasCellProperty<CellLabel>();
-
-    if (cell_A_labelled && cell_B_labelled)
+    /*
+     * The spring class is the number of labelled cells it connects: neither
+     * (non-myosin parameters), one (geometric mean) or both (myosin parameters).
+     * Outside of AddForceContribution() the labels are looked up directly.
+     */
+    bool cell_A_labelled;
+    bool cell_B_labelled;
+    if (mUseLabelCache)
     {
-        // If both cells are labelled, then use mMyosinSpringStiffness and mMyosinSpringNaturalLength
-        spring_stiffness = mMyosinSpringStiffness;
-        spring_rest_length = mMyosinSpringNaturalLength;
+        cell_A_labelled = mIsLocationLabelled[nodeAGlobalIndex];
+        cell_B_labelled = mIsLocationLabelled[nodeBGlobalIndex];
     }
-    else if (cell_A_labelled || cell_B_labelled)
+    else
     {
-        // If one cell is labelled, then use the geometric average
-        spring_stiffness = sqrt(mMyosinSpringStiffness*mNonMyosinSpringStiffness);
-        spring_rest_length = sqrt(mMyosinSpringNaturalLength*mNonMyosinSpringNaturalLength);
+        cell_A_labelled = rCellPopulation.GetCellUsingLocationIndex(nodeAGlobalIndex)->template HasCellProperty<CellLabel>();
+        cell_B_labelled = rCellPopulation.GetCellUsingLocationIndex(nodeBGlobalIndex)->template HasCellProperty<CellLabel>();
     }
 
+    unsigned spring_class = (unsigned) cell_A_labelled + (unsigned) cell_B_labelled;
+    double spring_stiffness = mSpringClassStiffnesses[spring_class];
+    double spring_rest_length = mSpringClassNaturalLengths[spring_class];
+
     return spring_stiffness * unit_difference * (distance_between_nodes - spring_rest_length);
 }
 
@@ -84,24 +131,28 @@ template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void MyosinWeightedSpringForce<ELEMENT_DIM,SPACE_DIM>::SetMyosinSpringStiffness(double myosinSpringstiffness)
 {
     mMyosinSpringStiffness = myosinSpringstiffness;
+    UpdateSpringClassTable();
 }
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void MyosinWeightedSpringForce<ELEMENT_DIM,SPACE_DIM>::SetMyosinSpringNaturalLength(double myosinSpringNaturalLength)
 {
     mMyosinSpringNaturalLength = myosinSpringNaturalLength;
+    UpdateSpringClassTable();
 }
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void MyosinWeightedSpringForce<ELEMENT_DIM,SPACE_DIM>::SetNonMyosinSpringStiffness(double nonMyosinSpringstiffness)
 {
     mNonMyosinSpringStiffness = nonMyosinSpringstiffness;
+    UpdateSpringClassTable();
 }
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void MyosinWeightedSpringForce<ELEMENT_DIM,SPACE_DIM>::SetNonMyosinSpringNaturalLength(double nonMyosinSpringNaturalLength)
 {
     mNonMyosinSpringNaturalLength = nonMyosinSpringNaturalLength;
+    UpdateSpringClassTable();
 }
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -4,6 +4,8 @@
 
 #include "AbstractTwoBodyInteractionForce.hpp"
 
+#include <vector>
+
 #include "ChasteSerialization.hpp"
 #include <boost/serialization/base_object.hpp>
 
@@ -30,8 +32,48 @@ private:
         archive & mMyosinSpringNaturalLength;
         archive & mNonMyosinSpringStiffness;
         archive & mNonMyosinSpringNaturalLength;
+
+        UpdateSpringClassTable();
     }
 
+    /**
+     * Whether the cell at each location index is labelled, filled in by
+     * AddForceContribution() at the start of each time step. Not archived.
+     */
+    std::vector<bool> mIsLocationLabelled;
+
+    /**
+     * Whether mIsLocationLabelled may be used by CalculateForceBetweenNodes(),
+     * which is only the case during a call to AddForceContribution().
+     */
+    bool mUseLabelCache;
+
+    /**
+     * The spring stiffness for each class of spring, indexed by the number of
+     * labelled cells (0, 1 or 2) the spring connects.
+     */
+    double mSpringClassStiffnesses[3];
+
+    /**
+     * The spring rest length for each class of spring, indexed as
+     * mSpringClassStiffnesses.
+     */
+    double mSpringClassNaturalLengths[3];
+
+    /**
+     * Recompute mSpringClassStiffnesses and mSpringClassNaturalLengths from the
+     * myosin and non-myosin spring parameters. Springs between a labelled and an
+     * unlabelled cell use the geometric mean of the two sets of parameters.
+     */
+    void UpdateSpringClassTable();
+
+    /**
+     * Fill in mIsLocationLabelled from the cells in the population.
+     *
+     * @param rCellPopulation the cell population
+     */
+    void UpdateLabelCache(AbstractCellPopulation<ELEMENT_DIM,SPACE_DIM>& rCellPopulation);
+
 protected:
 
     double mMyosinSpringStiffness;
@@ -44,6 +86,17 @@ public:
     MyosinWeightedSpringForce();
     virtual ~MyosinWeightedSpringForce();
 
+    /**
+     * Overridden AddForceContribution() method.
+     *
+     * Records which cells are labelled once, so that each spring evaluation
+     * reduces to two bit tests and a table lookup, then calls the method on
+     * the parent class.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    void AddForceContribution(AbstractCellPopulation<ELEMENT_DIM,SPACE_DIM>& rCellPopulation);
+
     c_vector<double, SPACE_DIM> CalculateForceBetweenNodes(unsigned nodeAGlobalIndex,
                                                            unsigned nodeBGlobalIndex,
                                                            AbstractCellPopulation<ELEMENT_DIM,SPACE_DIM>& rCellPopulation);
@@ -35,16 +35,58 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "NagaiHondaMultipleLabelsForce.hpp"
 #include "CellLabel.hpp"
+#include <boost/functional/hash.hpp>
+
+/**
+ * The per-edge loops below have no loop-carried dependencies and are written so that
+ * they can be vectorised. With OpenMP 4.0 or later we also request this explicitly.
+ */
+#if defined(_OPENMP) && (_OPENMP >= 201307)
+#define NAGAI_HONDA_SIMD _Pragma("omp simd")
+#else
+#define NAGAI_HONDA_SIMD
+#endif
+
+/** Spacing of the table of exp(-x) used when the exponential is tabulated. */
+static const double EXPONENTIAL_TABLE_SPACING = 1.0/256.0;
+
+/** Largest value of x for which exp(-x) is tabulated; exp() is called directly beyond this. */
+static const double EXPONENTIAL_TABLE_MAX_ARGUMENT = 16.0;
+
+/**
+ * @return exp(-x), by linear interpolation in a table of exp(-x) at spacing EXPONENTIAL_TABLE_SPACING
+ * if x is less than EXPONENTIAL_TABLE_MAX_ARGUMENT, and by calling exp() otherwise.
+ *
+ * @param pTable the table
+ * @param x the (non-negative) argument
+ */
+static inline double InterpolateExponential(const double* pTable, double x)
+{
+    // Linear interpolation of exp(-x) has relative error at most cosh(spacing/2) - 1, about (spacing)^2/8
+    if (x < EXPONENTIAL_TABLE_MAX_ARGUMENT)
+    {
+        double scaled_x = x/EXPONENTIAL_TABLE_SPACING;
+        unsigned bin = (unsigned)scaled_x;
+        double fraction = scaled_x - bin;
+        return pTable[bin] + fraction*(pTable[bin+1] - pTable[bin]);
+    }
+    else
+    {
+        return exp(-x);
+    }
+}
 
 template<unsigned DIM>
 NagaiHondaMultipleLabelsForce<DIM>::NagaiHondaMultipleLabelsForce()
     : NagaiHondaForce<DIM>(),
       mUseExponentialLineTension(false),
+      mUseTabulatedExponential(false),
       mCellBoundaryAdhesionParameter(1.0),
       mHomotypicCellAdhesionParameter(1.0),
       mHeterotypicCellAdhesionParameter(1.0),
       mLambdaParameter(1.0),
-      mNumLabelledColours(UNSIGNED_UNSET)
+      mNumLabelledColours(UNSIGNED_UNSET),
+      mUseCustomAdhesionParameterMatrix(false)
 {
 }
 
@@ -65,6 +107,25 @@ void NagaiHondaMultipleLabelsForce<DIM>::SetUseExponentialLineTension(bool useEx
     mUseExponentialLineTension = useExponentialLineTension;
 }
 
+template<unsigned DIM>
+bool NagaiHondaMultipleLabelsForce<DIM>::GetUseTabulatedExponential()
+{
+    return mUseTabulatedExponential;
+}
+
+template<unsigned DIM>
+void NagaiHondaMultipleLabelsForce<DIM>::SetUseTabulatedExponential(bool useTabulatedExponential)
+{
+    mUseTabulatedExponential = useTabulatedExponential;
+}
+
+template<unsigned DIM>
+double NagaiHondaMultipleLabelsForce<DIM>::GetTabulatedExponential(double x)
+{
+    BuildExponentialTable();
+    return InterpolateExponential(&mExponentialTable[0], x);
+}
+
 template<unsigned DIM>
 void NagaiHondaMultipleLabelsForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>& rCellPopulation)
 {
@@ -77,31 +138,69 @@ void NagaiHondaMultipleLabelsForce<DIM>::AddForceContribution(AbstractCellPopula
     // Define some helper variables
     VertexBasedCellPopulation<DIM>* p_cell_population = static_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation);
     unsigned num_nodes = p_cell_population->GetNumNodes();
-    unsigned num_elements = p_cell_population->GetNumElements();
 
-    // Begin by computing the area and perimeter of each element in the mesh, to avoid having to do this multiple times
-    std::vector<double> element_areas(num_elements);
-    std::vector<double> element_perimeters(num_elements);
-    std::vector<double> target_areas(num_elements);
-    for (typename VertexMesh<DIM,DIM>::VertexElementIterator elem_iter = p_cell_population->rGetMesh().GetElementIteratorBegin();
-         elem_iter != p_cell_population->rGetMesh().GetElementIteratorEnd();
-         ++elem_iter)
+    // The geometry snapshot is only implemented in 2D, so use the gradient methods of the mesh otherwise
+    if (DIM != 2)
     {
-        unsigned elem_index = elem_iter->GetIndex();
-        element_areas[elem_index] = p_cell_population->rGetMesh().GetVolumeOfElement(elem_index);
-        element_perimeters[elem_index] = p_cell_population->rGetMesh().GetSurfaceAreaOfElement(elem_index);
-        try
+        AddForceContributionUsingMeshGradients(*p_cell_population);
+        return;
+    }
+
+    // Begin by computing the target area, area and perimeter of each element, and the edge and area gradients at each node
+    ComputeElementGeometry(*p_cell_population);
+
+    double deformation_energy_parameter = this->GetNagaiHondaDeformationEnergyParameter();
+    double membrane_surface_energy_parameter = this->GetNagaiHondaMembraneSurfaceEnergyParameter();
+
+    /*
+     * Suppose we have an adhesion energy term U_A that is the sum over edges (i,j) of
+     * contributions
+     *
+     * gamma_ij * (1 - exp(-lambda * l_ij)),
+     *
+     * where l_ij is the length of edge (i,j) and gamma_ij and lambda are parameters.
+     * In this case, the force associated with U_A on vertex k is given by the sum over
+     * edges (k,j) containing vertex k of contributions
+     *
+     * lambda * gamma_kj * exp(-lambda * l_ij) * grad(l_kj),
+     *
+     * where grad(l_kj) = (r_k - r_j)/l_kj is the gradient of l_ij and r_k, r_j denote
+     * the position vectors of vertices k and j, respectively.
+     *
+     * The adhesion parameter and exponential factor of each edge are computed once here, and
+     * the adhesion coefficient of each element slot (the edge from its node to the next node of
+     * the element) is then gathered from its edge, rather than computed once for each of the
+     * two nodes at its ends.
+     */
+    UpdateLabelColourCache(*p_cell_population);
+    mEdgeTable.Build(p_cell_population->rGetMesh());
+    ComputeEdgeAdhesionParameters(*p_cell_population);
+
+    assert(mEdgeTable.GetNumSlots() == mGeometry.GetNumSlots());
+    mSlotAdhesionCoefficients.resize(mGeometry.GetNumSlots());
+    if (mUseExponentialLineTension)
+    {
+        ComputeEdgeExponentialFactors();
+        for (unsigned slot=0; slot<mGeometry.GetNumSlots(); slot++)
         {
-            target_areas[elem_index] = p_cell_population->GetCellUsingLocationIndex(elem_index)->GetCellData()->GetItem("target area");
+            unsigned edge_index = mEdgeTable.GetSlotEdge(slot);
+            mSlotAdhesionCoefficients[slot] = mEdgeAdhesionParameters[edge_index]*mEdgeExponentialFactors[edge_index];
         }
-        catch (Exception&)
+    }
+    else
+    {
+        for (unsigned slot=0; slot<mGeometry.GetNumSlots(); slot++)
         {
-            EXCEPTION("You need to add an AbstractTargetAreaModifier to the simulation in order to use NagaiHondaMultipleLabelsForce");
+            mSlotAdhesionCoefficients[slot] = mEdgeAdhesionParameters[mEdgeTable.GetSlotEdge(slot)];
         }
     }
 
-    // Compute the force contribution on each vertex arising from the cell deformation energy
-    // (target area) and membrane surface tension energy (perimeter contractility)
+    /*
+     * In what follows, each (node, element) pair is an element slot of mGeometry. The gradients
+     * of the previous and next edges of the element at the node are the unit vector along the
+     * previous edge and minus the unit vector along the next edge, so every term is computed
+     * from a single traversal of the slots of each node.
+     */
     for (unsigned node_index=0; node_index<num_nodes; node_index++)
     {
         /*
@@ -118,138 +217,482 @@ void NagaiHondaMultipleLabelsForce<DIM>::AddForceContribution(AbstractCellPopula
          */
         c_vector<double, DIM> deformation_contribution = zero_vector<double>(DIM);
         c_vector<double, DIM> membrane_surface_tension_contribution = zero_vector<double>(DIM);
+        c_vector<double, DIM> adhesion_contribution = zero_vector<double>(DIM);
 
-        // Find the indices of the elements owned by this node
-        std::set<unsigned> containing_elem_indices = p_cell_population->GetNode(node_index)->rGetContainingElementIndices();
-
-        // Iterate over these elements
-        for (std::set<unsigned>::iterator iter = containing_elem_indices.begin();
-             iter != containing_elem_indices.end();
-             ++iter)
+        // Iterate over the elements containing this node
+        for (unsigned i=0; i<mGeometry.GetNumNodeSlots(node_index); i++)
         {
-            // Get this element, its index and its number of nodes
-            VertexElement<DIM, DIM>* p_element = p_cell_population->GetElement(*iter);
-            unsigned elem_index = p_element->GetIndex();
-            unsigned num_nodes_elem = p_element->GetNumNodes();
+            unsigned slot = mGeometry.GetNodeSlot(node_index, i);
+            unsigned previous_slot = mGeometry.GetPreviousSlot(slot);
+            unsigned elem_index = mGeometry.GetSlotElement(slot);
 
-            // Find the local index of this node in this element
-            unsigned local_index = p_element->GetNodeLocalIndex(node_index);
+            double previous_edge_unit_x = mGeometry.GetEdgeUnitX(previous_slot);
+            double previous_edge_unit_y = mGeometry.GetEdgeUnitY(previous_slot);
+            double next_edge_unit_x = mGeometry.GetEdgeUnitX(slot);
+            double next_edge_unit_y = mGeometry.GetEdgeUnitY(slot);
 
             // Add the force contribution from this cell's deformation energy (note the minus sign)
-            c_vector<double, DIM> element_area_gradient = p_cell_population->rGetMesh().GetAreaGradientOfElementAtNode(p_element, local_index);
-            deformation_contribution -= 2*this->GetNagaiHondaDeformationEnergyParameter()*(element_areas[elem_index] - target_areas[elem_index])*element_area_gradient;
-
-            // Get the previous and next nodes in this element
-            unsigned previous_node_local_index = (num_nodes_elem+local_index-1)%num_nodes_elem;
-
-            // Compute the gradient of each these edges, computed at the present node
-            c_vector<double, DIM> previous_edge_gradient = -p_cell_population->rGetMesh().GetNextEdgeGradientOfElementAtNode(p_element, previous_node_local_index);
-            c_vector<double, DIM> next_edge_gradient = p_cell_population->rGetMesh().GetNextEdgeGradientOfElementAtNode(p_element, local_index);
+            double deformation_coefficient = 2*deformation_energy_parameter*(mGeometry.GetElementArea(elem_index) - mTargetAreas[elem_index]);
+            deformation_contribution[0] -= deformation_coefficient*mGeometry.GetAreaGradientX(slot);
+            if (DIM > 1)
+            {
+                deformation_contribution[1] -= deformation_coefficient*mGeometry.GetAreaGradientY(slot);
+            }
 
             // Add the force contribution from this cell's membrane surface tension (note the minus sign)
-            c_vector<double, DIM> element_perimeter_gradient = previous_edge_gradient + next_edge_gradient;
-            double cell_target_perimeter = 2*sqrt(M_PI*target_areas[elem_index]);
-            membrane_surface_tension_contribution -= 2*this->GetNagaiHondaMembraneSurfaceEnergyParameter()*(element_perimeters[elem_index] - cell_target_perimeter)*element_perimeter_gradient;
+            double cell_target_perimeter = 2*sqrt(M_PI*mTargetAreas[elem_index]);
+            double membrane_coefficient = 2*membrane_surface_energy_parameter*(mGeometry.GetElementPerimeter(elem_index) - cell_target_perimeter);
+            membrane_surface_tension_contribution[0] -= membrane_coefficient*(previous_edge_unit_x - next_edge_unit_x);
+            if (DIM > 1)
+            {
+                membrane_surface_tension_contribution[1] -= membrane_coefficient*(previous_edge_unit_y - next_edge_unit_y);
+            }
+
+            // Add the force contribution from cell-cell and cell-boundary adhesion (note the minus sign)
+            double previous_edge_adhesion_parameter = mSlotAdhesionCoefficients[previous_slot];
+            double next_edge_adhesion_parameter = mSlotAdhesionCoefficients[slot];
+            adhesion_contribution[0] -= previous_edge_adhesion_parameter*previous_edge_unit_x - next_edge_adhesion_parameter*next_edge_unit_x;
+            if (DIM > 1)
+            {
+                adhesion_contribution[1] -= previous_edge_adhesion_parameter*previous_edge_unit_y - next_edge_adhesion_parameter*next_edge_unit_y;
+            }
         }
 
-        c_vector<double, DIM> force_on_node = deformation_contribution + membrane_surface_tension_contribution;
+        c_vector<double, DIM> force_on_node = deformation_contribution + membrane_surface_tension_contribution + adhesion_contribution;
         p_cell_population->GetNode(node_index)->AddAppliedForceContribution(force_on_node);
     }
+}
+
+template<unsigned DIM>
+void NagaiHondaMultipleLabelsForce<DIM>::AddForceContributionUsingMeshGradients(VertexBasedCellPopulation<DIM>& rVertexCellPopulation)
+{
+    MutableVertexMesh<DIM,DIM>& r_mesh = rVertexCellPopulation.rGetMesh();
+    unsigned num_nodes = rVertexCellPopulation.GetNumNodes();
+
+    // Begin by computing the area, perimeter and target area of each element in the mesh, to avoid having to do this multiple times
+    ComputeTargetAreas(rVertexCellPopulation);
+    std::vector<double> element_areas(r_mesh.GetNumAllElements());
+    std::vector<double> element_perimeters(r_mesh.GetNumAllElements());
+    for (typename VertexMesh<DIM,DIM>::VertexElementIterator elem_iter = r_mesh.GetElementIteratorBegin();
+         elem_iter != r_mesh.GetElementIteratorEnd();
+         ++elem_iter)
+    {
+        unsigned elem_index = elem_iter->GetIndex();
+        element_areas[elem_index] = r_mesh.GetVolumeOfElement(elem_index);
+        element_perimeters[elem_index] = r_mesh.GetSurfaceAreaOfElement(elem_index);
+    }
+
+    UpdateLabelColourCache(rVertexCellPopulation);
 
-    // Compute the force contribution on each vertex arising from the adhesion energy (line tension)
     for (unsigned node_index=0; node_index<num_nodes; node_index++)
     {
-        Node<DIM>* p_this_node = p_cell_population->GetNode(node_index);
+        Node<DIM>* p_this_node = rVertexCellPopulation.GetNode(node_index);
 
+        c_vector<double, DIM> deformation_contribution = zero_vector<double>(DIM);
+        c_vector<double, DIM> membrane_surface_tension_contribution = zero_vector<double>(DIM);
         c_vector<double, DIM> adhesion_contribution = zero_vector<double>(DIM);
 
-        // Find the indices of the elements owned by this node
-        std::set<unsigned> containing_elem_indices = p_cell_population->GetNode(node_index)->rGetContainingElementIndices();
-
-        // Iterate over these elements
-        for (std::set<unsigned>::iterator iter = containing_elem_indices.begin();
-             iter != containing_elem_indices.end();
+        // Iterate over the elements containing this node
+        const std::set<unsigned>& r_containing_elem_indices = p_this_node->rGetContainingElementIndices();
+        for (std::set<unsigned>::const_iterator iter = r_containing_elem_indices.begin();
+             iter != r_containing_elem_indices.end();
              ++iter)
         {
-            // Get this element, its index and its number of nodes
-            VertexElement<DIM, DIM>* p_element = p_cell_population->GetElement(*iter);
+            VertexElement<DIM, DIM>* p_element = rVertexCellPopulation.GetElement(*iter);
+            unsigned elem_index = p_element->GetIndex();
             unsigned num_nodes_elem = p_element->GetNumNodes();
-
-            // Find the local index of this node in this element
             unsigned local_index = p_element->GetNodeLocalIndex(node_index);
-
-            // Get the previous and next nodes in this element
             unsigned previous_node_local_index = (num_nodes_elem+local_index-1)%num_nodes_elem;
-            Node<DIM>* p_previous_node = p_element->GetNode(previous_node_local_index);
-
             unsigned next_node_local_index = (local_index+1)%num_nodes_elem;
+            Node<DIM>* p_previous_node = p_element->GetNode(previous_node_local_index);
             Node<DIM>* p_next_node = p_element->GetNode(next_node_local_index);
 
-            // Compute the adhesion parameter for each of these edges
-            double previous_edge_adhesion_parameter = GetAdhesionParameter(p_previous_node, p_this_node, *p_cell_population);
-            double next_edge_adhesion_parameter = GetAdhesionParameter(p_this_node, p_next_node, *p_cell_population);
-
-            // Compute the gradient of each these edges, computed at the present node
-            c_vector<double, DIM> previous_edge_gradient = -p_cell_population->rGetMesh().GetNextEdgeGradientOfElementAtNode(p_element, previous_node_local_index);
-            c_vector<double, DIM> next_edge_gradient = p_cell_population->rGetMesh().GetNextEdgeGradientOfElementAtNode(p_element, local_index);
-
-            /*
-             * Suppose we have an adhesion energy term U_A that is the sum over edges (i,j) of
-             * contributions
-             *
-             * gamma_ij * (1 - exp(-lambda * l_ij)),
-             *
-             * where l_ij is the length of edge (i,j) and gamma_ij and lambda are parameters.
-             * In this case, the force associated with U_A on vertex k is given by the sum over
-             * edges (k,j) containing vertex k of contributions
-             *
-             * lambda * gamma_kj * exp(-lambda * l_ij) * grad(l_kj),
-             *
-             * where grad(l_kj) = (r_k - r_j)/l_kj is the gradient of l_ij and r_k, r_j denote
-             * the position vectors of vertices k and j, respectively.
-             */
+            // Add the force contribution from this cell's deformation energy (note the minus sign)
+            c_vector<double, DIM> element_area_gradient = r_mesh.GetAreaGradientOfElementAtNode(p_element, local_index);
+            deformation_contribution -= 2*this->GetNagaiHondaDeformationEnergyParameter()*(element_areas[elem_index] - mTargetAreas[elem_index])*element_area_gradient;
+
+            // Compute the gradient of the previous and next edges, computed at the present node
+            c_vector<double, DIM> previous_edge_gradient = -r_mesh.GetNextEdgeGradientOfElementAtNode(p_element, previous_node_local_index);
+            c_vector<double, DIM> next_edge_gradient = r_mesh.GetNextEdgeGradientOfElementAtNode(p_element, local_index);
+
+            // Add the force contribution from this cell's membrane surface tension (note the minus sign)
+            double cell_target_perimeter = 2*sqrt(M_PI*mTargetAreas[elem_index]);
+            membrane_surface_tension_contribution -= 2*this->GetNagaiHondaMembraneSurfaceEnergyParameter()*(element_perimeters[elem_index] - cell_target_perimeter)*(previous_edge_gradient + next_edge_gradient);
 
             // Add the force contribution from cell-cell and cell-boundary adhesion (note the minus sign)
+            double previous_edge_adhesion_parameter = GetAdhesionParameter(p_previous_node, p_this_node, rVertexCellPopulation);
+            double next_edge_adhesion_parameter = GetAdhesionParameter(p_this_node, p_next_node, rVertexCellPopulation);
+            if (mUseExponentialLineTension)
+            {
+                double previous_edge_length = r_mesh.GetDistanceBetweenNodes(p_previous_node->GetIndex(), node_index);
+                double next_edge_length = r_mesh.GetDistanceBetweenNodes(node_index, p_next_node->GetIndex());
+                previous_edge_adhesion_parameter *= mLambdaParameter*exp(-mLambdaParameter*previous_edge_length);
+                next_edge_adhesion_parameter *= mLambdaParameter*exp(-mLambdaParameter*next_edge_length);
+            }
+            adhesion_contribution -= previous_edge_adhesion_parameter*previous_edge_gradient + next_edge_adhesion_parameter*next_edge_gradient;
+        }
+
+        c_vector<double, DIM> force_on_node = deformation_contribution + membrane_surface_tension_contribution + adhesion_contribution;
+        p_this_node->AddAppliedForceContribution(force_on_node);
+    }
+}
+
+template<unsigned DIM>
+void NagaiHondaMultipleLabelsForce<DIM>::ComputeTargetAreas(VertexBasedCellPopulation<DIM>& rVertexCellPopulation)
+{
+    mTargetAreas.assign(rVertexCellPopulation.rGetMesh().GetNumAllElements(), 0.0);
+    for (typename VertexMesh<DIM,DIM>::VertexElementIterator elem_iter = rVertexCellPopulation.rGetMesh().GetElementIteratorBegin();
+         elem_iter != rVertexCellPopulation.rGetMesh().GetElementIteratorEnd();
+         ++elem_iter)
+    {
+        unsigned elem_index = elem_iter->GetIndex();
+        try
+        {
+            mTargetAreas[elem_index] = rVertexCellPopulation.GetCellUsingLocationIndex(elem_index)->GetCellData()->GetItem("target area");
+        }
+        catch (Exception&)
+        {
+            EXCEPTION("You need to add an AbstractTargetAreaModifier to the simulation in order to use NagaiHondaMultipleLabelsForce");
+        }
+    }
+}
+
+template<unsigned DIM>
+void NagaiHondaMultipleLabelsForce<DIM>::ComputeElementGeometry(VertexBasedCellPopulation<DIM>& rVertexCellPopulation)
+{
+    ComputeTargetAreas(rVertexCellPopulation);
+
+    // Compute the area and perimeter of each element, and the edge and area gradients at each node, in bulk
+    mGeometry.Build(rVertexCellPopulation.rGetMesh());
+}
+
+template<unsigned DIM>
+double NagaiHondaMultipleLabelsForce<DIM>::ComputeTotalEnergy(AbstractCellPopulation<DIM>& rCellPopulation)
+{
+    // Throw an exception message if not using a VertexBasedCellPopulation
+    if (dynamic_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation) == NULL)
+    {
+        EXCEPTION("NagaiHondaMultipleLabelsForce is to be used with a VertexBasedCellPopulation only");
+    }
+    VertexBasedCellPopulation<DIM>* p_cell_population = static_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation);
+
+    // The geometry snapshot is only implemented in 2D, so use the geometry methods of the mesh otherwise
+    if (DIM != 2)
+    {
+        return ComputeTotalEnergyUsingMeshGeometry(*p_cell_population);
+    }
+
+    // Reuse the geometry snapshot and edge table from the last assembly unless the mesh has changed since
+    ComputeTargetAreas(*p_cell_population);
+    if (!mGeometry.IsCurrent(p_cell_population->rGetMesh()))
+    {
+        mGeometry.Build(p_cell_population->rGetMesh());
+        mEdgeTable.Build(p_cell_population->rGetMesh());
+    }
+    assert(mEdgeTable.GetNumSlots() == mGeometry.GetNumSlots());
+
+    UpdateLabelColourCache(*p_cell_population);
+    ComputeEdgeAdhesionParameters(*p_cell_population);
+
+    double deformation_energy_parameter = this->GetNagaiHondaDeformationEnergyParameter();
+    double membrane_surface_energy_parameter = this->GetNagaiHondaMembraneSurfaceEnergyParameter();
+
+    double total_energy = 0.0;
+    for (typename VertexMesh<DIM,DIM>::VertexElementIterator elem_iter = p_cell_population->rGetMesh().GetElementIteratorBegin();
+         elem_iter != p_cell_population->rGetMesh().GetElementIteratorEnd();
+         ++elem_iter)
+    {
+        unsigned elem_index = elem_iter->GetIndex();
+
+        // Cell deformation and membrane surface tension energies
+        double area_difference = mGeometry.GetElementArea(elem_index) - mTargetAreas[elem_index];
+        double perimeter_difference = mGeometry.GetElementPerimeter(elem_index) - 2*sqrt(M_PI*mTargetAreas[elem_index]);
+        total_energy += deformation_energy_parameter*area_difference*area_difference
+                      + membrane_surface_energy_parameter*perimeter_difference*perimeter_difference;
+
+        // Adhesion energy of each edge of this cell
+        unsigned slot_offset = mGeometry.GetElementSlotOffset(elem_index);
+        unsigned num_slots = mGeometry.GetNumElementSlots(elem_index);
+        for (unsigned local_index=0; local_index<num_slots; local_index++)
+        {
+            double adhesion_parameter = mEdgeAdhesionParameters[mEdgeTable.GetSlotEdge(slot_offset + local_index)];
+            double edge_length = mGeometry.GetEdgeLength(slot_offset + local_index);
+
             if (mUseExponentialLineTension)
             {
-                double previous_edge_length = p_cell_population->rGetMesh().GetDistanceBetweenNodes(p_previous_node->GetIndex(), p_this_node->GetIndex());
-                double next_edge_length = p_cell_population->rGetMesh().GetDistanceBetweenNodes(p_this_node->GetIndex(), p_next_node->GetIndex());
-                adhesion_contribution -=   previous_edge_adhesion_parameter*mLambdaParameter*exp(-mLambdaParameter*previous_edge_length)*previous_edge_gradient
-                                         + next_edge_adhesion_parameter*mLambdaParameter*exp(-mLambdaParameter*next_edge_length)*next_edge_gradient;
+                total_energy += adhesion_parameter*(1.0 - exp(-mLambdaParameter*edge_length));
             }
             else
             {
-                adhesion_contribution -= previous_edge_adhesion_parameter*previous_edge_gradient + next_edge_adhesion_parameter*next_edge_gradient;
+                total_energy += adhesion_parameter*edge_length;
             }
         }
+    }
+    return total_energy;
+}
 
-        c_vector<double, DIM> force_on_node = adhesion_contribution;
-        p_cell_population->GetNode(node_index)->AddAppliedForceContribution(force_on_node);
+template<unsigned DIM>
+double NagaiHondaMultipleLabelsForce<DIM>::ComputeTotalEnergyUsingMeshGeometry(VertexBasedCellPopulation<DIM>& rVertexCellPopulation)
+{
+    MutableVertexMesh<DIM,DIM>& r_mesh = rVertexCellPopulation.rGetMesh();
+    ComputeTargetAreas(rVertexCellPopulation);
+    UpdateLabelColourCache(rVertexCellPopulation);
+
+    double deformation_energy_parameter = this->GetNagaiHondaDeformationEnergyParameter();
+    double membrane_surface_energy_parameter = this->GetNagaiHondaMembraneSurfaceEnergyParameter();
+
+    double total_energy = 0.0;
+    for (typename VertexMesh<DIM,DIM>::VertexElementIterator elem_iter = r_mesh.GetElementIteratorBegin();
+         elem_iter != r_mesh.GetElementIteratorEnd();
+         ++elem_iter)
+    {
+        unsigned elem_index = elem_iter->GetIndex();
+
+        // Cell deformation and membrane surface tension energies
+        double area_difference = r_mesh.GetVolumeOfElement(elem_index) - mTargetAreas[elem_index];
+        double perimeter_difference = r_mesh.GetSurfaceAreaOfElement(elem_index) - 2*sqrt(M_PI*mTargetAreas[elem_index]);
+        total_energy += deformation_energy_parameter*area_difference*area_difference
+                      + membrane_surface_energy_parameter*perimeter_difference*perimeter_difference;
+
+        // Adhesion energy of each edge of this cell
+        unsigned num_nodes_elem = elem_iter->GetNumNodes();
+        for (unsigned local_index=0; local_index<num_nodes_elem; local_index++)
+        {
+            Node<DIM>* p_node = elem_iter->GetNode(local_index);
+            Node<DIM>* p_next_node = elem_iter->GetNode((local_index+1)%num_nodes_elem);
+            double adhesion_parameter = GetAdhesionParameter(p_node, p_next_node, rVertexCellPopulation);
+            double edge_length = r_mesh.GetDistanceBetweenNodes(p_node->GetIndex(), p_next_node->GetIndex());
+
+            if (mUseExponentialLineTension)
+            {
+                total_energy += adhesion_parameter*(1.0 - exp(-mLambdaParameter*edge_length));
+            }
+            else
+            {
+                total_energy += adhesion_parameter*edge_length;
+            }
+        }
     }
+    return total_energy;
 }
 
 template<unsigned DIM>
-unsigned NagaiHondaMultipleLabelsForce<DIM>::GetDifferenceInLabelsAcrossEdge(Node<DIM>* pNodeA,
-                                                                             Node<DIM>* pNodeB,
-                                                                             VertexBasedCellPopulation<DIM>& rVertexCellPopulation)
+void NagaiHondaMultipleLabelsForce<DIM>::UpdateLabelColourCache(VertexBasedCellPopulation<DIM>& rVertexCellPopulation)
 {
     ///\todo For simplicity, we assume that every cell in the population has SOME cell label
 
-    // If this is the first time we have called GetAdhesionParameter() in the simulation...
+    // If this is the first time we have needed the label colours in the simulation...
     if (mNumLabelledColours == UNSIGNED_UNSET)
     {
         // ...then compute the number of different cell label colours present, and store this in mNumLabelledColours
         ComputeNumLabelledColours(rVertexCellPopulation);
     }
 
+    MutableVertexMesh<DIM,DIM>& r_mesh = rVertexCellPopulation.rGetMesh();
+    unsigned num_all_elements = r_mesh.GetNumAllElements();
+
+    // Check whether the cell associated with any element, or its label, has changed since the cache was last refreshed
+    bool cache_is_valid = (mElementCells.size() == num_all_elements);
+    for (typename VertexMesh<DIM,DIM>::VertexElementIterator elem_iter = r_mesh.GetElementIteratorBegin();
+         cache_is_valid && (elem_iter != r_mesh.GetElementIteratorEnd());
+         ++elem_iter)
+    {
+        unsigned elem_index = elem_iter->GetIndex();
+        CellPtr p_cell = rVertexCellPopulation.GetCellUsingLocationIndex(elem_index);
+        cache_is_valid = (mElementCells[elem_index] == p_cell.get())
+                      && (mElementPropertySignatures[elem_index] == GetCellPropertySignature(p_cell));
+    }
+
+    if (!cache_is_valid)
+    {
+        mElementCells.assign(num_all_elements, NULL);
+        mElementPropertySignatures.assign(num_all_elements, 0);
+        mElementColourIndices.assign(num_all_elements, UNSIGNED_UNSET);
+        for (typename VertexMesh<DIM,DIM>::VertexElementIterator elem_iter = r_mesh.GetElementIteratorBegin();
+             elem_iter != r_mesh.GetElementIteratorEnd();
+             ++elem_iter)
+        {
+            unsigned elem_index = elem_iter->GetIndex();
+            CellPtr p_cell = rVertexCellPopulation.GetCellUsingLocationIndex(elem_index);
+            mElementCells[elem_index] = p_cell.get();
+            mElementPropertySignatures[elem_index] = GetCellPropertySignature(p_cell);
+
+            if (p_cell->template HasCellProperty<CellLabel>())
+            {
+                CellPropertyCollection collection = p_cell->rGetCellPropertyCollection().template GetProperties<CellLabel>();
+                boost::shared_ptr<CellLabel> p_label = boost::static_pointer_cast<CellLabel>(collection.GetProperty());
+                mElementColourIndices[elem_index] = p_label->GetColour()%mNumLabelledColours;
+            }
+        }
+    }
+
+    if (mUseCustomAdhesionParameterMatrix)
+    {
+        if (mAdhesionParameterMatrix.size() != mNumLabelledColours*mNumLabelledColours)
+        {
+            EXCEPTION("The adhesion parameter matrix must have one row for each of the " << mNumLabelledColours << " label colours present");
+        }
+    }
+    else
+    {
+        // Recompute the default table, in case the homotypic or heterotypic adhesion parameters have changed
+        mAdhesionParameterMatrix.resize(mNumLabelledColours*mNumLabelledColours);
+        for (unsigned i=0; i<mNumLabelledColours; i++)
+        {
+            for (unsigned j=0; j<mNumLabelledColours; j++)
+            {
+                unsigned difference_in_labels = (i > j) ? (i - j) : (j - i);
+                if (difference_in_labels == 0)
+                {
+                    // In this case, the cells sharing this edge have the same label colour
+                    mAdhesionParameterMatrix[i*mNumLabelledColours + j] = this->GetHomotypicCellAdhesionParameter();
+                }
+                else
+                {
+                    // In this case, the cells sharing this edge have different label colours, so we use
+                    // mHeterotypicCellAdhesionParameter scaled by a multiplier defined by the difference
+                    // in label colours
+                    double energy_parameter_multiplier = (double)(difference_in_labels); // 26 SEP 2015 // 1.0;
+
+                    // Label numbers wrap around, so check to find smallest difference
+                    if (energy_parameter_multiplier > mNumLabelledColours/2)
+                    {
+                        energy_parameter_multiplier = mNumLabelledColours - energy_parameter_multiplier;
+                    }
+
+                    mAdhesionParameterMatrix[i*mNumLabelledColours + j] = this->GetHeterotypicCellAdhesionParameter() * energy_parameter_multiplier;
+                }
+            }
+        }
+    }
+}
+
+template<unsigned DIM>
+std::size_t NagaiHondaMultipleLabelsForce<DIM>::GetCellPropertySignature(CellPtr pCell)
+{
+    /*
+     * A CellLabel's colour cannot be changed once it is constructed, so the label of a cell can
+     * only change by adding or removing a property. Combining the addresses of the properties in
+     * the collection detects this without a dynamic cast for each property.
+     */
+    CellPropertyCollection& r_collection = pCell->rGetCellPropertyCollection();
+    std::size_t signature = r_collection.GetSize();
+    for (CellPropertyCollection::Iterator iter = r_collection.Begin(); iter != r_collection.End(); ++iter)
+    {
+        boost::hash_combine(signature, iter->get());
+    }
+    return signature;
+}
+
+template<unsigned DIM>
+void NagaiHondaMultipleLabelsForce<DIM>::ComputeEdgeAdhesionParameters(VertexBasedCellPopulation<DIM>& rVertexCellPopulation)
+{
+    mEdgeAdhesionParameters.resize(mEdgeTable.GetNumEdges());
+    for (unsigned edge_index=0; edge_index<mEdgeTable.GetNumEdges(); edge_index++)
+    {
+        unsigned num_elements = mEdgeTable.GetNumElementsContainingEdge(edge_index);
+        unsigned element_a = mEdgeTable.GetEdgeElementIndex(edge_index, 0);
+        unsigned element_b = (num_elements > 1) ? mEdgeTable.GetEdgeElementIndex(edge_index, 1) : element_a;
+        bool is_boundary_edge = rVertexCellPopulation.GetNode(mEdgeTable.GetEdgeNodeIndex(edge_index, 0))->IsBoundaryNode()
+                             || rVertexCellPopulation.GetNode(mEdgeTable.GetEdgeNodeIndex(edge_index, 1))->IsBoundaryNode();
+
+        mEdgeAdhesionParameters[edge_index] = GetAdhesionParameterForElements(num_elements, element_a, element_b, is_boundary_edge);
+    }
+}
+
+template<unsigned DIM>
+double NagaiHondaMultipleLabelsForce<DIM>::GetAdhesionParameterForElements(unsigned numElements,
+                                                                           unsigned elementA,
+                                                                           unsigned elementB,
+                                                                           bool isBoundaryEdge)
+{
+    // If the edge belongs to a single element, or either node is on the boundary, then the edge is on the boundary
+    if ((numElements == 1) || isBoundaryEdge)
+    {
+        return this->GetCellBoundaryAdhesionParameter();
+    }
+
+    unsigned colour_index_a = mElementColourIndices[elementA];
+    unsigned colour_index_b = mElementColourIndices[elementB];
+    assert(colour_index_a != UNSIGNED_UNSET);
+    assert(colour_index_b != UNSIGNED_UNSET);
+
+    return mAdhesionParameterMatrix[colour_index_a*mNumLabelledColours + colour_index_b];
+}
+
+template<unsigned DIM>
+void NagaiHondaMultipleLabelsForce<DIM>::ComputeEdgeExponentialFactors()
+{
+    unsigned num_edges = mEdgeTable.GetNumEdges();
+    mEdgeExponentialFactors.resize(num_edges);
+    if (num_edges == 0)
+    {
+        return;
+    }
+
+    // Gather the length of each edge from the first of its slots
+    for (unsigned edge_index=0; edge_index<num_edges; edge_index++)
+    {
+        mEdgeExponentialFactors[edge_index] = mGeometry.GetEdgeLength(mEdgeTable.GetEdgeSlot(edge_index, 0));
+    }
+
+    double lambda = mLambdaParameter;
+    double* p_factor = &mEdgeExponentialFactors[0];
+
+    if (mUseTabulatedExponential)
+    {
+        BuildExponentialTable();
+        const double* p_table = &mExponentialTable[0];
+
+        NAGAI_HONDA_SIMD
+        for (unsigned edge_index=0; edge_index<num_edges; edge_index++)
+        {
+            p_factor[edge_index] = lambda*InterpolateExponential(p_table, lambda*p_factor[edge_index]);
+        }
+    }
+    else
+    {
+        NAGAI_HONDA_SIMD
+        for (unsigned edge_index=0; edge_index<num_edges; edge_index++)
+        {
+            p_factor[edge_index] = lambda*exp(-lambda*p_factor[edge_index]);
+        }
+    }
+}
+
+template<unsigned DIM>
+void NagaiHondaMultipleLabelsForce<DIM>::BuildExponentialTable()
+{
+    if (mExponentialTable.empty())
+    {
+        unsigned table_size = (unsigned)(EXPONENTIAL_TABLE_MAX_ARGUMENT/EXPONENTIAL_TABLE_SPACING) + 2;
+        mExponentialTable.resize(table_size);
+        for (unsigned i=0; i<table_size; i++)
+        {
+            mExponentialTable[i] = exp(-(i*EXPONENTIAL_TABLE_SPACING));
+        }
+    }
+}
+
+template<unsigned DIM>
+unsigned NagaiHondaMultipleLabelsForce<DIM>::GetDifferenceInLabelsAcrossEdge(Node<DIM>* pNodeA,
+                                                                             Node<DIM>* pNodeB,
+                                                                             VertexBasedCellPopulation<DIM>& rVertexCellPopulation)
+{
+    // Only refresh the colour cache if it has never been built for this mesh; it is checked fully in each call to AddForceContribution()
+    if (mElementColourIndices.size() != rVertexCellPopulation.rGetMesh().GetNumAllElements())
+    {
+        UpdateLabelColourCache(rVertexCellPopulation);
+    }
+
     // Find the indices of the elements owned by each node
-    std::set<unsigned> elements_containing_nodeA = pNodeA->rGetContainingElementIndices();
-    std::set<unsigned> elements_containing_nodeB = pNodeB->rGetContainingElementIndices();
+    const std::set<unsigned>& r_elements_containing_nodeA = pNodeA->rGetContainingElementIndices();
+    const std::set<unsigned>& r_elements_containing_nodeB = pNodeB->rGetContainingElementIndices();
 
     // Find common elements
     std::set<unsigned> shared_elements;
-    std::set_intersection(elements_containing_nodeA.begin(), elements_containing_nodeA.end(),
-                          elements_containing_nodeB.begin(), elements_containing_nodeB.end(),
+    std::set_intersection(r_elements_containing_nodeA.begin(), r_elements_containing_nodeA.end(),
+                          r_elements_containing_nodeB.begin(), r_elements_containing_nodeB.end(),
                           std::inserter(shared_elements, shared_elements.begin()));
 
     // Check that the nodes have a common edge
@@ -262,29 +705,12 @@ unsigned NagaiHondaMultipleLabelsForce<DIM>::GetDifferenceInLabelsAcrossEdge(Nod
     }
     else
     {
-        // Get the colour of the label associated with cell 1
-        unsigned colour_of_cell_1 = 0;
         std::set<unsigned>::iterator iter = shared_elements.begin();
-        unsigned element_index = *(iter);
-        CellPtr p_cell = rVertexCellPopulation.GetCellUsingLocationIndex(element_index);
-
-        assert(p_cell->template HasCellProperty<CellLabel>());
-        CellPropertyCollection collection = p_cell->rGetCellPropertyCollection().GetProperties<CellLabel>();
-        boost::shared_ptr<CellLabel> p_label = boost::static_pointer_cast<CellLabel>(collection.GetProperty());
-        colour_of_cell_1 = p_label->GetColour();
-
-        // Get the colour of the label associated with cell 2
+        unsigned colour_index_1 = mElementColourIndices[*iter];
         ++iter;
-        unsigned colour_of_cell_2 = 0;
-        element_index = *(iter);
-        CellPtr p_cell2 = rVertexCellPopulation.GetCellUsingLocationIndex(element_index);
-
-        assert(p_cell->template HasCellProperty<CellLabel>());
-        CellPropertyCollection collection2 = p_cell2->rGetCellPropertyCollection().GetProperties<CellLabel>();
-        boost::shared_ptr<CellLabel> p_label2 = boost::static_pointer_cast<CellLabel>(collection2.GetProperty());
-        colour_of_cell_2 = p_label2->GetColour();
+        unsigned colour_index_2 = mElementColourIndices[*iter];
 
-        unsigned difference_in_labels = abs(colour_of_cell_1%mNumLabelledColours - colour_of_cell_2%mNumLabelledColours);
+        unsigned difference_in_labels = (colour_index_1 > colour_index_2) ? (colour_index_1 - colour_index_2) : (colour_index_2 - colour_index_1);
         return difference_in_labels;
     }
 }
@@ -294,37 +720,23 @@ double NagaiHondaMultipleLabelsForce<DIM>::GetAdhesionParameter(Node<DIM>* pNode
                                                                 Node<DIM>* pNodeB,
                                                                 VertexBasedCellPopulation<DIM>& rVertexCellPopulation)
 {
-    unsigned difference_in_labels = GetDifferenceInLabelsAcrossEdge(pNodeA, pNodeB, rVertexCellPopulation);
-
-    if (difference_in_labels == UNSIGNED_UNSET)
+    // Only refresh the colour cache if it has never been built for this mesh; it is checked fully in each call to AddForceContribution()
+    if (mElementColourIndices.size() != rVertexCellPopulation.rGetMesh().GetNumAllElements())
     {
-        // In this case, this edge belongs to a single element so is on the boundary
-        return this->GetCellBoundaryAdhesionParameter();
-    }
-    else if ((pNodeA->IsBoundaryNode()) || (pNodeB->IsBoundaryNode()))
-    {
-        return this->GetCellBoundaryAdhesionParameter();
+        UpdateLabelColourCache(rVertexCellPopulation);
     }
-    else if (difference_in_labels == 0)
-    {
-        // In this case, the cells sharing this edge have the same label colour
-        return this->GetHomotypicCellAdhesionParameter();
-    }
-    else
-    {
-        // In this case, the cells sharing this edge have different label colours, so we return
-        // mHeterotypicCellAdhesionParameter scaled by a multiplier defined by the difference
-        // in label colours
-        double energy_parameter_multiplier = (double)(difference_in_labels); // 26 SEP 2015 // 1.0;
 
-        // Label numbers wrap around, so check to find smallest difference
-        if (energy_parameter_multiplier > mNumLabelledColours/2)
-        {
-            energy_parameter_multiplier = mNumLabelledColours - energy_parameter_multiplier;
-        }
+    // Find the elements shared by the two nodes
+    const std::set<unsigned>& r_elements_containing_nodeA = pNodeA->rGetContainingElementIndices();
+    const std::set<unsigned>& r_elements_containing_nodeB = pNodeB->rGetContainingElementIndices();
+    std::set<unsigned> shared_elements;
+    std::set_intersection(r_elements_containing_nodeA.begin(), r_elements_containing_nodeA.end(),
+                          r_elements_containing_nodeB.begin(), r_elements_containing_nodeB.end(),
+                          std::inserter(shared_elements, shared_elements.begin()));
+    assert(!shared_elements.empty());
 
-        return this->GetHeterotypicCellAdhesionParameter() * energy_parameter_multiplier;
-    }
+    bool is_boundary_edge = pNodeA->IsBoundaryNode() || pNodeB->IsBoundaryNode();
+    return GetAdhesionParameterForElements(shared_elements.size(), *(shared_elements.begin()), *(shared_elements.rbegin()), is_boundary_edge);
 }
 
 template<unsigned DIM>
@@ -381,6 +793,43 @@ void NagaiHondaMultipleLabelsForce<DIM>::SetLambdaParameter(double lambdaParamet
     mLambdaParameter = lambdaParameter;
 }
 
+template<unsigned DIM>
+void NagaiHondaMultipleLabelsForce<DIM>::SetAdhesionParameterMatrix(const std::vector<std::vector<double> >& rAdhesionParameterMatrix)
+{
+    unsigned num_colours = rAdhesionParameterMatrix.size();
+    for (unsigned i=0; i<num_colours; i++)
+    {
+        if (rAdhesionParameterMatrix[i].size() != num_colours)
+        {
+            EXCEPTION("The adhesion parameter matrix must be square");
+        }
+    }
+
+    std::vector<double> adhesion_parameter_matrix(num_colours*num_colours);
+    for (unsigned i=0; i<num_colours; i++)
+    {
+        for (unsigned j=0; j<num_colours; j++)
+        {
+            if (rAdhesionParameterMatrix[i][j] != rAdhesionParameterMatrix[j][i])
+            {
+                EXCEPTION("The adhesion parameter matrix must be symmetric");
+            }
+            adhesion_parameter_matrix[i*num_colours + j] = rAdhesionParameterMatrix[i][j];
+        }
+    }
+    mAdhesionParameterMatrix = adhesion_parameter_matrix;
+    mUseCustomAdhesionParameterMatrix = true;
+}
+
+template<unsigned DIM>
+void NagaiHondaMultipleLabelsForce<DIM>::ResetLabelColourCache()
+{
+    mNumLabelledColours = UNSIGNED_UNSET;
+    mElementCells.clear();
+    mElementPropertySignatures.clear();
+    mElementColourIndices.clear();
+}
+
 //\guy 02/02
 template<unsigned DIM>
 void NagaiHondaMultipleLabelsForce<DIM>::ComputeNumLabelledColours(VertexBasedCellPopulation<DIM>& rVertexCellPopulation)
@@ -411,11 +860,13 @@ void NagaiHondaMultipleLabelsForce<DIM>::OutputForceParameters(out_stream& rPara
 {
     // Output member variables
     *rParamsFile << "\t\t\t<UseExponentialLineTension>" << mUseExponentialLineTension << "</UseExponentialLineTension> \n";
+    *rParamsFile << "\t\t\t<UseTabulatedExponential>" << mUseTabulatedExponential << "</UseTabulatedExponential> \n";
     *rParamsFile << "\t\t\t<CellBoundaryAdhesionParameter>" << mCellBoundaryAdhesionParameter << "</CellBoundaryAdhesionParameter> \n";
     *rParamsFile << "\t\t\t<HomotypicCellAdhesionParameter>" << mHomotypicCellAdhesionParameter << "</HomotypicCellAdhesionParameter> \n";
     *rParamsFile << "\t\t\t<HeterotypicCellAdhesionParameter>" << mHeterotypicCellAdhesionParameter << "</HeterotypicCellAdhesionParameter> \n";
     *rParamsFile << "\t\t\t<LambdaParameter>" << mLambdaParameter << "</LambdaParameter> \n";
     *rParamsFile << "\t\t\t<NumLabelledColours>" << mNumLabelledColours << "</NumLabelledColours> \n";
+    *rParamsFile << "\t\t\t<UseCustomAdhesionParameterMatrix>" << mUseCustomAdhesionParameterMatrix << "</UseCustomAdhesionParameterMatrix> \n";
 
     NagaiHondaForce<DIM>::OutputForceParameters(rParamsFile);
 }
@@ -38,8 +38,12 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "ChasteSerialization.hpp"
 #include <boost/serialization/base_object.hpp>
+#include <boost/serialization/vector.hpp>
+#include <cstddef>
 
 #include "NagaiHondaForce.hpp"
+#include "VertexGeometrySnapshot.hpp"
+#include "VertexMeshEdgeTable.hpp"
 
 #include <iostream>
 
@@ -51,6 +55,14 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * labelled cells. To include differential adhesion we override the
  * GetAdhesionParameter() method.
  *
+ * Each cell's label colour c is mapped to the colour index c % K, where K is the number
+ * of distinct label colours present in the population. The adhesion parameter of an edge
+ * shared by two cells is then looked up in a K x K table indexed by the colour indices of
+ * the two cells. By default this table reproduces the rule that cells of the same colour
+ * have the homotypic adhesion parameter, and cells whose colour indices differ by d (taking
+ * the shorter way round the colour 'wheel') have d times the heterotypic adhesion parameter;
+ * an arbitrary symmetric table may instead be set by calling SetAdhesionParameterMatrix().
+ *
  * Each of the model parameter member variables are rescaled such that
  * mDampingConstantNormal takes the default value 1, whereas Nagai and
  * Honda (who denote the parameter by nu) take the value 0.01.
@@ -67,6 +79,13 @@ private:
      */
     bool mUseExponentialLineTension;
 
+    /**
+     * Whether to evaluate the exponential in the exponential line tension term by linear
+     * interpolation in a table, rather than by calling exp().
+     * Takes the default value false.
+     */
+    bool mUseTabulatedExponential;
+
     /**
      * Adhesion parameter for cell edges on the boundary of the population.
      * Takes the default value 1.0.
@@ -98,6 +117,67 @@ private:
      */
     unsigned mNumLabelledColours;
 
+    /** Snapshot of the mesh geometry, built in each call to AddForceContribution(). Not archived. */
+    VertexGeometrySnapshot<DIM> mGeometry;
+
+    /** Target area of each element, found in each call to AddForceContribution(). Not archived. */
+    std::vector<double> mTargetAreas;
+
+    /**
+     * Adhesion force coefficient of each element slot of mGeometry (the edge from the slot's node to
+     * the next node of the element), found in each call to AddForceContribution(). Not archived.
+     */
+    std::vector<double> mSlotAdhesionCoefficients;
+
+    /**
+     * Whether the adhesion parameter table has been set by the user with SetAdhesionParameterMatrix().
+     * Takes the default value false, in which case the table is recomputed from the homotypic and
+     * heterotypic adhesion parameters.
+     */
+    bool mUseCustomAdhesionParameterMatrix;
+
+    /**
+     * Adhesion parameter for each pair of colour indices, stored as a K x K row-major table,
+     * where K is mNumLabelledColours.
+     */
+    std::vector<double> mAdhesionParameterMatrix;
+
+    /**
+     * Colour index (label colour modulo mNumLabelledColours) of the cell associated with each
+     * element, or UNSIGNED_UNSET if the cell is unlabelled or the element is deleted. Refreshed
+     * only when the cells associated with the elements or their cell properties change, or when
+     * ResetLabelColourCache() is called. Not archived.
+     */
+    std::vector<unsigned> mElementColourIndices;
+
+    /**
+     * The cell associated with each element when mElementColourIndices was last refreshed, used
+     * to detect changes in the topology of the population. Not archived.
+     */
+    std::vector<Cell*> mElementCells;
+
+    /**
+     * Signature of the cell property collection of the cell associated with each element when
+     * mElementColourIndices was last refreshed, used to detect a cell label being added, removed
+     * or replaced. Not archived.
+     */
+    std::vector<std::size_t> mElementPropertySignatures;
+
+    /** Table of the unique edges of the mesh, built in each call to AddForceContribution(). Not archived. */
+    VertexMeshEdgeTable<DIM> mEdgeTable;
+
+    /** Adhesion parameter of each edge of mEdgeTable, found in each call to AddForceContribution(). Not archived. */
+    std::vector<double> mEdgeAdhesionParameters;
+
+    /**
+     * Factor lambda*exp(-lambda*l) of each edge of mEdgeTable, where l is the edge length, found in
+     * each call to AddForceContribution() if mUseExponentialLineTension is true. Not archived.
+     */
+    std::vector<double> mEdgeExponentialFactors;
+
+    /** Values of exp(-x) at evenly spaced x, built on first use if mUseTabulatedExponential is true. Not archived. */
+    std::vector<double> mExponentialTable;
+
     friend class boost::serialization::access;
     /**
      * Boost Serialization method for archiving/checkpointing.
@@ -111,23 +191,106 @@ private:
     {
         archive & boost::serialization::base_object<NagaiHondaForce<DIM> >(*this);
         archive & mUseExponentialLineTension;
+        archive & mUseTabulatedExponential;
         archive & mCellBoundaryAdhesionParameter;
         archive & mHomotypicCellAdhesionParameter;
         archive & mHeterotypicCellAdhesionParameter;
         archive & mLambdaParameter;
         archive & mNumLabelledColours;
+        archive & mUseCustomAdhesionParameterMatrix;
+        archive & mAdhesionParameterMatrix;
     }
 
     /**
      * Helper method to compute the value of mNumLabelledColours.
      *
-     * This method is called the first time that GetAdhesionParameter() is called.
-     * We thus assume that no new cell labels are applied after this call.
+     * This method is called the first time that the label colours are needed, and again after
+     * any call to ResetLabelColourCache().
      *
      * @param rVertexCellPopulation reference to the cell population
      */
     void ComputeNumLabelledColours(VertexBasedCellPopulation<DIM>& rVertexCellPopulation);
 
+    /**
+     * Helper method to find the target area of each element and store it in mTargetAreas.
+     *
+     * @param rVertexCellPopulation reference to the cell population
+     */
+    void ComputeTargetAreas(VertexBasedCellPopulation<DIM>& rVertexCellPopulation);
+
+    /**
+     * Helper method to add the force contribution using the area and edge gradient methods of the
+     * mesh, one node at a time. Used instead of mGeometry, which is only implemented in 2D, when
+     * DIM is not 2.
+     *
+     * @param rVertexCellPopulation reference to the cell population
+     */
+    void AddForceContributionUsingMeshGradients(VertexBasedCellPopulation<DIM>& rVertexCellPopulation);
+
+    /**
+     * Helper method to compute the total energy using the geometry methods of the mesh. Used
+     * instead of mGeometry, which is only implemented in 2D, when DIM is not 2.
+     *
+     * @param rVertexCellPopulation reference to the cell population
+     * @return the total energy.
+     */
+    double ComputeTotalEnergyUsingMeshGeometry(VertexBasedCellPopulation<DIM>& rVertexCellPopulation);
+
+    /**
+     * Helper method to find the target area of each element and build mGeometry.
+     *
+     * @param rVertexCellPopulation reference to the cell population
+     */
+    void ComputeElementGeometry(VertexBasedCellPopulation<DIM>& rVertexCellPopulation);
+
+    /**
+     * @return a signature of the cell property collection of a cell, which changes whenever a
+     * property (such as a CellLabel) is added to or removed from the cell.
+     *
+     * @param pCell the cell
+     */
+    std::size_t GetCellPropertySignature(CellPtr pCell);
+
+    /**
+     * Helper method to refresh mElementColourIndices if the cells associated with the elements, or
+     * their cell properties, have changed since it was last refreshed, and to recompute the default adhesion parameter
+     * table from the current homotypic and heterotypic adhesion parameters.
+     *
+     * @param rVertexCellPopulation reference to the cell population
+     */
+    void UpdateLabelColourCache(VertexBasedCellPopulation<DIM>& rVertexCellPopulation);
+
+    /**
+     * Helper method to compute the adhesion parameter of each edge of mEdgeTable, storing
+     * the result in mEdgeAdhesionParameters. Must be called after UpdateLabelColourCache().
+     *
+     * @param rVertexCellPopulation reference to the cell population
+     */
+    void ComputeEdgeAdhesionParameters(VertexBasedCellPopulation<DIM>& rVertexCellPopulation);
+
+    /**
+     * @return the adhesion parameter of an edge, given the elements containing it and whether
+     * either of its nodes is a boundary node.
+     *
+     * @param numElements the number of elements containing the edge (1 or 2)
+     * @param elementA index of one element containing the edge
+     * @param elementB index of the other element containing the edge (ignored if numElements is 1)
+     * @param isBoundaryEdge whether either node of the edge is a boundary node
+     */
+    double GetAdhesionParameterForElements(unsigned numElements, unsigned elementA, unsigned elementB, bool isBoundaryEdge);
+
+    /**
+     * Helper method to compute the factor lambda*exp(-lambda*l) for each edge of mEdgeTable in a
+     * single pass, storing the result in mEdgeExponentialFactors. Must be called after mGeometry
+     * and mEdgeTable have been built.
+     */
+    void ComputeEdgeExponentialFactors();
+
+    /**
+     * Helper method to fill mExponentialTable, if it is empty.
+     */
+    void BuildExponentialTable();
+
 public:
 
     /**
@@ -154,6 +317,34 @@ public:
      */
     void SetUseExponentialLineTension(bool useExponentialLineTension);
 
+    /**
+     * Get the value of #mUseTabulatedExponential.
+     *
+     * @return mUseTabulatedExponential.
+     */
+    bool GetUseTabulatedExponential();
+
+    /**
+     * Set the value of #mUseTabulatedExponential.
+     *
+     * When true, the exponential line tension force evaluates exp(-lambda*l) by linear interpolation
+     * in a table with spacing 1/256 in lambda*l, so the relative error in each edge's contribution
+     * is at most cosh(1/512) - 1, about 1.9e-6; exp() is still called directly when lambda*l exceeds 16.
+     * This is several times cheaper than calling exp() for each edge. ComputeTotalEnergy() always
+     * uses exp().
+     *
+     * @param useTabulatedExponential whether to tabulate the exponential
+     */
+    void SetUseTabulatedExponential(bool useTabulatedExponential);
+
+    /**
+     * @return exp(-x) as evaluated by the exponential line tension force when
+     * #mUseTabulatedExponential is true.
+     *
+     * @param x the (non-negative) argument
+     */
+    double GetTabulatedExponential(double x);
+
     /**
      * Overridden AddForceContribution() method.
      *
@@ -162,7 +353,25 @@ public:
     virtual void AddForceContribution(AbstractCellPopulation<DIM>& rCellPopulation);
 
     /**
-     * @return the difference in label colours between the two cells sharing the edge between two given nodes.
+     * Compute the total energy of the cell population,
+     *
+     * E = sum over cells of K (A - A0)^2 + beta (P - 2 sqrt(pi A0))^2 + sum over element slots of U(l),
+     *
+     * where U(l) = gamma l, or gamma (1 - exp(-lambda l)) if mUseExponentialLineTension is true, gamma is
+     * the adhesion parameter of the edge and l its length. Each internal edge therefore contributes
+     * once for each of its two cells. The force computed by AddForceContribution() is minus the
+     * gradient of this energy.
+     *
+     * If no node has moved and the mesh is unchanged since the last call to AddForceContribution()
+     * or this method, the geometry snapshot and edge table built then are reused.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @return the total energy.
+     */
+    double ComputeTotalEnergy(AbstractCellPopulation<DIM>& rCellPopulation);
+
+    /**
+     * @return the difference in label colour indices between the two cells sharing the edge between two given nodes.
      * If the edge belongs to one element then the cell is on the boundary of the tissue; in this case,
      * the method returns UNSIGNED_UNSET.
      *
@@ -239,6 +448,26 @@ public:
      */
     void SetLambdaParameter(double lambdaParameter);
 
+    /**
+     * Set the adhesion parameter for each pair of colour indices, overriding the default rule
+     * based on the homotypic and heterotypic adhesion parameters. Entry (i,j) is the adhesion
+     * parameter of an edge shared by cells with label colours c_i and c_j such that c_i % K = i
+     * and c_j % K = j, where K is the number of distinct label colours present in the population,
+     * which must equal the size of the matrix.
+     *
+     * @param rAdhesionParameterMatrix a square, symmetric matrix of adhesion parameters
+     */
+    void SetAdhesionParameterMatrix(const std::vector<std::vector<double> >& rAdhesionParameterMatrix);
+
+    /**
+     * Force the number of label colours and the cached colour index of each element to be
+     * recomputed at the next call to AddForceContribution(). A change to the label of a cell
+     * is detected automatically, but this should be called if a label colour that was not
+     * previously present is introduced during a simulation, so that the number of label
+     * colours is recomputed.
+     */
+    void ResetLabelColourCache();
+
     /**
      * Overridden OutputForceParameters() method.
      *
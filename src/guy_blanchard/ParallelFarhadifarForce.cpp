@@ -0,0 +1,362 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "ParallelFarhadifarForce.hpp"
+#include "SimulationTime.hpp"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+template<unsigned DIM>
+ParallelFarhadifarForce<DIM>::ParallelFarhadifarForce()
+   : FarhadifarForce<DIM>(),
+     mNumThreads(0),
+     mAreaElasticityParameterInUse(DOUBLE_UNSET),
+     mPerimeterContractilityParameterInUse(DOUBLE_UNSET),
+     mSlotLineTensionsTimeStep(UNSIGNED_UNSET)
+{
+}
+
+template<unsigned DIM>
+ParallelFarhadifarForce<DIM>::~ParallelFarhadifarForce()
+{
+}
+
+template<unsigned DIM>
+void ParallelFarhadifarForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>& rCellPopulation)
+{
+    // Throw an exception message if not using a VertexBasedCellPopulation
+    if (dynamic_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation) == NULL)
+    {
+        EXCEPTION("ParallelFarhadifarForce is to be used with a VertexBasedCellPopulation only");
+    }
+
+    // The snapshot is only implemented in 2D, so use the serial assembly of FarhadifarForce otherwise
+    if (DIM != 2)
+    {
+        if (mpAreaElasticitySchedule || mpPerimeterContractilitySchedule)
+        {
+            EXCEPTION("Force coefficient schedules are only supported in 2D");
+        }
+        FarhadifarForce<DIM>::AddForceContribution(rCellPopulation);
+        return;
+    }
+
+    // Define some helper variables
+    VertexBasedCellPopulation<DIM>* p_cell_population = static_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation);
+    int num_nodes = (int)p_cell_population->GetNumNodes();
+    unsigned num_threads = GetNumThreadsInUse();
+
+    // Find the area, perimeter and target area of each element, and the line tension of each element slot
+    ComputeElementGeometry(*p_cell_population);
+    ComputeSlotLineTensions(*p_cell_population);
+    RecordSlotLineTensionsTimeStep();
+
+    double area_elasticity_parameter = mAreaElasticityParameterInUse;
+    double perimeter_contractility_parameter = mPerimeterContractilityParameterInUse;
+
+    // Iterate over vertices in the cell population; each iteration only writes to its own node
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+#endif
+    for (int node_index=0; node_index<num_nodes; node_index++)
+    {
+        /*
+         * The force on this Node is given by the gradient of the total free
+         * energy of the CellPopulation, evaluated at the position of the vertex.
+         * Since the movement of this Node only affects the free energy of the
+         * CellPtrs containing it, we just consider their contributions, one for
+         * each element slot occupied by the node.
+         */
+        double force_x = 0.0;
+        double force_y = 0.0;
+
+        unsigned num_node_slots = mGeometry.GetNumNodeSlots(node_index);
+        for (unsigned i=0; i<num_node_slots; i++)
+        {
+            unsigned slot = mGeometry.GetNodeSlot(node_index, i);
+            unsigned previous_slot = mGeometry.GetPreviousSlot(slot);
+            unsigned elem_index = mGeometry.GetSlotElement(slot);
+
+            // Add the force contribution from this cell's area elasticity (note the minus sign)
+            double area_coefficient = -area_elasticity_parameter*(mGeometry.GetElementArea(elem_index) - mTargetAreas[elem_index]);
+            force_x += area_coefficient*mGeometry.GetAreaGradientX(slot);
+            force_y += area_coefficient*mGeometry.GetAreaGradientY(slot);
+
+            /*
+             * The gradients of the previous and next edges at this node are the unit vector along the
+             * previous edge and minus the unit vector along the next edge. Each is weighted by the line
+             * tension of the edge plus this cell's perimeter contractility (note the minus sign).
+             */
+            double perimeter_term = perimeter_contractility_parameter*mGeometry.GetElementPerimeter(elem_index);
+            double previous_edge_coefficient = mSlotLineTensions[previous_slot] + perimeter_term;
+            double next_edge_coefficient = mSlotLineTensions[slot] + perimeter_term;
+            force_x += next_edge_coefficient*mGeometry.GetEdgeUnitX(slot) - previous_edge_coefficient*mGeometry.GetEdgeUnitX(previous_slot);
+            force_y += next_edge_coefficient*mGeometry.GetEdgeUnitY(slot) - previous_edge_coefficient*mGeometry.GetEdgeUnitY(previous_slot);
+        }
+
+        c_vector<double, DIM> force_on_node = zero_vector<double>(DIM);
+        force_on_node[0] = force_x;
+        if (DIM > 1)
+        {
+            force_on_node[1] = force_y;
+        }
+        p_cell_population->GetNode(node_index)->AddAppliedForceContribution(force_on_node);
+    }
+}
+
+template<unsigned DIM>
+double ParallelFarhadifarForce<DIM>::ComputeTotalEnergy(AbstractCellPopulation<DIM>& rCellPopulation)
+{
+    // Throw an exception message if not using a VertexBasedCellPopulation
+    if (dynamic_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation) == NULL)
+    {
+        EXCEPTION("ParallelFarhadifarForce is to be used with a VertexBasedCellPopulation only");
+    }
+    VertexBasedCellPopulation<DIM>* p_cell_population = static_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation);
+    unsigned num_threads = GetNumThreadsInUse();
+
+    // Reuse the snapshot and slot line tensions of the last assembly if they were found in this time step and the mesh is unchanged
+    if (SlotLineTensionsAreCurrent(*p_cell_population))
+    {
+        UpdateScheduledCoefficients();
+    }
+    else
+    {
+        ComputeElementGeometry(*p_cell_population);
+        ComputeSlotLineTensions(*p_cell_population);
+        RecordSlotLineTensionsTimeStep();
+    }
+
+    double area_elasticity_parameter = mAreaElasticityParameterInUse;
+    double perimeter_contractility_parameter = mPerimeterContractilityParameterInUse;
+
+    // Compute the energy of each element in parallel, then sum in a fixed order so the result is deterministic
+    int num_elements = (int)mTargetAreas.size();
+    std::vector<double> element_energies(num_elements);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+#endif
+    for (int elem_index=0; elem_index<num_elements; elem_index++)
+    {
+        double area_difference = mGeometry.GetElementArea(elem_index) - mTargetAreas[elem_index];
+        double perimeter = mGeometry.GetElementPerimeter(elem_index);
+        double energy = 0.5*area_elasticity_parameter*area_difference*area_difference
+                      + 0.5*perimeter_contractility_parameter*perimeter*perimeter;
+
+        unsigned slot_offset = mGeometry.GetElementSlotOffset(elem_index);
+        unsigned num_slots = mGeometry.GetNumElementSlots(elem_index);
+        for (unsigned slot=slot_offset; slot<slot_offset+num_slots; slot++)
+        {
+            energy += mSlotLineTensions[slot]*mGeometry.GetEdgeLength(slot);
+        }
+        element_energies[elem_index] = energy;
+    }
+
+    double total_energy = 0.0;
+    for (int elem_index=0; elem_index<num_elements; elem_index++)
+    {
+        total_energy += element_energies[elem_index];
+    }
+    return total_energy;
+}
+
+template<unsigned DIM>
+void ParallelFarhadifarForce<DIM>::UpdateScheduledCoefficients()
+{
+    // The getters are virtual, and are called here once per time step rather than in the assembly loops
+    mAreaElasticityParameterInUse = this->GetAreaElasticityParameter();
+    mPerimeterContractilityParameterInUse = this->GetPerimeterContractilityParameter();
+
+    if (mpAreaElasticitySchedule || mpPerimeterContractilitySchedule)
+    {
+        double time = SimulationTime::Instance()->GetTime();
+        if (mpAreaElasticitySchedule)
+        {
+            // Keep any offset a derived class adds to the parameter in its getter
+            mAreaElasticityParameterInUse += mpAreaElasticitySchedule->Evaluate(time) - this->mAreaElasticityParameter;
+        }
+        if (mpPerimeterContractilitySchedule)
+        {
+            mPerimeterContractilityParameterInUse += mpPerimeterContractilitySchedule->Evaluate(time) - this->mPerimeterContractilityParameter;
+        }
+    }
+}
+
+template<unsigned DIM>
+void ParallelFarhadifarForce<DIM>::ComputeElementGeometry(VertexBasedCellPopulation<DIM>& rVertexCellPopulation)
+{
+    // Find the coefficients once, so that the assembly loops read plain member variables
+    UpdateScheduledCoefficients();
+
+    MutableVertexMesh<DIM,DIM>& r_mesh = rVertexCellPopulation.rGetMesh();
+
+    // Find the target areas serially, since this may throw
+    mTargetAreas.assign(r_mesh.GetNumAllElements(), 0.0);
+    for (typename VertexMesh<DIM,DIM>::VertexElementIterator elem_iter = r_mesh.GetElementIteratorBegin();
+         elem_iter != r_mesh.GetElementIteratorEnd();
+         ++elem_iter)
+    {
+        unsigned elem_index = elem_iter->GetIndex();
+        try
+        {
+            mTargetAreas[elem_index] = rVertexCellPopulation.GetCellUsingLocationIndex(elem_index)->GetCellData()->GetItem("target area");
+        }
+        catch (Exception&)
+        {
+            EXCEPTION("You need to add an AbstractTargetAreaModifier to the simulation in order to use a ParallelFarhadifarForce");
+        }
+    }
+
+    // Compute the area and perimeter of each element, and the edge and area gradients at each node, in bulk
+    mGeometry.Build(r_mesh, GetNumThreadsInUse());
+
+    // The slot line tensions must be found again for the new snapshot
+    InvalidateSlotLineTensions();
+}
+
+template<unsigned DIM>
+void ParallelFarhadifarForce<DIM>::InvalidateSlotLineTensions()
+{
+    mSlotLineTensionsTimeStep = UNSIGNED_UNSET;
+}
+
+template<unsigned DIM>
+void ParallelFarhadifarForce<DIM>::RecordSlotLineTensionsTimeStep()
+{
+    SimulationTime* p_simulation_time = SimulationTime::Instance();
+    if (p_simulation_time->IsEndTimeAndNumberOfTimeStepsSetUp())
+    {
+        mSlotLineTensionsTimeStep = p_simulation_time->GetTimeStepsElapsed();
+    }
+}
+
+template<unsigned DIM>
+bool ParallelFarhadifarForce<DIM>::SlotLineTensionsAreCurrent(VertexBasedCellPopulation<DIM>& rVertexCellPopulation)
+{
+    SimulationTime* p_simulation_time = SimulationTime::Instance();
+    return (mSlotLineTensionsTimeStep != UNSIGNED_UNSET)
+        && p_simulation_time->IsEndTimeAndNumberOfTimeStepsSetUp()
+        && (mSlotLineTensionsTimeStep == p_simulation_time->GetTimeStepsElapsed())
+        && mGeometry.IsCurrent(rVertexCellPopulation.rGetMesh());
+}
+
+template<unsigned DIM>
+void ParallelFarhadifarForce<DIM>::ComputeSlotLineTensions(VertexBasedCellPopulation<DIM>& rVertexCellPopulation)
+{
+    mSlotLineTensions.resize(mGeometry.GetNumSlots());
+
+    MutableVertexMesh<DIM,DIM>& r_mesh = rVertexCellPopulation.rGetMesh();
+    for (typename VertexMesh<DIM,DIM>::VertexElementIterator elem_iter = r_mesh.GetElementIteratorBegin();
+         elem_iter != r_mesh.GetElementIteratorEnd();
+         ++elem_iter)
+    {
+        unsigned slot_offset = mGeometry.GetElementSlotOffset(elem_iter->GetIndex());
+        unsigned num_nodes_elem = elem_iter->GetNumNodes();
+        for (unsigned local_index=0; local_index<num_nodes_elem; local_index++)
+        {
+            Node<DIM>* p_node = elem_iter->GetNode(local_index);
+            Node<DIM>* p_next_node = elem_iter->GetNode((local_index+1)%num_nodes_elem);
+            mSlotLineTensions[slot_offset + local_index] = this->GetLineTensionParameter(p_node, p_next_node, rVertexCellPopulation);
+        }
+    }
+}
+
+template<unsigned DIM>
+unsigned ParallelFarhadifarForce<DIM>::GetNumThreadsInUse() const
+{
+#ifdef _OPENMP
+    return (mNumThreads > 0) ? mNumThreads : (unsigned)omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+template<unsigned DIM>
+unsigned ParallelFarhadifarForce<DIM>::GetNumThreads() const
+{
+    return mNumThreads;
+}
+
+template<unsigned DIM>
+void ParallelFarhadifarForce<DIM>::SetNumThreads(unsigned numThreads)
+{
+    mNumThreads = numThreads;
+}
+
+template<unsigned DIM>
+double ParallelFarhadifarForce<DIM>::GetAreaElasticityParameterInUse() const
+{
+    return mAreaElasticityParameterInUse;
+}
+
+template<unsigned DIM>
+double ParallelFarhadifarForce<DIM>::GetPerimeterContractilityParameterInUse() const
+{
+    return mPerimeterContractilityParameterInUse;
+}
+
+template<unsigned DIM>
+void ParallelFarhadifarForce<DIM>::SetAreaElasticitySchedule(boost::shared_ptr<ForceCoefficientSchedule> pSchedule)
+{
+    mpAreaElasticitySchedule = pSchedule;
+}
+
+template<unsigned DIM>
+void ParallelFarhadifarForce<DIM>::SetPerimeterContractilitySchedule(boost::shared_ptr<ForceCoefficientSchedule> pSchedule)
+{
+    mpPerimeterContractilitySchedule = pSchedule;
+}
+
+template<unsigned DIM>
+void ParallelFarhadifarForce<DIM>::OutputForceParameters(out_stream& rParamsFile)
+{
+    // Output member variables then call method on direct parent class
+    *rParamsFile << "\t\t\t<NumThreads>" << mNumThreads << "</NumThreads> \n";
+    *rParamsFile << "\t\t\t<UseAreaElasticitySchedule>" << (bool)mpAreaElasticitySchedule << "</UseAreaElasticitySchedule> \n";
+    *rParamsFile << "\t\t\t<UsePerimeterContractilitySchedule>" << (bool)mpPerimeterContractilitySchedule << "</UsePerimeterContractilitySchedule> \n";
+
+    FarhadifarForce<DIM>::OutputForceParameters(rParamsFile);
+}
+
+// Explicit instantiation
+template class ParallelFarhadifarForce<1>;
+template class ParallelFarhadifarForce<2>;
+template class ParallelFarhadifarForce<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(ParallelFarhadifarForce)
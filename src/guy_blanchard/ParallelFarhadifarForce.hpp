@@ -0,0 +1,280 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef PARALLELFARHADIFARFORCE_HPP_
+#define PARALLELFARHADIFARFORCE_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+#include <boost/serialization/shared_ptr.hpp>
+
+#include "FarhadifarForce.hpp"
+#include "ForceCoefficientSchedule.hpp"
+#include "VertexGeometrySnapshot.hpp"
+#include <vector>
+
+/**
+ * A FarhadifarForce whose AddForceContribution() method is split into a serial set-up
+ * phase and a thread-parallel assembly phase.
+ *
+ * In the set-up phase the target area of each element, a VertexGeometrySnapshot of the
+ * mesh, and the line tension parameter of each element 'slot' (the edge from local node i
+ * to local node i+1), are found.
+ * Derived classes customise the line tension either by overriding GetLineTensionParameter(),
+ * which is then called once per slot, or by overriding ComputeSlotLineTensions() directly.
+ *
+ * In the assembly phase the force on each node is computed from the snapshot arrays in
+ * a loop that is statically partitioned over OpenMP threads when the project is built
+ * with OpenMP. Each node only writes its own applied force, and the
+ * contributions to it are summed in a fixed order, so the result does not depend on
+ * the number of threads.
+ *
+ * The area elasticity and perimeter contractility parameters may each be given a
+ * ForceCoefficientSchedule. The values used in assembly are found once per call to
+ * ComputeElementGeometry(), i.e. once per time step: from the schedule at the current
+ * simulation time if there is one, and otherwise from GetAreaElasticityParameter() and
+ * GetPerimeterContractilityParameter(). They are kept in separate members, so the parameters
+ * set by the user, which are returned by the getters and written to the parameters file, are
+ * never overwritten, and take effect again if a schedule is removed.
+ *
+ * The snapshot is only implemented in 2D. In other dimensions AddForceContribution() uses the
+ * serial assembly of FarhadifarForce, and coefficient schedules are not supported.
+ */
+template<unsigned DIM>
+class ParallelFarhadifarForce : public FarhadifarForce<DIM>
+{
+private:
+
+    /**
+     * The number of threads used for force assembly, or 0 to use the OpenMP default.
+     * Ignored if the project is built without OpenMP. Defaults to 0.
+     */
+    unsigned mNumThreads;
+
+    friend class boost::serialization::access;
+    /**
+     * Boost Serialization method for archiving/checkpointing.
+     * Archives the object and its member variables.
+     *
+     * @param archive  The boost archive.
+     * @param version  The current version of this class.
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<FarhadifarForce<DIM> >(*this);
+        archive & mNumThreads;
+        archive & mpAreaElasticitySchedule;
+        archive & mpPerimeterContractilitySchedule;
+    }
+
+    /** Schedule for the area elasticity parameter, or NULL if the parameter is constant. */
+    boost::shared_ptr<ForceCoefficientSchedule> mpAreaElasticitySchedule;
+
+    /** Schedule for the perimeter contractility parameter, or NULL if the parameter is constant. */
+    boost::shared_ptr<ForceCoefficientSchedule> mpPerimeterContractilitySchedule;
+
+    /** The area elasticity parameter used in the current time step, found by UpdateScheduledCoefficients(). Not archived. */
+    double mAreaElasticityParameterInUse;
+
+    /** The perimeter contractility parameter used in the current time step, found by UpdateScheduledCoefficients(). Not archived. */
+    double mPerimeterContractilityParameterInUse;
+
+    /**
+     * Number of time steps elapsed when mSlotLineTensions was last filled for mGeometry, or
+     * UNSIGNED_UNSET if it must be filled again. Not archived.
+     */
+    unsigned mSlotLineTensionsTimeStep;
+
+    /**
+     * Record that mSlotLineTensions has been filled for mGeometry in the current time step.
+     * Outside a simulation there is no time step to tie them to, so they are never reused.
+     */
+    void RecordSlotLineTensionsTimeStep();
+
+    /**
+     * @return whether mGeometry matches the current mesh and mSlotLineTensions was filled for it
+     * in the current time step, so that both may be reused.
+     *
+     * @param rVertexCellPopulation reference to the cell population
+     */
+    bool SlotLineTensionsAreCurrent(VertexBasedCellPopulation<DIM>& rVertexCellPopulation);
+
+protected:
+
+    /** Snapshot of the mesh geometry, built in each call to ComputeElementGeometry(). */
+    VertexGeometrySnapshot<DIM> mGeometry;
+
+    /** Target area of each element, indexed by element index. */
+    std::vector<double> mTargetAreas;
+
+    /**
+     * Line tension parameter of each element slot of mGeometry (the edge from local node i to
+     * local node i+1 of an element), as used in a single visit.
+     */
+    std::vector<double> mSlotLineTensions;
+
+    /**
+     * Set mAreaElasticityParameterInUse and mPerimeterContractilityParameterInUse from their
+     * schedules at the current simulation time, or from GetAreaElasticityParameter() and
+     * GetPerimeterContractilityParameter() if they have no schedule.
+     */
+    void UpdateScheduledCoefficients();
+
+    /**
+     * Update any scheduled coefficients, then fill mGeometry and mTargetAreas for the current mesh.
+     *
+     * @param rVertexCellPopulation reference to the cell population
+     */
+    void ComputeElementGeometry(VertexBasedCellPopulation<DIM>& rVertexCellPopulation);
+
+    /**
+     * Fill mSlotLineTensions for the current mesh.
+     *
+     * This is called once per call to AddForceContribution(), after ComputeElementGeometry()
+     * and before the parallel assembly. The default implementation calls GetLineTensionParameter()
+     * once for each slot.
+     *
+     * @param rVertexCellPopulation reference to the cell population
+     */
+    virtual void ComputeSlotLineTensions(VertexBasedCellPopulation<DIM>& rVertexCellPopulation);
+
+    /**
+     * Mark mSlotLineTensions as out of date, so that the next call to ComputeTotalEnergy() fills
+     * it again. Derived classes call this whenever a parameter that the line tensions depend on
+     * is changed.
+     */
+    void InvalidateSlotLineTensions();
+
+    /**
+     * @return the number of threads to use for force assembly.
+     */
+    unsigned GetNumThreadsInUse() const;
+
+public:
+
+    /**
+     * Constructor.
+     */
+    ParallelFarhadifarForce();
+
+    /**
+     * Destructor.
+     */
+    virtual ~ParallelFarhadifarForce();
+
+    /**
+     * Overridden AddForceContribution() method.
+     *
+     * Computes the same force as FarhadifarForce, using the line tension parameters
+     * found by ComputeSlotLineTensions().
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void AddForceContribution(AbstractCellPopulation<DIM>& rCellPopulation);
+
+    /**
+     * Compute the total energy of the cell population,
+     *
+     * E = sum over cells of K/2 (A - A0)^2 + Gamma/2 P^2 + sum over element slots of lambda l,
+     *
+     * where lambda is the per-visit line tension of the slot (so halved for internal edges) and
+     * l is the edge length. The energy is computed from the same snapshot and slot line tensions
+     * as AddForceContribution(), whose force is minus its gradient provided that the line tensions
+     * do not depend on edge lengths. (This is not the case for LengthNormalisedStripeLineTension or
+     * for combined interfaces, whose forces are not conservative.)
+     *
+     * If no node has moved and the mesh is unchanged since the snapshot and slot line tensions
+     * were last found in the current time step, by AddForceContribution() or this method, they
+     * are reused rather than found again. The line tension parameters of FarhadifarForce are
+     * not watched, so a change to them within a time step reaches the energy at the next call
+     * to AddForceContribution().
+     *
+     * @param rCellPopulation reference to the cell population
+     * @return the total energy.
+     */
+    double ComputeTotalEnergy(AbstractCellPopulation<DIM>& rCellPopulation);
+
+    /**
+     * @return mNumThreads
+     */
+    unsigned GetNumThreads() const;
+
+    /**
+     * Set mNumThreads.
+     *
+     * @param numThreads the new value of mNumThreads (0 to use the OpenMP default)
+     */
+    void SetNumThreads(unsigned numThreads);
+
+    /**
+     * @return mAreaElasticityParameterInUse, the area elasticity parameter used in the current time step
+     */
+    double GetAreaElasticityParameterInUse() const;
+
+    /**
+     * @return mPerimeterContractilityParameterInUse, the perimeter contractility parameter used in the current time step
+     */
+    double GetPerimeterContractilityParameterInUse() const;
+
+    /**
+     * Set mpAreaElasticitySchedule. Once set, the schedule determines the area elasticity parameter
+     * used in assembly; the value returned by GetAreaElasticityParameter() is unchanged.
+     *
+     * @param pSchedule the schedule (or NULL to keep the parameter constant)
+     */
+    void SetAreaElasticitySchedule(boost::shared_ptr<ForceCoefficientSchedule> pSchedule);
+
+    /**
+     * Set mpPerimeterContractilitySchedule. Once set, the schedule determines the perimeter
+     * contractility parameter used in assembly; the value returned by GetPerimeterContractilityParameter()
+     * is unchanged.
+     *
+     * @param pSchedule the schedule (or NULL to keep the parameter constant)
+     */
+    void SetPerimeterContractilitySchedule(boost::shared_ptr<ForceCoefficientSchedule> pSchedule);
+
+    /**
+     * Overridden OutputForceParameters() method.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    virtual void OutputForceParameters(out_stream& rParamsFile);
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(ParallelFarhadifarForce)
+
+#endif /*PARALLELFARHADIFARFORCE_HPP_*/
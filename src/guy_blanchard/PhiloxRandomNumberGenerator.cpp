@@ -0,0 +1,74 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "PhiloxRandomNumberGenerator.hpp"
+
+#include <cmath>
+
+PhiloxRandomNumberGenerator::PhiloxRandomNumberGenerator(uint32_t seed)
+    : mSeed(seed)
+{
+}
+
+void PhiloxRandomNumberGenerator::GetStandardNormalDeviates(uint32_t step, uint32_t index, double deviates[4]) const
+{
+    // The counter is (index, step, 0, 0) and the key is (seed, 0)
+    uint32_t counter[4] = {index, step, 0u, 0u};
+    uint32_t key[2] = {mSeed, 0u};
+    uint32_t random_integers[4];
+    Philox4x32(counter, key, random_integers);
+
+    // Map each integer to a uniform deviate in (0,1), never 0, then apply the Box-Muller transform to each pair
+    const double scale = 1.0/4294967296.0;
+    for (unsigned pair=0; pair<2; pair++)
+    {
+        double u1 = (random_integers[2*pair] + 0.5)*scale;
+        double u2 = (random_integers[2*pair+1] + 0.5)*scale;
+        double radius = sqrt(-2.0*log(u1));
+        double angle = 2.0*M_PI*u2;
+        deviates[2*pair] = radius*cos(angle);
+        deviates[2*pair+1] = radius*sin(angle);
+    }
+}
+
+uint32_t PhiloxRandomNumberGenerator::GetSeed() const
+{
+    return mSeed;
+}
+
+void PhiloxRandomNumberGenerator::SetSeed(uint32_t seed)
+{
+    mSeed = seed;
+}
@@ -0,0 +1,136 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef PHILOXRANDOMNUMBERGENERATOR_HPP_
+#define PHILOXRANDOMNUMBERGENERATOR_HPP_
+
+#include <stdint.h>
+
+/**
+ * A counter-based random number generator, implementing the Philox4x32-10 generator of
+ * Salmon et al ("Parallel random numbers: as easy as 1, 2, 3", SC11, 2011).
+ *
+ * Each call maps a 128-bit counter and a 64-bit key to four independent 32-bit random
+ * integers, with no internal state. Random numbers can therefore be generated for any
+ * (seed, time step, index) triple independently, in any order and on any thread, and the
+ * result does not depend on how the work is divided. This is unlike the Chaste
+ * RandomNumberGenerator singleton, whose output depends on the order of calls.
+ */
+class PhiloxRandomNumberGenerator
+{
+private:
+
+    /** The seed, used as the key of the generator. */
+    uint32_t mSeed;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param seed the seed
+     */
+    PhiloxRandomNumberGenerator(uint32_t seed=0);
+
+    /**
+     * Apply the Philox4x32-10 bijection.
+     *
+     * @param counter the counter
+     * @param key the key
+     * @param result the four random integers (output)
+     */
+    static inline void Philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t result[4]);
+
+    /**
+     * Generate four independent standard normal random deviates for a given time step and index,
+     * using the Box-Muller transform of the four random integers for this (seed, step, index).
+     *
+     * @param step the time step
+     * @param index the index (e.g. of a node)
+     * @param deviates the four deviates (output)
+     */
+    void GetStandardNormalDeviates(uint32_t step, uint32_t index, double deviates[4]) const;
+
+    /**
+     * @return mSeed
+     */
+    uint32_t GetSeed() const;
+
+    /**
+     * Set mSeed.
+     *
+     * @param seed the new value of mSeed
+     */
+    void SetSeed(uint32_t seed);
+};
+
+void PhiloxRandomNumberGenerator::Philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t result[4])
+{
+    uint32_t c0 = counter[0];
+    uint32_t c1 = counter[1];
+    uint32_t c2 = counter[2];
+    uint32_t c3 = counter[3];
+    uint32_t k0 = key[0];
+    uint32_t k1 = key[1];
+
+    for (unsigned round=0; round<10; round++)
+    {
+        // Bump the key between rounds, using the Weyl sequence constants
+        if (round > 0)
+        {
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+
+        uint64_t product_0 = (uint64_t)0xD2511F53u*c0;
+        uint64_t product_1 = (uint64_t)0xCD9E8D57u*c2;
+        uint32_t high_0 = (uint32_t)(product_0 >> 32);
+        uint32_t low_0 = (uint32_t)product_0;
+        uint32_t high_1 = (uint32_t)(product_1 >> 32);
+        uint32_t low_1 = (uint32_t)product_1;
+
+        c0 = high_1 ^ c1 ^ k0;
+        c1 = low_1;
+        c2 = high_0 ^ c3 ^ k1;
+        c3 = low_0;
+    }
+
+    result[0] = c0;
+    result[1] = c1;
+    result[2] = c2;
+    result[3] = c3;
+}
+
+#endif /*PHILOXRANDOMNUMBERGENERATOR_HPP_*/
@@ -0,0 +1,151 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "PopulationGeometryCache.hpp"
+#include "SimulationTime.hpp"
+
+#include <algorithm>
+
+template<unsigned DIM>
+PopulationGeometryCache<DIM>::PopulationGeometryCache()
+    : mpCellPopulation(NULL),
+      mNumNodesWhenBuilt(0),
+      mNumCellsWhenBuilt(0),
+      mBoundaryNodesTimeStep(UNSIGNED_UNSET),
+      mLowerCorner(zero_vector<double>(DIM)),
+      mUpperCorner(zero_vector<double>(DIM)),
+      mBoundingBoxTimeStep(UNSIGNED_UNSET)
+{
+}
+
+template<unsigned DIM>
+bool PopulationGeometryCache<DIM>::BoundaryNodesAreStale(AbstractCellPopulation<DIM>& rCellPopulation)
+{
+    return (&rCellPopulation != mpCellPopulation)
+        || (rCellPopulation.GetNumNodes() != mNumNodesWhenBuilt)
+        || (rCellPopulation.GetNumAllCells() != mNumCellsWhenBuilt)
+        || (SimulationTime::Instance()->GetTimeStepsElapsed() != mBoundaryNodesTimeStep);
+}
+
+template<unsigned DIM>
+void PopulationGeometryCache<DIM>::Update(AbstractCellPopulation<DIM>& rCellPopulation)
+{
+    if (BoundaryNodesAreStale(rCellPopulation))
+    {
+        // Node indices need not be contiguous (for example in a NodesOnlyMesh), so use the node iterator
+        mBoundaryNodeIndices.clear();
+        for (typename AbstractMesh<DIM,DIM>::NodeIterator node_iter = rCellPopulation.rGetMesh().GetNodeIteratorBegin();
+             node_iter != rCellPopulation.rGetMesh().GetNodeIteratorEnd();
+             ++node_iter)
+        {
+            if (node_iter->IsBoundaryNode())
+            {
+                mBoundaryNodeIndices.push_back(node_iter->GetIndex());
+            }
+        }
+        std::sort(mBoundaryNodeIndices.begin(), mBoundaryNodeIndices.end());
+
+        mpCellPopulation = &rCellPopulation;
+        mNumNodesWhenBuilt = rCellPopulation.GetNumNodes();
+        mNumCellsWhenBuilt = rCellPopulation.GetNumAllCells();
+        mBoundaryNodesTimeStep = SimulationTime::Instance()->GetTimeStepsElapsed();
+        mBoundingBoxTimeStep = UNSIGNED_UNSET;
+    }
+}
+
+template<unsigned DIM>
+const std::vector<unsigned>& PopulationGeometryCache<DIM>::rGetBoundaryNodeIndices(AbstractCellPopulation<DIM>& rCellPopulation)
+{
+    Update(rCellPopulation);
+    return mBoundaryNodeIndices;
+}
+
+template<unsigned DIM>
+ChasteCuboid<DIM> PopulationGeometryCache<DIM>::GetBoundingBox(AbstractCellPopulation<DIM>& rCellPopulation)
+{
+    Update(rCellPopulation);
+
+    unsigned time_step = SimulationTime::Instance()->GetTimeStepsElapsed();
+    if (mBoundingBoxTimeStep != time_step)
+    {
+        if (mBoundaryNodeIndices.empty())
+        {
+            ChasteCuboid<DIM> bounds = rCellPopulation.rGetMesh().CalculateBoundingBox();
+            mLowerCorner = bounds.rGetLowerCorner().rGetLocation();
+            mUpperCorner = bounds.rGetUpperCorner().rGetLocation();
+        }
+        else
+        {
+            mLowerCorner = rCellPopulation.GetNode(mBoundaryNodeIndices[0])->rGetLocation();
+            mUpperCorner = mLowerCorner;
+            for (unsigned i=1; i<mBoundaryNodeIndices.size(); i++)
+            {
+                const c_vector<double, DIM>& r_location = rCellPopulation.GetNode(mBoundaryNodeIndices[i])->rGetLocation();
+                for (unsigned dim=0; dim<DIM; dim++)
+                {
+                    mLowerCorner[dim] = std::min(mLowerCorner[dim], r_location[dim]);
+                    mUpperCorner[dim] = std::max(mUpperCorner[dim], r_location[dim]);
+                }
+            }
+        }
+        mBoundingBoxTimeStep = time_step;
+    }
+
+    ChastePoint<DIM> lower(mLowerCorner);
+    ChastePoint<DIM> upper(mUpperCorner);
+    return ChasteCuboid<DIM>(lower, upper);
+}
+
+template<unsigned DIM>
+void PopulationGeometryCache<DIM>::InvalidateBoundingBox()
+{
+    mBoundingBoxTimeStep = UNSIGNED_UNSET;
+}
+
+template<unsigned DIM>
+void PopulationGeometryCache<DIM>::Reset()
+{
+    mpCellPopulation = NULL;
+    mBoundaryNodeIndices.clear();
+    mNumNodesWhenBuilt = 0;
+    mNumCellsWhenBuilt = 0;
+    mBoundaryNodesTimeStep = UNSIGNED_UNSET;
+    mBoundingBoxTimeStep = UNSIGNED_UNSET;
+}
+
+// Explicit instantiation
+template class PopulationGeometryCache<1>;
+template class PopulationGeometryCache<2>;
+template class PopulationGeometryCache<3>;
@@ -0,0 +1,141 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef POPULATIONGEOMETRYCACHE_HPP_
+#define POPULATIONGEOMETRYCACHE_HPP_
+
+#include <vector>
+#include "AbstractCellPopulation.hpp"
+#include "ChasteCuboid.hpp"
+
+/**
+ * A cache of geometric information about a cell population that several boundary
+ * conditions and simulation modifiers need at each time step: the global indices of
+ * its boundary nodes, and its bounding box.
+ *
+ * The cache is per time step. The boundary-node index list is rebuilt when it is first
+ * used in each time step, so that all of the classes sharing the cache pay for one scan
+ * of the nodes per step rather than one each. The mesh gives no notice of a
+ * rearrangement, and a T1 or T2 swap may put an interior node on the boundary without
+ * changing the number of nodes, but rearrangements only take place when the population
+ * is updated between time steps. Within a time step the list is only rebuilt if the
+ * number of nodes or cells changes; call Reset() after changing the mesh in any other
+ * way. The bounding box is found from the boundary nodes alone
+ * (the extreme nodes of a population always lie on its boundary) and is reused for
+ * the rest of the time step, unless InvalidateBoundingBox() is called by a class that
+ * has moved nodes. If the population has no boundary nodes, as in a periodic mesh, the
+ * bounding box of the whole mesh is used instead.
+ *
+ * A single cache may be shared by all of the classes acting on a population, by passing
+ * the same pointer to each. The cache is not archived.
+ */
+template<unsigned DIM>
+class PopulationGeometryCache
+{
+private:
+
+    /** The cell population described by the cache, used to detect a change of population. */
+    const AbstractCellPopulation<DIM>* mpCellPopulation;
+
+    /** The global indices of the boundary nodes of the population, in increasing order. */
+    std::vector<unsigned> mBoundaryNodeIndices;
+
+    /** The number of nodes in the population when mBoundaryNodeIndices was built. */
+    unsigned mNumNodesWhenBuilt;
+
+    /** The number of cells in the population when mBoundaryNodeIndices was built. */
+    unsigned mNumCellsWhenBuilt;
+
+    /** The number of time steps elapsed when mBoundaryNodeIndices was built, or UNSIGNED_UNSET if it is not valid. */
+    unsigned mBoundaryNodesTimeStep;
+
+    /** The lower corner of the cached bounding box. */
+    c_vector<double, DIM> mLowerCorner;
+
+    /** The upper corner of the cached bounding box. */
+    c_vector<double, DIM> mUpperCorner;
+
+    /** The number of time steps elapsed when the bounding box was found, or UNSIGNED_UNSET if it is not valid. */
+    unsigned mBoundingBoxTimeStep;
+
+    /**
+     * @return whether mBoundaryNodeIndices no longer describes the population.
+     *
+     * @param rCellPopulation the cell population
+     */
+    bool BoundaryNodesAreStale(AbstractCellPopulation<DIM>& rCellPopulation);
+
+public:
+
+    /**
+     * Constructor.
+     */
+    PopulationGeometryCache();
+
+    /**
+     * Update the boundary-node index list if it was built in an earlier time step or for a
+     * different number of nodes or cells.
+     *
+     * @param rCellPopulation the cell population
+     */
+    void Update(AbstractCellPopulation<DIM>& rCellPopulation);
+
+    /**
+     * @return the global indices of the boundary nodes of the population, updating them if required.
+     *
+     * @param rCellPopulation the cell population
+     */
+    const std::vector<unsigned>& rGetBoundaryNodeIndices(AbstractCellPopulation<DIM>& rCellPopulation);
+
+    /**
+     * @return the bounding box of the population at the present time step.
+     *
+     * @param rCellPopulation the cell population
+     */
+    ChasteCuboid<DIM> GetBoundingBox(AbstractCellPopulation<DIM>& rCellPopulation);
+
+    /**
+     * Discard the cached bounding box, for use after node locations have been changed
+     * within a time step.
+     */
+    void InvalidateBoundingBox();
+
+    /**
+     * Discard all cached information.
+     */
+    void Reset();
+};
+
+#endif /*POPULATIONGEOMETRYCACHE_HPP_*/
@@ -0,0 +1,200 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "PrescribedStrainRateDeformation.hpp"
+#include "Toroidal2dVertexMesh.hpp"
+#include "Exception.hpp"
+
+/*
+ * The loop over nodes in Apply() has no dependence between iterations, so it is both shared
+ * between threads and vectorised within each thread where OpenMP 4 is available.
+ */
+#if defined(_OPENMP) && (_OPENMP >= 201307)
+#define STRAIN_RATE_PARALLEL_SIMD _Pragma("omp parallel for simd schedule(static)")
+#elif defined(_OPENMP)
+#define STRAIN_RATE_PARALLEL_SIMD _Pragma("omp parallel for schedule(static)")
+#else
+#define STRAIN_RATE_PARALLEL_SIMD
+#endif
+
+template<unsigned DIM>
+PrescribedStrainRateDeformation<DIM>::PrescribedStrainRateDeformation()
+{
+}
+
+template<unsigned DIM>
+void PrescribedStrainRateDeformation<DIM>::AddPinnedRegion(const c_vector<double, DIM>& rLowerCorner, const c_vector<double, DIM>& rUpperCorner)
+{
+    for (unsigned d=0; d<DIM; d++)
+    {
+        mPinnedRegionLowerCorners.push_back(rLowerCorner[d]);
+        mPinnedRegionUpperCorners.push_back(rUpperCorner[d]);
+    }
+}
+
+template<unsigned DIM>
+void PrescribedStrainRateDeformation<DIM>::ClearPinnedRegions()
+{
+    mPinnedRegionLowerCorners.clear();
+    mPinnedRegionUpperCorners.clear();
+}
+
+template<unsigned DIM>
+unsigned PrescribedStrainRateDeformation<DIM>::GetNumPinnedRegions() const
+{
+    return mPinnedRegionLowerCorners.size()/DIM;
+}
+
+template<unsigned DIM>
+void PrescribedStrainRateDeformation<DIM>::Apply(AbstractCellPopulation<DIM,DIM>& rCellPopulation,
+                                                 const c_matrix<double, DIM, DIM>& rStrainRate,
+                                                 const c_vector<double, DIM>& rFixedPoint,
+                                                 double dt)
+{
+    // A periodic box can only be stretched or compressed along its axes
+    Toroidal2dVertexMesh* p_toroidal_mesh = dynamic_cast<Toroidal2dVertexMesh*>(&(rCellPopulation.rGetMesh()));
+    if (p_toroidal_mesh)
+    {
+        for (unsigned i=0; i<DIM; i++)
+        {
+            for (unsigned j=0; j<DIM; j++)
+            {
+                if ((i != j) && (rStrainRate(i,j) != 0.0))
+                {
+                    EXCEPTION("Only a diagonal strain rate may be applied to a Toroidal2dVertexMesh");
+                }
+            }
+        }
+    }
+
+    // Copy the displacement gradient dt*L and the fixed point into plain arrays for the loop below
+    double displacement_gradient[DIM*DIM];
+    double fixed_point[DIM];
+    for (unsigned i=0; i<DIM; i++)
+    {
+        fixed_point[i] = rFixedPoint[i];
+        for (unsigned j=0; j<DIM; j++)
+        {
+            displacement_gradient[DIM*i + j] = dt*rStrainRate(i,j);
+        }
+    }
+
+    // Node indices need not be contiguous (for example in a NodesOnlyMesh), so use the node iterator
+    AbstractMesh<DIM,DIM>& r_mesh = rCellPopulation.rGetMesh();
+    mNodeLocations.clear();
+    mNodeLocations.reserve(DIM*r_mesh.GetNumNodes());
+    for (typename AbstractMesh<DIM,DIM>::NodeIterator node_iter = r_mesh.GetNodeIteratorBegin();
+         node_iter != r_mesh.GetNodeIteratorEnd();
+         ++node_iter)
+    {
+        const c_vector<double, DIM>& r_location = node_iter->rGetLocation();
+        for (unsigned d=0; d<DIM; d++)
+        {
+            mNodeLocations.push_back(r_location[d]);
+        }
+    }
+    unsigned num_nodes = mNodeLocations.size()/DIM;
+
+    if (num_nodes > 0)
+    {
+        double* p_locations = &mNodeLocations[0];
+        unsigned num_pinned_regions = GetNumPinnedRegions();
+        const double* p_lower_corners = (num_pinned_regions > 0) ? &mPinnedRegionLowerCorners[0] : NULL;
+        const double* p_upper_corners = (num_pinned_regions > 0) ? &mPinnedRegionUpperCorners[0] : NULL;
+
+        STRAIN_RATE_PARALLEL_SIMD
+        for (int node_index=0; node_index<(int)num_nodes; node_index++)
+        {
+            double* p_location = p_locations + DIM*node_index;
+
+            // Nodes in a pinned region do not move
+            bool pinned = false;
+            for (unsigned region=0; region<num_pinned_regions; region++)
+            {
+                bool in_region = true;
+                for (unsigned d=0; d<DIM; d++)
+                {
+                    in_region = in_region && (p_location[d] >= p_lower_corners[DIM*region + d])
+                                          && (p_location[d] <= p_upper_corners[DIM*region + d]);
+                }
+                pinned = pinned || in_region;
+            }
+            double weight = pinned ? 0.0 : 1.0;
+
+            double relative_location[DIM];
+            for (unsigned d=0; d<DIM; d++)
+            {
+                relative_location[d] = p_location[d] - fixed_point[d];
+            }
+            for (unsigned i=0; i<DIM; i++)
+            {
+                double displacement = 0.0;
+                for (unsigned j=0; j<DIM; j++)
+                {
+                    displacement += displacement_gradient[DIM*i + j]*relative_location[j];
+                }
+                p_location[i] += weight*displacement;
+            }
+        }
+    }
+
+    // The nodes are visited in the same order as above
+    unsigned num_scattered = 0;
+    for (typename AbstractMesh<DIM,DIM>::NodeIterator node_iter = r_mesh.GetNodeIteratorBegin();
+         node_iter != r_mesh.GetNodeIteratorEnd();
+         ++node_iter)
+    {
+        c_vector<double, DIM>& r_location = node_iter->rGetModifiableLocation();
+        for (unsigned d=0; d<DIM; d++)
+        {
+            r_location[d] = mNodeLocations[DIM*num_scattered + d];
+        }
+        num_scattered++;
+    }
+
+    // Deform the periodic box with the nodes
+    if (p_toroidal_mesh)
+    {
+        for (unsigned d=0; d<DIM; d++)
+        {
+            p_toroidal_mesh->SetWidth(d, p_toroidal_mesh->GetWidth(d)*(1.0 + displacement_gradient[DIM*d + d]));
+        }
+    }
+}
+
+// Explicit instantiation
+template class PrescribedStrainRateDeformation<1>;
+template class PrescribedStrainRateDeformation<2>;
+template class PrescribedStrainRateDeformation<3>;
@@ -0,0 +1,133 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef PRESCRIBEDSTRAINRATEDEFORMATION_HPP_
+#define PRESCRIBEDSTRAINRATEDEFORMATION_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/vector.hpp>
+
+#include <vector>
+#include "AbstractCellPopulation.hpp"
+#include "UblasCustomFunctions.hpp"
+
+/**
+ * Applies a prescribed affine deformation to a cell population over a time step.
+ *
+ * Given a strain-rate tensor (velocity gradient) L and a fixed point x0, each node moves
+ * with velocity L(x - x0), so that over a time step dt its location becomes
+ * x0 + (I + dt L)(x - x0). Nodes in any of a set of axis-aligned pinned regions do not move.
+ * All node locations are updated in a single pass over a contiguous copy of the locations,
+ * which is shared between threads and vectorised where OpenMP is available.
+ *
+ * If the population's mesh is a Toroidal2dVertexMesh, its periodic widths are scaled by the
+ * same deformation, so that the nodes and the periodic box deform consistently; the fixed
+ * point should then be the origin of the box. Only diagonal strain rates are compatible with
+ * a periodic box.
+ *
+ * This class is used by ExtrinsicPullModifier, FollicularEpitheliumStretchModifier,
+ * Toroidal2dVertexMeshStretchModifier and PrescribedStrainRateModifier.
+ */
+template<unsigned DIM>
+class PrescribedStrainRateDeformation
+{
+private:
+
+    /** The lower corner of each pinned region, stored with stride DIM. */
+    std::vector<double> mPinnedRegionLowerCorners;
+
+    /** The upper corner of each pinned region, stored with stride DIM. */
+    std::vector<double> mPinnedRegionUpperCorners;
+
+    /** The node locations, in the order visited by the node iterator and stored with stride DIM. Not archived. */
+    std::vector<double> mNodeLocations;
+
+    friend class boost::serialization::access;
+    /**
+     * Boost Serialization method for archiving/checkpointing.
+     * Archives the object and its member variables.
+     *
+     * @param archive  The boost archive.
+     * @param version  The current version of this class.
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & mPinnedRegionLowerCorners;
+        archive & mPinnedRegionUpperCorners;
+    }
+
+public:
+
+    /**
+     * Constructor.
+     */
+    PrescribedStrainRateDeformation();
+
+    /**
+     * Add a region within which nodes do not move. A node is in the region if each of its
+     * coordinates lies between those of the lower and upper corners, inclusive; use -DBL_MAX
+     * and DBL_MAX for coordinates that are not to be restricted.
+     *
+     * @param rLowerCorner the lower corner of the region
+     * @param rUpperCorner the upper corner of the region
+     */
+    void AddPinnedRegion(const c_vector<double, DIM>& rLowerCorner, const c_vector<double, DIM>& rUpperCorner);
+
+    /**
+     * Remove all pinned regions.
+     */
+    void ClearPinnedRegions();
+
+    /**
+     * @return the number of pinned regions.
+     */
+    unsigned GetNumPinnedRegions() const;
+
+    /**
+     * Deform the cell population over a time step.
+     *
+     * @param rCellPopulation the cell population
+     * @param rStrainRate the strain-rate tensor L
+     * @param rFixedPoint the point x0 that does not move
+     * @param dt the time step
+     */
+    void Apply(AbstractCellPopulation<DIM,DIM>& rCellPopulation,
+               const c_matrix<double, DIM, DIM>& rStrainRate,
+               const c_vector<double, DIM>& rFixedPoint,
+               double dt);
+};
+
+#endif /*PRESCRIBEDSTRAINRATEDEFORMATION_HPP_*/
@@ -0,0 +1,147 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "PrescribedStrainRateModifier.hpp"
+#include "Toroidal2dVertexMesh.hpp"
+
+template<unsigned DIM>
+PrescribedStrainRateModifier<DIM>::PrescribedStrainRateModifier()
+    : AbstractCellBasedSimulationModifier<DIM>(),
+      mStrainRate(DIM*DIM, 0.0),
+      mpGeometryCache(new PopulationGeometryCache<DIM>())
+{
+}
+
+template<unsigned DIM>
+PrescribedStrainRateModifier<DIM>::~PrescribedStrainRateModifier()
+{
+}
+
+template<unsigned DIM>
+void PrescribedStrainRateModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    double dt = SimulationTime::Instance()->GetTimeStep();
+
+    c_vector<double, DIM> fixed_point = zero_vector<double>(DIM);
+    if (!mFixedPoint.empty())
+    {
+        for (unsigned d=0; d<DIM; d++)
+        {
+            fixed_point[d] = mFixedPoint[d];
+        }
+    }
+    else if (dynamic_cast<Toroidal2dVertexMesh*>(&(rCellPopulation.rGetMesh())) == NULL)
+    {
+        fixed_point = mpGeometryCache->GetBoundingBox(rCellPopulation).rGetLowerCorner().rGetLocation();
+    }
+
+    mDeformation.Apply(rCellPopulation, GetStrainRate(), fixed_point, dt);
+
+    // Nodes have moved, so the bounding box must be found again by the next class to use it
+    mpGeometryCache->InvalidateBoundingBox();
+}
+
+template<unsigned DIM>
+void PrescribedStrainRateModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
+{
+}
+
+template<unsigned DIM>
+void PrescribedStrainRateModifier<DIM>::SetStrainRate(const c_matrix<double, DIM, DIM>& rStrainRate)
+{
+    for (unsigned i=0; i<DIM; i++)
+    {
+        for (unsigned j=0; j<DIM; j++)
+        {
+            mStrainRate[DIM*i + j] = rStrainRate(i,j);
+        }
+    }
+}
+
+template<unsigned DIM>
+c_matrix<double, DIM, DIM> PrescribedStrainRateModifier<DIM>::GetStrainRate() const
+{
+    c_matrix<double, DIM, DIM> strain_rate;
+    for (unsigned i=0; i<DIM; i++)
+    {
+        for (unsigned j=0; j<DIM; j++)
+        {
+            strain_rate(i,j) = mStrainRate[DIM*i + j];
+        }
+    }
+    return strain_rate;
+}
+
+template<unsigned DIM>
+void PrescribedStrainRateModifier<DIM>::SetFixedPoint(const c_vector<double, DIM>& rFixedPoint)
+{
+    mFixedPoint.assign(rFixedPoint.begin(), rFixedPoint.end());
+}
+
+template<unsigned DIM>
+void PrescribedStrainRateModifier<DIM>::AddPinnedRegion(const c_vector<double, DIM>& rLowerCorner, const c_vector<double, DIM>& rUpperCorner)
+{
+    mDeformation.AddPinnedRegion(rLowerCorner, rUpperCorner);
+}
+
+template<unsigned DIM>
+void PrescribedStrainRateModifier<DIM>::SetGeometryCache(boost::shared_ptr<PopulationGeometryCache<DIM> > pGeometryCache)
+{
+    mpGeometryCache = pGeometryCache;
+}
+
+template<unsigned DIM>
+void PrescribedStrainRateModifier<DIM>::OutputSimulationModifierParameters(out_stream& rParamsFile)
+{
+    *rParamsFile << "\t\t\t<StrainRate>";
+    for (unsigned i=0; i<DIM*DIM; i++)
+    {
+        *rParamsFile << (i > 0 ? "," : "") << mStrainRate[i];
+    }
+    *rParamsFile << "</StrainRate>\n";
+    *rParamsFile << "\t\t\t<NumPinnedRegions>" << mDeformation.GetNumPinnedRegions() << "</NumPinnedRegions>\n";
+
+    // Next, call method on direct parent class
+    AbstractCellBasedSimulationModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
+}
+
+// Explicit instantiation
+template class PrescribedStrainRateModifier<1>;
+template class PrescribedStrainRateModifier<2>;
+template class PrescribedStrainRateModifier<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(PrescribedStrainRateModifier)
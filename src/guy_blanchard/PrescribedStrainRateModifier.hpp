@@ -0,0 +1,162 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef PRESCRIBEDSTRAINRATEMODIFIER_HPP_
+#define PRESCRIBEDSTRAINRATEMODIFIER_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include "AbstractCellBasedSimulationModifier.hpp"
+#include "PopulationGeometryCache.hpp"
+#include "PrescribedStrainRateDeformation.hpp"
+
+/**
+ * A modifier that deforms the cell population at the end of each time step with a constant,
+ * prescribed strain-rate tensor (see PrescribedStrainRateDeformation), optionally with
+ * regions in which nodes are pinned.
+ *
+ * Unless a fixed point is set, the lower corner of the bounding box of the population is held
+ * fixed, or the origin if the mesh is a Toroidal2dVertexMesh, whose periodic widths are
+ * deformed with the nodes.
+ */
+template<unsigned DIM>
+class PrescribedStrainRateModifier : public AbstractCellBasedSimulationModifier<DIM,DIM>
+{
+private:
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Boost Serialization method for archiving/checkpointing.
+     * Archives the object and its member variables.
+     *
+     * @param archive  The boost archive.
+     * @param version  The current version of this class.
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractCellBasedSimulationModifier<DIM,DIM> >(*this);
+        archive & mStrainRate;
+        archive & mFixedPoint;
+        archive & mDeformation;
+    }
+
+    /** The strain-rate tensor, stored by rows. Defaults to zero. */
+    std::vector<double> mStrainRate;
+
+    /** The point held fixed by the deformation, or empty if it is to be found from the population. */
+    std::vector<double> mFixedPoint;
+
+    /** Applies the deformation and holds the pinned regions. */
+    PrescribedStrainRateDeformation<DIM> mDeformation;
+
+    /** The bounding box of the cell population. Not archived. */
+    boost::shared_ptr<PopulationGeometryCache<DIM> > mpGeometryCache;
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    PrescribedStrainRateModifier();
+
+    /**
+     * Destructor.
+     */
+    virtual ~PrescribedStrainRateModifier();
+
+    /**
+     * Overridden UpdateAtEndOfTimeStep() method.
+     *
+     * Deform the cell population over the time step.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden SetupSolve() method.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     */
+    virtual void SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory);
+
+    /**
+     * @param rStrainRate the strain-rate tensor
+     */
+    void SetStrainRate(const c_matrix<double, DIM, DIM>& rStrainRate);
+
+    /**
+     * @return the strain-rate tensor.
+     */
+    c_matrix<double, DIM, DIM> GetStrainRate() const;
+
+    /**
+     * @param rFixedPoint the point held fixed by the deformation
+     */
+    void SetFixedPoint(const c_vector<double, DIM>& rFixedPoint);
+
+    /**
+     * Add a region within which nodes do not move (see PrescribedStrainRateDeformation::AddPinnedRegion()).
+     *
+     * @param rLowerCorner the lower corner of the region
+     * @param rUpperCorner the upper corner of the region
+     */
+    void AddPinnedRegion(const c_vector<double, DIM>& rLowerCorner, const c_vector<double, DIM>& rUpperCorner);
+
+    /**
+     * Set the geometry cache, so that it may be shared with other classes acting on the same cell population.
+     *
+     * @param pGeometryCache the geometry cache
+     */
+    void SetGeometryCache(boost::shared_ptr<PopulationGeometryCache<DIM> > pGeometryCache);
+
+    /**
+     * Overridden OutputSimulationModifierParameters() method.
+     * Output any simulation modifier parameters to file.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    void OutputSimulationModifierParameters(out_stream& rParamsFile);
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(PrescribedStrainRateModifier)
+
+#endif /*PRESCRIBEDSTRAINRATEMODIFIER_HPP_*/
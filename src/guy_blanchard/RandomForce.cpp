@@ -39,7 +39,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 template<unsigned DIM>
 RandomForce<DIM>::RandomForce(double diffusionConstant)
     : AbstractForce<DIM>(),
-      mDiffusionConstant(diffusionConstant)
+      mDiffusionConstant(diffusionConstant),
+      mUseCounterBasedRandomNumbers(false),
+      mCounterBasedSeed(0)
 {
 }
 
@@ -54,6 +56,18 @@ void RandomForce<DIM>::SetDiffusionConstant(double diffusionConstant)
     mDiffusionConstant = diffusionConstant;
 }
 
+template<unsigned DIM>
+void RandomForce<DIM>::SetUseCounterBasedRandomNumbers(bool useCounterBasedRandomNumbers)
+{
+    mUseCounterBasedRandomNumbers = useCounterBasedRandomNumbers;
+}
+
+template<unsigned DIM>
+void RandomForce<DIM>::SetCounterBasedSeed(unsigned seed)
+{
+    mCounterBasedSeed = seed;
+}
+
 template<unsigned DIM>
 void RandomForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>& rCellPopulation)
 {
@@ -67,18 +81,53 @@ void RandomForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>& rCellPo
     VertexBasedCellPopulation<DIM>* p_cell_population = static_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation);
 
     double dt = SimulationTime::Instance()->GetTimeStep();
+    double noise_scale = sqrt(2.0*mDiffusionConstant/dt);
 
-    // Iterate over vertices in the cell population
-    for (unsigned node_index=0; node_index<p_cell_population->GetNumNodes(); node_index++)
+    if (mUseCounterBasedRandomNumbers)
     {
-        c_vector<double, DIM> force_contribution;
-        for (unsigned i=0; i<DIM; i++)
+        // Find the damping constants serially, then generate the noise for each node independently
+        int num_nodes = (int)p_cell_population->GetNumNodes();
+        std::vector<double> damping_constants(num_nodes);
+        for (int node_index=0; node_index<num_nodes; node_index++)
+        {
+            damping_constants[node_index] = p_cell_population->GetDampingConstant(node_index);
+        }
+
+        PhiloxRandomNumberGenerator generator(mCounterBasedSeed);
+        uint32_t step = SimulationTime::Instance()->GetTimeStepsElapsed();
+
+        // Each iteration only writes to its own node
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int node_index=0; node_index<num_nodes; node_index++)
+        {
+            double xi[4];
+            generator.GetStandardNormalDeviates(step, node_index, xi);
+
+            c_vector<double, DIM> force_contribution;
+            for (unsigned i=0; i<DIM; i++)
+            {
+                force_contribution[i] = damping_constants[node_index]*noise_scale*xi[i];
+            }
+            p_cell_population->GetNode(node_index)->AddAppliedForceContribution(force_contribution);
+        }
+    }
+    else
+    {
+        // Iterate over vertices in the cell population
+        for (unsigned node_index=0; node_index<p_cell_population->GetNumNodes(); node_index++)
         {
             double nu = p_cell_population->GetDampingConstant(node_index);
-            double xi = RandomNumberGenerator::Instance()->StandardNormalRandomDeviate();
-            force_contribution[i] = nu*sqrt(2.0*mDiffusionConstant/dt)*xi;
+
+            c_vector<double, DIM> force_contribution;
+            for (unsigned i=0; i<DIM; i++)
+            {
+                double xi = RandomNumberGenerator::Instance()->StandardNormalRandomDeviate();
+                force_contribution[i] = nu*noise_scale*xi;
+            }
+            rCellPopulation.GetNode(node_index)->AddAppliedForceContribution(force_contribution);
         }
-        rCellPopulation.GetNode(node_index)->AddAppliedForceContribution(force_contribution);
     }
 }
 
@@ -87,6 +136,8 @@ void RandomForce<DIM>::OutputForceParameters(out_stream& rParamsFile)
 {
     // Output member variable then call method on direct parent class
     *rParamsFile << "\t\t\t<DiffusionConstant>" << mDiffusionConstant << "</DiffusionConstant> \n";
+    *rParamsFile << "\t\t\t<UseCounterBasedRandomNumbers>" << mUseCounterBasedRandomNumbers << "</UseCounterBasedRandomNumbers> \n";
+    *rParamsFile << "\t\t\t<CounterBasedSeed>" << mCounterBasedSeed << "</CounterBasedSeed> \n";
 
     AbstractForce<DIM>::OutputForceParameters(rParamsFile);
 }
@@ -41,10 +41,17 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "AbstractForce.hpp"
 #include "RandomNumberGenerator.hpp"
+#include "PhiloxRandomNumberGenerator.hpp"
 
 /**
  * A force class to model the random motion of vertices.
  * For use with a VertexBasedCellPopulation only.
+ *
+ * By default the random forces are drawn serially from the RandomNumberGenerator singleton.
+ * If SetUseCounterBasedRandomNumbers(true) is called, they are instead generated by a
+ * PhiloxRandomNumberGenerator keyed by (seed, time step, node index), in parallel over nodes
+ * when the project is built with OpenMP. The forces are then bitwise reproducible for a given
+ * seed, whatever the number of threads or the order in which nodes are visited.
  */
 template<unsigned DIM>
 class RandomForce : public AbstractForce<DIM>
@@ -54,12 +61,20 @@ private:
     /** Diffusion constant */
     double mDiffusionConstant;
 
+    /** Whether to use counter-based random numbers. Defaults to false. */
+    bool mUseCounterBasedRandomNumbers;
+
+    /** The seed of the counter-based random numbers. Defaults to 0. */
+    unsigned mCounterBasedSeed;
+
     friend class boost::serialization::access;
     template<class Archive>
     void serialize(Archive & archive, const unsigned int version)
     {
         archive & boost::serialization::base_object<AbstractForce<DIM> >(*this);
         archive & mDiffusionConstant;
+        archive & mUseCounterBasedRandomNumbers;
+        archive & mCounterBasedSeed;
     }
 
 public :
@@ -83,6 +98,20 @@ public :
      */
     void SetDiffusionConstant(double diffusionConstant);
 
+    /**
+     * Set mUseCounterBasedRandomNumbers.
+     *
+     * @param useCounterBasedRandomNumbers whether to use counter-based random numbers
+     */
+    void SetUseCounterBasedRandomNumbers(bool useCounterBasedRandomNumbers);
+
+    /**
+     * Set mCounterBasedSeed.
+     *
+     * @param seed the new value of mCounterBasedSeed
+     */
+    void SetCounterBasedSeed(unsigned seed);
+
     /**
      * Overridden AddForceContribution() method.
      *
@@ -2,42 +2,43 @@
 
 template<unsigned DIM>
 SidekickBoundaryCondition<DIM>::SidekickBoundaryCondition(AbstractCellPopulation<DIM>* pCellPopulation)
-    : AbstractCellPopulationBoundaryCondition<DIM>(pCellPopulation)
+    : AbstractIndexedBoundaryCondition<DIM>(pCellPopulation),
+      mpGeometryCache(new PopulationGeometryCache<DIM>())
 {
 }
 
 template<unsigned DIM>
-void SidekickBoundaryCondition<DIM>::ImposeBoundaryCondition(const std::map<Node<DIM>*, c_vector<double, DIM> >& rOldLocations)
+void SidekickBoundaryCondition<DIM>::ImposeIndexedBoundaryCondition(const std::vector<c_vector<double, DIM> >& rOldLocations)
 {
     double epsilon = 0.8;
 
-    ChasteCuboid<DIM> bounds = this->mpCellPopulation->rGetMesh().CalculateBoundingBox();
+    ChasteCuboid<DIM> bounds = mpGeometryCache->GetBoundingBox(*(this->mpCellPopulation));
     double x_min = bounds.rGetLowerCorner()[0];
     double x_max = bounds.rGetUpperCorner()[0];
 
-    // Loop over every node
-    for (unsigned node_index=0; node_index<this->mpCellPopulation->GetNumNodes(); node_index++)
+    // Loop over the boundary nodes only
+    const std::vector<unsigned>& r_boundary_nodes = mpGeometryCache->rGetBoundaryNodeIndices(*(this->mpCellPopulation));
+    for (unsigned i=0; i<r_boundary_nodes.size(); i++)
     {
-        Node<DIM>* p_node = this->mpCellPopulation->GetNode(node_index);
+        Node<DIM>* p_node = this->mpCellPopulation->GetNode(r_boundary_nodes[i]);
+        const c_vector<double, DIM>& r_old_node_location = rOldLocations[p_node->GetIndex()];
 
-        if (p_node->IsBoundaryNode())
+        // If the node lies on the left, then revert its x coordinate
+        if (p_node->rGetLocation()[0] < x_min + epsilon)
         {
-            c_vector<double, DIM> old_node_location;
-            old_node_location = rOldLocations.find(p_node)->second;
-
-            // If the node lies on the left, then revert its x coordinate
-            if (p_node->rGetLocation()[0] < x_min + epsilon)
-            {
-                p_node->rGetModifiableLocation()[0] = old_node_location[0];
-            }
-
-//            // If the node lies on the right, then revert its x coordinate
-//            if (p_node->rGetLocation()[0] > x_max - epsilon)
-//            {
-//                p_node->rGetModifiableLocation()[0] = old_node_location[0];
-//            }
+            p_node->rGetModifiableLocation()[0] = r_old_node_location[0];
         }
-    }}
+
+//        // If the node lies on the right, then revert its x coordinate
+//        if (p_node->rGetLocation()[0] > x_max - epsilon)
+//        {
+//            p_node->rGetModifiableLocation()[0] = r_old_node_location[0];
+//        }
+    }
+
+    // Nodes may have moved, so the bounding box must be found again by the next class to use it
+    mpGeometryCache->InvalidateBoundingBox();
+}
 
 template<unsigned DIM>
 bool SidekickBoundaryCondition<DIM>::VerifyBoundaryCondition()
@@ -50,7 +51,19 @@ bool SidekickBoundaryCondition<DIM>::VerifyBoundaryCondition()
 template<unsigned DIM>
 void SidekickBoundaryCondition<DIM>::OutputCellPopulationBoundaryConditionParameters(out_stream& rParamsFile)
 {
-    AbstractCellPopulationBoundaryCondition<DIM>::OutputCellPopulationBoundaryConditionParameters(rParamsFile);
+    AbstractIndexedBoundaryCondition<DIM>::OutputCellPopulationBoundaryConditionParameters(rParamsFile);
+}
+
+template<unsigned DIM>
+void SidekickBoundaryCondition<DIM>::SetGeometryCache(boost::shared_ptr<PopulationGeometryCache<DIM> > pGeometryCache)
+{
+    mpGeometryCache = pGeometryCache;
+}
+
+template<unsigned DIM>
+boost::shared_ptr<PopulationGeometryCache<DIM> > SidekickBoundaryCondition<DIM>::GetGeometryCache()
+{
+    return mpGeometryCache;
 }
 
 // Explicit instantiation
@@ -1,14 +1,15 @@
 #ifndef SidekickBoundaryCondition_HPP_
 #define SidekickBoundaryCondition_HPP_
 
-#include "AbstractCellPopulationBoundaryCondition.hpp"
+#include "AbstractIndexedBoundaryCondition.hpp"
+#include "PopulationGeometryCache.hpp"
 
 #include "ChasteSerialization.hpp"
 #include <boost/serialization/base_object.hpp>
 #include <boost/serialization/vector.hpp>
 
 template<unsigned DIM>
-class SidekickBoundaryCondition : public AbstractCellPopulationBoundaryCondition<DIM>
+class SidekickBoundaryCondition : public AbstractIndexedBoundaryCondition<DIM>
 {
 private:
 
@@ -23,9 +24,12 @@ private:
     template<class Archive>
     void serialize(Archive & archive, const unsigned int version)
     {
-        archive & boost::serialization::base_object<AbstractCellPopulationBoundaryCondition<DIM> >(*this);
+        archive & boost::serialization::base_object<AbstractIndexedBoundaryCondition<DIM> >(*this);
     }
 
+    /** The boundary nodes and bounding box of the cell population. Not archived. */
+    boost::shared_ptr<PopulationGeometryCache<DIM> > mpGeometryCache;
+
 public:
 
     /**
@@ -36,13 +40,13 @@ public:
     SidekickBoundaryCondition(AbstractCellPopulation<DIM>* pCellPopulation);
 
     /**
-     * Overridden ImposeBoundaryCondition() method.
+     * Overridden ImposeIndexedBoundaryCondition() method.
      *
      * Apply the cell population boundary conditions.
      *
-     * @param rOldLocations the node locations before any boundary conditions are applied
+     * @param rOldLocations the node locations before any boundary conditions are applied, indexed by node index
      */
-    void ImposeBoundaryCondition(const std::map<Node<DIM>*, c_vector<double, DIM> >& rOldLocations);
+    void ImposeIndexedBoundaryCondition(const std::vector<c_vector<double, DIM> >& rOldLocations);
 
     /**
      * Overridden VerifyBoundaryCondition() method.
@@ -60,6 +64,18 @@ public:
      * @param rParamsFile the file stream to which the parameters are output
      */
     void OutputCellPopulationBoundaryConditionParameters(out_stream& rParamsFile);
+
+    /**
+     * Set the geometry cache, so that it may be shared with other classes acting on the same cell population.
+     *
+     * @param pGeometryCache the geometry cache
+     */
+    void SetGeometryCache(boost::shared_ptr<PopulationGeometryCache<DIM> > pGeometryCache);
+
+    /**
+     * @return the geometry cache.
+     */
+    boost::shared_ptr<PopulationGeometryCache<DIM> > GetGeometryCache();
 };
 
 #include "SerializationExportWrapper.hpp"
@@ -36,49 +36,13 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef SIDEKICKFORCE_HPP_
 #define SIDEKICKFORCE_HPP_
 
-#include "ChasteSerialization.hpp"
-#include <boost/serialization/base_object.hpp>
-#include "FarhadifarForce.hpp"
-#include <iostream>
+#include "StripeLineTensionForce.hpp"
 
+/**
+ * The line tension used in the Sidekick simulations, which is that of BlanchardForce
+ * without combined interfaces. See StripeLineTensionForce.
+ */
 template<unsigned DIM>
-class SidekickForce: public FarhadifarForce<DIM>
-{
-private:
-
-    double mHomotypicLineTensionParameter;
-    double mHeterotypicLineTensionParameter;
-    double mSupercontractileLineTensionParameter;
-    unsigned mNumStripes;
-
-    friend class boost::serialization::access;
-    template<class Archive>
-    void serialize(Archive & archive, const unsigned int version)
-    {
-        archive & boost::serialization::base_object<FarhadifarForce<DIM> >(*this);
-        archive & mHomotypicLineTensionParameter;
-        archive & mHeterotypicLineTensionParameter;
-        archive & mSupercontractileLineTensionParameter;
-        archive & mNumStripes;
-    }
-
-public:
-
-    SidekickForce();
-
-    ~SidekickForce()
-    {}
-
-    double GetLineTensionParameter(Node<DIM>* pNodeA, Node<DIM>* pNodeB, VertexBasedCellPopulation<DIM>& rVertexCellPopulation);
-
-    void SetHomotypicLineTensionParameter(double homotypicLineTensionParameter);
-    void SetHeterotypicLineTensionParameter(double heterotypicLineTensionParameter);
-    void SetSupercontractileLineTensionParameter(double supercontractileLineTensionParameter);
-    void SetNumStripes(unsigned numStripes);
-    void OutputForceParameters(out_stream& rParamsFile);
-};
-
-#include "SerializationExportWrapper.hpp"
-EXPORT_TEMPLATE_CLASS_SAME_DIMS(SidekickForce)
+using SidekickForce = StripeLineTensionForce<DIM, ConstantStripeLineTension>;
 
 #endif /*SIDEKICKFORCE_HPP_*/
@@ -6,7 +6,7 @@ SlidingBoundaryCondition::SlidingBoundaryCondition(AbstractCellPopulation<2,2>*
                                                    double yMin,
                                                    double xMax,
                                                    double yMax)
-    : AbstractCellPopulationBoundaryCondition<2,2>(pCellPopulation),
+    : AbstractIndexedBoundaryCondition<2,2>(pCellPopulation),
       mXMin(xMin),
       mYMin(yMin),
       mXMax(xMax),
@@ -14,7 +14,7 @@ SlidingBoundaryCondition::SlidingBoundaryCondition(AbstractCellPopulation<2,2>*
 {
 }
 
-void SlidingBoundaryCondition::ImposeBoundaryCondition(const std::map<Node<2>*, c_vector<double, 2> >& rOldLocations)
+void SlidingBoundaryCondition::ImposeIndexedBoundaryCondition(const std::vector<c_vector<double, 2> >& rOldLocations)
 {
     double epsilon = 1e-1;
 
@@ -25,19 +25,18 @@ void SlidingBoundaryCondition::ImposeBoundaryCondition(const std::map<Node<2>*,
 
         if (p_node->IsBoundaryNode())
         {
-            c_vector<double, 2> old_node_location;
-            old_node_location = rOldLocations.find(p_node)->second;
+            const c_vector<double, 2>& r_old_node_location = rOldLocations[p_node->GetIndex()];
 
             // If the node lies on the top or bottom boundary, then revert its y coordinate
             if ((fabs(p_node->rGetLocation()[1] - mYMin) < epsilon) || (fabs(p_node->rGetLocation()[1] - mYMax) < epsilon))
             {
-                p_node->rGetModifiableLocation()[1] = old_node_location[1];
+                p_node->rGetModifiableLocation()[1] = r_old_node_location[1];
             }
 
             // If the node lies on the left or right boundary, then revert its x coordinate
             if ((p_node->rGetLocation()[0] - mXMin < 0.5+epsilon) || (p_node->rGetLocation()[0] - mXMax > -(0.5+epsilon)))
             {
-                p_node->rGetModifiableLocation()[0] = old_node_location[0];
+                p_node->rGetModifiableLocation()[0] = r_old_node_location[0];
             }
         }
     }
@@ -56,7 +55,7 @@ void SlidingBoundaryCondition::OutputCellPopulationBoundaryConditionParameters(o
     *rParamsFile << "\t\t\t<YMax>" << mYMax << "</YMax>\n";
 
     // Call method on direct parent class
-    AbstractCellPopulationBoundaryCondition<2,2>::OutputCellPopulationBoundaryConditionParameters(rParamsFile);
+    AbstractIndexedBoundaryCondition<2,2>::OutputCellPopulationBoundaryConditionParameters(rParamsFile);
 }
 
 // Serialization for Boost >= 1.36
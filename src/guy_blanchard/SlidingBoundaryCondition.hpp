@@ -2,12 +2,12 @@
 #ifndef SLIDINGBOUNDARYCONDITION_HPP_
 #define SLIDINGBOUNDARYCONDITION_HPP_
 
-#include "AbstractCellPopulationBoundaryCondition.hpp"
+#include "AbstractIndexedBoundaryCondition.hpp"
 
 #include "ChasteSerialization.hpp"
 #include <boost/serialization/base_object.hpp>
 
-class SlidingBoundaryCondition : public AbstractCellPopulationBoundaryCondition<2,2>
+class SlidingBoundaryCondition : public AbstractIndexedBoundaryCondition<2,2>
 {
 private:
 
@@ -27,7 +27,7 @@ private:
     template<class Archive>
     void serialize(Archive & archive, const unsigned int version)
     {
-        archive & boost::serialization::base_object<AbstractCellPopulationBoundaryCondition<2,2> >(*this);
+        archive & boost::serialization::base_object<AbstractIndexedBoundaryCondition<2,2> >(*this);
         archive & mXMin;
         archive & mYMin;
         archive & mXMax;
@@ -42,7 +42,7 @@ public:
                              double xMax=DOUBLE_UNSET,
                              double yMax=DOUBLE_UNSET);
 
-    void ImposeBoundaryCondition(const std::map<Node<2>*, c_vector<double, 2> >& rOldLocations);
+    void ImposeIndexedBoundaryCondition(const std::vector<c_vector<double, 2> >& rOldLocations);
 
     bool VerifyBoundaryCondition();
     void OutputCellPopulationBoundaryConditionParameters(out_stream& rParamsFile);
@@ -1,10 +1,32 @@
 
 #include "StretchTrackingModifier.hpp"
 #include "VertexBasedCellPopulation.hpp"
+#include "Exception.hpp"
+
+#include <algorithm>
+
+/**
+ * Order points by their first coordinate, then by their second.
+ */
+template<unsigned DIM>
+bool ComparePointsLexicographically(const c_vector<double, DIM>& rA, const c_vector<double, DIM>& rB)
+{
+    return (rA[0] < rB[0]) || ((rA[0] == rB[0]) && (rA[1] < rB[1]));
+}
+
+/**
+ * @return the z component of the cross product of (rA - rO) and (rB - rO), for points in 2D.
+ */
+template<unsigned DIM>
+double CrossProductAboutPoint(const c_vector<double, DIM>& rO, const c_vector<double, DIM>& rA, const c_vector<double, DIM>& rB)
+{
+    return (rA[0] - rO[0])*(rB[1] - rO[1]) - (rA[1] - rO[1])*(rB[0] - rO[0]);
+}
 
 template<unsigned DIM>
 StretchTrackingModifier<DIM>::StretchTrackingModifier()
-    : AbstractCellBasedSimulationModifier<DIM>()
+    : AbstractCellBasedSimulationModifier<DIM>(),
+      mUpdateInterval(1)
 {
 }
 
@@ -16,7 +38,10 @@ StretchTrackingModifier<DIM>::~StretchTrackingModifier()
 template<unsigned DIM>
 void StretchTrackingModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
 {
-    UpdateCellData(rCellPopulation);
+    if (SimulationTime::Instance()->GetTimeStepsElapsed() % mUpdateInterval == 0)
+    {
+        UpdateCellData(rCellPopulation);
+    }
 }
 
 template<unsigned DIM>
@@ -28,41 +53,139 @@ void StretchTrackingModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& r
 template<unsigned DIM>
 void StretchTrackingModifier<DIM>::UpdateCellData(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
 {
-	VertexBasedCellPopulation<DIM>* p_cell_population = static_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation);
+    VertexBasedCellPopulation<DIM>* p_cell_population = static_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation);
+    MutableVertexMesh<DIM, DIM>& r_mesh = p_cell_population->rGetMesh();
 
-    // Iterate over cell population
+    // Gather the cells and their elements, so that the diameters may be computed in parallel
+    std::vector<CellPtr> cells;
+    std::vector<VertexElement<DIM, DIM>*> elements;
     for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = p_cell_population->Begin();
          cell_iter != p_cell_population->End();
          ++cell_iter)
     {
-    	double stretch = 0.0;
-
-        // Get the element corresponding to this cell
-    	VertexElement<DIM, DIM>* p_element = p_cell_population->GetElementCorrespondingToCell(*cell_iter);
-
-    	for (unsigned i=0; i<p_element->GetNumNodes()-1; i++)
-    	{
-    		c_vector<double, DIM> location_i = p_element->GetNode(i)->rGetLocation();
-    		for (unsigned j=i+1; j<p_element->GetNumNodes(); j++)
-    		{
-    			c_vector<double, DIM> location_j = p_element->GetNode(j)->rGetLocation();
-    			double distance = norm_2(p_cell_population->rGetMesh().GetVectorFromAtoB(location_i,location_j));
-    			if (distance > stretch)
-    			{
-    				stretch = distance;
-    			}
-    		}
-    	}
-
-        // Store the cell's volume in CellData
-        cell_iter->GetCellData()->SetItem("stretch", stretch);
+        cells.push_back(*cell_iter);
+        elements.push_back(p_cell_population->GetElementCorrespondingToCell(*cell_iter));
+    }
+
+    std::vector<double> stretches(cells.size());
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int i=0; i<(int)cells.size(); i++)
+    {
+        VertexElement<DIM, DIM>* p_element = elements[i];
+        unsigned num_nodes = p_element->GetNumNodes();
+
+        // Place the vertices relative to the first, so that elements crossing a periodic boundary are not split
+        std::vector<c_vector<double, DIM> > points(num_nodes);
+        const c_vector<double, DIM>& r_first_location = p_element->GetNode(0)->rGetLocation();
+        points[0] = r_first_location;
+        for (unsigned j=1; j<num_nodes; j++)
+        {
+            points[j] = r_first_location + r_mesh.GetVectorFromAtoB(r_first_location, p_element->GetNode(j)->rGetLocation());
+        }
+
+        stretches[i] = CalculateDiameter(points);
+    }
+
+    // Store each cell's diameter in CellData
+    for (unsigned i=0; i<cells.size(); i++)
+    {
+        cells[i]->GetCellData()->SetItem("stretch", stretches[i]);
+    }
+}
+
+template<unsigned DIM>
+double StretchTrackingModifier<DIM>::CalculateDiameter(std::vector<c_vector<double, DIM> >& rPoints)
+{
+    unsigned num_points = rPoints.size();
+    if (num_points < 2)
+    {
+        return 0.0;
+    }
+
+    if (DIM != 2)
+    {
+        // Compare every pair of points
+        double diameter = 0.0;
+        for (unsigned i=0; i<num_points-1; i++)
+        {
+            for (unsigned j=i+1; j<num_points; j++)
+            {
+                diameter = std::max(diameter, norm_2(rPoints[j] - rPoints[i]));
+            }
+        }
+        return diameter;
+    }
+
+    // Find the convex hull by Andrew's monotone chain algorithm, in anticlockwise order
+    std::sort(rPoints.begin(), rPoints.end(), ComparePointsLexicographically<DIM>);
+    std::vector<c_vector<double, DIM> > hull(2*num_points);
+    unsigned hull_size = 0;
+    for (unsigned i=0; i<num_points; i++)
+    {
+        while ((hull_size >= 2) && (CrossProductAboutPoint<DIM>(hull[hull_size-2], hull[hull_size-1], rPoints[i]) <= 0.0))
+        {
+            hull_size--;
+        }
+        hull[hull_size++] = rPoints[i];
+    }
+    unsigned lower_hull_size = hull_size + 1;
+    for (unsigned i=num_points-1; i>0; i--)
+    {
+        while ((hull_size >= lower_hull_size) && (CrossProductAboutPoint<DIM>(hull[hull_size-2], hull[hull_size-1], rPoints[i-1]) <= 0.0))
+        {
+            hull_size--;
+        }
+        hull[hull_size++] = rPoints[i-1];
+    }
+    hull_size--; // the first point is repeated at the end
+
+    // All points coincide or are collinear, so the diameter joins the extreme points
+    if (hull_size < 3)
+    {
+        return norm_2(rPoints[num_points-1] - rPoints[0]);
+    }
+
+    // Rotating calipers: for each hull edge, advance to the vertex furthest from it
+    double diameter = 0.0;
+    unsigned j = 1;
+    for (unsigned i=0; i<hull_size; i++)
+    {
+        unsigned next_i = (i+1)%hull_size;
+        while (CrossProductAboutPoint<DIM>(hull[i], hull[next_i], hull[(j+1)%hull_size])
+               > CrossProductAboutPoint<DIM>(hull[i], hull[next_i], hull[j]))
+        {
+            j = (j+1)%hull_size;
+        }
+        diameter = std::max(diameter, std::max(norm_2(hull[j] - hull[i]), norm_2(hull[j] - hull[next_i])));
     }
+    return diameter;
+}
+
+template<unsigned DIM>
+void StretchTrackingModifier<DIM>::SetUpdateInterval(unsigned updateInterval)
+{
+    if (updateInterval == 0)
+    {
+        EXCEPTION("The update interval of a StretchTrackingModifier must be positive");
+    }
+    mUpdateInterval = updateInterval;
+}
+
+template<unsigned DIM>
+unsigned StretchTrackingModifier<DIM>::GetUpdateInterval() const
+{
+    return mUpdateInterval;
 }
 
 template<unsigned DIM>
 void StretchTrackingModifier<DIM>::OutputSimulationModifierParameters(out_stream& rParamsFile)
 {
-    // No parameters to output, so just call method on direct parent class
+    *rParamsFile << "\t\t\t<UpdateInterval>" << mUpdateInterval << "</UpdateInterval>\n";
+
+    // Next, call method on direct parent class
     AbstractCellBasedSimulationModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
 }
 
@@ -7,6 +7,12 @@
 
 #include "AbstractCellBasedSimulationModifier.hpp"
 
+#include <vector>
+
+/**
+ * A modifier that stores the diameter of each cell (the largest distance between two of its
+ * vertices) in CellData as "stretch", for use by StretchBasedCellCycleModel.
+ */
 template<unsigned DIM>
 class StretchTrackingModifier : public AbstractCellBasedSimulationModifier<DIM,DIM>
 {
@@ -15,8 +21,12 @@ class StretchTrackingModifier : public AbstractCellBasedSimulationModifier<DIM,D
     void serialize(Archive & archive, const unsigned int version)
     {
         archive & boost::serialization::base_object<AbstractCellBasedSimulationModifier<DIM,DIM> >(*this);
+        archive & mUpdateInterval;
     }
 
+    /** The number of time steps between updates of the cell data. Defaults to 1. */
+    unsigned mUpdateInterval;
+
 public:
 
     StretchTrackingModifier();
@@ -25,6 +35,26 @@ public:
     virtual void SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory);
     void UpdateCellData(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
     void OutputSimulationModifierParameters(out_stream& rParamsFile);
+
+    /**
+     * Set mUpdateInterval, so that "stretch" is recomputed only every updateInterval time steps.
+     *
+     * @param updateInterval the new value of mUpdateInterval
+     */
+    void SetUpdateInterval(unsigned updateInterval);
+
+    /**
+     * @return mUpdateInterval
+     */
+    unsigned GetUpdateInterval() const;
+
+    /**
+     * @return the largest distance between any two of a set of points. In 2D this is found from
+     * the convex hull of the points by rotating calipers, in O(k log k) time for k points.
+     *
+     * @param rPoints the points (reordered by this method)
+     */
+    static double CalculateDiameter(std::vector<c_vector<double, DIM> >& rPoints);
 };
 
 #include "SerializationExportWrapper.hpp"
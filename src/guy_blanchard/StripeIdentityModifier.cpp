@@ -0,0 +1,169 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "StripeIdentityModifier.hpp"
+#include "VertexBasedCellPopulation.hpp"
+#include "SimulationTime.hpp"
+#include <limits>
+
+template<unsigned DIM>
+StripeIdentityModifier<DIM>::StripeIdentityModifier()
+    : AbstractCellBasedSimulationModifier<DIM>(),
+      mNumCells(UNSIGNED_UNSET),
+      mNumLocations(UNSIGNED_UNSET),
+      mCellIdSum(0),
+      mCheckedTimeStep(UNSIGNED_UNSET)
+{
+}
+
+template<unsigned DIM>
+StripeIdentityModifier<DIM>::~StripeIdentityModifier()
+{
+}
+
+template<unsigned DIM>
+void StripeIdentityModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    // Cells are born and removed when the population is next updated, so check the array again after that
+    mCheckedTimeStep = UNSIGNED_UNSET;
+}
+
+template<unsigned DIM>
+void StripeIdentityModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
+{
+    UpdateStripeIdentities(rCellPopulation);
+}
+
+template<unsigned DIM>
+unsigned StripeIdentityModifier<DIM>::GetNumLocations(AbstractCellPopulation<DIM,DIM>& rCellPopulation) const
+{
+    // For vertex-based populations, cells are located at elements rather than nodes
+    if (bool(dynamic_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation)))
+    {
+        return static_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation)->rGetMesh().GetNumAllElements();
+    }
+    return rCellPopulation.rGetMesh().GetNumAllNodes();
+}
+
+template<unsigned DIM>
+void StripeIdentityModifier<DIM>::UpdateStripeIdentities(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    mNumCells = 0;
+    mNumLocations = GetNumLocations(rCellPopulation);
+    mCellIdSum = 0;
+
+    mStripeIdentities.assign(mNumLocations, 0);
+    for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
+         cell_iter != rCellPopulation.End();
+         ++cell_iter)
+    {
+        unsigned location_index = rCellPopulation.GetLocationIndexUsingCell(*cell_iter);
+        double stripe_identity = cell_iter->GetCellData()->GetItem("stripe");
+        if ((stripe_identity < 0) || (stripe_identity > std::numeric_limits<uint16_t>::max()))
+        {
+            EXCEPTION("Stripe identities must lie between 0 and " << std::numeric_limits<uint16_t>::max());
+        }
+        if (location_index >= mStripeIdentities.size())
+        {
+            mStripeIdentities.resize(location_index + 1, 0);
+        }
+        mStripeIdentities[location_index] = (uint16_t) stripe_identity;
+
+        mNumCells++;
+        mCellIdSum += cell_iter->GetCellId();
+    }
+}
+
+template<unsigned DIM>
+const std::vector<uint16_t>& StripeIdentityModifier<DIM>::rGetStripeIdentities(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    // Within a time step of a simulation the topology cannot change once the array has been checked
+    SimulationTime* p_simulation_time = SimulationTime::Instance();
+    bool is_in_simulation = p_simulation_time->IsEndTimeAndNumberOfTimeStepsSetUp();
+    if (is_in_simulation && (mCheckedTimeStep == p_simulation_time->GetTimeStepsElapsed()))
+    {
+        return mStripeIdentities;
+    }
+
+    // Compute the population's signature without looking up any cell's location or CellData
+    unsigned num_cells = 0;
+    unsigned long cell_id_sum = 0;
+    for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
+         cell_iter != rCellPopulation.End();
+         ++cell_iter)
+    {
+        num_cells++;
+        cell_id_sum += cell_iter->GetCellId();
+    }
+
+    unsigned num_locations = GetNumLocations(rCellPopulation);
+    if ((num_cells != mNumCells) || (num_locations != mNumLocations) || (cell_id_sum != mCellIdSum))
+    {
+        UpdateStripeIdentities(rCellPopulation);
+    }
+#ifndef NDEBUG
+    else
+    {
+        // Stripe identities must not change during Solve() without a call to UpdateStripeIdentities()
+        for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
+             cell_iter != rCellPopulation.End();
+             ++cell_iter)
+        {
+            unsigned location_index = rCellPopulation.GetLocationIndexUsingCell(*cell_iter);
+            assert(mStripeIdentities[location_index] == cell_iter->GetCellData()->GetItem("stripe"));
+        }
+    }
+#endif // NDEBUG
+
+    // Outside a simulation there is no time step to tie the check to, so it is made on every call
+    mCheckedTimeStep = is_in_simulation ? p_simulation_time->GetTimeStepsElapsed() : UNSIGNED_UNSET;
+    return mStripeIdentities;
+}
+
+template<unsigned DIM>
+void StripeIdentityModifier<DIM>::OutputSimulationModifierParameters(out_stream& rParamsFile)
+{
+    // No parameters to output, so just call method on direct parent class
+    AbstractCellBasedSimulationModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
+}
+
+// Explicit instantiation
+template class StripeIdentityModifier<1>;
+template class StripeIdentityModifier<2>;
+template class StripeIdentityModifier<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(StripeIdentityModifier)
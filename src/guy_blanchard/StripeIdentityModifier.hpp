@@ -0,0 +1,182 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef STRIPEIDENTITYMODIFIER_HPP_
+#define STRIPEIDENTITYMODIFIER_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+#include <stdint.h>
+#include <vector>
+
+#include "AbstractCellBasedSimulationModifier.hpp"
+
+/**
+ * A modifier class that maintains a dense array of the stripe identity (the CellData
+ * item "stripe") of each cell, indexed by location index. Forces that look up stripe
+ * identities for every edge at every time step, such as StripeLineTensionForce, can
+ * read this array instead of searching each cell's CellData.
+ *
+ * The array is rebuilt only when the population's topology may have changed: when the
+ * number of cells or locations, or the sum of the cell IDs, differs from when it was last
+ * built (this catches divisions and removals, including both in one time step, and the
+ * re-indexing of elements that follows a removal). T1 swaps do not change the location
+ * index of any cell, so do not require a rebuild.
+ *
+ * During a simulation, cells are only born and removed when the population is updated at
+ * the start of a time step, so this check is made once per time step: on the first call to
+ * rGetStripeIdentities() after UpdateAtEndOfTimeStep(), or after the time step changes.
+ * Later calls in the same time step return the array without visiting any cell. Outside a
+ * simulation the check is made on every call.
+ *
+ * Stripe identities are treated as fixed during a call to Solve(): the signature above does
+ * not look at any cell's CellData, since that is the lookup this class exists to avoid.
+ * Daughter cells inherit the stripe identity of their parent, so division is safe. The
+ * array is rebuilt at the start of every call to Solve(), so stripe identities may be
+ * reassigned between calls to Solve(); if they are changed in any other way (for example
+ * by another modifier), UpdateStripeIdentities() must be called afterwards. Debug builds
+ * check that the array agrees with the cells' CellData whenever the check above finds that
+ * it may be reused.
+ */
+template<unsigned DIM>
+class StripeIdentityModifier : public AbstractCellBasedSimulationModifier<DIM,DIM>
+{
+private:
+
+    /** Stripe identity of the cell at each location index. Not archived. */
+    std::vector<uint16_t> mStripeIdentities;
+
+    /** Number of cells in the population when mStripeIdentities was last built. */
+    unsigned mNumCells;
+
+    /** Number of locations in the population when mStripeIdentities was last built (see GetNumLocations()). */
+    unsigned mNumLocations;
+
+    /** Sum of the IDs of the cells in the population when mStripeIdentities was last built. */
+    unsigned long mCellIdSum;
+
+    /**
+     * Number of time steps elapsed when mStripeIdentities was last checked against the population,
+     * or UNSIGNED_UNSET if it must be checked on the next call to rGetStripeIdentities(). Not archived.
+     */
+    unsigned mCheckedTimeStep;
+
+    friend class boost::serialization::access;
+    /**
+     * Boost Serialization method for archiving/checkpointing.
+     * Archives the object and its member variables.
+     *
+     * @param archive  The boost archive.
+     * @param version  The current version of this class.
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractCellBasedSimulationModifier<DIM,DIM> >(*this);
+    }
+
+    /**
+     * Get the number of location indices that a cell in the population may have: the number of
+     * elements, including deleted ones, for a vertex-based population, and otherwise the number
+     * of nodes, including deleted ones. Location indices are not contiguous once elements or
+     * nodes have been deleted, so the array is sized by this rather than by the number of cells.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @return the size of the array of stripe identities.
+     */
+    unsigned GetNumLocations(AbstractCellPopulation<DIM,DIM>& rCellPopulation) const;
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    StripeIdentityModifier();
+
+    /**
+     * Destructor.
+     */
+    virtual ~StripeIdentityModifier();
+
+    /**
+     * Overridden UpdateAtEndOfTimeStep() method.
+     *
+     * Mark the array of stripe identities to be checked against the population on the next call
+     * to rGetStripeIdentities(), which follows any births and removals in the next time step.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden SetupSolve() method.
+     *
+     * Rebuild the array of stripe identities.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     */
+    virtual void SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory);
+
+    /**
+     * Rebuild the array of stripe identities from the cells' CellData.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    void UpdateStripeIdentities(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Get the array of stripe identities, first rebuilding it if the topology of the
+     * population has changed since it was last built. During a simulation this is only
+     * checked on the first call in each time step.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @return the stripe identity of the cell at each location index.
+     */
+    const std::vector<uint16_t>& rGetStripeIdentities(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden OutputSimulationModifierParameters() method.
+     * Output any simulation modifier parameters to file.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    void OutputSimulationModifierParameters(out_stream& rParamsFile);
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(StripeIdentityModifier)
+
+#endif /*STRIPEIDENTITYMODIFIER_HPP_*/
@@ -0,0 +1,216 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "StripeInterfaceTable.hpp"
+#include <algorithm>
+
+template<unsigned DIM>
+StripeInterfaceTable<DIM>::StripeInterfaceTable()
+    : mpStripeIdentities(NULL)
+{
+}
+
+template<unsigned DIM>
+unsigned StripeInterfaceTable<DIM>::GetStripeIdentity(unsigned elemIndex, VertexBasedCellPopulation<DIM>& rVertexCellPopulation)
+{
+    if (mpStripeIdentities)
+    {
+        return (*mpStripeIdentities)[elemIndex];
+    }
+    if (mStripeIdentities[elemIndex] == UNSIGNED_UNSET)
+    {
+        mStripeIdentities[elemIndex] = rVertexCellPopulation.GetCellUsingLocationIndex(elemIndex)->GetCellData()->GetItem("stripe");
+    }
+    return mStripeIdentities[elemIndex];
+}
+
+template<unsigned DIM>
+void StripeInterfaceTable<DIM>::Build(VertexBasedCellPopulation<DIM>& rVertexCellPopulation,
+                                      unsigned numStripes,
+                                      bool useCombinedInterfaces,
+                                      bool useDistinctStripeMismatches,
+                                      const std::vector<uint16_t>* pStripeIdentities)
+{
+    MutableVertexMesh<DIM,DIM>& r_mesh = rVertexCellPopulation.rGetMesh();
+    mEdgeTable.Build(r_mesh);
+
+    // Without a dense array, each cell's stripe identity is looked up at most once, when first needed
+    mpStripeIdentities = pStripeIdentities;
+    if (mpStripeIdentities)
+    {
+        if (mpStripeIdentities->size() < r_mesh.GetNumAllElements())
+        {
+            EXCEPTION("The array of stripe identities has fewer entries than the mesh has elements");
+        }
+    }
+    else
+    {
+        mStripeIdentities.assign(r_mesh.GetNumAllElements(), UNSIGNED_UNSET);
+    }
+
+    unsigned num_edges = mEdgeTable.GetNumEdges();
+    mMismatchClasses.resize(num_edges);
+    mEdgeLengths.assign(num_edges, 0.0);
+    mScaleFactors.assign(num_edges, 1.0);
+    mEdgeKeys.assign(num_edges, 0);
+
+    for (unsigned edge_index=0; edge_index<num_edges; edge_index++)
+    {
+        // Edges contained in a single element lie on the boundary and do not belong to any combined interface
+        if (mEdgeTable.GetNumElementsContainingEdge(edge_index) == 1)
+        {
+            mMismatchClasses[edge_index] = UNSIGNED_UNSET;
+            continue;
+        }
+
+        /*
+         * Edges with a boundary node are treated as boundary edges. They may still form part of a
+         * combined interface, in which case the stripe identities on either side are needed.
+         */
+        Node<DIM>* p_node_a = r_mesh.GetNode(mEdgeTable.GetEdgeNodeIndex(edge_index, 0));
+        Node<DIM>* p_node_b = r_mesh.GetNode(mEdgeTable.GetEdgeNodeIndex(edge_index, 1));
+        bool has_boundary_node = p_node_a->IsBoundaryNode() || p_node_b->IsBoundaryNode();
+        if (has_boundary_node && !useCombinedInterfaces)
+        {
+            mMismatchClasses[edge_index] = UNSIGNED_UNSET;
+            continue;
+        }
+
+        unsigned cell_1_stripe_identity = GetStripeIdentity(mEdgeTable.GetEdgeElementIndex(edge_index, 0), rVertexCellPopulation);
+        unsigned cell_2_stripe_identity = GetStripeIdentity(mEdgeTable.GetEdgeElementIndex(edge_index, 1), rVertexCellPopulation);
+
+        unsigned mismatch = 0;
+        if (cell_1_stripe_identity != cell_2_stripe_identity)
+        {
+            // Label numbers wrap around, so check to find smallest difference in stripe identities
+            mismatch = abs(cell_1_stripe_identity - cell_2_stripe_identity);
+            if (mismatch > numStripes/2)
+            {
+                mismatch = numStripes - mismatch;
+            }
+
+            mEdgeLengths[edge_index] = r_mesh.GetDistanceBetweenNodes(mEdgeTable.GetEdgeNodeIndex(edge_index, 0),
+                                                                      mEdgeTable.GetEdgeNodeIndex(edge_index, 1));
+
+            // Edges with the same non-zero key are part of the same combined interface when adjacent
+            if (useDistinctStripeMismatches)
+            {
+                unsigned lower = std::min(cell_1_stripe_identity, cell_2_stripe_identity);
+                unsigned upper = std::max(cell_1_stripe_identity, cell_2_stripe_identity);
+                assert(upper < 65536);
+                mEdgeKeys[edge_index] = 1 + (lower << 16) + upper;
+            }
+            else
+            {
+                mEdgeKeys[edge_index] = 1;
+            }
+        }
+        mMismatchClasses[edge_index] = has_boundary_node ? UNSIGNED_UNSET : mismatch;
+    }
+
+    if (useCombinedInterfaces)
+    {
+        mEdgeTable.ComputeRunLengths(mEdgeKeys, mEdgeLengths, mSlotRunLengths);
+
+        for (unsigned edge_index=0; edge_index<num_edges; edge_index++)
+        {
+            unsigned mismatch = mMismatchClasses[edge_index];
+            if ((mismatch != 0) && (mismatch != UNSIGNED_UNSET))
+            {
+                double interface_length_in_cell_1 = mSlotRunLengths[mEdgeTable.GetEdgeSlot(edge_index, 0)];
+                double interface_length_in_cell_2 = mSlotRunLengths[mEdgeTable.GetEdgeSlot(edge_index, 1)];
+                assert(interface_length_in_cell_1 > 0);
+                assert(interface_length_in_cell_2 > 0);
+
+                // Scale by the reciprocal of the shorter of the two combined interfaces
+                mScaleFactors[edge_index] = 1.0/std::min(interface_length_in_cell_1, interface_length_in_cell_2);
+            }
+        }
+    }
+}
+
+template<unsigned DIM>
+void StripeInterfaceTable<DIM>::Clear()
+{
+    mEdgeTable.Clear();
+    mpStripeIdentities = NULL;
+}
+
+template<unsigned DIM>
+bool StripeInterfaceTable<DIM>::IsBuilt() const
+{
+    return mEdgeTable.IsBuilt();
+}
+
+template<unsigned DIM>
+const VertexMeshEdgeTable<DIM>& StripeInterfaceTable<DIM>::rGetEdgeTable() const
+{
+    return mEdgeTable;
+}
+
+template<unsigned DIM>
+unsigned StripeInterfaceTable<DIM>::GetNumEdges() const
+{
+    return mEdgeTable.GetNumEdges();
+}
+
+template<unsigned DIM>
+unsigned StripeInterfaceTable<DIM>::GetEdgeIndex(unsigned nodeAIndex, unsigned nodeBIndex) const
+{
+    return mEdgeTable.GetEdgeIndex(nodeAIndex, nodeBIndex);
+}
+
+template<unsigned DIM>
+unsigned StripeInterfaceTable<DIM>::GetMismatchClass(unsigned edgeIndex) const
+{
+    return mMismatchClasses[edgeIndex];
+}
+
+template<unsigned DIM>
+double StripeInterfaceTable<DIM>::GetEdgeLength(unsigned edgeIndex) const
+{
+    return mEdgeLengths[edgeIndex];
+}
+
+template<unsigned DIM>
+double StripeInterfaceTable<DIM>::GetCombinedInterfaceScaleFactor(unsigned edgeIndex) const
+{
+    return mScaleFactors[edgeIndex];
+}
+
+// Explicit instantiation
+template class StripeInterfaceTable<1>;
+template class StripeInterfaceTable<2>;
+template class StripeInterfaceTable<3>;
@@ -0,0 +1,169 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef STRIPEINTERFACETABLE_HPP_
+#define STRIPEINTERFACETABLE_HPP_
+
+#include <stdint.h>
+#include <vector>
+#include "VertexBasedCellPopulation.hpp"
+#include "VertexMeshEdgeTable.hpp"
+
+/**
+ * A per-time-step table describing the interfaces between cell stripes in a vertex-based
+ * cell population, for use by forces whose line tension depends on 'stripe identity'
+ * (a value stored in each cell's CellData property as the item "stripe").
+ *
+ * For each unique edge of the mesh the table stores its mismatch class (0 for an edge
+ * within a stripe, otherwise the wrapped difference between the stripe identities on
+ * either side, or UNSIGNED_UNSET for boundary edges) and, if requested, the scale factor
+ * used when line tension depends on combined interfaces.
+ *
+ * The combined interfaces are found in a single sweep around each element: the perimeter
+ * is split into maximal runs of consecutive edges that qualify (any stripe mismatch, or
+ * the same pair of stripe identities if distinct stripe mismatches are used), and each
+ * edge is assigned the total length of its run. The scale factor of an edge is then the
+ * reciprocal of the shorter of its two run lengths. A run may cover a whole perimeter, in
+ * which case its length is that of the perimeter.
+ */
+template<unsigned DIM>
+class StripeInterfaceTable
+{
+private:
+
+    /** Table of the unique edges of the mesh. */
+    VertexMeshEdgeTable<DIM> mEdgeTable;
+
+    /** Stripe identity of each element's cell, or UNSIGNED_UNSET if not yet looked up. */
+    std::vector<unsigned> mStripeIdentities;
+
+    /** Dense array of stripe identities indexed by element, if supplied to Build(); otherwise NULL. */
+    const std::vector<uint16_t>* mpStripeIdentities;
+
+    /** Mismatch class of each edge. */
+    std::vector<unsigned> mMismatchClasses;
+
+    /** Length of each edge; only computed for edges between cells with different stripe identities. */
+    std::vector<double> mEdgeLengths;
+
+    /** Combined interface scale factor of each edge (1.0 unless combined interfaces are used). */
+    std::vector<double> mScaleFactors;
+
+    /** Work space: key of each edge used to segment element perimeters into combined interfaces. */
+    std::vector<unsigned> mEdgeKeys;
+
+    /** Work space: length of the combined interface containing each element slot. */
+    std::vector<double> mSlotRunLengths;
+
+    /**
+     * Get the stripe identity of the cell corresponding to a given element, from the dense array
+     * supplied to Build() if there is one, otherwise from the cell's CellData (at most once per cell).
+     *
+     * @param elemIndex index of the element
+     * @param rVertexCellPopulation reference to the cell population
+     * @return the stripe identity.
+     */
+    unsigned GetStripeIdentity(unsigned elemIndex, VertexBasedCellPopulation<DIM>& rVertexCellPopulation);
+
+public:
+
+    /**
+     * Constructor.
+     */
+    StripeInterfaceTable();
+
+    /**
+     * Build the table for the current state of a cell population.
+     *
+     * @param rVertexCellPopulation reference to the cell population
+     * @param numStripes the number of distinct stripe identities (used to wrap mismatches)
+     * @param useCombinedInterfaces whether to compute combined interface scale factors
+     * @param useDistinctStripeMismatches whether combined interfaces are restricted to a single pair of stripe identities
+     * @param pStripeIdentities optional dense array of the stripe identity of each element's cell (see StripeIdentityModifier)
+     */
+    void Build(VertexBasedCellPopulation<DIM>& rVertexCellPopulation,
+               unsigned numStripes,
+               bool useCombinedInterfaces,
+               bool useDistinctStripeMismatches,
+               const std::vector<uint16_t>* pStripeIdentities=NULL);
+
+    /**
+     * Discard the contents of the table.
+     */
+    void Clear();
+
+    /**
+     * @return whether the table currently describes a cell population.
+     */
+    bool IsBuilt() const;
+
+    /**
+     * @return the underlying edge table.
+     */
+    const VertexMeshEdgeTable<DIM>& rGetEdgeTable() const;
+
+    /**
+     * @return the number of unique edges in the table.
+     */
+    unsigned GetNumEdges() const;
+
+    /**
+     * @param nodeAIndex global index of one node
+     * @param nodeBIndex global index of the other node
+     *
+     * @return the index of the edge between the nodes, or UNSIGNED_UNSET if there is none.
+     */
+    unsigned GetEdgeIndex(unsigned nodeAIndex, unsigned nodeBIndex) const;
+
+    /**
+     * @param edgeIndex index of an edge
+     * @return the mismatch class of the edge.
+     */
+    unsigned GetMismatchClass(unsigned edgeIndex) const;
+
+    /**
+     * @param edgeIndex index of an edge between cells with different stripe identities
+     * @return the length of the edge.
+     */
+    double GetEdgeLength(unsigned edgeIndex) const;
+
+    /**
+     * @param edgeIndex index of an edge
+     * @return the combined interface scale factor of the edge.
+     */
+    double GetCombinedInterfaceScaleFactor(unsigned edgeIndex) const;
+};
+
+#endif /*STRIPEINTERFACETABLE_HPP_*/
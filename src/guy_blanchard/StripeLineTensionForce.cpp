@@ -0,0 +1,396 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "StripeLineTensionForce.hpp"
+#include "SimulationTime.hpp"
+#include <algorithm>
+
+template<unsigned DIM, class MISMATCH_POLICY>
+StripeLineTensionForce<DIM, MISMATCH_POLICY>::StripeLineTensionForce()
+    : ParallelFarhadifarForce<DIM>(),
+      mHomotypicLineTensionParameter(1.0),
+      mHeterotypicLineTensionParameter(1.0),
+      mSupercontractileLineTensionParameter(1.0),
+      mNumStripes(4),
+      mUseCombinedInterfacesForLineTension(false),
+      mUseDistinctStripeMismatchesForCombinedInterfaces(false),
+      mpInterfaceTablePopulation(NULL),
+      mInterfaceTableTimeStep(UNSIGNED_UNSET),
+      mUseEdgeBasedAssembly(false)
+{
+}
+
+template<unsigned DIM, class MISMATCH_POLICY>
+void StripeLineTensionForce<DIM, MISMATCH_POLICY>::AddForceContribution(AbstractCellPopulation<DIM>& rCellPopulation)
+{
+    if (!mUseEdgeBasedAssembly)
+    {
+        ParallelFarhadifarForce<DIM>::AddForceContribution(rCellPopulation);
+        return;
+    }
+
+    // Throw an exception message if not using a VertexBasedCellPopulation
+    if (dynamic_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation) == NULL)
+    {
+        EXCEPTION("StripeLineTensionForce is to be used with a VertexBasedCellPopulation only");
+    }
+    VertexBasedCellPopulation<DIM>* p_cell_population = static_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation);
+
+    this->ComputeElementGeometry(*p_cell_population);
+    BuildEdgeLineTensionTable(*p_cell_population);
+    AddEdgeBasedForceContribution(*p_cell_population);
+}
+
+template<unsigned DIM, class MISMATCH_POLICY>
+void StripeLineTensionForce<DIM, MISMATCH_POLICY>::AddEdgeBasedForceContribution(VertexBasedCellPopulation<DIM>& rVertexCellPopulation)
+{
+    const VertexMeshEdgeTable<DIM>& r_edge_table = mInterfaceTable.rGetEdgeTable();
+    const VertexGeometrySnapshot<DIM>& r_geometry = this->mGeometry;
+    int num_nodes = (int)rVertexCellPopulation.GetNumNodes();
+    int num_edges = (int)r_edge_table.GetNumEdges();
+    unsigned num_threads = this->GetNumThreadsInUse();
+
+    double area_elasticity_parameter = this->GetAreaElasticityParameterInUse();
+    double perimeter_contractility_parameter = this->GetPerimeterContractilityParameterInUse();
+
+    /*
+     * The energy of an edge of length l is c*l, where c is the sum over the elements containing
+     * the edge of the per-visit line tension plus the perimeter contractility parameter times the
+     * element perimeter. The force on the lower-indexed node is c times the unit vector towards
+     * the other node, and the force on the other node is its negative.
+     */
+    mEdgeForceX.resize(num_edges);
+    mEdgeForceY.resize(num_edges);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+#endif
+    for (int edge_index=0; edge_index<num_edges; edge_index++)
+    {
+        unsigned num_containing_elements = r_edge_table.GetNumElementsContainingEdge(edge_index);
+        double coefficient = num_containing_elements*mEdgeLineTensions[edge_index];
+        for (unsigned i=0; i<num_containing_elements; i++)
+        {
+            coefficient += perimeter_contractility_parameter*r_geometry.GetElementPerimeter(r_edge_table.GetEdgeElementIndex(edge_index, i));
+        }
+
+        // The unit vector of the edge is read from one of its element slots, which may run in either direction
+        unsigned slot = r_edge_table.GetEdgeSlot(edge_index, 0);
+        if (r_geometry.GetSlotNode(slot) != r_edge_table.GetEdgeNodeIndex(edge_index, 0))
+        {
+            coefficient = -coefficient;
+        }
+        mEdgeForceX[edge_index] = coefficient*r_geometry.GetEdgeUnitX(slot);
+        mEdgeForceY[edge_index] = coefficient*r_geometry.GetEdgeUnitY(slot);
+    }
+
+    // Iterate over vertices in the cell population; each iteration only writes to its own node
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+#endif
+    for (int node_index=0; node_index<num_nodes; node_index++)
+    {
+        double force_x = 0.0;
+        double force_y = 0.0;
+
+        // Add the force contribution from the area elasticity of each element containing this node (note the minus sign)
+        unsigned num_node_slots = r_geometry.GetNumNodeSlots(node_index);
+        for (unsigned i=0; i<num_node_slots; i++)
+        {
+            unsigned slot = r_geometry.GetNodeSlot(node_index, i);
+            unsigned elem_index = r_geometry.GetSlotElement(slot);
+            double area_coefficient = -area_elasticity_parameter*(r_geometry.GetElementArea(elem_index) - this->mTargetAreas[elem_index]);
+            force_x += area_coefficient*r_geometry.GetAreaGradientX(slot);
+            force_y += area_coefficient*r_geometry.GetAreaGradientY(slot);
+        }
+
+        // Gather the line tension and perimeter contractility forces from the edges incident on this node
+        unsigned num_node_edges = r_edge_table.GetNumNodeEdges(node_index);
+        for (unsigned i=0; i<num_node_edges; i++)
+        {
+            unsigned edge_index = r_edge_table.GetNodeEdge(node_index, i);
+            if (r_edge_table.GetEdgeNodeIndex(edge_index, 0) == (unsigned)node_index)
+            {
+                force_x += mEdgeForceX[edge_index];
+                force_y += mEdgeForceY[edge_index];
+            }
+            else
+            {
+                force_x -= mEdgeForceX[edge_index];
+                force_y -= mEdgeForceY[edge_index];
+            }
+        }
+
+        c_vector<double, DIM> force_on_node = zero_vector<double>(DIM);
+        force_on_node[0] = force_x;
+        if (DIM > 1)
+        {
+            force_on_node[1] = force_y;
+        }
+        rVertexCellPopulation.GetNode(node_index)->AddAppliedForceContribution(force_on_node);
+    }
+}
+
+template<unsigned DIM, class MISMATCH_POLICY>
+void StripeLineTensionForce<DIM, MISMATCH_POLICY>::ComputeSlotLineTensions(VertexBasedCellPopulation<DIM>& rVertexCellPopulation)
+{
+    // Resolve the line tension of every edge once, then copy it to both element slots of the edge
+    BuildEdgeLineTensionTable(rVertexCellPopulation);
+    const VertexMeshEdgeTable<DIM>& r_edge_table = mInterfaceTable.rGetEdgeTable();
+
+    // The edge table and the geometry snapshot number the slots of the mesh in the same way
+    unsigned num_slots = r_edge_table.GetNumSlots();
+    assert(num_slots == this->mGeometry.GetNumSlots());
+    this->mSlotLineTensions.resize(num_slots);
+    for (unsigned slot=0; slot<num_slots; slot++)
+    {
+        this->mSlotLineTensions[slot] = mEdgeLineTensions[r_edge_table.GetSlotEdge(slot)];
+    }
+}
+
+template<unsigned DIM, class MISMATCH_POLICY>
+void StripeLineTensionForce<DIM, MISMATCH_POLICY>::BuildInterfaceTable(VertexBasedCellPopulation<DIM>& rVertexCellPopulation)
+{
+    const std::vector<uint16_t>* p_stripe_identities = NULL;
+    if (mpStripeIdentityModifier)
+    {
+        p_stripe_identities = &(mpStripeIdentityModifier->rGetStripeIdentities(rVertexCellPopulation));
+    }
+
+    mInterfaceTable.Build(rVertexCellPopulation,
+                          mNumStripes,
+                          mUseCombinedInterfacesForLineTension,
+                          mUseDistinctStripeMismatchesForCombinedInterfaces,
+                          p_stripe_identities);
+
+    // Outside a simulation there is no time step to tie the table to, so it is never reused
+    mpInterfaceTablePopulation = &rVertexCellPopulation;
+    mInterfaceTableTimeStep = UNSIGNED_UNSET;
+    if (SimulationTime::Instance()->IsEndTimeAndNumberOfTimeStepsSetUp())
+    {
+        mInterfaceTableTimeStep = SimulationTime::Instance()->GetTimeStepsElapsed();
+    }
+}
+
+template<unsigned DIM, class MISMATCH_POLICY>
+bool StripeLineTensionForce<DIM, MISMATCH_POLICY>::IsInterfaceTableCurrent(const VertexBasedCellPopulation<DIM>& rVertexCellPopulation) const
+{
+    return mInterfaceTable.IsBuilt()
+        && (mpInterfaceTablePopulation == &rVertexCellPopulation)
+        && (mInterfaceTableTimeStep != UNSIGNED_UNSET)
+        && SimulationTime::Instance()->IsEndTimeAndNumberOfTimeStepsSetUp()
+        && (SimulationTime::Instance()->GetTimeStepsElapsed() == mInterfaceTableTimeStep);
+}
+
+template<unsigned DIM, class MISMATCH_POLICY>
+void StripeLineTensionForce<DIM, MISMATCH_POLICY>::BuildEdgeLineTensionTable(VertexBasedCellPopulation<DIM>& rVertexCellPopulation)
+{
+    BuildInterfaceTable(rVertexCellPopulation);
+
+    if (mUseCombinedInterfacesForLineTension)
+    {
+        ResolveEdgeLineTensions<true>();
+    }
+    else
+    {
+        ResolveEdgeLineTensions<false>();
+    }
+}
+
+template<unsigned DIM, class MISMATCH_POLICY>
+void StripeLineTensionForce<DIM, MISMATCH_POLICY>::GetLineTensionByClass(double* pLineTensionByClass) const
+{
+    /*
+     * The factor of 0.5 arises because each internal interface is visited twice in our iteration.
+     * Note: To 'turn off' super-contractility, we simply set mSupercontractileLineTensionParameter
+     * to equal mHeterotypicLineTensionParameter.
+     */
+    pLineTensionByClass[HOMOTYPIC_EDGE] = 0.5*mHomotypicLineTensionParameter;
+    pLineTensionByClass[HETEROTYPIC_EDGE] = 0.5*mHeterotypicLineTensionParameter;
+    pLineTensionByClass[SUPERCONTRACTILE_EDGE] = 0.5*mSupercontractileLineTensionParameter;
+    pLineTensionByClass[BOUNDARY_EDGE] = this->mBoundaryLineTensionParameter;
+}
+
+template<unsigned DIM, class MISMATCH_POLICY>
+template<bool USE_COMBINED_INTERFACES>
+double StripeLineTensionForce<DIM, MISMATCH_POLICY>::ResolveEdgeLineTension(unsigned edgeIndex, const double* pLineTensionByClass) const
+{
+    // Edges on the boundary, or with a boundary node, are boundary edges; otherwise classify by stripe mismatch
+    unsigned mismatch = mInterfaceTable.GetMismatchClass(edgeIndex);
+    unsigned edge_class = (mismatch == UNSIGNED_UNSET) ? BOUNDARY_EDGE : std::min(mismatch, (unsigned)SUPERCONTRACTILE_EDGE);
+
+    double line_tension = pLineTensionByClass[edge_class];
+    if ((edge_class == HETEROTYPIC_EDGE) || (edge_class == SUPERCONTRACTILE_EDGE))
+    {
+        if (MISMATCH_POLICY::IsLengthNormalised(edge_class))
+        {
+            line_tension /= mInterfaceTable.GetEdgeLength(edgeIndex);
+        }
+        if (USE_COMBINED_INTERFACES)
+        {
+            line_tension *= mInterfaceTable.GetCombinedInterfaceScaleFactor(edgeIndex);
+        }
+    }
+    return line_tension;
+}
+
+template<unsigned DIM, class MISMATCH_POLICY>
+template<bool USE_COMBINED_INTERFACES>
+void StripeLineTensionForce<DIM, MISMATCH_POLICY>::ResolveEdgeLineTensions()
+{
+    double line_tension_by_class[NUM_STRIPE_EDGE_CLASSES];
+    GetLineTensionByClass(line_tension_by_class);
+
+    unsigned num_edges = mInterfaceTable.GetNumEdges();
+    mEdgeLineTensions.resize(num_edges);
+    for (unsigned edge_index=0; edge_index<num_edges; edge_index++)
+    {
+        mEdgeLineTensions[edge_index] = ResolveEdgeLineTension<USE_COMBINED_INTERFACES>(edge_index, line_tension_by_class);
+    }
+}
+
+template<unsigned DIM, class MISMATCH_POLICY>
+double StripeLineTensionForce<DIM, MISMATCH_POLICY>::GetLineTensionParameter(Node<DIM>* pNodeA,
+                                                                             Node<DIM>* pNodeB,
+                                                                             VertexBasedCellPopulation<DIM>& rVertexCellPopulation)
+{
+    // Reuse the table from this time step's force assembly if there is one
+    if (!IsInterfaceTableCurrent(rVertexCellPopulation))
+    {
+        BuildInterfaceTable(rVertexCellPopulation);
+    }
+
+    unsigned edge_index = mInterfaceTable.GetEdgeIndex(pNodeA->GetIndex(), pNodeB->GetIndex());
+    assert(edge_index != UNSIGNED_UNSET);
+
+    // Resolve the line tension from the current parameters, so that the table need not be rebuilt when they change
+    double line_tension_by_class[NUM_STRIPE_EDGE_CLASSES];
+    GetLineTensionByClass(line_tension_by_class);
+    if (mUseCombinedInterfacesForLineTension)
+    {
+        return ResolveEdgeLineTension<true>(edge_index, line_tension_by_class);
+    }
+    return ResolveEdgeLineTension<false>(edge_index, line_tension_by_class);
+}
+
+template<unsigned DIM, class MISMATCH_POLICY>
+void StripeLineTensionForce<DIM, MISMATCH_POLICY>::SetHomotypicLineTensionParameter(double homotypicLineTensionParameter)
+{
+    mHomotypicLineTensionParameter = homotypicLineTensionParameter;
+    this->InvalidateSlotLineTensions();
+}
+
+template<unsigned DIM, class MISMATCH_POLICY>
+void StripeLineTensionForce<DIM, MISMATCH_POLICY>::SetHeterotypicLineTensionParameter(double heterotypicLineTensionParameter)
+{
+    mHeterotypicLineTensionParameter = heterotypicLineTensionParameter;
+    this->InvalidateSlotLineTensions();
+}
+
+template<unsigned DIM, class MISMATCH_POLICY>
+void StripeLineTensionForce<DIM, MISMATCH_POLICY>::SetSupercontractileLineTensionParameter(double supercontractileLineTensionParameter)
+{
+    mSupercontractileLineTensionParameter = supercontractileLineTensionParameter;
+    this->InvalidateSlotLineTensions();
+}
+
+template<unsigned DIM, class MISMATCH_POLICY>
+void StripeLineTensionForce<DIM, MISMATCH_POLICY>::SetNumStripes(unsigned numStripes)
+{
+    mNumStripes = numStripes;
+    mInterfaceTableTimeStep = UNSIGNED_UNSET;
+    this->InvalidateSlotLineTensions();
+}
+
+template<unsigned DIM, class MISMATCH_POLICY>
+void StripeLineTensionForce<DIM, MISMATCH_POLICY>::SetUseCombinedInterfacesForLineTension(bool useCombinedInterfaceLineTension)
+{
+    mUseCombinedInterfacesForLineTension = useCombinedInterfaceLineTension;
+    mInterfaceTableTimeStep = UNSIGNED_UNSET;
+    this->InvalidateSlotLineTensions();
+}
+
+template<unsigned DIM, class MISMATCH_POLICY>
+void StripeLineTensionForce<DIM, MISMATCH_POLICY>::SetUseDistinctStripeMismatchesForCombinedInterfaces(bool useDistinctStripeMismatchesForCombinedInterfaces)
+{
+    mUseDistinctStripeMismatchesForCombinedInterfaces = useDistinctStripeMismatchesForCombinedInterfaces;
+    mInterfaceTableTimeStep = UNSIGNED_UNSET;
+    this->InvalidateSlotLineTensions();
+}
+
+template<unsigned DIM, class MISMATCH_POLICY>
+void StripeLineTensionForce<DIM, MISMATCH_POLICY>::SetUseEdgeBasedAssembly(bool useEdgeBasedAssembly)
+{
+    mUseEdgeBasedAssembly = useEdgeBasedAssembly;
+}
+
+template<unsigned DIM, class MISMATCH_POLICY>
+void StripeLineTensionForce<DIM, MISMATCH_POLICY>::SetStripeIdentityModifier(boost::shared_ptr<StripeIdentityModifier<DIM> > pStripeIdentityModifier)
+{
+    mpStripeIdentityModifier = pStripeIdentityModifier;
+    mInterfaceTableTimeStep = UNSIGNED_UNSET;
+    this->InvalidateSlotLineTensions();
+}
+
+template<unsigned DIM, class MISMATCH_POLICY>
+void StripeLineTensionForce<DIM, MISMATCH_POLICY>::OutputForceParameters(out_stream& rParamsFile)
+{
+    // Output member variables then call method on direct parent class
+    *rParamsFile << "\t\t\t<HomotypicLineTensionParameter>" << mHomotypicLineTensionParameter << "</HomotypicLineTensionParameter> \n";
+    *rParamsFile << "\t\t\t<HeterotypicLineTensionParameter>" << mHeterotypicLineTensionParameter << "</HeterotypicLineTensionParameter> \n";
+    *rParamsFile << "\t\t\t<SupercontractileLineTensionParameter>" << mSupercontractileLineTensionParameter << "</SupercontractileLineTensionParameter> \n";
+    *rParamsFile << "\t\t\t<NumStripes>" << mNumStripes << "</NumStripes> \n";
+    *rParamsFile << "\t\t\t<UseCombinedInterfacesForLineTension>" << mUseCombinedInterfacesForLineTension << "</UseCombinedInterfacesForLineTension> \n";
+    *rParamsFile << "\t\t\t<UseDistinctStripeMismatchesForCombinedInterfaces>" << mUseDistinctStripeMismatchesForCombinedInterfaces << "</UseDistinctStripeMismatchesForCombinedInterfaces> \n";
+    *rParamsFile << "\t\t\t<UseEdgeBasedAssembly>" << mUseEdgeBasedAssembly << "</UseEdgeBasedAssembly> \n";
+
+    ParallelFarhadifarForce<DIM>::OutputForceParameters(rParamsFile);
+}
+
+// Explicit instantiation
+template class StripeLineTensionForce<1, ConstantStripeLineTension>;
+template class StripeLineTensionForce<2, ConstantStripeLineTension>;
+template class StripeLineTensionForce<3, ConstantStripeLineTension>;
+template class StripeLineTensionForce<1, LengthNormalisedStripeLineTension>;
+template class StripeLineTensionForce<2, LengthNormalisedStripeLineTension>;
+template class StripeLineTensionForce<3, LengthNormalisedStripeLineTension>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS2(StripeLineTensionForce, 1, ConstantStripeLineTension)
+EXPORT_TEMPLATE_CLASS2(StripeLineTensionForce, 2, ConstantStripeLineTension)
+EXPORT_TEMPLATE_CLASS2(StripeLineTensionForce, 3, ConstantStripeLineTension)
+EXPORT_TEMPLATE_CLASS2(StripeLineTensionForce, 1, LengthNormalisedStripeLineTension)
+EXPORT_TEMPLATE_CLASS2(StripeLineTensionForce, 2, LengthNormalisedStripeLineTension)
+EXPORT_TEMPLATE_CLASS2(StripeLineTensionForce, 3, LengthNormalisedStripeLineTension)
@@ -0,0 +1,398 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef STRIPELINETENSIONFORCE_HPP_
+#define STRIPELINETENSIONFORCE_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+#include <boost/serialization/shared_ptr.hpp>
+#include "ParallelFarhadifarForce.hpp"
+#include "StripeInterfaceTable.hpp"
+#include "StripeIdentityModifier.hpp"
+#include <iostream>
+
+/**
+ * Classes of edge used to index the line tension table of a StripeLineTensionForce.
+ */
+typedef enum StripeEdgeClass_
+{
+    HOMOTYPIC_EDGE = 0,
+    HETEROTYPIC_EDGE = 1,
+    SUPERCONTRACTILE_EDGE = 2,
+    BOUNDARY_EDGE = 3,
+    NUM_STRIPE_EDGE_CLASSES = 4
+} StripeEdgeClass;
+
+/**
+ * Mismatch policy for StripeLineTensionForce under which the line tension of an edge
+ * depends only on its class (used by BlanchardForce, SidekickForce and scenarios 1, 3 and 4).
+ */
+struct ConstantStripeLineTension
+{
+    /**
+     * @param edgeClass the class of an edge
+     * @return whether the line tension of edges of this class is divided by their length.
+     */
+    static constexpr bool IsLengthNormalised(unsigned edgeClass)
+    {
+        return false;
+    }
+};
+
+/**
+ * Mismatch policy for StripeLineTensionForce under which the line tension of heterotypic and
+ * supercontractile edges is inversely proportional to their length (used by scenario 2).
+ */
+struct LengthNormalisedStripeLineTension
+{
+    /**
+     * @param edgeClass the class of an edge
+     * @return whether the line tension of edges of this class is divided by their length.
+     */
+    static constexpr bool IsLengthNormalised(unsigned edgeClass)
+    {
+        return (edgeClass == HETEROTYPIC_EDGE) || (edgeClass == SUPERCONTRACTILE_EDGE);
+    }
+};
+
+/**
+ * A force class for use in vertex-based simulations. This force is based on the
+ * energy function proposed by Farhadifar et al (Curr. Biol., 2007, 17, 2095-2104)
+ * with the following modifications:
+ *
+ * 1. We allow for the line tension parameter to take distinct values for cell-cell
+ * interfaces between cells whose 'stripe identities' are the same, or differ by one,
+ * or differ by two, or for 'boundary' interfaces. (Here, stripe identity is a value
+ * from 1 to mNumStripes, which is stored in each cell's CellData property as the item "stripe".)
+ *
+ * 2. Optionally, the line tension of an edge between different stripes is scaled by the
+ * reciprocal of the length of the shorter of the two 'combined interfaces' containing it
+ * (see StripeInterfaceTable).
+ *
+ * How the line tension of an edge depends on its class is fixed at compile time by the
+ * MISMATCH_POLICY template parameter (ConstantStripeLineTension or LengthNormalisedStripeLineTension).
+ *
+ * The class of every edge is found once per time step and copied to the element slots
+ * used by the (thread-parallel) assembly in ParallelFarhadifarForce.
+ * If a StripeIdentityModifier is supplied using SetStripeIdentityModifier(), stripe identities
+ * are read from its dense array rather than from each cell's CellData.
+ */
+template<unsigned DIM, class MISMATCH_POLICY>
+class StripeLineTensionForce : public ParallelFarhadifarForce<DIM>
+{
+private:
+
+    /**
+     * Line tension parameter for edges shared by two cells with the same stripe identity.
+     * Defaults to 1.0.
+     */
+    double mHomotypicLineTensionParameter;
+
+    /**
+     * Line tension parameter for edges shared by two cells whose stripes identities differ by one.
+     * Defaults to 1.0.
+     */
+    double mHeterotypicLineTensionParameter;
+
+    /**
+     * Line tension parameter for edges shared by two cells whose stripes identities differ by two.
+     * Defaults to 1.0.
+     */
+    double mSupercontractileLineTensionParameter;
+
+    /**
+     * The number of distinct cell stripes present in the population.
+     * Defaults to 4.
+     */
+    unsigned mNumStripes;
+
+    /**
+     * Whether to have the line tension parameter dependent on the total lengths of 'boundary interfaces'
+     * experienced by a cell.
+     * Defaults to false.
+     */
+    bool mUseCombinedInterfacesForLineTension;
+
+    /**
+     * Whether combined interfaces are restricted to edges between the same pair of stripe
+     * identities, rather than to edges between any two different stripe identities.
+     * Only used if mUseCombinedInterfacesForLineTension is true.
+     * Defaults to false.
+     */
+    bool mUseDistinctStripeMismatchesForCombinedInterfaces;
+
+    /**
+     * Table of the stripe interfaces of the population, built once per time step by the
+     * force assembly and kept so that GetLineTensionParameter() can reuse it. Not archived.
+     */
+    StripeInterfaceTable<DIM> mInterfaceTable;
+
+    /** The cell population described by mInterfaceTable, or NULL if it has not been built. Not archived. */
+    const VertexBasedCellPopulation<DIM>* mpInterfaceTablePopulation;
+
+    /**
+     * The number of time steps elapsed when mInterfaceTable was built, or UNSIGNED_UNSET if it
+     * was built outside a simulation or has been invalidated by a change of parameters. Not archived.
+     */
+    unsigned mInterfaceTableTimeStep;
+
+    /** Line tension parameter of each edge in mInterfaceTable. */
+    std::vector<double> mEdgeLineTensions;
+
+    /**
+     * Whether to assemble the line tension and perimeter contractility forces by visiting
+     * each edge once, rather than each (node, element) pair. Defaults to false.
+     */
+    bool mUseEdgeBasedAssembly;
+
+    /**
+     * Work space holding, for each edge in mInterfaceTable, the x component of the line tension
+     * and perimeter contractility force that it exerts on its lower-indexed node.
+     */
+    std::vector<double> mEdgeForceX;
+
+    /** As mEdgeForceX, for the y component. */
+    std::vector<double> mEdgeForceY;
+
+    /** Optional modifier maintaining a dense array of stripe identities. */
+    boost::shared_ptr<StripeIdentityModifier<DIM> > mpStripeIdentityModifier;
+
+    friend class boost::serialization::access;
+    /**
+     * Boost Serialization method for archiving/checkpointing.
+     * Archives the object and its member variables.
+     *
+     * @param archive  The boost archive.
+     * @param version  The current version of this class.
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<ParallelFarhadifarForce<DIM> >(*this);
+        archive & mHomotypicLineTensionParameter;
+        archive & mHeterotypicLineTensionParameter;
+        archive & mSupercontractileLineTensionParameter;
+        archive & mNumStripes;
+        archive & mUseCombinedInterfacesForLineTension;
+        archive & mUseDistinctStripeMismatchesForCombinedInterfaces;
+        archive & mUseEdgeBasedAssembly;
+        archive & mpStripeIdentityModifier;
+    }
+
+    /**
+     * Build mInterfaceTable for the current state of a cell population and record when it was built.
+     *
+     * @param rVertexCellPopulation reference to the cell population
+     */
+    void BuildInterfaceTable(VertexBasedCellPopulation<DIM>& rVertexCellPopulation);
+
+    /**
+     * Whether mInterfaceTable describes a cell population at the current time step. The mesh
+     * topology only changes when the population is updated at the start of each time step, so
+     * a table built by the force assembly remains valid until the next time step.
+     *
+     * @param rVertexCellPopulation reference to the cell population
+     * @return whether mInterfaceTable may be reused.
+     */
+    bool IsInterfaceTableCurrent(const VertexBasedCellPopulation<DIM>& rVertexCellPopulation) const;
+
+    /**
+     * Build mInterfaceTable and resolve the line tension parameter of each edge.
+     *
+     * @param rVertexCellPopulation reference to the cell population
+     */
+    void BuildEdgeLineTensionTable(VertexBasedCellPopulation<DIM>& rVertexCellPopulation);
+
+    /**
+     * Fill in the line tension parameter of each class of edge.
+     *
+     * @param pLineTensionByClass array of NUM_STRIPE_EDGE_CLASSES entries to fill in
+     */
+    void GetLineTensionByClass(double* pLineTensionByClass) const;
+
+    /**
+     * Resolve the line tension parameter of an edge in mInterfaceTable. The treatment of
+     * combined interfaces is a template parameter so that it is decided once per call.
+     *
+     * @param edgeIndex index of the edge in mInterfaceTable
+     * @param pLineTensionByClass the line tension parameter of each class of edge
+     * @return the line tension parameter of the edge.
+     */
+    template<bool USE_COMBINED_INTERFACES>
+    double ResolveEdgeLineTension(unsigned edgeIndex, const double* pLineTensionByClass) const;
+
+    /**
+     * Resolve the line tension parameter of each edge in mInterfaceTable.
+     */
+    template<bool USE_COMBINED_INTERFACES>
+    void ResolveEdgeLineTensions();
+
+    /**
+     * Add the force on each node using the edge-based assembly. Assumes that the element
+     * geometry and mInterfaceTable have been computed for the current mesh.
+     *
+     * @param rVertexCellPopulation reference to the cell population
+     */
+    void AddEdgeBasedForceContribution(VertexBasedCellPopulation<DIM>& rVertexCellPopulation);
+
+protected:
+
+    /**
+     * Overridden ComputeSlotLineTensions() method.
+     *
+     * Resolves the line tension of every edge once, using mInterfaceTable, and copies it to
+     * the element slots of the edge.
+     *
+     * @param rVertexCellPopulation reference to the cell population
+     */
+    void ComputeSlotLineTensions(VertexBasedCellPopulation<DIM>& rVertexCellPopulation);
+
+public:
+
+    /**
+     * Constructor.
+     */
+    StripeLineTensionForce();
+
+    /**
+     * Destructor.
+     */
+    ~StripeLineTensionForce()
+    {}
+
+    /**
+     * Overridden AddForceContribution() method.
+     *
+     * If mUseEdgeBasedAssembly is false this is the node-based assembly of the parent class.
+     * Otherwise the line tension and perimeter contractility terms are assembled edge by edge:
+     * each edge is visited once, its line tension and gradient are found once, and equal and
+     * opposite forces are added to its two nodes. The line tension of an edge is the sum of
+     * its per-visit values over the elements containing it, so the halved internal line
+     * tensions give the same forces in either mode (up to rounding).
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    void AddForceContribution(AbstractCellPopulation<DIM>& rCellPopulation);
+
+    /**
+     * Get the line tension parameter for the edge between two given nodes.
+     *
+     * This is not used by AddForceContribution(). Within a simulation, the interface table
+     * built by the force assembly at the current time step is reused, so the result is the
+     * line tension used for the current forces and each call is O(1). Otherwise the table
+     * is built for this call, which is O(N).
+     *
+     * @param pNodeA one node
+     * @param pNodeB the other node
+     * @param rVertexCellPopulation reference to the cell population
+     *
+     * @return the line tension parameter for this edge.
+     */
+    double GetLineTensionParameter(Node<DIM>* pNodeA, Node<DIM>* pNodeB, VertexBasedCellPopulation<DIM>& rVertexCellPopulation);
+
+    /**
+     * Set mHomotypicLineTensionParameter.
+     *
+     * @param homotypicLineTensionParameter the new value of mHomotypicLineTensionParameter
+     */
+    void SetHomotypicLineTensionParameter(double homotypicLineTensionParameter);
+
+    /**
+     * Set mHeterotypicLineTensionParameter.
+     *
+     * @param heterotypicLineTensionParameter the new value of mHeterotypicLineTensionParameter
+     */
+    void SetHeterotypicLineTensionParameter(double heterotypicLineTensionParameter);
+
+    /**
+     * Set mSupercontractileLineTensionParameter.
+     *
+     * @param supercontractileLineTensionParameter the new value of mSupercontractileLineTensionParameter
+     */
+    void SetSupercontractileLineTensionParameter(double supercontractileLineTensionParameter);
+
+    /**
+     * Set mNumStripes.
+     *
+     * @param numStripes the new value of mNumStripes
+     */
+    void SetNumStripes(unsigned numStripes);
+
+    /**
+     * Set mUseCombinedInterfacesForLineTension.
+     *
+     * @param useCombinedInterfaceLineTension the new value of mUseCombinedInterfacesForLineTension
+     */
+    void SetUseCombinedInterfacesForLineTension(bool useCombinedInterfaceLineTension);
+
+    /**
+     * Set mUseDistinctStripeMismatchesForCombinedInterfaces.
+     *
+     * @param useDistinctStripeMismatchesForCombinedInterfaces the new value of mUseDistinctStripeMismatchesForCombinedInterfaces
+     */
+    void SetUseDistinctStripeMismatchesForCombinedInterfaces(bool useDistinctStripeMismatchesForCombinedInterfaces);
+
+    /**
+     * Set mUseEdgeBasedAssembly.
+     *
+     * @param useEdgeBasedAssembly the new value of mUseEdgeBasedAssembly
+     */
+    void SetUseEdgeBasedAssembly(bool useEdgeBasedAssembly);
+
+    /**
+     * Set mpStripeIdentityModifier. The modifier should also be added to the simulation.
+     *
+     * @param pStripeIdentityModifier the modifier maintaining a dense array of stripe identities
+     */
+    void SetStripeIdentityModifier(boost::shared_ptr<StripeIdentityModifier<DIM> > pStripeIdentityModifier);
+
+    /**
+     * Overridden OutputForceParameters() method.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    void OutputForceParameters(out_stream& rParamsFile);
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS2(StripeLineTensionForce, 1, ConstantStripeLineTension)
+EXPORT_TEMPLATE_CLASS2(StripeLineTensionForce, 2, ConstantStripeLineTension)
+EXPORT_TEMPLATE_CLASS2(StripeLineTensionForce, 3, ConstantStripeLineTension)
+EXPORT_TEMPLATE_CLASS2(StripeLineTensionForce, 1, LengthNormalisedStripeLineTension)
+EXPORT_TEMPLATE_CLASS2(StripeLineTensionForce, 2, LengthNormalisedStripeLineTension)
+EXPORT_TEMPLATE_CLASS2(StripeLineTensionForce, 3, LengthNormalisedStripeLineTension)
+
+#endif /*STRIPELINETENSIONFORCE_HPP_*/
@@ -62,16 +62,28 @@ void StripeStatisticsWriter<ELEMENT_DIM, SPACE_DIM>::Visit(VertexBasedCellPopula
     double mismatch_two_num_edges = 0.0;
     double mismatch_two_boundary_length = 0.0;
 
-    // Iterate over cells
+    // Look up each cell's stripe identity once, rather than once per neighbour.
+    // Element indices are not contiguous once elements have been deleted, so size by all elements.
+    std::vector<unsigned> stripe_identities(pCellPopulation->rGetMesh().GetNumAllElements());
+    std::vector<unsigned> elem_indices;
+    elem_indices.reserve(pCellPopulation->GetNumElements());
     for (typename AbstractCellPopulation<SPACE_DIM>::Iterator cell_iter = pCellPopulation->Begin();
          cell_iter != pCellPopulation->End();
          ++cell_iter)
+    {
+        unsigned elem_index = pCellPopulation->GetLocationIndexUsingCell(*cell_iter);
+        stripe_identities[elem_index] = cell_iter->GetCellData()->GetItem("stripe");
+        elem_indices.push_back(elem_index);
+    }
+
+    // Iterate over cells
+    for (unsigned i=0; i<elem_indices.size(); i++)
     {
         // Find this cell's stripe identity
-        unsigned cell_stripe_identity = cell_iter->GetCellData()->GetItem("stripe");
+        unsigned elem_index = elem_indices[i];
+        unsigned cell_stripe_identity = stripe_identities[elem_index];
 
         // Get the set of neighbouring element indices
-        unsigned elem_index = pCellPopulation->GetLocationIndexUsingCell(*cell_iter);
         std::set<unsigned> neighbour_elem_indices = pCellPopulation->rGetMesh().GetNeighbouringElementIndices(elem_index);
 
         // Iterate over these neighbours
@@ -87,8 +99,7 @@ void StripeStatisticsWriter<ELEMENT_DIM, SPACE_DIM>::Visit(VertexBasedCellPopula
             total_num_edges += 1.0;
 
             // Find this neighbour's stripe identity
-            CellPtr p_neighbour = pCellPopulation->GetCellUsingLocationIndex(*neighbour_iter);
-            unsigned neighbour_stripe_identity = p_neighbour->GetCellData()->GetItem("stripe");
+            unsigned neighbour_stripe_identity = stripe_identities[neighbour_index];
 
             unsigned num_stripes = 4; ///\todo remove hardcoding
             unsigned mismatch = abs(cell_stripe_identity - neighbour_stripe_identity);
@@ -0,0 +1,320 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "VertexGeometrySnapshot.hpp"
+#include "Cylindrical2dVertexMesh.hpp"
+#include "Toroidal2dVertexMesh.hpp"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*
+ * Loops over slots below are written over raw arrays with no aliasing or branches, so that
+ * they can be vectorised. With OpenMP 4.0 or later we also request this explicitly.
+ */
+#if defined(_OPENMP) && (_OPENMP >= 201307)
+#define VERTEX_GEOMETRY_SIMD _Pragma("omp simd")
+#else
+#define VERTEX_GEOMETRY_SIMD
+#endif
+
+template<unsigned DIM>
+void VertexGeometrySnapshot<DIM>::Build(MutableVertexMesh<DIM,DIM>& rMesh, unsigned numThreads)
+{
+    if (DIM != 2)
+    {
+        EXCEPTION("VertexGeometrySnapshot is only implemented in 2D");
+    }
+
+    GatherMesh(rMesh, numThreads);
+    ComputeEdgeKernel();
+    ComputeAreaGradientKernel();
+    ComputeElementSums(numThreads);
+}
+
+template<unsigned DIM>
+bool VertexGeometrySnapshot<DIM>::IsCurrent(MutableVertexMesh<DIM,DIM>& rMesh) const
+{
+    unsigned num_nodes = rMesh.GetNumAllNodes();
+    if ((mElementSlotOffsets.size() != rMesh.GetNumAllElements() + 1) || (mNodeX.size() != num_nodes))
+    {
+        return false;
+    }
+
+    for (unsigned node_index=0; node_index<num_nodes; node_index++)
+    {
+        const c_vector<double, DIM>& r_location = rMesh.GetNode(node_index)->rGetLocation();
+        if ((mNodeX[node_index] != r_location[0]) || (mNodeY[node_index] != r_location[1]))
+        {
+            return false;
+        }
+    }
+
+    // Every slot must be accounted for by an element that is not deleted
+    unsigned num_slots_checked = 0;
+    for (typename VertexMesh<DIM,DIM>::VertexElementIterator elem_iter = rMesh.GetElementIteratorBegin();
+         elem_iter != rMesh.GetElementIteratorEnd();
+         ++elem_iter)
+    {
+        unsigned elem_index = elem_iter->GetIndex();
+        unsigned num_nodes_elem = elem_iter->GetNumNodes();
+        if (mElementSlotOffsets[elem_index + 1] - mElementSlotOffsets[elem_index] != num_nodes_elem)
+        {
+            return false;
+        }
+
+        unsigned offset = mElementSlotOffsets[elem_index];
+        for (unsigned local_index=0; local_index<num_nodes_elem; local_index++)
+        {
+            if (mSlotNodes[offset + local_index] != elem_iter->GetNodeGlobalIndex(local_index))
+            {
+                return false;
+            }
+        }
+        num_slots_checked += num_nodes_elem;
+    }
+    return (num_slots_checked == mSlotNodes.size());
+}
+
+template<unsigned DIM>
+void VertexGeometrySnapshot<DIM>::GatherMesh(MutableVertexMesh<DIM,DIM>& rMesh, unsigned numThreads)
+{
+    int num_nodes = (int)rMesh.GetNumAllNodes();
+    unsigned num_elements = rMesh.GetNumAllElements();
+
+    // Node coordinates
+    mNodeX.resize(num_nodes);
+    mNodeY.resize(num_nodes);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(numThreads)
+#endif
+    for (int node_index=0; node_index<num_nodes; node_index++)
+    {
+        const c_vector<double, DIM>& r_location = rMesh.GetNode(node_index)->rGetLocation();
+        mNodeX[node_index] = r_location[0];
+        mNodeY[node_index] = r_location[1];
+    }
+
+    // Element to node arrays (deleted elements are given no slots)
+    mElementSlotOffsets.assign(num_elements + 1, 0);
+    for (typename VertexMesh<DIM,DIM>::VertexElementIterator elem_iter = rMesh.GetElementIteratorBegin();
+         elem_iter != rMesh.GetElementIteratorEnd();
+         ++elem_iter)
+    {
+        mElementSlotOffsets[elem_iter->GetIndex() + 1] = elem_iter->GetNumNodes();
+    }
+    for (unsigned elem_index=0; elem_index<num_elements; elem_index++)
+    {
+        mElementSlotOffsets[elem_index + 1] += mElementSlotOffsets[elem_index];
+    }
+
+    unsigned num_slots = mElementSlotOffsets[num_elements];
+    mSlotNodes.resize(num_slots);
+    mSlotElements.resize(num_slots);
+    mPreviousSlots.resize(num_slots);
+    for (typename VertexMesh<DIM,DIM>::VertexElementIterator elem_iter = rMesh.GetElementIteratorBegin();
+         elem_iter != rMesh.GetElementIteratorEnd();
+         ++elem_iter)
+    {
+        unsigned elem_index = elem_iter->GetIndex();
+        unsigned offset = mElementSlotOffsets[elem_index];
+        unsigned num_nodes_elem = elem_iter->GetNumNodes();
+        for (unsigned local_index=0; local_index<num_nodes_elem; local_index++)
+        {
+            mSlotNodes[offset + local_index] = elem_iter->GetNodeGlobalIndex(local_index);
+            mSlotElements[offset + local_index] = elem_index;
+            mPreviousSlots[offset + local_index] = offset + (local_index + num_nodes_elem - 1)%num_nodes_elem;
+        }
+    }
+
+    // Node to slot arrays, by a counting sort that preserves the order of element indices
+    mNodeSlotOffsets.assign(num_nodes + 1, 0);
+    for (unsigned slot=0; slot<num_slots; slot++)
+    {
+        mNodeSlotOffsets[mSlotNodes[slot] + 1]++;
+    }
+    for (int node_index=0; node_index<num_nodes; node_index++)
+    {
+        mNodeSlotOffsets[node_index + 1] += mNodeSlotOffsets[node_index];
+    }
+    mNodeSlots.resize(num_slots);
+    std::vector<unsigned> next_free(mNodeSlotOffsets.begin(), mNodeSlotOffsets.end() - 1);
+    for (unsigned slot=0; slot<num_slots; slot++)
+    {
+        mNodeSlots[next_free[mSlotNodes[slot]]++] = slot;
+    }
+
+    // Edge vectors; on periodic meshes these must be found by the mesh
+    mEdgeVectorX.resize(num_slots);
+    mEdgeVectorY.resize(num_slots);
+    std::vector<unsigned> next_nodes(num_slots);
+    for (unsigned elem_index=0; elem_index<num_elements; elem_index++)
+    {
+        unsigned offset = mElementSlotOffsets[elem_index];
+        unsigned num_nodes_elem = mElementSlotOffsets[elem_index + 1] - offset;
+        for (unsigned local_index=0; local_index<num_nodes_elem; local_index++)
+        {
+            next_nodes[offset + local_index] = mSlotNodes[offset + (local_index + 1)%num_nodes_elem];
+        }
+    }
+
+    bool is_periodic = (dynamic_cast<Cylindrical2dVertexMesh*>(&rMesh) != NULL)
+                    || (dynamic_cast<Toroidal2dVertexMesh*>(&rMesh) != NULL);
+    if (is_periodic)
+    {
+        for (unsigned slot=0; slot<num_slots; slot++)
+        {
+            c_vector<double, DIM> edge_vector = rMesh.GetVectorFromAtoB(rMesh.GetNode(mSlotNodes[slot])->rGetLocation(),
+                                                                        rMesh.GetNode(next_nodes[slot])->rGetLocation());
+            mEdgeVectorX[slot] = edge_vector[0];
+            mEdgeVectorY[slot] = edge_vector[1];
+        }
+    }
+    else
+    {
+        for (unsigned slot=0; slot<num_slots; slot++)
+        {
+            mEdgeVectorX[slot] = mNodeX[next_nodes[slot]] - mNodeX[mSlotNodes[slot]];
+            mEdgeVectorY[slot] = mNodeY[next_nodes[slot]] - mNodeY[mSlotNodes[slot]];
+        }
+    }
+
+    // Node positions relative to the first node of each element, by summing edge vectors
+    mRelativeX.resize(num_slots);
+    mRelativeY.resize(num_slots);
+    for (unsigned elem_index=0; elem_index<num_elements; elem_index++)
+    {
+        double relative_x = 0.0;
+        double relative_y = 0.0;
+        for (unsigned slot=mElementSlotOffsets[elem_index]; slot<mElementSlotOffsets[elem_index + 1]; slot++)
+        {
+            mRelativeX[slot] = relative_x;
+            mRelativeY[slot] = relative_y;
+            relative_x += mEdgeVectorX[slot];
+            relative_y += mEdgeVectorY[slot];
+        }
+    }
+}
+
+template<unsigned DIM>
+void VertexGeometrySnapshot<DIM>::ComputeEdgeKernel()
+{
+    unsigned num_slots = mSlotNodes.size();
+    mEdgeLengths.resize(num_slots);
+    mEdgeUnitX.resize(num_slots);
+    mEdgeUnitY.resize(num_slots);
+    mSignedAreaTerms.resize(num_slots);
+    if (num_slots == 0)
+    {
+        return;
+    }
+
+    const double* p_dx = &mEdgeVectorX[0];
+    const double* p_dy = &mEdgeVectorY[0];
+    const double* p_rx = &mRelativeX[0];
+    const double* p_ry = &mRelativeY[0];
+    double* p_length = &mEdgeLengths[0];
+    double* p_unit_x = &mEdgeUnitX[0];
+    double* p_unit_y = &mEdgeUnitY[0];
+    double* p_area_term = &mSignedAreaTerms[0];
+
+    VERTEX_GEOMETRY_SIMD
+    for (unsigned slot=0; slot<num_slots; slot++)
+    {
+        double length = sqrt(p_dx[slot]*p_dx[slot] + p_dy[slot]*p_dy[slot]);
+        p_length[slot] = length;
+        p_unit_x[slot] = p_dx[slot]/length;
+        p_unit_y[slot] = p_dy[slot]/length;
+
+        // Shoelace term r_i x r_{i+1}, where r_{i+1} = r_i + d_i
+        p_area_term[slot] = 0.5*(p_rx[slot]*p_dy[slot] - p_dx[slot]*p_ry[slot]);
+    }
+}
+
+template<unsigned DIM>
+void VertexGeometrySnapshot<DIM>::ComputeAreaGradientKernel()
+{
+    unsigned num_slots = mSlotNodes.size();
+    mAreaGradientX.resize(num_slots);
+    mAreaGradientY.resize(num_slots);
+    if (num_slots == 0)
+    {
+        return;
+    }
+
+    const unsigned* p_previous = &mPreviousSlots[0];
+    const double* p_dx = &mEdgeVectorX[0];
+    const double* p_dy = &mEdgeVectorY[0];
+    double* p_gradient_x = &mAreaGradientX[0];
+    double* p_gradient_y = &mAreaGradientY[0];
+
+    // As in GetAreaGradientOfElementAtNode(), the gradient is half the vector from the previous to the next node, rotated
+    VERTEX_GEOMETRY_SIMD
+    for (unsigned slot=0; slot<num_slots; slot++)
+    {
+        p_gradient_x[slot] = 0.5*(p_dy[p_previous[slot]] + p_dy[slot]);
+        p_gradient_y[slot] = -0.5*(p_dx[p_previous[slot]] + p_dx[slot]);
+    }
+}
+
+template<unsigned DIM>
+void VertexGeometrySnapshot<DIM>::ComputeElementSums(unsigned numThreads)
+{
+    int num_elements = (int)mElementSlotOffsets.size() - 1;
+    mElementAreas.resize(num_elements);
+    mElementPerimeters.resize(num_elements);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(numThreads)
+#endif
+    for (int elem_index=0; elem_index<num_elements; elem_index++)
+    {
+        double signed_area = 0.0;
+        double perimeter = 0.0;
+        for (unsigned slot=mElementSlotOffsets[elem_index]; slot<mElementSlotOffsets[elem_index + 1]; slot++)
+        {
+            signed_area += mSignedAreaTerms[slot];
+            perimeter += mEdgeLengths[slot];
+        }
+        mElementAreas[elem_index] = fabs(signed_area);
+        mElementPerimeters[elem_index] = perimeter;
+    }
+}
+
+// Explicit instantiation
+template class VertexGeometrySnapshot<1>;
+template class VertexGeometrySnapshot<2>;
+template class VertexGeometrySnapshot<3>;
@@ -0,0 +1,310 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef VERTEXGEOMETRYSNAPSHOT_HPP_
+#define VERTEXGEOMETRYSNAPSHOT_HPP_
+
+#include <vector>
+#include "MutableVertexMesh.hpp"
+#include "Exception.hpp"
+
+/**
+ * A structure-of-arrays snapshot of the geometry of a 2D vertex mesh, taken once per
+ * time step for use in force assembly.
+ *
+ * The snapshot stores the node coordinates in separate x and y arrays and the node
+ * indices of each element in compressed sparse row form. Each element 'slot'
+ * s = GetElementSlotOffset(e) + i refers to local node i of element e and to the edge
+ * from local node i to local node i+1 (deleted elements own no slots). For each slot the
+ * snapshot holds the edge vector (using GetVectorFromAtoB() on periodic meshes), the edge
+ * length and unit vector, and the gradient of the element area at the node; for each
+ * element it holds the area and perimeter. These are computed in bulk by loops over
+ * contiguous arrays that the compiler can vectorise.
+ *
+ * The slots occupied by each node are also stored, in increasing order of element index,
+ * so that a force class can assemble the force on a node without looking up local indices.
+ *
+ * Since GetNextEdgeGradientOfElementAtNode() equals minus the unit vector of the next edge,
+ * the gradients of the edges before and after local node i of an element are
+ * GetEdgeUnitX/Y(previous slot) and -GetEdgeUnitX/Y(slot) respectively.
+ *
+ * The snapshot is not archived.
+ */
+template<unsigned DIM>
+class VertexGeometrySnapshot
+{
+private:
+
+    /** x coordinate of each node. */
+    std::vector<double> mNodeX;
+
+    /** y coordinate of each node. */
+    std::vector<double> mNodeY;
+
+    /** Offset of the first slot of each element, with a final entry equal to the number of slots. */
+    std::vector<unsigned> mElementSlotOffsets;
+
+    /** Global index of the node at each slot. */
+    std::vector<unsigned> mSlotNodes;
+
+    /** Index of the element owning each slot. */
+    std::vector<unsigned> mSlotElements;
+
+    /** The slot preceding each slot in its element (that is, the slot of the previous node). */
+    std::vector<unsigned> mPreviousSlots;
+
+    /** x component of the vector from the node at each slot to the next node of the element. */
+    std::vector<double> mEdgeVectorX;
+
+    /** y component of the vector from the node at each slot to the next node of the element. */
+    std::vector<double> mEdgeVectorY;
+
+    /** x coordinate of the node at each slot relative to the first node of the element. */
+    std::vector<double> mRelativeX;
+
+    /** y coordinate of the node at each slot relative to the first node of the element. */
+    std::vector<double> mRelativeY;
+
+    /** Length of the edge starting at each slot. */
+    std::vector<double> mEdgeLengths;
+
+    /** x component of the unit vector along the edge starting at each slot. */
+    std::vector<double> mEdgeUnitX;
+
+    /** y component of the unit vector along the edge starting at each slot. */
+    std::vector<double> mEdgeUnitY;
+
+    /** Contribution of the edge starting at each slot to the signed area of its element. */
+    std::vector<double> mSignedAreaTerms;
+
+    /** x component of the gradient of the element area at the node at each slot. */
+    std::vector<double> mAreaGradientX;
+
+    /** y component of the gradient of the element area at the node at each slot. */
+    std::vector<double> mAreaGradientY;
+
+    /** Area of each element (zero for deleted elements). */
+    std::vector<double> mElementAreas;
+
+    /** Perimeter of each element (zero for deleted elements). */
+    std::vector<double> mElementPerimeters;
+
+    /** Offset into mNodeSlots of the first slot of each node, with a final entry equal to the number of slots. */
+    std::vector<unsigned> mNodeSlotOffsets;
+
+    /** Slots occupied by each node, in increasing order of element index. */
+    std::vector<unsigned> mNodeSlots;
+
+    /** Gather node coordinates and element topology, and compute the edge vectors. */
+    void GatherMesh(MutableVertexMesh<DIM,DIM>& rMesh, unsigned numThreads);
+
+    /** Compute mEdgeLengths, mEdgeUnitX, mEdgeUnitY and mSignedAreaTerms from the edge vectors. */
+    void ComputeEdgeKernel();
+
+    /** Compute mAreaGradientX and mAreaGradientY from the edge vectors. */
+    void ComputeAreaGradientKernel();
+
+    /**
+     * Sum the slot quantities of each element into mElementAreas and mElementPerimeters.
+     *
+     * @param numThreads the number of threads to use
+     */
+    void ComputeElementSums(unsigned numThreads);
+
+public:
+
+    /**
+     * Build the snapshot from the current state of a mesh. Storage is reused between calls.
+     *
+     * @param rMesh the mesh (must be 2D)
+     * @param numThreads the number of threads to use, if built with OpenMP (defaults to 1)
+     */
+    void Build(MutableVertexMesh<DIM,DIM>& rMesh, unsigned numThreads=1);
+
+    /**
+     * @return whether the snapshot still describes a mesh, that is whether the mesh has the same
+     * elements, with the same nodes in the same order, and every node is at the same location as
+     * when the snapshot was last built. This is cheaper than rebuilding the snapshot.
+     *
+     * @param rMesh the mesh
+     */
+    bool IsCurrent(MutableVertexMesh<DIM,DIM>& rMesh) const;
+
+    /** @return the number of slots. */
+    unsigned GetNumSlots() const
+    {
+        return mSlotNodes.size();
+    }
+
+    /**
+     * @param elementIndex index of an element
+     * @return the first slot of the element.
+     */
+    unsigned GetElementSlotOffset(unsigned elementIndex) const
+    {
+        return mElementSlotOffsets[elementIndex];
+    }
+
+    /**
+     * @param elementIndex index of an element
+     * @return the number of slots (nodes) of the element.
+     */
+    unsigned GetNumElementSlots(unsigned elementIndex) const
+    {
+        return mElementSlotOffsets[elementIndex + 1] - mElementSlotOffsets[elementIndex];
+    }
+
+    /**
+     * @param slot a slot
+     * @return the global index of the node at the slot.
+     */
+    unsigned GetSlotNode(unsigned slot) const
+    {
+        return mSlotNodes[slot];
+    }
+
+    /**
+     * @param slot a slot
+     * @return the index of the element owning the slot.
+     */
+    unsigned GetSlotElement(unsigned slot) const
+    {
+        return mSlotElements[slot];
+    }
+
+    /**
+     * @param slot a slot
+     * @return the slot of the previous node in the same element.
+     */
+    unsigned GetPreviousSlot(unsigned slot) const
+    {
+        return mPreviousSlots[slot];
+    }
+
+    /**
+     * @param slot a slot
+     * @return the slot of the next node in the same element.
+     */
+    unsigned GetNextSlot(unsigned slot) const
+    {
+        unsigned next_slot = slot + 1;
+        unsigned elem_index = mSlotElements[slot];
+        return (next_slot == mElementSlotOffsets[elem_index + 1]) ? mElementSlotOffsets[elem_index] : next_slot;
+    }
+
+    /**
+     * @param slot a slot
+     * @return the length of the edge starting at the slot.
+     */
+    double GetEdgeLength(unsigned slot) const
+    {
+        return mEdgeLengths[slot];
+    }
+
+    /**
+     * @param slot a slot
+     * @return the x component of the unit vector along the edge starting at the slot.
+     */
+    double GetEdgeUnitX(unsigned slot) const
+    {
+        return mEdgeUnitX[slot];
+    }
+
+    /**
+     * @param slot a slot
+     * @return the y component of the unit vector along the edge starting at the slot.
+     */
+    double GetEdgeUnitY(unsigned slot) const
+    {
+        return mEdgeUnitY[slot];
+    }
+
+    /**
+     * @param slot a slot
+     * @return the x component of the gradient of the element area at the node at the slot.
+     */
+    double GetAreaGradientX(unsigned slot) const
+    {
+        return mAreaGradientX[slot];
+    }
+
+    /**
+     * @param slot a slot
+     * @return the y component of the gradient of the element area at the node at the slot.
+     */
+    double GetAreaGradientY(unsigned slot) const
+    {
+        return mAreaGradientY[slot];
+    }
+
+    /**
+     * @param elementIndex index of an element
+     * @return the area of the element.
+     */
+    double GetElementArea(unsigned elementIndex) const
+    {
+        return mElementAreas[elementIndex];
+    }
+
+    /**
+     * @param elementIndex index of an element
+     * @return the perimeter of the element.
+     */
+    double GetElementPerimeter(unsigned elementIndex) const
+    {
+        return mElementPerimeters[elementIndex];
+    }
+
+    /**
+     * @param nodeIndex global index of a node
+     * @return the number of slots occupied by the node (its number of containing elements).
+     */
+    unsigned GetNumNodeSlots(unsigned nodeIndex) const
+    {
+        return mNodeSlotOffsets[nodeIndex + 1] - mNodeSlotOffsets[nodeIndex];
+    }
+
+    /**
+     * @param nodeIndex global index of a node
+     * @param localIndex index of the slot among those occupied by the node
+     * @return the slot.
+     */
+    unsigned GetNodeSlot(unsigned nodeIndex, unsigned localIndex) const
+    {
+        return mNodeSlots[mNodeSlotOffsets[nodeIndex] + localIndex];
+    }
+};
+
+#endif /*VERTEXGEOMETRYSNAPSHOT_HPP_*/
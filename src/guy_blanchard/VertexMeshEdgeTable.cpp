@@ -0,0 +1,316 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "VertexMeshEdgeTable.hpp"
+#include <algorithm>
+
+template<unsigned DIM>
+VertexMeshEdgeTable<DIM>::VertexMeshEdgeTable()
+    : mIsBuilt(false)
+{
+}
+
+template<unsigned DIM>
+void VertexMeshEdgeTable<DIM>::Build(VertexMesh<DIM,DIM>& rMesh)
+{
+    unsigned num_nodes = rMesh.GetNumAllNodes();
+    unsigned num_elements = rMesh.GetNumAllElements();
+
+    // Assign a contiguous range of slots to each element (deleted elements are given no slots)
+    mElementSlotOffsets.assign(num_elements + 1, 0);
+    for (typename VertexMesh<DIM,DIM>::VertexElementIterator elem_iter = rMesh.GetElementIteratorBegin();
+         elem_iter != rMesh.GetElementIteratorEnd();
+         ++elem_iter)
+    {
+        mElementSlotOffsets[elem_iter->GetIndex() + 1] = elem_iter->GetNumNodes();
+    }
+    for (unsigned elem_index=0; elem_index<num_elements; elem_index++)
+    {
+        mElementSlotOffsets[elem_index + 1] += mElementSlotOffsets[elem_index];
+    }
+    unsigned num_slots = mElementSlotOffsets[num_elements];
+
+    // Record every element's copy of every edge, then sort so that copies of the same edge are adjacent
+    mElementEdges.resize(num_slots);
+    for (typename VertexMesh<DIM,DIM>::VertexElementIterator elem_iter = rMesh.GetElementIteratorBegin();
+         elem_iter != rMesh.GetElementIteratorEnd();
+         ++elem_iter)
+    {
+        unsigned elem_index = elem_iter->GetIndex();
+        unsigned num_nodes_in_elem = elem_iter->GetNumNodes();
+        unsigned offset = mElementSlotOffsets[elem_index];
+
+        for (unsigned local_index=0; local_index<num_nodes_in_elem; local_index++)
+        {
+            unsigned this_node = elem_iter->GetNodeGlobalIndex(local_index);
+            unsigned next_node = elem_iter->GetNodeGlobalIndex((local_index + 1)%num_nodes_in_elem);
+
+            ElementEdge& r_edge = mElementEdges[offset + local_index];
+            r_edge.mNodeA = std::min(this_node, next_node);
+            r_edge.mNodeB = std::max(this_node, next_node);
+            r_edge.mElement = elem_index;
+            r_edge.mSlot = offset + local_index;
+        }
+    }
+    std::sort(mElementEdges.begin(), mElementEdges.end());
+
+    // Merge the copies of each edge
+    mEdgeNodes.clear();
+    mEdgeElements.clear();
+    mEdgeSlots.clear();
+    mSlotEdges.assign(num_slots, UNSIGNED_UNSET);
+
+    unsigned first = 0;
+    while (first < num_slots)
+    {
+        unsigned last = first + 1;
+        while ((last < num_slots)
+               && (mElementEdges[last].mNodeA == mElementEdges[first].mNodeA)
+               && (mElementEdges[last].mNodeB == mElementEdges[first].mNodeB))
+        {
+            last++;
+        }
+
+        // In a valid vertex mesh each edge is contained in one or two elements
+        assert(last - first <= 2);
+
+        unsigned edge_index = mEdgeNodes.size()/2;
+        mEdgeNodes.push_back(mElementEdges[first].mNodeA);
+        mEdgeNodes.push_back(mElementEdges[first].mNodeB);
+        mEdgeElements.push_back(mElementEdges[first].mElement);
+        mEdgeSlots.push_back(mElementEdges[first].mSlot);
+        if (last - first > 1)
+        {
+            mEdgeElements.push_back(mElementEdges[first + 1].mElement);
+            mEdgeSlots.push_back(mElementEdges[first + 1].mSlot);
+        }
+        else
+        {
+            mEdgeElements.push_back(UNSIGNED_UNSET);
+            mEdgeSlots.push_back(UNSIGNED_UNSET);
+        }
+
+        for (unsigned i=first; i<last; i++)
+        {
+            mSlotEdges[mElementEdges[i].mSlot] = edge_index;
+        }
+        first = last;
+    }
+
+    // Store the edges incident on each node in compressed sparse row form
+    unsigned num_edges = mEdgeNodes.size()/2;
+    mNodeEdgeOffsets.assign(num_nodes + 1, 0);
+    for (unsigned i=0; i<2*num_edges; i++)
+    {
+        mNodeEdgeOffsets[mEdgeNodes[i] + 1]++;
+    }
+    for (unsigned node_index=0; node_index<num_nodes; node_index++)
+    {
+        mNodeEdgeOffsets[node_index + 1] += mNodeEdgeOffsets[node_index];
+    }
+
+    mNodeEdges.resize(2*num_edges);
+    std::vector<unsigned> next_free(mNodeEdgeOffsets.begin(), mNodeEdgeOffsets.end() - 1);
+    for (unsigned edge_index=0; edge_index<num_edges; edge_index++)
+    {
+        mNodeEdges[next_free[mEdgeNodes[2*edge_index]]++] = edge_index;
+        mNodeEdges[next_free[mEdgeNodes[2*edge_index + 1]]++] = edge_index;
+    }
+
+    mIsBuilt = true;
+}
+
+template<unsigned DIM>
+void VertexMeshEdgeTable<DIM>::Clear()
+{
+    mEdgeNodes.clear();
+    mEdgeElements.clear();
+    mEdgeSlots.clear();
+    mElementSlotOffsets.clear();
+    mSlotEdges.clear();
+    mNodeEdgeOffsets.clear();
+    mNodeEdges.clear();
+    mIsBuilt = false;
+}
+
+template<unsigned DIM>
+bool VertexMeshEdgeTable<DIM>::IsBuilt() const
+{
+    return mIsBuilt;
+}
+
+template<unsigned DIM>
+unsigned VertexMeshEdgeTable<DIM>::GetNumEdges() const
+{
+    return mEdgeNodes.size()/2;
+}
+
+template<unsigned DIM>
+unsigned VertexMeshEdgeTable<DIM>::GetNumSlots() const
+{
+    return mSlotEdges.size();
+}
+
+template<unsigned DIM>
+unsigned VertexMeshEdgeTable<DIM>::GetEdgeNodeIndex(unsigned edgeIndex, unsigned localIndex) const
+{
+    assert(localIndex < 2);
+    return mEdgeNodes[2*edgeIndex + localIndex];
+}
+
+template<unsigned DIM>
+unsigned VertexMeshEdgeTable<DIM>::GetNumElementsContainingEdge(unsigned edgeIndex) const
+{
+    return (mEdgeElements[2*edgeIndex + 1] == UNSIGNED_UNSET) ? 1 : 2;
+}
+
+template<unsigned DIM>
+unsigned VertexMeshEdgeTable<DIM>::GetEdgeElementIndex(unsigned edgeIndex, unsigned localIndex) const
+{
+    assert(localIndex < 2);
+    return mEdgeElements[2*edgeIndex + localIndex];
+}
+
+template<unsigned DIM>
+unsigned VertexMeshEdgeTable<DIM>::GetEdgeSlot(unsigned edgeIndex, unsigned localIndex) const
+{
+    assert(localIndex < 2);
+    return mEdgeSlots[2*edgeIndex + localIndex];
+}
+
+template<unsigned DIM>
+unsigned VertexMeshEdgeTable<DIM>::GetElementSlotOffset(unsigned elementIndex) const
+{
+    return mElementSlotOffsets[elementIndex];
+}
+
+template<unsigned DIM>
+unsigned VertexMeshEdgeTable<DIM>::GetNumElementSlots(unsigned elementIndex) const
+{
+    return mElementSlotOffsets[elementIndex + 1] - mElementSlotOffsets[elementIndex];
+}
+
+template<unsigned DIM>
+unsigned VertexMeshEdgeTable<DIM>::GetSlotEdge(unsigned slot) const
+{
+    return mSlotEdges[slot];
+}
+
+template<unsigned DIM>
+unsigned VertexMeshEdgeTable<DIM>::GetNumNodeEdges(unsigned nodeIndex) const
+{
+    return mNodeEdgeOffsets[nodeIndex + 1] - mNodeEdgeOffsets[nodeIndex];
+}
+
+template<unsigned DIM>
+unsigned VertexMeshEdgeTable<DIM>::GetNodeEdge(unsigned nodeIndex, unsigned localIndex) const
+{
+    assert(localIndex < GetNumNodeEdges(nodeIndex));
+    return mNodeEdges[mNodeEdgeOffsets[nodeIndex] + localIndex];
+}
+
+template<unsigned DIM>
+unsigned VertexMeshEdgeTable<DIM>::GetEdgeIndex(unsigned nodeAIndex, unsigned nodeBIndex) const
+{
+    if (nodeAIndex + 1 < mNodeEdgeOffsets.size())
+    {
+        for (unsigned i=mNodeEdgeOffsets[nodeAIndex]; i<mNodeEdgeOffsets[nodeAIndex + 1]; i++)
+        {
+            unsigned edge_index = mNodeEdges[i];
+            if ((mEdgeNodes[2*edge_index] == nodeBIndex) || (mEdgeNodes[2*edge_index + 1] == nodeBIndex))
+            {
+                return edge_index;
+            }
+        }
+    }
+    return UNSIGNED_UNSET;
+}
+
+template<unsigned DIM>
+void VertexMeshEdgeTable<DIM>::ComputeRunLengths(const std::vector<unsigned>& rEdgeKeys,
+                                                 const std::vector<double>& rEdgeLengths,
+                                                 std::vector<double>& rSlotRunLengths) const
+{
+    rSlotRunLengths.assign(mSlotEdges.size(), 0.0);
+
+    unsigned num_elements = mElementSlotOffsets.empty() ? 0 : mElementSlotOffsets.size() - 1;
+    for (unsigned elem_index=0; elem_index<num_elements; elem_index++)
+    {
+        unsigned offset = mElementSlotOffsets[elem_index];
+        unsigned num_slots = mElementSlotOffsets[elem_index + 1] - offset;
+        if (num_slots == 0)
+        {
+            continue;
+        }
+
+        // Start the sweep at a change of key, so that no run wraps past the end of the sweep
+        unsigned start = 0;
+        while ((start < num_slots)
+               && (rEdgeKeys[mSlotEdges[offset + start]] == rEdgeKeys[mSlotEdges[offset + (start + num_slots - 1)%num_slots]]))
+        {
+            start++;
+        }
+        if (start == num_slots)
+        {
+            // Every edge has the same key, so the whole perimeter is a single run
+            start = 0;
+        }
+
+        unsigned i = 0;
+        while (i < num_slots)
+        {
+            unsigned run_start = i;
+            unsigned key = rEdgeKeys[mSlotEdges[offset + (start + i)%num_slots]];
+            double run_length = 0.0;
+            while ((i < num_slots) && (rEdgeKeys[mSlotEdges[offset + (start + i)%num_slots]] == key))
+            {
+                if (key != 0)
+                {
+                    run_length += rEdgeLengths[mSlotEdges[offset + (start + i)%num_slots]];
+                }
+                i++;
+            }
+            for (unsigned j=run_start; j<i; j++)
+            {
+                rSlotRunLengths[offset + (start + j)%num_slots] = run_length;
+            }
+        }
+    }
+}
+
+// Explicit instantiation
+template class VertexMeshEdgeTable<1>;
+template class VertexMeshEdgeTable<2>;
+template class VertexMeshEdgeTable<3>;
@@ -0,0 +1,257 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef VERTEXMESHEDGETABLE_HPP_
+#define VERTEXMESHEDGETABLE_HPP_
+
+#include <vector>
+#include "VertexMesh.hpp"
+#include "Exception.hpp"
+
+/**
+ * A flat table of the unique edges of a vertex mesh.
+ *
+ * The table is built in a single sweep over the elements of the mesh and stores,
+ * for each edge, its two nodes (lower global index first), the elements containing
+ * it (in increasing order of index) and the 'slot' of the edge in each of these
+ * elements. Slot s = GetElementSlotOffset(e) + i refers to the edge running from
+ * local node i to local node i+1 of element e.
+ *
+ * For each node, the table also stores the edges incident on it in compressed
+ * sparse row form, so that the edge between two given nodes can be found in O(1)
+ * time (vertex valency is bounded).
+ *
+ * The table is not archived: it is a per-time-step cache that should be rebuilt
+ * whenever the mesh topology may have changed.
+ */
+template<unsigned DIM>
+class VertexMeshEdgeTable
+{
+private:
+
+    /**
+     * Helper structure recording one element's copy of an edge, used while building the table.
+     */
+    struct ElementEdge
+    {
+        /** Global index of the lower-indexed node of the edge. */
+        unsigned mNodeA;
+
+        /** Global index of the higher-indexed node of the edge. */
+        unsigned mNodeB;
+
+        /** Index of the element. */
+        unsigned mElement;
+
+        /** Slot of the edge within the element. */
+        unsigned mSlot;
+
+        /**
+         * Order element edges by their nodes, then by element index.
+         *
+         * @param rOther the element edge to compare with
+         * @return whether this element edge precedes rOther.
+         */
+        bool operator<(const ElementEdge& rOther) const
+        {
+            if (mNodeA != rOther.mNodeA)
+            {
+                return mNodeA < rOther.mNodeA;
+            }
+            if (mNodeB != rOther.mNodeB)
+            {
+                return mNodeB < rOther.mNodeB;
+            }
+            return mElement < rOther.mElement;
+        }
+    };
+
+    /** Work space holding every element's copy of every edge, kept between builds to avoid reallocation. */
+    std::vector<ElementEdge> mElementEdges;
+
+    /** Global indices of the nodes of each edge, stored in consecutive pairs with the lower index first. */
+    std::vector<unsigned> mEdgeNodes;
+
+    /**
+     * Indices of the elements containing each edge, stored in consecutive pairs in increasing order.
+     * The second entry is UNSIGNED_UNSET for edges on the boundary of the mesh.
+     */
+    std::vector<unsigned> mEdgeElements;
+
+    /** Slot of each edge within each of the elements stored in mEdgeElements. */
+    std::vector<unsigned> mEdgeSlots;
+
+    /** Offset into mSlotEdges of the first slot of each element, with a final entry equal to the number of slots. */
+    std::vector<unsigned> mElementSlotOffsets;
+
+    /** Index of the edge occupying each element slot. */
+    std::vector<unsigned> mSlotEdges;
+
+    /** Offset into mNodeEdges of the first edge incident on each node, with a final entry equal to twice the number of edges. */
+    std::vector<unsigned> mNodeEdgeOffsets;
+
+    /** Indices of the edges incident on each node. */
+    std::vector<unsigned> mNodeEdges;
+
+    /** Whether the table currently holds the edges of a mesh. */
+    bool mIsBuilt;
+
+public:
+
+    /**
+     * Constructor.
+     */
+    VertexMeshEdgeTable();
+
+    /**
+     * Build the table from the current topology of a vertex mesh. Any previous
+     * contents are discarded, but allocated storage is reused.
+     *
+     * @param rMesh the mesh
+     */
+    void Build(VertexMesh<DIM,DIM>& rMesh);
+
+    /**
+     * Discard the contents of the table.
+     */
+    void Clear();
+
+    /**
+     * @return whether the table currently holds the edges of a mesh.
+     */
+    bool IsBuilt() const;
+
+    /**
+     * @return the number of unique edges in the table.
+     */
+    unsigned GetNumEdges() const;
+
+    /**
+     * @return the total number of element slots in the table.
+     */
+    unsigned GetNumSlots() const;
+
+    /**
+     * @param edgeIndex index of an edge
+     * @param localIndex 0 for the lower-indexed node of the edge, 1 for the other
+     *
+     * @return the global index of the given node of the edge.
+     */
+    unsigned GetEdgeNodeIndex(unsigned edgeIndex, unsigned localIndex) const;
+
+    /**
+     * @param edgeIndex index of an edge
+     *
+     * @return the number of elements containing the edge (1 for boundary edges, 2 otherwise).
+     */
+    unsigned GetNumElementsContainingEdge(unsigned edgeIndex) const;
+
+    /**
+     * @param edgeIndex index of an edge
+     * @param localIndex 0 or 1; the containing elements are ordered by increasing index
+     *
+     * @return the index of the given element containing the edge.
+     */
+    unsigned GetEdgeElementIndex(unsigned edgeIndex, unsigned localIndex) const;
+
+    /**
+     * @param edgeIndex index of an edge
+     * @param localIndex 0 or 1, as in GetEdgeElementIndex()
+     *
+     * @return the slot occupied by the edge in the given containing element.
+     */
+    unsigned GetEdgeSlot(unsigned edgeIndex, unsigned localIndex) const;
+
+    /**
+     * @param elementIndex index of an element
+     *
+     * @return the first slot of the element.
+     */
+    unsigned GetElementSlotOffset(unsigned elementIndex) const;
+
+    /**
+     * @param elementIndex index of an element
+     *
+     * @return the number of slots (equivalently, edges or nodes) of the element.
+     */
+    unsigned GetNumElementSlots(unsigned elementIndex) const;
+
+    /**
+     * @param slot an element slot
+     *
+     * @return the index of the edge occupying the slot.
+     */
+    unsigned GetSlotEdge(unsigned slot) const;
+
+    /**
+     * @param nodeIndex global index of a node
+     *
+     * @return the number of edges incident on the node.
+     */
+    unsigned GetNumNodeEdges(unsigned nodeIndex) const;
+
+    /**
+     * @param nodeIndex global index of a node
+     * @param localIndex index of the edge among those incident on the node (in increasing order of edge index)
+     *
+     * @return the index of the edge.
+     */
+    unsigned GetNodeEdge(unsigned nodeIndex, unsigned localIndex) const;
+
+    /**
+     * Find the edge between two nodes.
+     *
+     * @param nodeAIndex global index of one node
+     * @param nodeBIndex global index of the other node
+     *
+     * @return the index of the edge, or UNSIGNED_UNSET if the nodes do not share an edge.
+     */
+    unsigned GetEdgeIndex(unsigned nodeAIndex, unsigned nodeBIndex) const;
+
+    /**
+     * Split the perimeter of each element into maximal runs of consecutive edges that share
+     * the same non-zero key, and compute the total length of the run containing each slot.
+     * Each perimeter is traversed once; a run may cover a whole perimeter.
+     *
+     * @param rEdgeKeys key of each edge; edges with key 0 do not belong to any run
+     * @param rEdgeLengths length of each edge (only read for edges with non-zero key)
+     * @param rSlotRunLengths filled with the length of the run containing each slot, or 0 if the slot's edge has key 0
+     */
+    void ComputeRunLengths(const std::vector<unsigned>& rEdgeKeys,
+                           const std::vector<double>& rEdgeLengths,
+                           std::vector<double>& rSlotRunLengths) const;
+};
+
+#endif /*VERTEXMESHEDGETABLE_HPP_*/
@@ -5,7 +5,10 @@
 template<unsigned DIM>
 ApicalEdgesForce<DIM>::ApicalEdgesForce()
     : AbstractForce<DIM>(),
-      mLambda(1.0)
+      mLambda(1.0),
+      mNumNodesWhenBuilt(0),
+      mNumElementsWhenBuilt(0),
+      mNumRingSourcesWhenBuilt(0)
 {
 }
 
@@ -26,6 +29,12 @@ double ApicalEdgesForce<DIM>::GetLambda()
     return mLambda;
 }
 
+template<unsigned DIM>
+const std::vector<unsigned>& ApicalEdgesForce<DIM>::rGetApicalNodeIndices() const
+{
+    return mApicalNodeIndices;
+}
+
 template<unsigned DIM>
 void ApicalEdgesForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>& rCellPopulation)
 {
@@ -38,91 +47,222 @@ void ApicalEdgesForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>& rC
     // Define some helper variables
     VertexBasedCellPopulation<DIM>* p_cell_population = static_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation);
     MutableVertexMesh<DIM, DIM>& r_mesh = p_cell_population->rGetMesh();
-    unsigned num_nodes = p_cell_population->GetNumNodes();
 
-    // Iterate over vertices in the cell population
-    ///\todo see starting value in for loop below
-    for (unsigned node_index=num_nodes/2; node_index<num_nodes; node_index++)
+    // Find the apical rings afresh only if the topology has changed since they were last found
+    if (ApicalRingsAreStale(r_mesh))
+    {
+        BuildApicalRings(r_mesh);
+    }
+
+    // Compute the unit vector along each apical edge of each ring
+    unsigned num_slots = mApicalRingNodes.size();
+    mApicalSlotUnitVectors.resize(DIM*num_slots);
+    for (unsigned ring_index=0; ring_index<mApicalRingSources.size(); ring_index++)
+    {
+        unsigned first_slot = mApicalRingOffsets[ring_index];
+        unsigned end_slot = mApicalRingOffsets[ring_index + 1];
+        for (unsigned slot=first_slot; slot<end_slot; slot++)
+        {
+            unsigned next_slot = (slot + 1 < end_slot) ? slot + 1 : first_slot;
+            c_vector<double, DIM> edge_vector = r_mesh.GetVectorFromAtoB(r_mesh.GetNode(mApicalRingNodes[slot])->rGetLocation(),
+                                                                         r_mesh.GetNode(mApicalRingNodes[next_slot])->rGetLocation());
+            double edge_length = norm_2(edge_vector);
+            assert(edge_length > DBL_EPSILON);
+            for (unsigned dim=0; dim<DIM; dim++)
+            {
+                mApicalSlotUnitVectors[DIM*slot + dim] = edge_vector[dim]/edge_length;
+            }
+        }
+    }
+
+    /**
+     * Compute the line tension parameter for each of these edges
+     * \todo be aware that this is half of the actual value for internal edges,
+     * since we are looping over each of the internal edges twice (see the
+     * method FarhadifarForce::GetLineTensionParameter())
+     */
+    double line_tension = mLambda;
+
+    // Iterate over apical vertices only
+    for (unsigned apical_index=0; apical_index<mApicalNodeIndices.size(); apical_index++)
     {
         /*
-         * The apical line tension energy is associated with apical Nodes. Here we define apical
-         * nodes are those with NodeAttributes, as specified by the HexagonalPrism3dVertexMeshGenerator
-         * used to construct the mesh. (Note that if there are no rearrangements or re-indexing
-         * then we could just use the fact that the first half of the nodes vector are apical.)
+         * The force on this Node is given by the gradient of the total apical line tension
+         * energy of the CellPopulation, evaluated at the Node's position. Since the movement
+         * of this Node only affects the free energy associated with the apical rings that
+         * contain it, we can just consider the contributions to the free energy gradient from
+         * the previous and next edges at each of its slots in these rings.
          */
-        Node<DIM>* p_this_node = p_cell_population->GetNode(node_index);
-        if (p_this_node->HasNodeAttributes())
+        unsigned first_node_slot = mApicalNodeSlotOffsets[apical_index];
+        unsigned end_node_slot = mApicalNodeSlotOffsets[apical_index + 1];
+
+        // If the node is contained in less than three elements, then 'pin' it by imposing no force
+        if (end_node_slot - first_node_slot > 2)
         {
-            /*
-             * The force on this Node is given by the gradient of the total apical line tension
-             * energy of the CellPopulation, evaluated at the Node's position. Since the movement
-             * of this Node only affects the free energy associated with the VertexElements that
-             * contain it, we can just consider the contributions to the free energy gradient from
-             * each of these VertexElements.
-             */
             c_vector<double, DIM> force_on_node = zero_vector<double>(DIM);
-
-            // Find the indices of the elements containing this node
-            std::set<unsigned> containing_elem_indices = p_this_node->rGetContainingElementIndices();
-
-            // If the node is contained in less than three elements, then 'pin' it by imposing no force
-            if (containing_elem_indices.size() > 2)
+            for (unsigned i=first_node_slot; i<end_node_slot; i++)
             {
-                // Iterate over these elements
-                for (std::set<unsigned>::iterator iter = containing_elem_indices.begin();
-                     iter != containing_elem_indices.end();
-                     ++iter)
+                unsigned slot = mApicalNodeSlots[i];
+                unsigned previous_slot = mPreviousApicalSlots[slot];
+
+                // Add the force contribution from cell-cell and cell-boundary line tension (note the minus sign)
+                for (unsigned dim=0; dim<DIM; dim++)
                 {
-                    // Get this element, its index and its number of nodes
-                    VertexElement<DIM, DIM>* p_element = p_cell_population->GetElement(*iter);
-//                    unsigned elem_index = p_element->GetIndex();
-//                    unsigned num_nodes_elem = p_element->GetNumNodes();
-
-                    // Find the local index of this node in this element
-                    unsigned local_index = p_element->GetNodeLocalIndex(node_index);
-
-                    // Get the previous and next nodes in this element
-                    unsigned previous_node_local_index = local_index - 1;
-                    unsigned next_node_local_index = local_index + 1;
-                    if (local_index == 6)
-                    {
-                        previous_node_local_index = 11;
-                    }
-                    else if (local_index == 11)
-                    {
-                        next_node_local_index = 6;
-                    }
-
-                    Node<DIM>* p_previous_node = p_element->GetNode(previous_node_local_index);
-                    Node<DIM>* p_next_node = p_element->GetNode(next_node_local_index);
-
-                    /**
-                     * Compute the line tension parameter for each of these edges
-                     * \todo be aware that this is half of the actual value for internal edges,
-                     * since we are looping over each of the internal edges twice (see the
-                     * method FarhadifarForce::GetLineTensionParameter())
-                     */
-                    double line_tension = mLambda;
-
-                    // Compute the gradient of each these edges, computed at the present node
-                    c_vector<double, DIM> previous_edge_gradient = r_mesh.GetVectorFromAtoB(p_previous_node->rGetLocation(), p_this_node->rGetLocation());
-                    double previous_edge_length = norm_2(previous_edge_gradient);
-                    assert(previous_edge_length > DBL_EPSILON);
-                    previous_edge_gradient /= previous_edge_length;
-
-                    c_vector<double, DIM> next_edge_gradient = r_mesh.GetVectorFromAtoB(p_this_node->rGetLocation(), p_next_node->rGetLocation());
-                    double next_edge_length = norm_2(next_edge_gradient);
-                    assert(next_edge_length > DBL_EPSILON);
-                    next_edge_gradient /= next_edge_length;
-
-                    // Add the force contribution from cell-cell and cell-boundary line tension (note the minus sign)
-                    force_on_node += -line_tension*previous_edge_gradient + line_tension*next_edge_gradient;
+                    force_on_node[dim] += line_tension*(mApicalSlotUnitVectors[DIM*slot + dim] - mApicalSlotUnitVectors[DIM*previous_slot + dim]);
                 }
+            }
+
+            p_cell_population->GetNode(mApicalNodeIndices[apical_index])->AddAppliedForceContribution(force_on_node);
+        }
+    }
+}
+
+template<unsigned DIM>
+unsigned ApicalEdgesForce<DIM>::GetNumRingSources(MutableVertexMesh<DIM,DIM>& rMesh)
+{
+    // In 3D the apical rings are faces of elements; otherwise they are the elements themselves
+    MutableVertexMesh<3,3>* p_mesh_3d = dynamic_cast<MutableVertexMesh<3,3>*>(&rMesh);
+    if (p_mesh_3d != NULL)
+    {
+        return p_mesh_3d->GetNumFaces();
+    }
+    return rMesh.GetNumAllElements();
+}
+
+template<unsigned DIM>
+void ApicalEdgesForce<DIM>::GetRingSourceNodes(MutableVertexMesh<DIM,DIM>& rMesh,
+                                               unsigned sourceIndex,
+                                               std::vector<unsigned>& rNodeIndices)
+{
+    rNodeIndices.clear();
+    MutableVertexMesh<3,3>* p_mesh_3d = dynamic_cast<MutableVertexMesh<3,3>*>(&rMesh);
+    if (p_mesh_3d != NULL)
+    {
+        VertexElement<2,3>* p_face = p_mesh_3d->GetFace(sourceIndex);
+        for (unsigned local_index=0; local_index<p_face->GetNumNodes(); local_index++)
+        {
+            rNodeIndices.push_back(p_face->GetNodeGlobalIndex(local_index));
+        }
+    }
+    else
+    {
+        VertexElement<DIM,DIM>* p_element = rMesh.GetElement(sourceIndex);
+        if (!p_element->IsDeleted())
+        {
+            for (unsigned local_index=0; local_index<p_element->GetNumNodes(); local_index++)
+            {
+                rNodeIndices.push_back(p_element->GetNodeGlobalIndex(local_index));
+            }
+        }
+    }
+}
+
+template<unsigned DIM>
+bool ApicalEdgesForce<DIM>::ApicalRingsAreStale(MutableVertexMesh<DIM,DIM>& rMesh)
+{
+    if ((mApicalRingOffsets.empty())
+        || (rMesh.GetNumAllNodes() != mNumNodesWhenBuilt)
+        || (rMesh.GetNumAllElements() != mNumElementsWhenBuilt)
+        || (GetNumRingSources(rMesh) != mNumRingSourcesWhenBuilt))
+    {
+        return true;
+    }
 
-                p_cell_population->GetNode(node_index)->AddAppliedForceContribution(force_on_node);
+    // A rearrangement may change the nodes of an apical face without changing the number of faces
+    std::vector<unsigned> source_nodes;
+    for (unsigned ring_index=0; ring_index<mApicalRingSources.size(); ring_index++)
+    {
+        GetRingSourceNodes(rMesh, mApicalRingSources[ring_index], source_nodes);
+        unsigned first_slot = mApicalRingOffsets[ring_index];
+        if (source_nodes.size() != mApicalRingOffsets[ring_index + 1] - first_slot)
+        {
+            return true;
+        }
+        for (unsigned i=0; i<source_nodes.size(); i++)
+        {
+            if (source_nodes[i] != mApicalRingNodes[first_slot + i])
+            {
+                return true;
             }
         }
     }
+    return false;
+}
+
+template<unsigned DIM>
+void ApicalEdgesForce<DIM>::BuildApicalRings(MutableVertexMesh<DIM,DIM>& rMesh)
+{
+    unsigned num_nodes = rMesh.GetNumAllNodes();
+    unsigned num_sources = GetNumRingSources(rMesh);
+
+    mApicalRingNodes.clear();
+    mApicalRingOffsets.assign(1, 0);
+    mApicalRingSources.clear();
+    mPreviousApicalSlots.clear();
+
+    // Record every face (or element) all of whose nodes are apical as an apical ring
+    std::vector<unsigned> source_nodes;
+    for (unsigned source_index=0; source_index<num_sources; source_index++)
+    {
+        GetRingSourceNodes(rMesh, source_index, source_nodes);
+        if (source_nodes.size() < 3)
+        {
+            continue;
+        }
+
+        bool is_apical = true;
+        for (unsigned i=0; i<source_nodes.size(); i++)
+        {
+            if (!rMesh.GetNode(source_nodes[i])->HasNodeAttributes())
+            {
+                is_apical = false;
+                break;
+            }
+        }
+
+        if (is_apical)
+        {
+            unsigned first_slot = mApicalRingNodes.size();
+            for (unsigned i=0; i<source_nodes.size(); i++)
+            {
+                mApicalRingNodes.push_back(source_nodes[i]);
+                mPreviousApicalSlots.push_back((i == 0) ? first_slot + source_nodes.size() - 1 : first_slot + i - 1);
+            }
+            mApicalRingOffsets.push_back(mApicalRingNodes.size());
+            mApicalRingSources.push_back(source_index);
+        }
+    }
+
+    // Group the slots by node, so that the force loop visits each apical node once
+    std::vector<unsigned> num_node_slots(num_nodes, 0);
+    for (unsigned slot=0; slot<mApicalRingNodes.size(); slot++)
+    {
+        num_node_slots[mApicalRingNodes[slot]]++;
+    }
+
+    std::vector<unsigned> apical_node_positions(num_nodes, UNSIGNED_UNSET);
+    mApicalNodeIndices.clear();
+    mApicalNodeSlotOffsets.assign(1, 0);
+    for (unsigned node_index=0; node_index<num_nodes; node_index++)
+    {
+        if (num_node_slots[node_index] > 0)
+        {
+            apical_node_positions[node_index] = mApicalNodeIndices.size();
+            mApicalNodeIndices.push_back(node_index);
+            mApicalNodeSlotOffsets.push_back(mApicalNodeSlotOffsets.back() + num_node_slots[node_index]);
+        }
+    }
+
+    mApicalNodeSlots.resize(mApicalRingNodes.size());
+    std::vector<unsigned> next_free(mApicalNodeSlotOffsets.begin(), mApicalNodeSlotOffsets.end() - 1);
+    for (unsigned slot=0; slot<mApicalRingNodes.size(); slot++)
+    {
+        mApicalNodeSlots[next_free[apical_node_positions[mApicalRingNodes[slot]]]++] = slot;
+    }
+
+    mNumNodesWhenBuilt = num_nodes;
+    mNumElementsWhenBuilt = rMesh.GetNumAllElements();
+    mNumRingSourcesWhenBuilt = num_sources;
 }
 
 template<unsigned DIM>
@@ -8,6 +8,7 @@
 #include "AbstractForce.hpp"
 #include "VertexBasedCellPopulation.hpp"
 #include <iostream>
+#include <vector>
 
 template<unsigned DIM>
 class ApicalEdgesForce  : public AbstractForce<DIM>
@@ -35,6 +36,77 @@ private:
         archive & mLambda;
     }
 
+    /**
+     * The apical rings of the mesh, stored as consecutive runs of global node indices in
+     * ring order. An apical ring is a face of an element (or, in 2D, an element) all of
+     * whose nodes are apical, that is have NodeAttributes, as specified by the
+     * HexagonalPrism3dVertexMeshGenerator used to construct the mesh. Each entry of
+     * this vector is a 'ring slot': the apical edge from that node to the next in its ring.
+     * The ring tables below are not archived, and are rebuilt when the topology changes.
+     */
+    std::vector<unsigned> mApicalRingNodes;
+
+    /** The index of the first slot of each apical ring in mApicalRingNodes, plus a final entry. */
+    std::vector<unsigned> mApicalRingOffsets;
+
+    /** The index of the face (or, in 2D, the element) from which each apical ring was taken. */
+    std::vector<unsigned> mApicalRingSources;
+
+    /** The slot preceding each slot in its ring. */
+    std::vector<unsigned> mPreviousApicalSlots;
+
+    /** The global index of each apical node contained in at least one apical ring. */
+    std::vector<unsigned> mApicalNodeIndices;
+
+    /** The index of the first slot of each apical node in mApicalNodeSlots, plus a final entry. */
+    std::vector<unsigned> mApicalNodeSlotOffsets;
+
+    /** The slots at which each apical node appears, grouped by apical node. */
+    std::vector<unsigned> mApicalNodeSlots;
+
+    /** The number of nodes in the mesh when the ring tables were built. */
+    unsigned mNumNodesWhenBuilt;
+
+    /** The number of elements in the mesh when the ring tables were built. */
+    unsigned mNumElementsWhenBuilt;
+
+    /** The number of faces (or, in 2D, elements) that may form apical rings when the ring tables were built. */
+    unsigned mNumRingSourcesWhenBuilt;
+
+    /** The unit vector along each ring slot, stored with stride DIM. */
+    std::vector<double> mApicalSlotUnitVectors;
+
+    /**
+     * @return the number of faces (or, in 2D, elements) of the mesh that may form apical rings.
+     *
+     * @param rMesh the vertex mesh
+     */
+    unsigned GetNumRingSources(MutableVertexMesh<DIM,DIM>& rMesh);
+
+    /**
+     * Get the global node indices, in order, of a face (or, in 2D, an element) of the mesh.
+     *
+     * @param rMesh the vertex mesh
+     * @param sourceIndex the index of the face or element
+     * @param rNodeIndices filled in with the global node indices
+     */
+    void GetRingSourceNodes(MutableVertexMesh<DIM,DIM>& rMesh, unsigned sourceIndex, std::vector<unsigned>& rNodeIndices);
+
+    /**
+     * @return whether the ring tables no longer describe the mesh, for example because
+     * a rearrangement has changed an apical face, or because they have not yet been built.
+     *
+     * @param rMesh the vertex mesh
+     */
+    bool ApicalRingsAreStale(MutableVertexMesh<DIM,DIM>& rMesh);
+
+    /**
+     * Rebuild the apical ring tables from the mesh.
+     *
+     * @param rMesh the vertex mesh
+     */
+    void BuildApicalRings(MutableVertexMesh<DIM,DIM>& rMesh);
+
 public:
 
     /**
@@ -59,6 +131,11 @@ public:
      */
     double GetLambda();
 
+    /**
+     * @return the global indices of the apical nodes found when the ring tables were last built.
+     */
+    const std::vector<unsigned>& rGetApicalNodeIndices() const;
+
     /**
      * Overridden AddForceContribution() method.
      *
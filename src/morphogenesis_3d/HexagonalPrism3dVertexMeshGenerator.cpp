@@ -2,6 +2,10 @@
 #include "HexagonalPrism3dVertexMeshGenerator.hpp"
 #include "Debug.hpp"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 HexagonalPrism3dVertexMeshGenerator::HexagonalPrism3dVertexMeshGenerator(unsigned numElementsInXDirection,
     unsigned numElementsInYDirection,
     double elementSideLength,
@@ -12,12 +16,21 @@ HexagonalPrism3dVertexMeshGenerator::HexagonalPrism3dVertexMeshGenerator(unsigne
     assert(elementSideLength > 0.0);
     assert(elementHeight > 0.0);
 
-    // First, create the lower and upper nodes, row by row in increasing x then y
+    /*
+     * The mesh is generated in two passes. First, the node coordinates and the connectivity of
+     * the faces and elements are computed into flat arrays of indices; then the mesh objects
+     * are allocated from these arrays. Each upper node lies directly above the lower node with
+     * the same index, offset by num_lower_nodes, so only the lower nodes and lower faces need
+     * to be described in the first pass.
+     */
+
+    // First, find the coordinates of the lower nodes, row by row in increasing x then y
     ///\todo change side lengths
     unsigned lower_node_index = 0;
     unsigned num_lower_nodes = 2*(numElementsInXDirection + numElementsInXDirection*numElementsInYDirection + numElementsInYDirection);
 
-    std::vector<Node<3>*> nodes(2*num_lower_nodes);
+    std::vector<double> lower_node_x(num_lower_nodes);
+    std::vector<double> lower_node_y(num_lower_nodes);
 
     // On each first row we have numElementsInXDirection nodes, all of which are boundary nodes
     for (unsigned i=0; i<numElementsInXDirection; i++)
@@ -25,15 +38,8 @@ HexagonalPrism3dVertexMeshGenerator::HexagonalPrism3dVertexMeshGenerator(unsigne
         double x = i+0.5;
         double y = 0.0;
 
-        // Lower node
-        Node<3>* p_lower_node = new Node<3>(lower_node_index, true, x, y, 0.0);
-        nodes[lower_node_index] = p_lower_node;
-
-        // Upper node
-        unsigned upper_node_index = num_lower_nodes + lower_node_index;
-        Node<3>* p_upper_node = new Node<3>(upper_node_index, true, x, y, elementHeight);
-        p_upper_node->AddNodeAttribute(1.0);
-        nodes[upper_node_index] = p_upper_node;
+        lower_node_x[lower_node_index] = x;
+        lower_node_y[lower_node_index] = y;
 
         lower_node_index++;
     }
@@ -45,15 +51,8 @@ HexagonalPrism3dVertexMeshGenerator::HexagonalPrism3dVertexMeshGenerator(unsigne
             double x = ((j%4 == 0)||(j%4 == 3)) ? i+0.5 : i;
             double y = (1.5*j - 0.5*(j%2))*0.5/sqrt(3.0);
 
-            // Lower node
-            Node<3>* p_lower_node = new Node<3>(lower_node_index, true, x, y, 0.0);
-            nodes[lower_node_index] = p_lower_node;
-
-            // Upper node
-            unsigned upper_node_index = num_lower_nodes + lower_node_index;
-            Node<3>* p_upper_node = new Node<3>(upper_node_index, true, x, y, elementHeight);
-            p_upper_node->AddNodeAttribute(1.0);
-            nodes[upper_node_index] = p_upper_node;
+            lower_node_x[lower_node_index] = x;
+            lower_node_y[lower_node_index] = y;
 
             lower_node_index++;
         }
@@ -64,15 +63,8 @@ HexagonalPrism3dVertexMeshGenerator::HexagonalPrism3dVertexMeshGenerator(unsigne
         double x = 0.5;
         double y = (1.5*(2*numElementsInYDirection+1) - 0.5*((2*numElementsInYDirection+1)%2))*0.5/sqrt(3.0);
 
-        // Lower node
-        Node<3>* p_lower_node = new Node<3>(lower_node_index, true, x, y, 0.0);
-        nodes[lower_node_index] = p_lower_node;
-
-        // Upper node
-        unsigned upper_node_index = num_lower_nodes + lower_node_index;
-        Node<3>* p_upper_node = new Node<3>(upper_node_index, true, x, y, elementHeight);
-        p_upper_node->AddNodeAttribute(1.0);
-        nodes[upper_node_index] = p_upper_node;
+        lower_node_x[lower_node_index] = x;
+        lower_node_y[lower_node_index] = y;
 
         lower_node_index++;
     }
@@ -81,15 +73,8 @@ HexagonalPrism3dVertexMeshGenerator::HexagonalPrism3dVertexMeshGenerator(unsigne
         double x = (((2*numElementsInYDirection+1)%4 == 0)||((2*numElementsInYDirection+1)%4 == 3)) ? i+0.5 : i;
         double y = (1.5*(2*numElementsInYDirection+1) - 0.5*((2*numElementsInYDirection+1)%2))*0.5/sqrt(3.0);
 
-        // Lower node
-        Node<3>* p_lower_node = new Node<3>(lower_node_index, true, x, y, 0.0);
-        nodes[lower_node_index] = p_lower_node;
-
-        // Upper node
-        unsigned upper_node_index = num_lower_nodes + lower_node_index;
-        Node<3>* p_upper_node = new Node<3>(upper_node_index, true, x, y, elementHeight);
-        p_upper_node->AddNodeAttribute(1.0);
-        nodes[upper_node_index] = p_upper_node;
+        lower_node_x[lower_node_index] = x;
+        lower_node_y[lower_node_index] = y;
 
         lower_node_index++;
     }
@@ -98,15 +83,8 @@ HexagonalPrism3dVertexMeshGenerator::HexagonalPrism3dVertexMeshGenerator(unsigne
         double x = numElementsInXDirection;
         double y = (1.5*(2*numElementsInYDirection+1) - 0.5*((2*numElementsInYDirection+1)%2))*0.5/sqrt(3.0);
 
-        // Lower node
-        Node<3>* p_lower_node = new Node<3>(lower_node_index, true, x, y, 0.0);
-        nodes[lower_node_index] = p_lower_node;
-
-        // Upper node
-        unsigned upper_node_index = num_lower_nodes + lower_node_index;
-        Node<3>* p_upper_node = new Node<3>(upper_node_index, true, x, y, elementHeight);
-        p_upper_node->AddNodeAttribute(1.0);
-        nodes[upper_node_index] = p_upper_node;
+        lower_node_x[lower_node_index] = x;
+        lower_node_y[lower_node_index] = y;
 
         lower_node_index++; ///\todo remove this line?
     }
@@ -114,14 +92,25 @@ HexagonalPrism3dVertexMeshGenerator::HexagonalPrism3dVertexMeshGenerator(unsigne
     unsigned num_lower_faces = numElementsInXDirection*numElementsInYDirection;
     unsigned num_lateral_faces = 3*numElementsInXDirection*numElementsInYDirection + 2*(numElementsInXDirection + numElementsInYDirection) - 1;
 
-    std::vector<VertexElement<2,3>*> faces(2*num_lower_faces + num_lateral_faces);
+    unsigned first_lateral_face_index = 2*num_lower_faces;
 
-    // Create the lower and upper faces of elements (global node indices for each face are given anticlockwise)
-    unsigned node_indices_for_face[6];
-    for (unsigned j=0; j<numElementsInYDirection; j++)
+    // The lower node indices of each lower face, stored with stride 6
+    std::vector<unsigned> hexagon_node_indices(6*num_lower_faces);
+
+    // The two lower node indices of each lateral face, stored with stride 2
+    std::vector<unsigned> lateral_face_node_indices(2*num_lateral_faces);
+
+    // Find the lower and upper faces of elements (global node indices for each face are given anticlockwise); each row is independent
+    int num_rows = (int)numElementsInYDirection;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int row=0; row<num_rows; row++)
     {
+        unsigned j = row;
         for (unsigned i=0; i<numElementsInXDirection; i++)
         {
+            unsigned node_indices_for_face[6];
             if (j==0)
             {
                 node_indices_for_face[0] = i;
@@ -136,31 +125,18 @@ HexagonalPrism3dVertexMeshGenerator::HexagonalPrism3dVertexMeshGenerator(unsigne
             node_indices_for_face[4] = node_indices_for_face[2] - 1;
             node_indices_for_face[5] = node_indices_for_face[1] - 1;
 
-            // Create lower face
-            std::vector<Node<3>*> nodes_for_lower_face;
-            for (unsigned k=0; k<6; k++)
-            {
-                nodes_for_lower_face.push_back(nodes[node_indices_for_face[k]]);
-            }
+            // The upper face of this element has the same nodes, offset by num_lower_nodes
             unsigned lower_face_index = j*numElementsInXDirection + i;
-            VertexElement<2,3>* p_lower_face = new VertexElement<2,3>(lower_face_index, nodes_for_lower_face);
-            faces[lower_face_index] = p_lower_face;
-
-            // Create upper face
-            std::vector<Node<3>*> nodes_for_upper_face;
             for (unsigned k=0; k<6; k++)
             {
-                nodes_for_upper_face.push_back(nodes[node_indices_for_face[k] + num_lower_nodes]);
+                hexagon_node_indices[6*lower_face_index + k] = node_indices_for_face[k];
             }
-            unsigned upper_face_index = j*numElementsInXDirection + i + num_lower_faces;
-            VertexElement<2,3>* p_upper_face = new VertexElement<2,3>(upper_face_index, nodes_for_upper_face);
-            faces[upper_face_index] = p_upper_face;
         }
     }
 
-    // Create the lateral faces of elements (global node indices for each face are given anticlockwise)
+    // Find the lateral faces of elements (global node indices for each face are given anticlockwise)
 
-    // Create the lateral faces of the 'bottom left' element (in the xy plane)
+    // Find the lateral faces of the 'bottom left' element (in the xy plane)
     unsigned lateral_node_indices_for_element[6];
     lateral_node_indices_for_element[0] = 0;
     lateral_node_indices_for_element[1] = numElementsInXDirection + 1;
@@ -171,24 +147,12 @@ HexagonalPrism3dVertexMeshGenerator::HexagonalPrism3dVertexMeshGenerator(unsigne
 
     for (unsigned local_face_index=0; local_face_index<6; local_face_index++)
     {
-        unsigned node_indices_for_face[4];
-        node_indices_for_face[0] = lateral_node_indices_for_element[local_face_index];
-        node_indices_for_face[1] = lateral_node_indices_for_element[(local_face_index+1)%6];
-        node_indices_for_face[2] = node_indices_for_face[1] + num_lower_nodes;
-        node_indices_for_face[3] = node_indices_for_face[0] + num_lower_nodes;
-
-        std::vector<Node<3>*> nodes_for_lateral_face;
-        for (unsigned k=0; k<4; k++)
-        {
-            nodes_for_lateral_face.push_back(nodes[node_indices_for_face[k]]);
-        }
-
         unsigned lateral_face_index = 2*num_lower_faces + local_face_index;
-        VertexElement<2,3>* p_lateral_face = new VertexElement<2,3>(lateral_face_index, nodes_for_lateral_face);
-        faces[lateral_face_index] = p_lateral_face;
+        lateral_face_node_indices[2*(lateral_face_index - first_lateral_face_index)] = lateral_node_indices_for_element[local_face_index];
+        lateral_face_node_indices[2*(lateral_face_index - first_lateral_face_index) + 1] = lateral_node_indices_for_element[(local_face_index+1)%6];
     }
 
-    // Create the lateral faces of the other elements in this row (in the x direction)
+    // Find the lateral faces of the other elements in this row (in the x direction)
     for (unsigned local_elem_index=1; local_elem_index<numElementsInXDirection; local_elem_index++)
     {
         unsigned lateral_node_indices_for_element[6];
@@ -201,21 +165,9 @@ HexagonalPrism3dVertexMeshGenerator::HexagonalPrism3dVertexMeshGenerator(unsigne
 
         for (unsigned local_face_index=0; local_face_index<5; local_face_index++)
         {
-            unsigned node_indices_for_face[4];
-            node_indices_for_face[0] = lateral_node_indices_for_element[local_face_index];
-            node_indices_for_face[1] = lateral_node_indices_for_element[local_face_index+1];
-            node_indices_for_face[2] = node_indices_for_face[1] + num_lower_nodes;
-            node_indices_for_face[3] = node_indices_for_face[0] + num_lower_nodes;
-
-            std::vector<Node<3>*> nodes_for_lateral_face;
-            for (unsigned k=0; k<4; k++)
-            {
-                nodes_for_lateral_face.push_back(nodes[node_indices_for_face[k]]);
-            }
-
             unsigned lateral_face_index = 2*num_lower_faces + 6 + 5*(local_elem_index-1) + local_face_index;
-            VertexElement<2,3>* p_lateral_face = new VertexElement<2,3>(lateral_face_index, nodes_for_lateral_face);
-            faces[lateral_face_index] = p_lateral_face;
+            lateral_face_node_indices[2*(lateral_face_index - first_lateral_face_index)] = lateral_node_indices_for_element[local_face_index];
+            lateral_face_node_indices[2*(lateral_face_index - first_lateral_face_index) + 1] = lateral_node_indices_for_element[local_face_index+1];
         }
     }
 
@@ -226,7 +178,7 @@ HexagonalPrism3dVertexMeshGenerator::HexagonalPrism3dVertexMeshGenerator(unsigne
 
         if (j%2 == 1)
         {
-            // Create the lateral faces of the left-most element in this row (in the x direction)
+            // Find the lateral faces of the left-most element in this row (in the x direction)
             unsigned lateral_node_indices_for_leftmost_element[5];
             lateral_node_indices_for_leftmost_element[0] = (numElementsInXDirection + 1)*(1 + 2*j);
             lateral_node_indices_for_leftmost_element[1] = lateral_node_indices_for_leftmost_element[0] + numElementsInXDirection + 1;
@@ -236,24 +188,12 @@ HexagonalPrism3dVertexMeshGenerator::HexagonalPrism3dVertexMeshGenerator(unsigne
 
             for (unsigned local_face_index=0; local_face_index<4; local_face_index++)
             {
-                unsigned node_indices_for_face[4];
-                node_indices_for_face[0] = lateral_node_indices_for_leftmost_element[local_face_index];
-                node_indices_for_face[1] = lateral_node_indices_for_leftmost_element[local_face_index+1];
-                node_indices_for_face[2] = node_indices_for_face[1] + num_lower_nodes;
-                node_indices_for_face[3] = node_indices_for_face[0] + num_lower_nodes;
-
-                std::vector<Node<3>*> nodes_for_lateral_face;
-                for (unsigned k=0; k<4; k++)
-                {
-                    nodes_for_lateral_face.push_back(nodes[node_indices_for_face[k]]);
-                }
-
                 unsigned lateral_face_index = smallest_lateral_face_index_this_row + local_face_index;
-                VertexElement<2,3>* p_lateral_face = new VertexElement<2,3>(lateral_face_index, nodes_for_lateral_face);
-                faces[lateral_face_index] = p_lateral_face;
+                lateral_face_node_indices[2*(lateral_face_index - first_lateral_face_index)] = lateral_node_indices_for_leftmost_element[local_face_index];
+                lateral_face_node_indices[2*(lateral_face_index - first_lateral_face_index) + 1] = lateral_node_indices_for_leftmost_element[local_face_index+1];
             }
 
-            // Create the lateral faces of the intermediate elements in this row (in the x direction)
+            // Find the lateral faces of the intermediate elements in this row (in the x direction)
             for (unsigned i=1; i<numElementsInXDirection-1; i++)
             {
                 unsigned lateral_node_indices_for_element[4];
@@ -264,25 +204,13 @@ HexagonalPrism3dVertexMeshGenerator::HexagonalPrism3dVertexMeshGenerator(unsigne
 
                 for (unsigned local_face_index=0; local_face_index<3; local_face_index++)
                 {
-                    unsigned node_indices_for_face[4];
-                    node_indices_for_face[0] = lateral_node_indices_for_element[local_face_index];
-                    node_indices_for_face[1] = lateral_node_indices_for_element[local_face_index+1];
-                    node_indices_for_face[2] = node_indices_for_face[1] + num_lower_nodes;
-                    node_indices_for_face[3] = node_indices_for_face[0] + num_lower_nodes;
-
-                    std::vector<Node<3>*> nodes_for_lateral_face;
-                    for (unsigned k=0; k<4; k++)
-                    {
-                        nodes_for_lateral_face.push_back(nodes[node_indices_for_face[k]]);
-                    }
-
                     unsigned lateral_face_index = smallest_lateral_face_index_this_row + 1 + 3*i + local_face_index;
-                    VertexElement<2,3>* p_lateral_face = new VertexElement<2,3>(lateral_face_index, nodes_for_lateral_face);
-                    faces[lateral_face_index] = p_lateral_face;
+                    lateral_face_node_indices[2*(lateral_face_index - first_lateral_face_index)] = lateral_node_indices_for_element[local_face_index];
+                    lateral_face_node_indices[2*(lateral_face_index - first_lateral_face_index) + 1] = lateral_node_indices_for_element[local_face_index+1];
                 }
             }
 
-            // Create the lateral faces of the right-most element in this row (in the x direction)
+            // Find the lateral faces of the right-most element in this row (in the x direction)
             unsigned lateral_node_indices_for_rightmost_element[5];
             lateral_node_indices_for_rightmost_element[0] = (numElementsInXDirection + 1)*(1 + 2*j) - 2;
             lateral_node_indices_for_rightmost_element[1] = lateral_node_indices_for_rightmost_element[0] + numElementsInXDirection + 1;
@@ -292,26 +220,14 @@ HexagonalPrism3dVertexMeshGenerator::HexagonalPrism3dVertexMeshGenerator(unsigne
 
             for (unsigned local_face_index=0; local_face_index<4; local_face_index++)
             {
-                unsigned node_indices_for_face[4];
-                node_indices_for_face[0] = lateral_node_indices_for_rightmost_element[local_face_index];
-                node_indices_for_face[1] = lateral_node_indices_for_rightmost_element[local_face_index+1];
-                node_indices_for_face[2] = node_indices_for_face[1] + num_lower_nodes;
-                node_indices_for_face[3] = node_indices_for_face[0] + num_lower_nodes;
-
-                std::vector<Node<3>*> nodes_for_lateral_face;
-                for (unsigned k=0; k<4; k++)
-                {
-                    nodes_for_lateral_face.push_back(nodes[node_indices_for_face[k]]);
-                }
-
                 unsigned lateral_face_index = smallest_lateral_face_index_this_row + 1 + 3*(numElementsInXDirection-1) + local_face_index;
-                VertexElement<2,3>* p_lateral_face = new VertexElement<2,3>(lateral_face_index, nodes_for_lateral_face);
-                faces[lateral_face_index] = p_lateral_face;
+                lateral_face_node_indices[2*(lateral_face_index - first_lateral_face_index)] = lateral_node_indices_for_rightmost_element[local_face_index];
+                lateral_face_node_indices[2*(lateral_face_index - first_lateral_face_index) + 1] = lateral_node_indices_for_rightmost_element[local_face_index+1];
             }
         }
         else // j%2 == 0
         {
-            // Create the lateral faces of the left-most element in this row (in the x direction)
+            // Find the lateral faces of the left-most element in this row (in the x direction)
             unsigned lateral_node_indices_for_leftmost_element[6];
             lateral_node_indices_for_leftmost_element[0] = (numElementsInXDirection + 1)*(2*j + 1);
             lateral_node_indices_for_leftmost_element[1] = lateral_node_indices_for_leftmost_element[0] + numElementsInXDirection + 1;
@@ -322,24 +238,12 @@ HexagonalPrism3dVertexMeshGenerator::HexagonalPrism3dVertexMeshGenerator(unsigne
 
             for (unsigned local_face_index=0; local_face_index<5; local_face_index++)
             {
-                unsigned node_indices_for_face[4];
-                node_indices_for_face[0] = lateral_node_indices_for_leftmost_element[local_face_index];
-                node_indices_for_face[1] = lateral_node_indices_for_leftmost_element[local_face_index+1];
-                node_indices_for_face[2] = node_indices_for_face[1] + num_lower_nodes;
-                node_indices_for_face[3] = node_indices_for_face[0] + num_lower_nodes;
-
-                std::vector<Node<3>*> nodes_for_lateral_face;
-                for (unsigned k=0; k<4; k++)
-                {
-                    nodes_for_lateral_face.push_back(nodes[node_indices_for_face[k]]);
-                }
-
                 unsigned lateral_face_index = smallest_lateral_face_index_this_row + local_face_index;
-                VertexElement<2,3>* p_lateral_face = new VertexElement<2,3>(lateral_face_index, nodes_for_lateral_face);
-                faces[lateral_face_index] = p_lateral_face;
+                lateral_face_node_indices[2*(lateral_face_index - first_lateral_face_index)] = lateral_node_indices_for_leftmost_element[local_face_index];
+                lateral_face_node_indices[2*(lateral_face_index - first_lateral_face_index) + 1] = lateral_node_indices_for_leftmost_element[local_face_index+1];
             }
 
-            // Create the lateral faces of the other elements in this row (in the x direction)
+            // Find the lateral faces of the other elements in this row (in the x direction)
             for (unsigned i=1; i<numElementsInXDirection; i++)
             {
                 unsigned lateral_node_indices_for_element[4];
@@ -350,35 +254,17 @@ HexagonalPrism3dVertexMeshGenerator::HexagonalPrism3dVertexMeshGenerator(unsigne
 
                 for (unsigned local_face_index=0; local_face_index<3; local_face_index++)
                 {
-                    unsigned node_indices_for_face[4];
-                    node_indices_for_face[0] = lateral_node_indices_for_element[local_face_index];
-                    node_indices_for_face[1] = lateral_node_indices_for_element[local_face_index+1];
-                    node_indices_for_face[2] = node_indices_for_face[1] + num_lower_nodes;
-                    node_indices_for_face[3] = node_indices_for_face[0] + num_lower_nodes;
-
-                    std::vector<Node<3>*> nodes_for_lateral_face;
-                    for (unsigned k=0; k<4; k++)
-                    {
-                        nodes_for_lateral_face.push_back(nodes[node_indices_for_face[k]]);
-                    }
-
                     unsigned lateral_face_index = smallest_lateral_face_index_this_row + 2 + 3*i + local_face_index;
-                    VertexElement<2,3>* p_lateral_face = new VertexElement<2,3>(lateral_face_index, nodes_for_lateral_face);
-                    faces[lateral_face_index] = p_lateral_face;
+                    lateral_face_node_indices[2*(lateral_face_index - first_lateral_face_index)] = lateral_node_indices_for_element[local_face_index];
+                    lateral_face_node_indices[2*(lateral_face_index - first_lateral_face_index) + 1] = lateral_node_indices_for_element[local_face_index+1];
                 }
             }
         }
     }
 
-    // Create vector of face orientations
-    ///\todo think carefully about whether all faces are oriented anticlockwise
-    std::vector<bool> face_orientations;
-    for (unsigned i=0; i<faces.size(); i++)
-    {
-        face_orientations.push_back(true);
-    }
-
-    std::vector<VertexElement<3,3>*> elements;
+    // The indices of the faces of each element, stored with stride 8
+    unsigned num_elements = numElementsInXDirection*numElementsInYDirection;
+    std::vector<unsigned> element_face_indices(8*num_elements);
 
     // Store the indices of the faces that will form the 'bottom left' element (in the xy plane)
     unsigned face_indices[8];
@@ -391,18 +277,12 @@ HexagonalPrism3dVertexMeshGenerator::HexagonalPrism3dVertexMeshGenerator(unsigne
     face_indices[6] = 2*num_lower_faces + 4;
     face_indices[7] = 2*num_lower_faces + 5;
 
-    // Create and populate vectors of the faces and face orientations for this element
-    std::vector<VertexElement<2,3>*> faces_for_element;
-    std::vector<bool> orientations_for_element;
     for (unsigned k=0; k<8; k++)
     {
-        faces_for_element.push_back(faces[face_indices[k]]);
-        orientations_for_element.push_back(face_orientations[face_indices[k]]);
+        element_face_indices[k] = face_indices[k];
     }
 
-    elements.push_back(new VertexElement<3,3>(0, faces_for_element, orientations_for_element));
-
-    // Create the other elements in this row (in the x direction)
+    // Find the faces of the other elements in this row (in the x direction)
     for (unsigned i=1; i<numElementsInXDirection; i++)
     {
         // Store the indices of the faces that will form this element
@@ -416,23 +296,21 @@ HexagonalPrism3dVertexMeshGenerator::HexagonalPrism3dVertexMeshGenerator(unsigne
         face_indices[6] = 2*num_lower_faces + 5*i + 5;
         face_indices[7] = 2*num_lower_faces + 5*i - 2 - 2*(i==1);
 
-        // Create and populate vectors of the faces and face orientations for this element
-        std::vector<VertexElement<2,3>*> faces_for_element;
-        std::vector<bool> orientations_for_element;
         for (unsigned k=0; k<8; k++)
         {
-            faces_for_element.push_back(faces[face_indices[k]]);
-            orientations_for_element.push_back(face_orientations[face_indices[k]]);
+            element_face_indices[8*i + k] = face_indices[k];
         }
-
-        elements.push_back(new VertexElement<3,3>(i, faces_for_element, orientations_for_element));
     }
 
-    // Create all other elements
+    // Find the faces of all other elements; each row is independent
     if (numElementsInYDirection != 1)
     {
-        for (unsigned j=1; j<numElementsInYDirection; j++)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int row=1; row<num_rows; row++)
         {
+            unsigned j = row;
             for (unsigned i=0; i<numElementsInXDirection; i++)
             {
                 // Store the indices of the faces that will form this element
@@ -534,21 +412,76 @@ HexagonalPrism3dVertexMeshGenerator::HexagonalPrism3dVertexMeshGenerator(unsigne
                     face_indices[7] = 1 + 2*numElementsInXDirection*numElementsInYDirection + 5*numElementsInXDirection + 1 + (j-2)*(3*numElementsInXDirection + 2) + (3*i + 2)*(i > 0);
                 }
 
-                // Create and populate vectors of the faces and face orientations for this element
-                std::vector<VertexElement<2,3>*> faces_for_element;
-                std::vector<bool> orientations_for_element;
+                unsigned elem_index = i + j*numElementsInXDirection;
                 for (unsigned k=0; k<8; k++)
                 {
-                    faces_for_element.push_back(faces[face_indices[k]]);
-                    orientations_for_element.push_back(face_orientations[face_indices[k]]);
+                    element_face_indices[8*elem_index + k] = face_indices[k];
                 }
-
-                unsigned elem_index = i + j*numElementsInXDirection;
-                elements.push_back(new VertexElement<3,3>(elem_index, faces_for_element, orientations_for_element));
             }
         }
     }
 
+    // Now allocate the nodes...
+    std::vector<Node<3>*> nodes(2*num_lower_nodes);
+    for (unsigned index=0; index<num_lower_nodes; index++)
+    {
+        nodes[index] = new Node<3>(index, true, lower_node_x[index], lower_node_y[index], 0.0);
+
+        Node<3>* p_upper_node = new Node<3>(num_lower_nodes + index, true, lower_node_x[index], lower_node_y[index], elementHeight);
+        p_upper_node->AddNodeAttribute(1.0);
+        nodes[num_lower_nodes + index] = p_upper_node;
+    }
+
+    // ...then the faces, reusing a single vector of node pointers...
+    std::vector<VertexElement<2,3>*> faces(2*num_lower_faces + num_lateral_faces);
+    std::vector<Node<3>*> nodes_for_face;
+    nodes_for_face.reserve(6);
+    for (unsigned lower_face_index=0; lower_face_index<num_lower_faces; lower_face_index++)
+    {
+        nodes_for_face.clear();
+        for (unsigned k=0; k<6; k++)
+        {
+            nodes_for_face.push_back(nodes[hexagon_node_indices[6*lower_face_index + k]]);
+        }
+        faces[lower_face_index] = new VertexElement<2,3>(lower_face_index, nodes_for_face);
+
+        nodes_for_face.clear();
+        for (unsigned k=0; k<6; k++)
+        {
+            nodes_for_face.push_back(nodes[hexagon_node_indices[6*lower_face_index + k] + num_lower_nodes]);
+        }
+        unsigned upper_face_index = lower_face_index + num_lower_faces;
+        faces[upper_face_index] = new VertexElement<2,3>(upper_face_index, nodes_for_face);
+    }
+    for (unsigned lateral_index=0; lateral_index<num_lateral_faces; lateral_index++)
+    {
+        unsigned node_a = lateral_face_node_indices[2*lateral_index];
+        unsigned node_b = lateral_face_node_indices[2*lateral_index + 1];
+
+        nodes_for_face.clear();
+        nodes_for_face.push_back(nodes[node_a]);
+        nodes_for_face.push_back(nodes[node_b]);
+        nodes_for_face.push_back(nodes[node_b + num_lower_nodes]);
+        nodes_for_face.push_back(nodes[node_a + num_lower_nodes]);
+
+        unsigned lateral_face_index = first_lateral_face_index + lateral_index;
+        faces[lateral_face_index] = new VertexElement<2,3>(lateral_face_index, nodes_for_face);
+    }
+
+    // ...and finally the elements
+    ///\todo think carefully about whether all faces are oriented anticlockwise
+    std::vector<VertexElement<3,3>*> elements(num_elements);
+    std::vector<VertexElement<2,3>*> faces_for_element(8);
+    std::vector<bool> orientations_for_element(8, true);
+    for (unsigned elem_index=0; elem_index<num_elements; elem_index++)
+    {
+        for (unsigned k=0; k<8; k++)
+        {
+            faces_for_element[k] = faces[element_face_indices[8*elem_index + k]];
+        }
+        elements[elem_index] = new VertexElement<3,3>(elem_index, faces_for_element, orientations_for_element);
+    }
+
     /*
      * Finally, reorder the local indices of the nodes within each element,
      * so that the local indices 0 to 5 correspond to the lower nodes in
@@ -559,10 +492,11 @@ HexagonalPrism3dVertexMeshGenerator::HexagonalPrism3dVertexMeshGenerator(unsigne
     {
         VertexElement<3,3>* p_element = elements[elem_index];
 
-        std::vector<Node<3>*> temp_nodes;
-        for (unsigned temp_index=0; temp_index<p_element->GetNumNodes(); temp_index++)
+        assert(p_element->GetNumNodes() == 12);
+        Node<3>* temp_nodes[12];
+        for (unsigned temp_index=0; temp_index<12; temp_index++)
         {
-            temp_nodes.push_back(p_element->GetNode(temp_index));
+            temp_nodes[temp_index] = p_element->GetNode(temp_index);
         }
 
         // Node 0 already has the correct local index
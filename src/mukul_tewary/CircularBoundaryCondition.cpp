@@ -4,7 +4,7 @@
 CircularBoundaryCondition::CircularBoundaryCondition(AbstractCellPopulation<2>* pCellPopulation,
 													 c_vector<double,2> centre,
 													 double radius)
-    : AbstractCellPopulationBoundaryCondition<2>(pCellPopulation),
+    : AbstractIndexedBoundaryCondition<2>(pCellPopulation),
       mCentreOfCircle(centre),
       mRadiusOfCircle(radius)
 {
@@ -21,9 +21,9 @@ double CircularBoundaryCondition::GetRadiusOfCircle() const
     return mRadiusOfCircle;
 }
 
-void CircularBoundaryCondition::ImposeBoundaryCondition(const std::map<Node<2>*, c_vector<double,2> >& rOldLocations)
+void CircularBoundaryCondition::ImposeIndexedBoundaryCondition(const std::vector<c_vector<double,2> >& rOldLocations)
 {
-    assert(dynamic_cast<AbstractCentreBasedCellPopulation<1>*>(this->mpCellPopulation) != nullptr);
+    assert(dynamic_cast<AbstractCentreBasedCellPopulation<2>*>(this->mpCellPopulation) != nullptr);
 
     for (AbstractCellPopulation<2>::Iterator cell_iter = this->mpCellPopulation->Begin();
          cell_iter != this->mpCellPopulation->End();
@@ -41,11 +41,16 @@ void CircularBoundaryCondition::ImposeBoundaryCondition(const std::map<Node<2>*,
     }
 }
 
+bool CircularBoundaryCondition::UsesOldLocations() const
+{
+    return false;
+}
+
 bool CircularBoundaryCondition::VerifyBoundaryCondition()
 {
     bool condition_satisfied = true;
 
-    assert(dynamic_cast<AbstractCentreBasedCellPopulation<1>*>(this->mpCellPopulation) != nullptr);
+    assert(dynamic_cast<AbstractCentreBasedCellPopulation<2>*>(this->mpCellPopulation) != nullptr);
 
     for (AbstractCellPopulation<2>::Iterator cell_iter = this->mpCellPopulation->Begin();
          cell_iter != this->mpCellPopulation->End();
@@ -68,7 +73,7 @@ void CircularBoundaryCondition::OutputCellPopulationBoundaryConditionParameters(
 {
     *rParamsFile << "\t\t\t<CentreOfCircle>" << mCentreOfCircle[0] << "," << mCentreOfCircle[1] << "</CentreOfCircle>\n";
     *rParamsFile << "\t\t\t<RadiusOfCircle>" << mRadiusOfCircle << "</RadiusOfCircle>\n";
-    AbstractCellPopulationBoundaryCondition<2>::OutputCellPopulationBoundaryConditionParameters(rParamsFile);
+    AbstractIndexedBoundaryCondition<2>::OutputCellPopulationBoundaryConditionParameters(rParamsFile);
 }
 
 // Serialization for Boost >= 1.36
@@ -1,13 +1,13 @@
 #ifndef CIRCULARBOUNDARYCONDITION_HPP_
 #define CIRCULARBOUNDARYCONDITION_HPP_
 
-#include "AbstractCellPopulationBoundaryCondition.hpp"
+#include "AbstractIndexedBoundaryCondition.hpp"
 
 #include "ChasteSerialization.hpp"
 #include <boost/serialization/base_object.hpp>
 #include <boost/serialization/vector.hpp>
 
-class CircularBoundaryCondition : public AbstractCellPopulationBoundaryCondition<2>
+class CircularBoundaryCondition : public AbstractIndexedBoundaryCondition<2>
 {
 private:
 
@@ -18,7 +18,7 @@ private:
     template<class Archive>
     void serialize(Archive & archive, const unsigned int version)
     {
-        archive & boost::serialization::base_object<AbstractCellPopulationBoundaryCondition<2> >(*this);
+        archive & boost::serialization::base_object<AbstractIndexedBoundaryCondition<2> >(*this);
     }
 
 public:
@@ -31,7 +31,9 @@ public:
 
     double GetRadiusOfCircle() const;
 
-    void ImposeBoundaryCondition(const std::map<Node<2>*, c_vector<double,2> >& rOldLocations);
+    void ImposeIndexedBoundaryCondition(const std::vector<c_vector<double,2> >& rOldLocations);
+
+    bool UsesOldLocations() const;
 
     bool VerifyBoundaryCondition();
 
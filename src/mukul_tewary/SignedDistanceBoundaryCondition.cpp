@@ -0,0 +1,153 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "SignedDistanceBoundaryCondition.hpp"
+
+template<unsigned DIM>
+SignedDistanceBoundaryCondition<DIM>::SignedDistanceBoundaryCondition(AbstractCellPopulation<DIM>* pCellPopulation,
+                                                                      boost::shared_ptr<SignedDistanceGrid<DIM> > pGrid)
+    : AbstractIndexedBoundaryCondition<DIM>(pCellPopulation),
+      mpGrid(pGrid),
+      mTolerance(1e-4)
+{
+}
+
+template<unsigned DIM>
+const boost::shared_ptr<SignedDistanceGrid<DIM> > SignedDistanceBoundaryCondition<DIM>::GetGrid() const
+{
+    return mpGrid;
+}
+
+template<unsigned DIM>
+double SignedDistanceBoundaryCondition<DIM>::GetTolerance() const
+{
+    return mTolerance;
+}
+
+template<unsigned DIM>
+void SignedDistanceBoundaryCondition<DIM>::SetTolerance(double tolerance)
+{
+    mTolerance = tolerance;
+}
+
+template<unsigned DIM>
+void SignedDistanceBoundaryCondition<DIM>::GatherNodeLocations()
+{
+    // Node indices need not be contiguous (for example after cells die in a NodesOnlyMesh), so use the node iterator
+    AbstractMesh<DIM,DIM>& r_mesh = this->mpCellPopulation->rGetMesh();
+    mNodeLocations.clear();
+    mNodeLocations.reserve(DIM*r_mesh.GetNumNodes());
+    for (typename AbstractMesh<DIM,DIM>::NodeIterator node_iter = r_mesh.GetNodeIteratorBegin();
+         node_iter != r_mesh.GetNodeIteratorEnd();
+         ++node_iter)
+    {
+        const c_vector<double, DIM>& r_location = node_iter->rGetLocation();
+        for (unsigned d=0; d<DIM; d++)
+        {
+            mNodeLocations.push_back(r_location[d]);
+        }
+    }
+}
+
+template<unsigned DIM>
+void SignedDistanceBoundaryCondition<DIM>::ImposeIndexedBoundaryCondition(const std::vector<c_vector<double, DIM> >& rOldLocations)
+{
+    GatherNodeLocations();
+
+    unsigned num_nodes = mNodeLocations.size()/DIM;
+    if (num_nodes > 0)
+    {
+        mpGrid->ProjectOntoDomain(&mNodeLocations[0], num_nodes);
+    }
+
+    // The nodes are visited in the same order as in GatherNodeLocations()
+    AbstractMesh<DIM,DIM>& r_mesh = this->mpCellPopulation->rGetMesh();
+    unsigned num_scattered = 0;
+    for (typename AbstractMesh<DIM,DIM>::NodeIterator node_iter = r_mesh.GetNodeIteratorBegin();
+         node_iter != r_mesh.GetNodeIteratorEnd();
+         ++node_iter)
+    {
+        c_vector<double, DIM>& r_location = node_iter->rGetModifiableLocation();
+        for (unsigned d=0; d<DIM; d++)
+        {
+            r_location[d] = mNodeLocations[DIM*num_scattered + d];
+        }
+        num_scattered++;
+    }
+}
+
+template<unsigned DIM>
+bool SignedDistanceBoundaryCondition<DIM>::UsesOldLocations() const
+{
+    return false;
+}
+
+template<unsigned DIM>
+bool SignedDistanceBoundaryCondition<DIM>::VerifyBoundaryCondition()
+{
+    GatherNodeLocations();
+
+    unsigned num_nodes = mNodeLocations.size()/DIM;
+    if (num_nodes == 0)
+    {
+        return true;
+    }
+    return (mpGrid->GetMaxSignedDistance(&mNodeLocations[0], num_nodes) <= mTolerance);
+}
+
+template<unsigned DIM>
+void SignedDistanceBoundaryCondition<DIM>::OutputCellPopulationBoundaryConditionParameters(out_stream& rParamsFile)
+{
+    *rParamsFile << "\t\t\t<GridSpacing>" << mpGrid->GetSpacing() << "</GridSpacing>\n";
+    *rParamsFile << "\t\t\t<GridNumPoints>";
+    for (unsigned d=0; d<DIM; d++)
+    {
+        *rParamsFile << (d > 0 ? "," : "") << mpGrid->rGetNumPoints()[d];
+    }
+    *rParamsFile << "</GridNumPoints>\n";
+    *rParamsFile << "\t\t\t<Tolerance>" << mTolerance << "</Tolerance>\n";
+
+    // Call method on direct parent class
+    AbstractIndexedBoundaryCondition<DIM>::OutputCellPopulationBoundaryConditionParameters(rParamsFile);
+}
+
+// Explicit instantiation
+template class SignedDistanceBoundaryCondition<1>;
+template class SignedDistanceBoundaryCondition<2>;
+template class SignedDistanceBoundaryCondition<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(SignedDistanceBoundaryCondition)
@@ -0,0 +1,192 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef SIGNEDDISTANCEBOUNDARYCONDITION_HPP_
+#define SIGNEDDISTANCEBOUNDARYCONDITION_HPP_
+
+#include "AbstractIndexedBoundaryCondition.hpp"
+#include "SignedDistanceGrid.hpp"
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+#include <boost/serialization/shared_ptr.hpp>
+
+/**
+ * A boundary condition that confines every node of a cell population to an arbitrary domain,
+ * given by its signed distance function sampled on a grid (see SignedDistanceGrid). This
+ * generalises CircularBoundaryCondition to irregular domains in 2D and 3D.
+ *
+ * At each time step the node locations are gathered into a contiguous array, any node that
+ * has left the domain is projected back onto its boundary along the interpolated gradient of
+ * the signed distance, at O(1) cost per node, and the locations are written back.
+ */
+template<unsigned DIM>
+class SignedDistanceBoundaryCondition : public AbstractIndexedBoundaryCondition<DIM>
+{
+private:
+
+    /** The signed distance function of the domain. */
+    boost::shared_ptr<SignedDistanceGrid<DIM> > mpGrid;
+
+    /** The largest signed distance of any node for the boundary condition to be satisfied. Defaults to 1e-4. */
+    double mTolerance;
+
+    /** The node locations, in the order visited by the node iterator and stored with stride DIM. Not archived. */
+    std::vector<double> mNodeLocations;
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Serialize the object.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractIndexedBoundaryCondition<DIM> >(*this);
+        archive & mTolerance;
+    }
+
+    /**
+     * Copy the location of each node of the cell population into mNodeLocations, in the
+     * order visited by the node iterator of its mesh.
+     */
+    void GatherNodeLocations();
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param pCellPopulation pointer to the cell population
+     * @param pGrid the signed distance function of the domain
+     */
+    SignedDistanceBoundaryCondition(AbstractCellPopulation<DIM>* pCellPopulation,
+                                    boost::shared_ptr<SignedDistanceGrid<DIM> > pGrid);
+
+    /**
+     * @return the signed distance function of the domain.
+     */
+    const boost::shared_ptr<SignedDistanceGrid<DIM> > GetGrid() const;
+
+    /**
+     * @return mTolerance
+     */
+    double GetTolerance() const;
+
+    /**
+     * Set mTolerance.
+     *
+     * @param tolerance the new value of mTolerance
+     */
+    void SetTolerance(double tolerance);
+
+    /**
+     * Overridden ImposeIndexedBoundaryCondition() method.
+     *
+     * Project any node lying outside the domain onto its boundary.
+     *
+     * @param rOldLocations the node locations before any boundary conditions are applied, indexed by node index
+     */
+    void ImposeIndexedBoundaryCondition(const std::vector<c_vector<double, DIM> >& rOldLocations);
+
+    /**
+     * Overridden UsesOldLocations() method.
+     *
+     * @return false, as the projection only depends on the current node locations
+     */
+    bool UsesOldLocations() const;
+
+    /**
+     * Overridden VerifyBoundaryCondition() method.
+     *
+     * @return whether every node lies within mTolerance of the domain.
+     */
+    bool VerifyBoundaryCondition();
+
+    /**
+     * Overridden OutputCellPopulationBoundaryConditionParameters() method.
+     * Output cell population boundary condition parameters to file.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    void OutputCellPopulationBoundaryConditionParameters(out_stream& rParamsFile);
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(SignedDistanceBoundaryCondition)
+
+namespace boost
+{
+namespace serialization
+{
+/**
+ * Serialize information required to construct a SignedDistanceBoundaryCondition.
+ */
+template<class Archive, unsigned DIM>
+inline void save_construct_data(
+    Archive & ar, const SignedDistanceBoundaryCondition<DIM>* t, const unsigned int file_version)
+{
+    // Save data required to construct instance
+    const AbstractCellPopulation<DIM>* const p_cell_population = t->GetCellPopulation();
+    ar << p_cell_population;
+
+    const boost::shared_ptr<SignedDistanceGrid<DIM> > p_grid = t->GetGrid();
+    ar << p_grid;
+}
+
+/**
+ * De-serialize constructor parameters and initialize a SignedDistanceBoundaryCondition.
+ */
+template<class Archive, unsigned DIM>
+inline void load_construct_data(
+    Archive & ar, SignedDistanceBoundaryCondition<DIM>* t, const unsigned int file_version)
+{
+    // Retrieve data from archive required to construct new instance
+    AbstractCellPopulation<DIM>* p_cell_population;
+    ar >> p_cell_population;
+
+    boost::shared_ptr<SignedDistanceGrid<DIM> > p_grid;
+    ar >> p_grid;
+
+    // Invoke inplace constructor to initialise instance
+    ::new(t)SignedDistanceBoundaryCondition<DIM>(p_cell_population, p_grid);
+}
+}
+} // namespace ...
+
+#endif /*SIGNEDDISTANCEBOUNDARYCONDITION_HPP_*/
@@ -0,0 +1,449 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "SignedDistanceGrid.hpp"
+#include "Exception.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+/*
+ * The loop over points in ProjectOntoDomain() has no dependence between iterations, so it is
+ * both shared between threads and vectorised within each thread where OpenMP 4 is available.
+ */
+#if defined(_OPENMP) && (_OPENMP >= 201307)
+#define SIGNED_DISTANCE_PARALLEL_SIMD _Pragma("omp parallel for simd schedule(static)")
+#elif defined(_OPENMP)
+#define SIGNED_DISTANCE_PARALLEL_SIMD _Pragma("omp parallel for schedule(static)")
+#else
+#define SIGNED_DISTANCE_PARALLEL_SIMD
+#endif
+
+/**
+ * Interpolate a signed distance grid and its gradient at a point. This is written over raw
+ * arrays, rather than as a member of SignedDistanceGrid, so that it may be inlined into the
+ * vectorised loops below.
+ *
+ * @param pPoint the point
+ * @param pOrigin the location of the grid point with index zero
+ * @param inverseSpacing the reciprocal of the grid spacing
+ * @param pNumPoints the number of grid points in each coordinate direction
+ * @param pValues the signed distance at each grid point
+ * @param pGradients the gradient at each grid point, stored with stride DIM
+ * @param pGradient filled in with the interpolated gradient
+ * @return the interpolated signed distance
+ */
+template<unsigned DIM>
+inline double InterpolateSignedDistance(const double* pPoint,
+                                        const double* pOrigin,
+                                        double inverseSpacing,
+                                        const unsigned* pNumPoints,
+                                        const double* pValues,
+                                        const double* pGradients,
+                                        double* pGradient)
+{
+    // Find the grid cell containing the point, clamped to the grid so that values are extrapolated outside it
+    unsigned base = 0;
+    unsigned stride = 1;
+    unsigned strides[DIM];
+    double fractions[DIM];
+    for (unsigned d=0; d<DIM; d++)
+    {
+        double scaled = (pPoint[d] - pOrigin[d])*inverseSpacing;
+        double cell = std::max(0.0, std::min(floor(scaled), (double)(pNumPoints[d] - 2)));
+        fractions[d] = scaled - cell;
+        strides[d] = stride;
+        base += ((unsigned)cell)*stride;
+        stride *= pNumPoints[d];
+        pGradient[d] = 0.0;
+    }
+
+    // Sum the contributions of the 2^DIM corners of the cell
+    double value = 0.0;
+    for (unsigned corner=0; corner<(1u << DIM); corner++)
+    {
+        double weight = 1.0;
+        unsigned offset = base;
+        for (unsigned d=0; d<DIM; d++)
+        {
+            if ((corner >> d) & 1u)
+            {
+                weight *= fractions[d];
+                offset += strides[d];
+            }
+            else
+            {
+                weight *= 1.0 - fractions[d];
+            }
+        }
+
+        value += weight*pValues[offset];
+        for (unsigned d=0; d<DIM; d++)
+        {
+            pGradient[d] += weight*pGradients[DIM*offset + d];
+        }
+    }
+    return value;
+}
+
+template<unsigned DIM>
+SignedDistanceGrid<DIM>::SignedDistanceGrid()
+    : mOrigin(DIM, 0.0),
+      mSpacing(1.0),
+      mNumPoints(DIM, 0)
+{
+}
+
+template<unsigned DIM>
+void SignedDistanceGrid<DIM>::SetValues(const c_vector<double, DIM>& rOrigin,
+                                        double spacing,
+                                        const std::vector<unsigned>& rNumPoints,
+                                        const std::vector<double>& rValues)
+{
+    if (spacing <= 0.0)
+    {
+        EXCEPTION("The spacing of a SignedDistanceGrid must be positive");
+    }
+    if (rNumPoints.size() != DIM)
+    {
+        EXCEPTION("A SignedDistanceGrid must be given the number of grid points in each of the " << DIM << " coordinate directions");
+    }
+
+    unsigned num_values = 1;
+    for (unsigned d=0; d<DIM; d++)
+    {
+        if (rNumPoints[d] < 2)
+        {
+            EXCEPTION("A SignedDistanceGrid must have at least two grid points in each coordinate direction");
+        }
+        num_values *= rNumPoints[d];
+        mOrigin[d] = rOrigin[d];
+    }
+    if (rValues.size() != num_values)
+    {
+        EXCEPTION("A SignedDistanceGrid with " << num_values << " grid points was given " << rValues.size() << " values");
+    }
+
+    mSpacing = spacing;
+    mNumPoints = rNumPoints;
+    mValues = rValues;
+    ComputeGradients();
+}
+
+template<unsigned DIM>
+void SignedDistanceGrid<DIM>::LoadFromFile(const FileFinder& rFile)
+{
+    if (!rFile.IsFile())
+    {
+        EXCEPTION("Unable to open signed distance grid file " << rFile.GetAbsolutePath());
+    }
+
+    // Gather the entries of every line that is not a comment
+    std::ifstream file(rFile.GetAbsolutePath().c_str());
+    std::stringstream entries;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::string::size_type first = line.find_first_not_of(" \t\r");
+        if ((first != std::string::npos) && (line[first] != '#'))
+        {
+            entries << line << "\n";
+        }
+    }
+
+    std::vector<unsigned> num_points(DIM);
+    c_vector<double, DIM> origin;
+    double spacing;
+    for (unsigned d=0; d<DIM; d++)
+    {
+        if (!(entries >> num_points[d]))
+        {
+            EXCEPTION("Unable to read the number of grid points from " << rFile.GetAbsolutePath());
+        }
+    }
+    for (unsigned d=0; d<DIM; d++)
+    {
+        if (!(entries >> origin[d]))
+        {
+            EXCEPTION("Unable to read the grid origin from " << rFile.GetAbsolutePath());
+        }
+    }
+    if (!(entries >> spacing))
+    {
+        EXCEPTION("Unable to read the grid spacing from " << rFile.GetAbsolutePath());
+    }
+
+    std::vector<double> values;
+    double value;
+    while (entries >> value)
+    {
+        values.push_back(value);
+    }
+    if (!entries.eof())
+    {
+        EXCEPTION("Unable to read a signed distance value from " << rFile.GetAbsolutePath());
+    }
+
+    SetValues(origin, spacing, num_points, values);
+}
+
+template<unsigned DIM>
+void SignedDistanceGrid<DIM>::BuildFromPolygon(const std::vector<c_vector<double, DIM> >& rVertices, double spacing, double margin)
+{
+    if (DIM != 2)
+    {
+        EXCEPTION("A SignedDistanceGrid may only be built from a polygon in 2D");
+    }
+    if (rVertices.size() < 3)
+    {
+        EXCEPTION("A polygon must have at least three vertices");
+    }
+    if (spacing <= 0.0)
+    {
+        EXCEPTION("The spacing of a SignedDistanceGrid must be positive");
+    }
+
+    // Cover the bounding box of the polygon, plus the margin, with grid points
+    c_vector<double, DIM> lower = rVertices[0];
+    c_vector<double, DIM> upper = rVertices[0];
+    for (unsigned i=1; i<rVertices.size(); i++)
+    {
+        for (unsigned d=0; d<DIM; d++)
+        {
+            lower[d] = std::min(lower[d], rVertices[i][d]);
+            upper[d] = std::max(upper[d], rVertices[i][d]);
+        }
+    }
+
+    c_vector<double, DIM> origin;
+    std::vector<unsigned> num_points(DIM);
+    for (unsigned d=0; d<DIM; d++)
+    {
+        origin[d] = lower[d] - margin;
+        num_points[d] = std::max(2u, (unsigned)ceil((upper[d] - lower[d] + 2.0*margin)/spacing) + 1);
+    }
+
+    unsigned num_vertices = rVertices.size();
+    std::vector<double> values(num_points[0]*num_points[1]);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int row=0; row<(int)num_points[1]; row++)
+    {
+        double y = origin[1] + row*spacing;
+        for (unsigned col=0; col<num_points[0]; col++)
+        {
+            double x = origin[0] + col*spacing;
+
+            // Find the distance to the nearest edge, and whether the point is inside by the even-odd rule
+            double min_distance_squared = DBL_MAX;
+            bool inside = false;
+            for (unsigned i=0; i<num_vertices; i++)
+            {
+                const c_vector<double, DIM>& r_a = rVertices[i];
+                const c_vector<double, DIM>& r_b = rVertices[(i+1)%num_vertices];
+
+                double edge_x = r_b[0] - r_a[0];
+                double edge_y = r_b[1] - r_a[1];
+                double edge_length_squared = edge_x*edge_x + edge_y*edge_y;
+                double t = 0.0;
+                if (edge_length_squared > 0.0)
+                {
+                    t = std::max(0.0, std::min(1.0, ((x - r_a[0])*edge_x + (y - r_a[1])*edge_y)/edge_length_squared));
+                }
+                double dx = x - (r_a[0] + t*edge_x);
+                double dy = y - (r_a[1] + t*edge_y);
+                min_distance_squared = std::min(min_distance_squared, dx*dx + dy*dy);
+
+                if ((r_a[1] > y) != (r_b[1] > y))
+                {
+                    double crossing_x = r_a[0] + (y - r_a[1])*edge_x/edge_y;
+                    if (x < crossing_x)
+                    {
+                        inside = !inside;
+                    }
+                }
+            }
+
+            double distance = sqrt(min_distance_squared);
+            values[row*num_points[0] + col] = inside ? -distance : distance;
+        }
+    }
+
+    SetValues(origin, spacing, num_points, values);
+}
+
+template<unsigned DIM>
+void SignedDistanceGrid<DIM>::ComputeGradients()
+{
+    unsigned num_values = mValues.size();
+    mGradients.assign(DIM*num_values, 0.0);
+
+    unsigned stride = 1;
+    for (unsigned d=0; d<DIM; d++)
+    {
+        // Use central differences in the interior of the grid, and one-sided differences on its faces
+        for (unsigned k=0; k<num_values; k++)
+        {
+            unsigned index = (k/stride)%mNumPoints[d];
+            if (index == 0)
+            {
+                mGradients[DIM*k + d] = (mValues[k + stride] - mValues[k])/mSpacing;
+            }
+            else if (index == mNumPoints[d] - 1)
+            {
+                mGradients[DIM*k + d] = (mValues[k] - mValues[k - stride])/mSpacing;
+            }
+            else
+            {
+                mGradients[DIM*k + d] = 0.5*(mValues[k + stride] - mValues[k - stride])/mSpacing;
+            }
+        }
+        stride *= mNumPoints[d];
+    }
+}
+
+template<unsigned DIM>
+double SignedDistanceGrid<DIM>::GetSignedDistance(const c_vector<double, DIM>& rPoint) const
+{
+    if (mValues.empty())
+    {
+        EXCEPTION("A SignedDistanceGrid must be given values before it is evaluated");
+    }
+
+    double point[DIM];
+    double gradient[DIM];
+    for (unsigned d=0; d<DIM; d++)
+    {
+        point[d] = rPoint[d];
+    }
+    return InterpolateSignedDistance<DIM>(point, &mOrigin[0], 1.0/mSpacing, &mNumPoints[0], &mValues[0], &mGradients[0], gradient);
+}
+
+template<unsigned DIM>
+void SignedDistanceGrid<DIM>::ProjectOntoDomain(double* pPoints, unsigned numPoints, unsigned numIterations) const
+{
+    if (mValues.empty())
+    {
+        EXCEPTION("A SignedDistanceGrid must be given values before it is evaluated");
+    }
+
+    const double* p_origin = &mOrigin[0];
+    const unsigned* p_num_points = &mNumPoints[0];
+    const double* p_values = &mValues[0];
+    const double* p_gradients = &mGradients[0];
+    double inverse_spacing = 1.0/mSpacing;
+
+    SIGNED_DISTANCE_PARALLEL_SIMD
+    for (int i=0; i<(int)numPoints; i++)
+    {
+        double* p_point = pPoints + DIM*i;
+        for (unsigned iteration=0; iteration<numIterations; iteration++)
+        {
+            double gradient[DIM];
+            double distance = InterpolateSignedDistance<DIM>(p_point, p_origin, inverse_spacing, p_num_points, p_values, p_gradients, gradient);
+
+            double gradient_norm_squared = 0.0;
+            for (unsigned d=0; d<DIM; d++)
+            {
+                gradient_norm_squared += gradient[d]*gradient[d];
+            }
+
+            // Points inside the domain, or where the gradient vanishes, do not move
+            double step = ((distance > 0.0) && (gradient_norm_squared > 0.0)) ? distance/gradient_norm_squared : 0.0;
+            for (unsigned d=0; d<DIM; d++)
+            {
+                p_point[d] -= step*gradient[d];
+            }
+        }
+    }
+}
+
+template<unsigned DIM>
+double SignedDistanceGrid<DIM>::GetMaxSignedDistance(const double* pPoints, unsigned numPoints) const
+{
+    if (mValues.empty())
+    {
+        EXCEPTION("A SignedDistanceGrid must be given values before it is evaluated");
+    }
+
+    const double* p_origin = &mOrigin[0];
+    const unsigned* p_num_points = &mNumPoints[0];
+    const double* p_values = &mValues[0];
+    const double* p_gradients = &mGradients[0];
+    double inverse_spacing = 1.0/mSpacing;
+
+    // The max reduction needs OpenMP 3.1
+    double max_distance = -DBL_MAX;
+#if defined(_OPENMP) && (_OPENMP >= 201307)
+#pragma omp parallel for simd schedule(static) reduction(max:max_distance)
+#elif defined(_OPENMP) && (_OPENMP >= 201107)
+#pragma omp parallel for schedule(static) reduction(max:max_distance)
+#endif
+    for (int i=0; i<(int)numPoints; i++)
+    {
+        double gradient[DIM];
+        double distance = InterpolateSignedDistance<DIM>(pPoints + DIM*i, p_origin, inverse_spacing, p_num_points, p_values, p_gradients, gradient);
+        max_distance = std::max(max_distance, distance);
+    }
+    return max_distance;
+}
+
+template<unsigned DIM>
+double SignedDistanceGrid<DIM>::GetSpacing() const
+{
+    return mSpacing;
+}
+
+template<unsigned DIM>
+const std::vector<unsigned>& SignedDistanceGrid<DIM>::rGetNumPoints() const
+{
+    return mNumPoints;
+}
+
+template<unsigned DIM>
+const std::vector<double>& SignedDistanceGrid<DIM>::rGetOrigin() const
+{
+    return mOrigin;
+}
+
+// Explicit instantiation
+template class SignedDistanceGrid<1>;
+template class SignedDistanceGrid<2>;
+template class SignedDistanceGrid<3>;
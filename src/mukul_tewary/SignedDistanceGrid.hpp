@@ -0,0 +1,184 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef SIGNEDDISTANCEGRID_HPP_
+#define SIGNEDDISTANCEGRID_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/vector.hpp>
+
+#include <vector>
+#include "UblasVectorInclude.hpp"
+#include "FileFinder.hpp"
+
+/**
+ * A domain given by its signed distance function, sampled on a uniform Cartesian grid.
+ * The signed distance is negative inside the domain and positive outside it.
+ *
+ * The signed distance and its gradient at any point are found by multilinear interpolation
+ * of the grid values and of a gradient precomputed at each grid point by finite differences,
+ * so each evaluation costs O(1) however complicated the domain. Outside the grid, values are
+ * extrapolated linearly from the nearest grid cell.
+ *
+ * A grid may be read from file (see LoadFromFile()) or, in 2D, built from a polygon (see
+ * BuildFromPolygon()).
+ */
+template<unsigned DIM>
+class SignedDistanceGrid
+{
+private:
+
+    /** The location of the grid point with index zero. */
+    std::vector<double> mOrigin;
+
+    /** The distance between neighbouring grid points in each coordinate direction. */
+    double mSpacing;
+
+    /** The number of grid points in each coordinate direction. */
+    std::vector<unsigned> mNumPoints;
+
+    /** The signed distance at each grid point, with the first coordinate varying fastest. */
+    std::vector<double> mValues;
+
+    /** The gradient of the signed distance at each grid point, stored with stride DIM. */
+    std::vector<double> mGradients;
+
+    friend class boost::serialization::access;
+    /**
+     * Boost Serialization method for archiving/checkpointing.
+     * Archives the object and its member variables.
+     *
+     * @param archive  The boost archive.
+     * @param version  The current version of this class.
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & mOrigin;
+        archive & mSpacing;
+        archive & mNumPoints;
+        archive & mValues;
+        archive & mGradients;
+    }
+
+    /**
+     * Helper method to check the grid dimensions and recompute mGradients after the values change.
+     */
+    void ComputeGradients();
+
+public:
+
+    /**
+     * Default constructor. The grid is empty until SetValues(), LoadFromFile() or
+     * BuildFromPolygon() is called.
+     */
+    SignedDistanceGrid();
+
+    /**
+     * Set the grid and the signed distance at each grid point.
+     *
+     * @param rOrigin the location of the grid point with index zero
+     * @param spacing the distance between neighbouring grid points
+     * @param rNumPoints the number of grid points in each coordinate direction (at least 2)
+     * @param rValues the signed distance at each grid point, with the first coordinate varying fastest
+     */
+    void SetValues(const c_vector<double, DIM>& rOrigin,
+                   double spacing,
+                   const std::vector<unsigned>& rNumPoints,
+                   const std::vector<double>& rValues);
+
+    /**
+     * Replace the grid by one read from a file. Lines starting with '#' are ignored. The
+     * remaining entries, separated by whitespace, are: the number of grid points in each of
+     * the DIM coordinate directions; the DIM coordinates of the grid point with index zero;
+     * the grid spacing; and the signed distance at each grid point, with the first coordinate
+     * varying fastest.
+     *
+     * @param rFile the file to read
+     */
+    void LoadFromFile(const FileFinder& rFile);
+
+    /**
+     * Replace the grid by the signed distance function of a simple polygon. Only implemented in 2D.
+     *
+     * @param rVertices the vertices of the polygon, in order around its boundary
+     * @param spacing the grid spacing
+     * @param margin the distance by which the grid extends beyond the bounding box of the polygon
+     */
+    void BuildFromPolygon(const std::vector<c_vector<double, DIM> >& rVertices, double spacing, double margin);
+
+    /**
+     * @return the interpolated signed distance at a point.
+     *
+     * @param rPoint the point
+     */
+    double GetSignedDistance(const c_vector<double, DIM>& rPoint) const;
+
+    /**
+     * Move any of a set of points lying outside the domain onto its boundary, by taking a
+     * fixed number of Newton steps along the interpolated gradient towards the zero level set.
+     * Points inside the domain are left unchanged.
+     *
+     * @param pPoints the coordinates of the points, stored with stride DIM
+     * @param numPoints the number of points
+     * @param numIterations the number of projection steps to take (defaults to 3)
+     */
+    void ProjectOntoDomain(double* pPoints, unsigned numPoints, unsigned numIterations=3) const;
+
+    /**
+     * @return the largest interpolated signed distance of a set of points, or -DBL_MAX if there are none.
+     *
+     * @param pPoints the coordinates of the points, stored with stride DIM
+     * @param numPoints the number of points
+     */
+    double GetMaxSignedDistance(const double* pPoints, unsigned numPoints) const;
+
+    /**
+     * @return the grid spacing.
+     */
+    double GetSpacing() const;
+
+    /**
+     * @return the number of grid points in each coordinate direction.
+     */
+    const std::vector<unsigned>& rGetNumPoints() const;
+
+    /**
+     * @return the location of the grid point with index zero.
+     */
+    const std::vector<double>& rGetOrigin() const;
+};
+
+#endif /*SIGNEDDISTANCEGRID_HPP_*/
@@ -0,0 +1,262 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTADAPTIVETIMESTEPOFFLATTICESIMULATION_HPP_
+#define TESTADAPTIVETIMESTEPOFFLATTICESIMULATION_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+#include "HoneycombVertexMeshGenerator.hpp"
+#include "CellsGenerator.hpp"
+#include "NoCellCycleModel.hpp"
+#include "VertexBasedCellPopulation.hpp"
+#include "FarhadifarForce.hpp"
+#include "ConstantTargetAreaModifier.hpp"
+#include "AdaptiveTimestepOffLatticeSimulation.hpp"
+#include "OffLatticeSimulation.hpp"
+#include "AbstractForce.hpp"
+#include "SimulationTime.hpp"
+#include "SmartPointers.hpp"
+#include "FakePetscSetup.hpp"
+
+/**
+ * A force pulling a single node towards a fixed point, proportionally to its distance from the point.
+ */
+class PullNodeTowardsPointForce : public AbstractForce<2>
+{
+private:
+
+    friend class boost::serialization::access;
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractForce<2> >(*this);
+    }
+
+public:
+
+    /** Index of the node to pull. */
+    unsigned mNodeIndex;
+
+    /** The point that the node is pulled towards. */
+    c_vector<double, 2> mTarget;
+
+    /** Force per unit distance from the point. */
+    double mStiffness;
+
+    PullNodeTowardsPointForce()
+        : mNodeIndex(0),
+          mTarget(zero_vector<double>(2)),
+          mStiffness(1.0)
+    {
+    }
+
+    void AddForceContribution(AbstractCellPopulation<2>& rCellPopulation)
+    {
+        Node<2>* p_node = rCellPopulation.GetNode(mNodeIndex);
+        c_vector<double, 2> force = mStiffness*(mTarget - p_node->rGetLocation());
+        p_node->AddAppliedForceContribution(force);
+    }
+
+    void OutputForceParameters(out_stream& rParamsFile)
+    {
+        AbstractForce<2>::OutputForceParameters(rParamsFile);
+    }
+};
+
+// The class must be registered to write its parameters when a simulation is run
+#include "SerializationExportWrapper.hpp"
+CHASTE_CLASS_EXPORT(PullNodeTowardsPointForce)
+#include "SerializationExportWrapperForCpp.hpp"
+CHASTE_CLASS_EXPORT(PullNodeTowardsPointForce)
+
+class TestAdaptiveTimestepOffLatticeSimulation : public AbstractCellBasedTestSuite
+{
+public:
+
+    void TestAdaptiveSimulationAgreesWithSmallFixedTimeStep() throw (Exception)
+    {
+        double end_time = 1.0;
+
+        // Run a reference simulation with a small fixed time step
+        std::vector<c_vector<double, 2> > reference_locations;
+        {
+            HoneycombVertexMeshGenerator generator(6, 6);
+            MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+            std::vector<CellPtr> cells;
+            CellsGenerator<NoCellCycleModel, 2> cells_generator;
+            cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+            VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+
+            OffLatticeSimulation<2> simulation(cell_population);
+            simulation.SetOutputDirectory("TestAdaptiveTimestepOffLatticeSimulation/Fixed");
+            simulation.SetEndTime(end_time);
+            simulation.SetDt(0.001);
+            simulation.SetSamplingTimestepMultiple(100);
+
+            MAKE_PTR(FarhadifarForce<2>, p_force);
+            simulation.AddForce(p_force);
+            MAKE_PTR(ConstantTargetAreaModifier<2>, p_growth_modifier);
+            simulation.AddSimulationModifier(p_growth_modifier);
+
+            simulation.Solve();
+
+            for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+            {
+                reference_locations.push_back(cell_population.GetNode(i)->rGetLocation());
+            }
+        }
+
+        SimulationTime::Destroy();
+        SimulationTime::Instance()->SetStartTime(0.0);
+
+        // Run the same simulation with adaptive substeps inside a coarse time step
+        HoneycombVertexMeshGenerator generator(6, 6);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+
+        AdaptiveTimestepOffLatticeSimulation<2> simulation(cell_population);
+        simulation.SetOutputDirectory("TestAdaptiveTimestepOffLatticeSimulation/Adaptive");
+        simulation.SetEndTime(end_time);
+        simulation.SetDt(0.1);
+        simulation.SetSamplingTimestepMultiple(1);
+
+        MAKE_PTR(FarhadifarForce<2>, p_force);
+        simulation.AddForce(p_force);
+        MAKE_PTR(ConstantTargetAreaModifier<2>, p_growth_modifier);
+        simulation.AddSimulationModifier(p_growth_modifier);
+
+        simulation.Solve();
+
+        // Output has landed on the requested end time, using far fewer steps than the fixed time step
+        TS_ASSERT_DELTA(SimulationTime::Instance()->GetTime(), end_time, 1e-12);
+        TS_ASSERT_LESS_THAN(simulation.GetNumSubsteps(), 1000u);
+
+        TS_ASSERT_EQUALS(cell_population.GetNumNodes(), reference_locations.size());
+        for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+        {
+            TS_ASSERT_DELTA(cell_population.GetNode(i)->rGetLocation()[0], reference_locations[i][0], 5e-3);
+            TS_ASSERT_DELTA(cell_population.GetNode(i)->rGetLocation()[1], reference_locations[i][1], 5e-3);
+        }
+    }
+
+    void TestExceptionForElementInvertedBeforeStep() throw (Exception)
+    {
+        HoneycombVertexMeshGenerator generator(3, 3);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        // Reflecting the mesh reverses the orientation of every element, without changing any edge length
+        for (unsigned i=0; i<p_mesh->GetNumNodes(); i++)
+        {
+            p_mesh->GetNode(i)->rGetModifiableLocation()[0] *= -1.0;
+        }
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+
+        AdaptiveTimestepOffLatticeSimulation<2> simulation(cell_population);
+        simulation.SetOutputDirectory("TestAdaptiveTimestepOffLatticeSimulation/Inverted");
+        simulation.SetEndTime(0.1);
+        simulation.SetDt(0.1);
+        simulation.SetUpdateCellPopulationRule(false);
+
+        MAKE_PTR(FarhadifarForce<2>, p_force);
+        simulation.AddForce(p_force);
+        MAKE_PTR(ConstantTargetAreaModifier<2>, p_growth_modifier);
+        simulation.AddSimulationModifier(p_growth_modifier);
+
+        // The inversion is reported directly, rather than after the substep has been halved to its minimum
+        TS_ASSERT_THROWS_THIS(simulation.Solve(),
+            "Element 0 is inverted at the start of a substep, before any node has been moved; adaptive substepping cannot recover from this");
+        TS_ASSERT_EQUALS(simulation.GetNumRejectedSubsteps(), 0u);
+    }
+
+    void TestSubstepIsHalvedWhenItWouldInvertAnElement() throw (Exception)
+    {
+        // A unit square element
+        std::vector<Node<2>*> nodes;
+        nodes.push_back(new Node<2>(0, true, 0.0, 0.0));
+        nodes.push_back(new Node<2>(1, true, 1.0, 0.0));
+        nodes.push_back(new Node<2>(2, true, 1.0, 1.0));
+        nodes.push_back(new Node<2>(3, true, 0.0, 1.0));
+        std::vector<VertexElement<2,2>*> elements;
+        elements.push_back(new VertexElement<2,2>(0, nodes));
+        MutableVertexMesh<2,2> mesh(nodes, elements);
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, mesh.GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(mesh, cells);
+
+        AdaptiveTimestepOffLatticeSimulation<2> simulation(cell_population);
+        simulation.SetOutputDirectory("TestAdaptiveTimestepOffLatticeSimulation/Halved");
+        simulation.SetEndTime(1.0);
+        simulation.SetDt(1.0);
+        simulation.SetUpdateCellPopulationRule(false);
+
+        // Let the substep be limited only by the time step, so that the first trial substep is the whole step
+        simulation.SetMaxDisplacementFraction(1000.0);
+
+        // Pull node 1 from (1,0) towards (0.5,0). The trial substeps of 1 and 0.5 overshoot to x = -4 and
+        // x = -1.5, past x = -1 where the element inverts, and the substep of 0.25 reaches x = -0.25.
+        MAKE_PTR(PullNodeTowardsPointForce, p_force);
+        p_force->mNodeIndex = 1;
+        p_force->mTarget[0] = 0.5;
+        p_force->mStiffness = 10.0;
+        simulation.AddForce(p_force);
+
+        simulation.Solve();
+
+        TS_ASSERT_EQUALS(simulation.GetNumRejectedSubsteps(), 2u);
+        TS_ASSERT_LESS_THAN(1u, simulation.GetNumSubsteps());
+        TS_ASSERT_DELTA(SimulationTime::Instance()->GetTime(), 1.0, 1e-12);
+
+        // The element was never left inverted, and the other nodes have not moved
+        TS_ASSERT_LESS_THAN(0.0, mesh.GetVolumeOfElement(0));
+        TS_ASSERT_DELTA(mesh.GetNode(0)->rGetLocation()[0], 0.0, 1e-12);
+        TS_ASSERT_DELTA(mesh.GetNode(2)->rGetLocation()[0], 1.0, 1e-12);
+        TS_ASSERT_DELTA(mesh.GetNode(3)->rGetLocation()[1], 1.0, 1e-12);
+    }
+};
+
+#endif /*TESTADAPTIVETIMESTEPOFFLATTICESIMULATION_HPP_*/
@@ -0,0 +1,208 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTFIRERELAXATIONSOLVER_HPP_
+#define TESTFIRERELAXATIONSOLVER_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+#include "HoneycombVertexMeshGenerator.hpp"
+#include "CellsGenerator.hpp"
+#include "NoCellCycleModel.hpp"
+#include "VertexBasedCellPopulation.hpp"
+#include "ForceForScenario4.hpp"
+#include "ConstantTargetAreaModifier.hpp"
+#include "SlidingBoundaryCondition.hpp"
+#include "FireRelaxationSolver.hpp"
+#include "OffLatticeSimulation.hpp"
+#include "SmartPointers.hpp"
+#include "FakePetscSetup.hpp"
+
+class TestFireRelaxationSolver : public AbstractCellBasedTestSuite
+{
+public:
+
+    void TestRelaxationOfHoneycombBeforeSimulation() throw (Exception)
+    {
+        // Use the mechanical parameter values of TestSidekick
+        double k = 1.0;
+        double lambda_bar = 0.05;
+        double gamma_bar = 0.04;
+
+        HoneycombVertexMeshGenerator generator(14, 20);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        for (unsigned i=0; i<cells.size(); i++)
+        {
+            cells[i]->GetCellData()->SetItem("stripe", 1);
+        }
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+
+        MAKE_PTR(ForceForScenario4<2>, p_force);
+        p_force->SetNumStripes(4);
+        p_force->SetAreaElasticityParameter(k);
+        p_force->SetPerimeterContractilityParameter(gamma_bar*k);
+        p_force->SetHomotypicLineTensionParameter(lambda_bar*pow(k,1.5));
+        p_force->SetHeterotypicLineTensionParameter(2.0*lambda_bar*pow(k,1.5));
+        p_force->SetSupercontractileLineTensionParameter(4.0*lambda_bar*pow(k,1.5));
+        p_force->SetBoundaryLineTensionParameter(lambda_bar*lambda_bar*pow(k,1.5));
+
+        // The target areas must be set before relaxing
+        MAKE_PTR(ConstantTargetAreaModifier<2>, p_growth_modifier);
+        p_growth_modifier->UpdateTargetAreas(cell_population);
+
+        FireRelaxationSolver<2> solver(cell_population);
+        solver.AddForce(p_force);
+        solver.SetForceTolerance(1e-6);
+
+        bool converged = solver.Relax();
+
+        TS_ASSERT(converged);
+        TS_ASSERT_LESS_THAN(solver.GetFinalForceNorm(), 1e-6);
+
+        // Hand the relaxed population to a simulation; it should remain at rest
+        std::vector<c_vector<double, 2> > relaxed_locations;
+        for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+        {
+            relaxed_locations.push_back(cell_population.GetNode(i)->rGetLocation());
+        }
+
+        OffLatticeSimulation<2> simulation(cell_population);
+        simulation.SetOutputDirectory("TestFireRelaxationSolver");
+        simulation.SetEndTime(1.0);
+        simulation.SetDt(0.01);
+        simulation.AddForce(p_force);
+        simulation.AddSimulationModifier(p_growth_modifier);
+        simulation.Solve();
+
+        TS_ASSERT_EQUALS(cell_population.GetNumNodes(), relaxed_locations.size());
+        for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+        {
+            TS_ASSERT_DELTA(cell_population.GetNode(i)->rGetLocation()[0], relaxed_locations[i][0], 1e-5);
+            TS_ASSERT_DELTA(cell_population.GetNode(i)->rGetLocation()[1], relaxed_locations[i][1], 1e-5);
+        }
+    }
+
+    void TestRelaxationWithBoundaryCondition() throw (Exception)
+    {
+        HoneycombVertexMeshGenerator generator(8, 8);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        for (unsigned i=0; i<cells.size(); i++)
+        {
+            cells[i]->GetCellData()->SetItem("stripe", 1);
+        }
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+
+        MAKE_PTR(ForceForScenario4<2>, p_force);
+        p_force->SetNumStripes(4);
+        p_force->SetAreaElasticityParameter(1.0);
+        p_force->SetPerimeterContractilityParameter(0.04);
+        p_force->SetHomotypicLineTensionParameter(0.05);
+        p_force->SetHeterotypicLineTensionParameter(0.1);
+        p_force->SetSupercontractileLineTensionParameter(0.2);
+        p_force->SetBoundaryLineTensionParameter(0.0025);
+
+        MAKE_PTR(ConstantTargetAreaModifier<2>, p_growth_modifier);
+        p_growth_modifier->UpdateTargetAreas(cell_population);
+
+        // Boundary nodes on the top and bottom of the sheet may only slide horizontally
+        ChasteCuboid<2> bounds = p_mesh->CalculateBoundingBox();
+        double y_min = bounds.rGetLowerCorner()[1];
+        double y_max = bounds.rGetUpperCorner()[1];
+        MAKE_PTR_ARGS(SlidingBoundaryCondition, p_bc, (&cell_population, bounds.rGetLowerCorner()[0], y_min,
+                                                       bounds.rGetUpperCorner()[0], y_max));
+
+        std::map<unsigned, double> initial_heights;
+        for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+        {
+            Node<2>* p_node = cell_population.GetNode(i);
+            double y = p_node->rGetLocation()[1];
+            if (p_node->IsBoundaryNode() && ((fabs(y - y_min) < 1e-1) || (fabs(y - y_max) < 1e-1)))
+            {
+                initial_heights[i] = y;
+            }
+        }
+        TS_ASSERT(!initial_heights.empty());
+
+        FireRelaxationSolver<2> solver(cell_population);
+        solver.AddForce(p_force);
+        solver.AddCellPopulationBoundaryCondition(p_bc);
+        solver.SetForceTolerance(1e-6);
+
+        // The forces held by the boundary condition must not prevent convergence
+        TS_ASSERT(solver.Relax());
+        TS_ASSERT_LESS_THAN(solver.GetFinalForceNorm(), 1e-6);
+        TS_ASSERT_LESS_THAN(0u, solver.GetNumIterations());
+
+        // The boundary condition has been imposed after every iteration
+        for (std::map<unsigned, double>::iterator iter = initial_heights.begin(); iter != initial_heights.end(); ++iter)
+        {
+            TS_ASSERT_DELTA(cell_population.GetNode(iter->first)->rGetLocation()[1], iter->second, 1e-12);
+        }
+
+        // Without the boundary condition, the same sheet relaxes to a different state
+        HoneycombVertexMeshGenerator free_generator(8, 8);
+        MutableVertexMesh<2,2>* p_free_mesh = free_generator.GetMesh();
+        std::vector<CellPtr> free_cells;
+        cells_generator.GenerateBasic(free_cells, p_free_mesh->GetNumElements());
+        for (unsigned i=0; i<free_cells.size(); i++)
+        {
+            free_cells[i]->GetCellData()->SetItem("stripe", 1);
+        }
+        VertexBasedCellPopulation<2> free_population(*p_free_mesh, free_cells);
+        p_growth_modifier->UpdateTargetAreas(free_population);
+
+        FireRelaxationSolver<2> free_solver(free_population);
+        free_solver.AddForce(p_force);
+        TS_ASSERT(free_solver.Relax());
+
+        double max_difference = 0.0;
+        for (std::map<unsigned, double>::iterator iter = initial_heights.begin(); iter != initial_heights.end(); ++iter)
+        {
+            max_difference = std::max(max_difference, fabs(free_population.GetNode(iter->first)->rGetLocation()[1] - iter->second));
+        }
+        TS_ASSERT_LESS_THAN(1e-3, max_difference);
+    }
+};
+
+#endif /*TESTFIRERELAXATIONSOLVER_HPP_*/
@@ -0,0 +1,277 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTFORCECOEFFICIENTSCHEDULE_HPP_
+#define TESTFORCECOEFFICIENTSCHEDULE_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <fstream>
+#include <iterator>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+#include "ForceCoefficientSchedule.hpp"
+#include "HoneycombVertexMeshGenerator.hpp"
+#include "CellsGenerator.hpp"
+#include "NoCellCycleModel.hpp"
+#include "VertexBasedCellPopulation.hpp"
+#include "ParallelFarhadifarForce.hpp"
+#include "FarhadifarForceWithTimeDependentCoefficients.hpp"
+#include "OffLatticeSimulation.hpp"
+#include "ConstantTargetAreaModifier.hpp"
+#include "OutputFileHandler.hpp"
+#include "SimulationTime.hpp"
+#include "SmartPointers.hpp"
+#include "FakePetscSetup.hpp"
+
+/**
+ * The original FarhadifarForceWithTimeDependentCoefficients, which derived from FarhadifarForce and
+ * found its coefficients in every call to the getters, kept to check that the current class follows
+ * the same trajectory.
+ */
+class OriginalFarhadifarForceWithTimeDependentCoefficients : public FarhadifarForce<2>
+{
+private:
+
+    friend class boost::serialization::access;
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<FarhadifarForce<2> >(*this);
+    }
+
+public:
+
+    virtual double GetAreaElasticityParameter()
+    {
+        double area_elasticity_parameter = this->mAreaElasticityParameter;
+        double num_rounds = floor(SimulationTime::Instance()->GetTimeStepsElapsed()*SimulationTime::Instance()->GetTimeStep()/50.0);
+        double increase_per_round = 0.1;
+        area_elasticity_parameter += increase_per_round*num_rounds;
+        return area_elasticity_parameter;
+    }
+
+    virtual double GetPerimeterContractilityParameter()
+    {
+        double perimeter_contractility_parameter = this->mPerimeterContractilityParameter;
+        double num_rounds = floor(SimulationTime::Instance()->GetTimeStepsElapsed()*SimulationTime::Instance()->GetTimeStep()/50.0);
+        double increase_per_round = 0.1;
+        perimeter_contractility_parameter += increase_per_round*num_rounds;
+        return perimeter_contractility_parameter;
+    }
+};
+
+// The class must be registered to write its parameters when a simulation is run
+#include "SerializationExportWrapper.hpp"
+CHASTE_CLASS_EXPORT(OriginalFarhadifarForceWithTimeDependentCoefficients)
+#include "SerializationExportWrapperForCpp.hpp"
+CHASTE_CLASS_EXPORT(OriginalFarhadifarForceWithTimeDependentCoefficients)
+
+class TestForceCoefficientSchedule : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * Run a short simulation of a small honeycomb with a given force, long enough for the
+     * time-dependent coefficients to increase twice, and return the final node locations.
+     */
+    std::vector<c_vector<double, 2> > RunSimulation(boost::shared_ptr<AbstractForce<2> > pForce, std::string outputDirectory)
+    {
+        SimulationTime::Destroy();
+        SimulationTime::Instance()->SetStartTime(0.0);
+
+        HoneycombVertexMeshGenerator generator(3, 3);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+
+        OffLatticeSimulation<2> simulation(cell_population);
+        simulation.SetOutputDirectory(outputDirectory);
+        simulation.SetEndTime(110.0);
+        simulation.SetDt(0.05);
+        simulation.SetSamplingTimestepMultiple(1000);
+        simulation.AddForce(pForce);
+        MAKE_PTR(ConstantTargetAreaModifier<2>, p_growth_modifier);
+        simulation.AddSimulationModifier(p_growth_modifier);
+        simulation.Solve();
+
+        std::vector<c_vector<double, 2> > locations;
+        for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+        {
+            locations.push_back(cell_population.GetNode(i)->rGetLocation());
+        }
+        return locations;
+    }
+
+public:
+
+    void TestInterpolation() throw (Exception)
+    {
+        ForceCoefficientSchedule schedule;
+        TS_ASSERT_THROWS_THIS(schedule.Evaluate(0.0), "A ForceCoefficientSchedule must have at least one knot before it is evaluated");
+
+        schedule.AddKnot(0.0, 1.0);
+        schedule.AddKnot(1.0, 3.0);
+        schedule.AddKnot(3.0, 2.0);
+        TS_ASSERT_EQUALS(schedule.GetNumKnots(), 3u);
+        TS_ASSERT_THROWS_THIS(schedule.AddKnot(2.0, 0.0), "Knots must be added to a ForceCoefficientSchedule in increasing order of time");
+
+        // Piecewise constant, holding the end values outside the knots
+        TS_ASSERT_EQUALS(schedule.GetInterpolationType(), ForceCoefficientSchedule::PIECEWISE_CONSTANT);
+        TS_ASSERT_DELTA(schedule.Evaluate(-1.0), 1.0, 1e-12);
+        TS_ASSERT_DELTA(schedule.Evaluate(0.5), 1.0, 1e-12);
+        TS_ASSERT_DELTA(schedule.Evaluate(1.0), 3.0, 1e-12);
+        TS_ASSERT_DELTA(schedule.Evaluate(2.9), 3.0, 1e-12);
+        TS_ASSERT_DELTA(schedule.Evaluate(10.0), 2.0, 1e-12);
+
+        // Linear
+        schedule.SetInterpolationType(ForceCoefficientSchedule::LINEAR);
+        TS_ASSERT_DELTA(schedule.Evaluate(0.5), 2.0, 1e-12);
+        TS_ASSERT_DELTA(schedule.Evaluate(2.0), 2.5, 1e-12);
+
+        // Natural cubic spline: passes through the knots, with zero second derivative at the ends
+        // and second derivative -2.5 at t=1 for these knots
+        schedule.SetInterpolationType(ForceCoefficientSchedule::CUBIC_SPLINE);
+        TS_ASSERT_DELTA(schedule.Evaluate(0.0), 1.0, 1e-12);
+        TS_ASSERT_DELTA(schedule.Evaluate(1.0), 3.0, 1e-12);
+        TS_ASSERT_DELTA(schedule.Evaluate(3.0), 2.0, 1e-12);
+        TS_ASSERT_DELTA(schedule.Evaluate(0.5), 2.0 + (0.125 - 0.5)*(-2.5)/6.0, 1e-12);
+
+        // A spline through points on a straight line is the straight line
+        ForceCoefficientSchedule linear_spline(ForceCoefficientSchedule::CUBIC_SPLINE);
+        for (unsigned i=0; i<5; i++)
+        {
+            linear_spline.AddKnot(i*i, 2.0*i*i + 1.0);
+        }
+        TS_ASSERT_DELTA(linear_spline.Evaluate(5.5), 12.0, 1e-12);
+    }
+
+    void TestLoadFromFile() throw (Exception)
+    {
+        OutputFileHandler handler("TestForceCoefficientSchedule");
+        out_stream p_file = handler.OpenOutputFile("schedule.dat");
+        *p_file << "# time value\n";
+        *p_file << "0.0 1.0\n";
+        *p_file << "\n";
+        *p_file << "50.0 1.1\n";
+        *p_file << "100.0 1.2\n";
+        p_file->close();
+
+        ForceCoefficientSchedule schedule;
+        schedule.LoadFromFile(handler.FindFile("schedule.dat"));
+        TS_ASSERT_EQUALS(schedule.GetNumKnots(), 3u);
+        TS_ASSERT_DELTA(schedule.Evaluate(75.0), 1.1, 1e-12);
+
+        p_file = handler.OpenOutputFile("bad_schedule.dat");
+        *p_file << "0.0 1.0\n";
+        *p_file << "0.0 2.0\n";
+        p_file->close();
+        TS_ASSERT_THROWS_CONTAINS(schedule.LoadFromFile(handler.FindFile("bad_schedule.dat")), "must be in increasing order (line 2)");
+        TS_ASSERT_THROWS_CONTAINS(schedule.LoadFromFile(handler.FindFile("missing.dat")), "Unable to open force coefficient schedule file");
+    }
+
+    void TestScheduledForceCoefficients() throw (Exception)
+    {
+        HoneycombVertexMeshGenerator generator(4, 4);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+
+        MAKE_PTR(ConstantTargetAreaModifier<2>, p_growth_modifier);
+        p_growth_modifier->UpdateTargetAreas(cell_population);
+
+        MAKE_PTR_ARGS(ForceCoefficientSchedule, p_area_schedule, (ForceCoefficientSchedule::LINEAR));
+        p_area_schedule->AddKnot(0.0, 1.0);
+        p_area_schedule->AddKnot(10.0, 2.0);
+
+        ParallelFarhadifarForce<2> force;
+        force.SetAreaElasticitySchedule(p_area_schedule);
+        force.SetPerimeterContractilityParameter(0.3);
+
+        // The parameter used is set from the schedule once per time step, without changing the parameter set by the user
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(10.0, 10);
+        for (unsigned step=0; step<3; step++)
+        {
+            SimulationTime::Instance()->IncrementTimeOneStep();
+            force.AddForceContribution(cell_population);
+            TS_ASSERT_DELTA(force.GetAreaElasticityParameterInUse(), 1.0 + 0.1*(step+1), 1e-12);
+            TS_ASSERT_DELTA(force.GetPerimeterContractilityParameterInUse(), 0.3, 1e-12);
+            TS_ASSERT_DELTA(force.GetAreaElasticityParameter(), 1.0, 1e-12);
+            TS_ASSERT_DELTA(force.GetPerimeterContractilityParameter(), 0.3, 1e-12);
+        }
+
+        // The parameters file records the parameter set by the user
+        OutputFileHandler handler("TestForceCoefficientSchedule", false);
+        out_stream p_params_file = handler.OpenOutputFile("force_parameters.dat");
+        force.OutputForceParameters(p_params_file);
+        p_params_file->close();
+        std::ifstream params_file((handler.GetOutputDirectoryFullPath() + "force_parameters.dat").c_str());
+        std::string params((std::istreambuf_iterator<char>(params_file)), std::istreambuf_iterator<char>());
+        TS_ASSERT(params.find("<AreaElasticityParameter>1</AreaElasticityParameter>") != std::string::npos);
+
+        // Once the schedule is removed, the parameter set by the user is used again
+        force.SetAreaElasticitySchedule(boost::shared_ptr<ForceCoefficientSchedule>());
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        force.AddForceContribution(cell_population);
+        TS_ASSERT_DELTA(force.GetAreaElasticityParameterInUse(), 1.0, 1e-12);
+    }
+
+    void TestFarhadifarForceWithTimeDependentCoefficientsFollowsOriginalTrajectory() throw (Exception)
+    {
+        MAKE_PTR(OriginalFarhadifarForceWithTimeDependentCoefficients, p_original_force);
+        std::vector<c_vector<double, 2> > original_locations = RunSimulation(p_original_force, "TestForceCoefficientSchedule/Original");
+
+        MAKE_PTR(FarhadifarForceWithTimeDependentCoefficients<2>, p_force);
+        std::vector<c_vector<double, 2> > locations = RunSimulation(p_force, "TestForceCoefficientSchedule/TimeDependent");
+
+        // The coefficients have increased twice by the end of the simulation
+        TS_ASSERT_DELTA(p_force->GetAreaElasticityParameterInUse(), p_force->GetAreaElasticityParameter(), 1e-12);
+        TS_ASSERT_DELTA(p_force->GetAreaElasticityParameter(), 1.0 + 0.2, 1e-12);
+
+        TS_ASSERT_EQUALS(locations.size(), original_locations.size());
+        for (unsigned i=0; i<locations.size(); i++)
+        {
+            TS_ASSERT_DELTA(locations[i][0], original_locations[i][0], 1e-8);
+            TS_ASSERT_DELTA(locations[i][1], original_locations[i][1], 1e-8);
+        }
+    }
+};
+
+#endif /*TESTFORCECOEFFICIENTSCHEDULE_HPP_*/
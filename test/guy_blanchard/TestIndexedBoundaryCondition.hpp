@@ -0,0 +1,311 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTINDEXEDBOUNDARYCONDITION_HPP_
+#define TESTINDEXEDBOUNDARYCONDITION_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+#include "HoneycombVertexMeshGenerator.hpp"
+#include "CellsGenerator.hpp"
+#include "NoCellCycleModel.hpp"
+#include "VertexBasedCellPopulation.hpp"
+#include "SlidingBoundaryCondition.hpp"
+#include "SidekickBoundaryCondition.hpp"
+#include "CircularBoundaryCondition.hpp"
+#include "HoneycombMeshGenerator.hpp"
+#include "NodesOnlyMesh.hpp"
+#include "NodeBasedCellPopulation.hpp"
+#include "RandomNumberGenerator.hpp"
+#include "SimulationTime.hpp"
+#include "Timer.hpp"
+#include "FakePetscSetup.hpp"
+
+#include <map>
+
+class TestIndexedBoundaryCondition : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * Record the node locations of a population as a map keyed by node pointer, as
+     * OffLatticeSimulation does.
+     */
+    std::map<Node<2>*, c_vector<double, 2> > RecordOldLocationMap(AbstractCellPopulation<2>& rCellPopulation)
+    {
+        std::map<Node<2>*, c_vector<double, 2> > old_locations;
+        for (AbstractMesh<2,2>::NodeIterator node_iter = rCellPopulation.rGetMesh().GetNodeIteratorBegin();
+             node_iter != rCellPopulation.rGetMesh().GetNodeIteratorEnd();
+             ++node_iter)
+        {
+            old_locations[&(*node_iter)] = node_iter->rGetLocation();
+        }
+        return old_locations;
+    }
+
+    /**
+     * Move every node of a population by the given displacements.
+     */
+    void MoveNodes(VertexBasedCellPopulation<2>& rCellPopulation, const std::vector<c_vector<double, 2> >& rDisplacements)
+    {
+        for (unsigned i=0; i<rCellPopulation.GetNumNodes(); i++)
+        {
+            rCellPopulation.GetNode(i)->rGetModifiableLocation() += rDisplacements[i];
+        }
+    }
+
+public:
+
+    void TestMapAdaptorAgreesWithIndexedLocations() throw (Exception)
+    {
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 1);
+
+        // Create two identical populations
+        HoneycombVertexMeshGenerator generator_a(8, 8);
+        MutableVertexMesh<2,2>* p_mesh_a = generator_a.GetMesh();
+        HoneycombVertexMeshGenerator generator_b(8, 8);
+        MutableVertexMesh<2,2>* p_mesh_b = generator_b.GetMesh();
+
+        std::vector<CellPtr> cells_a;
+        std::vector<CellPtr> cells_b;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells_a, p_mesh_a->GetNumElements());
+        cells_generator.GenerateBasic(cells_b, p_mesh_b->GetNumElements());
+        VertexBasedCellPopulation<2> population_a(*p_mesh_a, cells_a);
+        VertexBasedCellPopulation<2> population_b(*p_mesh_b, cells_b);
+
+        ChasteCuboid<2> bounds = p_mesh_a->CalculateBoundingBox();
+        SlidingBoundaryCondition sliding_a(&population_a, bounds.rGetLowerCorner()[0], bounds.rGetLowerCorner()[1],
+                                           bounds.rGetUpperCorner()[0], bounds.rGetUpperCorner()[1]);
+        SlidingBoundaryCondition sliding_b(&population_b, bounds.rGetLowerCorner()[0], bounds.rGetLowerCorner()[1],
+                                           bounds.rGetUpperCorner()[0], bounds.rGetUpperCorner()[1]);
+        SidekickBoundaryCondition<2> sidekick_a(&population_a);
+        SidekickBoundaryCondition<2> sidekick_b(&population_b);
+
+        std::vector<c_vector<double, 2> > displacements(population_a.GetNumNodes());
+        for (unsigned i=0; i<displacements.size(); i++)
+        {
+            displacements[i][0] = 0.1*(RandomNumberGenerator::Instance()->ranf() - 0.5);
+            displacements[i][1] = 0.1*(RandomNumberGenerator::Instance()->ranf() - 0.5);
+        }
+
+        // Population a is passed a map of old locations, as by OffLatticeSimulation; population b an indexed array
+        std::map<Node<2>*, c_vector<double, 2> > old_location_map = RecordOldLocationMap(population_a);
+        std::vector<c_vector<double, 2> > old_locations;
+        AbstractIndexedBoundaryCondition<2>::RecordOldLocations(population_b, old_locations);
+        TS_ASSERT_EQUALS(old_locations.size(), population_b.GetNumNodes());
+
+        MoveNodes(population_a, displacements);
+        MoveNodes(population_b, displacements);
+
+        sliding_a.ImposeBoundaryCondition(old_location_map);
+        sidekick_a.ImposeBoundaryCondition(old_location_map);
+        sliding_b.ImposeIndexedBoundaryCondition(old_locations);
+        sidekick_b.ImposeIndexedBoundaryCondition(old_locations);
+
+        unsigned num_reverted = 0;
+        for (unsigned i=0; i<population_a.GetNumNodes(); i++)
+        {
+            c_vector<double, 2> location_a = population_a.GetNode(i)->rGetLocation();
+            c_vector<double, 2> location_b = population_b.GetNode(i)->rGetLocation();
+            TS_ASSERT_DELTA(location_a[0], location_b[0], 1e-12);
+            TS_ASSERT_DELTA(location_a[1], location_b[1], 1e-12);
+
+            if (population_a.GetNode(i)->IsBoundaryNode() && location_a[0] == old_location_map[population_a.GetNode(i)][0])
+            {
+                num_reverted++;
+            }
+        }
+
+        // Some boundary nodes have had their x coordinate reverted
+        TS_ASSERT_LESS_THAN(0u, num_reverted);
+    }
+
+    void TestCircularBoundaryCondition() throw (Exception)
+    {
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 1);
+
+        // Create two identical node-based populations
+        HoneycombMeshGenerator generator(10, 10);
+        MutableMesh<2,2>* p_generating_mesh = generator.GetMesh();
+        NodesOnlyMesh<2> mesh_a;
+        mesh_a.ConstructNodesWithoutMesh(*p_generating_mesh, 1.5);
+        NodesOnlyMesh<2> mesh_b;
+        mesh_b.ConstructNodesWithoutMesh(*p_generating_mesh, 1.5);
+
+        std::vector<CellPtr> cells_a;
+        std::vector<CellPtr> cells_b;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells_a, mesh_a.GetNumNodes());
+        cells_generator.GenerateBasic(cells_b, mesh_b.GetNumNodes());
+        NodeBasedCellPopulation<2> population_a(mesh_a, cells_a);
+        NodeBasedCellPopulation<2> population_b(mesh_b, cells_b);
+
+        c_vector<double, 2> centre;
+        centre[0] = 4.5;
+        centre[1] = 4.0;
+        double radius = 3.0;
+        CircularBoundaryCondition circular_a(&population_a, centre, radius);
+        CircularBoundaryCondition circular_b(&population_b, centre, radius);
+
+        // The condition only acts on the current locations
+        TS_ASSERT_EQUALS(circular_a.UsesOldLocations(), false);
+        TS_ASSERT_EQUALS(circular_a.VerifyBoundaryCondition(), false);
+
+        // Population a is passed a map of old locations, as by OffLatticeSimulation; population b no old locations at all
+        std::map<Node<2>*, c_vector<double, 2> > old_location_map = RecordOldLocationMap(population_a);
+        circular_a.ImposeBoundaryCondition(old_location_map);
+        circular_b.ImposeIndexedBoundaryCondition(std::vector<c_vector<double, 2> >());
+
+        TS_ASSERT_EQUALS(circular_a.VerifyBoundaryCondition(), true);
+        TS_ASSERT_EQUALS(circular_b.VerifyBoundaryCondition(), true);
+
+        unsigned num_projected = 0;
+        for (AbstractMesh<2,2>::NodeIterator node_iter = mesh_a.GetNodeIteratorBegin();
+             node_iter != mesh_a.GetNodeIteratorEnd();
+             ++node_iter)
+        {
+            c_vector<double, 2> location_a = node_iter->rGetLocation();
+            c_vector<double, 2> location_b = mesh_b.GetNode(node_iter->GetIndex())->rGetLocation();
+            TS_ASSERT_DELTA(location_a[0], location_b[0], 1e-12);
+            TS_ASSERT_DELTA(location_a[1], location_b[1], 1e-12);
+
+            // Nodes outside the circle are projected onto it, along the line from its centre
+            c_vector<double, 2> old_location = old_location_map[&(*node_iter)];
+            double old_radius = norm_2(old_location - centre);
+            if (old_radius > radius)
+            {
+                TS_ASSERT_DELTA(norm_2(location_a - centre), radius, 1e-12);
+                TS_ASSERT_DELTA(location_a[0] - centre[0], (old_location[0] - centre[0])*radius/old_radius, 1e-12);
+                TS_ASSERT_DELTA(location_a[1] - centre[1], (old_location[1] - centre[1])*radius/old_radius, 1e-12);
+                num_projected++;
+            }
+            else
+            {
+                TS_ASSERT_DELTA(location_a[0], old_location[0], 1e-12);
+                TS_ASSERT_DELTA(location_a[1], old_location[1], 1e-12);
+            }
+        }
+        TS_ASSERT_LESS_THAN(0u, num_projected);
+    }
+
+    void TestIndexedLocationsOverheadRelativeToMap() throw (Exception)
+    {
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 1);
+
+        HoneycombVertexMeshGenerator generator(100, 100);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+
+        ChasteCuboid<2> bounds = p_mesh->CalculateBoundingBox();
+        SlidingBoundaryCondition boundary_condition(&cell_population, bounds.rGetLowerCorner()[0], bounds.rGetLowerCorner()[1],
+                                                    bounds.rGetUpperCorner()[0], bounds.rGetUpperCorner()[1]);
+
+        // Time recording the old locations and imposing the condition, through each interface
+        unsigned num_repeats = 20;
+        Timer::Reset();
+        for (unsigned repeat=0; repeat<num_repeats; repeat++)
+        {
+            std::map<Node<2>*, c_vector<double, 2> > old_location_map = RecordOldLocationMap(cell_population);
+            boundary_condition.ImposeBoundaryCondition(old_location_map);
+        }
+        double map_time = Timer::GetElapsedTime();
+
+        std::vector<c_vector<double, 2> > old_locations;
+        Timer::Reset();
+        for (unsigned repeat=0; repeat<num_repeats; repeat++)
+        {
+            AbstractIndexedBoundaryCondition<2>::RecordOldLocations(cell_population, old_locations);
+            boundary_condition.ImposeIndexedBoundaryCondition(old_locations);
+        }
+        double indexed_time = Timer::GetElapsedTime();
+
+        // Filling an array indexed by node avoids allocating a map entry for every node
+        TS_ASSERT_LESS_THAN(indexed_time, map_time);
+    }
+
+    void TestCircularMapAdaptorOverhead() throw (Exception)
+    {
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 1);
+
+        HoneycombMeshGenerator generator(100, 100);
+        MutableMesh<2,2>* p_generating_mesh = generator.GetMesh();
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(*p_generating_mesh, 1.5);
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, mesh.GetNumNodes());
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+        c_vector<double, 2> centre;
+        centre[0] = 50.0;
+        centre[1] = 43.0;
+        CircularBoundaryCondition boundary_condition(&cell_population, centre, 40.0);
+
+        // OffLatticeSimulation builds the map of old locations whether or not a condition uses it
+        std::map<Node<2>*, c_vector<double, 2> > old_location_map = RecordOldLocationMap(cell_population);
+        std::vector<c_vector<double, 2> > no_old_locations;
+
+        // Project the nodes outside the circle first, so that every timed call does the same work
+        boundary_condition.ImposeIndexedBoundaryCondition(no_old_locations);
+
+        // Time imposing the condition through the map adaptor and directly, alternating to share any drift in timing
+        unsigned num_repeats = 20;
+        double adaptor_time = 0.0;
+        double direct_time = 0.0;
+        for (unsigned repeat=0; repeat<num_repeats; repeat++)
+        {
+            Timer::Reset();
+            boundary_condition.ImposeBoundaryCondition(old_location_map);
+            adaptor_time += Timer::GetElapsedTime();
+
+            Timer::Reset();
+            boundary_condition.ImposeIndexedBoundaryCondition(no_old_locations);
+            direct_time += Timer::GetElapsedTime();
+        }
+        TS_ASSERT_EQUALS(boundary_condition.VerifyBoundaryCondition(), true);
+
+        // As the condition does not use the old locations, the adaptor does not copy the map and adds nothing
+        TS_ASSERT_LESS_THAN(adaptor_time, 1.5*direct_time);
+    }
+};
+
+#endif /*TESTINDEXEDBOUNDARYCONDITION_HPP_*/
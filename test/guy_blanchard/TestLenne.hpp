@@ -51,12 +51,103 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "FakePetscSetup.hpp"
 #include "LenneForce.hpp"
 #include "SimpleTargetAreaModifier.hpp"
+#include "ConstantTargetAreaModifier.hpp"
+#include "RandomNumberGenerator.hpp"
 
 
 class TestLenne : public AbstractCellBasedTestSuite
 {
+private:
+
+    /**
+     * @return the total line tension energy of the population, sum over element slots of T*l, where the
+     * line tension T of each edge is found from its orientation using atan2() and the given bin multipliers.
+     */
+    double ComputeReferenceLineTensionEnergy(VertexBasedCellPopulation<2>& rCellPopulation, const std::vector<double>& rProfile)
+    {
+        double energy = 0.0;
+        for (unsigned elem_index=0; elem_index<rCellPopulation.GetNumElements(); elem_index++)
+        {
+            VertexElement<2,2>* p_element = rCellPopulation.GetElement(elem_index);
+            unsigned num_nodes = p_element->GetNumNodes();
+            for (unsigned local_index=0; local_index<num_nodes; local_index++)
+            {
+                Node<2>* p_node_a = p_element->GetNode(local_index);
+                Node<2>* p_node_b = p_element->GetNode((local_index+1)%num_nodes);
+
+                std::set<unsigned> shared_elements;
+                std::set_intersection(p_node_a->rGetContainingElementIndices().begin(), p_node_a->rGetContainingElementIndices().end(),
+                                      p_node_b->rGetContainingElementIndices().begin(), p_node_b->rGetContainingElementIndices().end(),
+                                      std::inserter(shared_elements, shared_elements.begin()));
+                // Boundary line tension 0.3; each slot of an internal edge has half the line tension 1.0
+                double line_tension = (shared_elements.size() == 1) ? 0.3 : 0.5;
+
+                c_vector<double, 2> vector = p_node_b->rGetLocation() - p_node_a->rGetLocation();
+                double theta = atan2(fabs(vector(1)), fabs(vector(0)));
+                unsigned bin = std::min((unsigned)(theta/(0.5*M_PI)*rProfile.size()), (unsigned)(rProfile.size()-1));
+
+                energy += line_tension*rProfile[bin]*norm_2(vector);
+            }
+        }
+        return energy;
+    }
+
 public:
 
+    void TestOrientationTensionProfile() throw (Exception)
+    {
+        HoneycombVertexMeshGenerator generator(6, 6);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        // Perturb the nodes so that edges span all orientations
+        for (unsigned i=0; i<p_mesh->GetNumNodes(); i++)
+        {
+            p_mesh->GetNode(i)->rGetModifiableLocation()[0] += 0.1*(RandomNumberGenerator::Instance()->ranf() - 0.5);
+            p_mesh->GetNode(i)->rGetModifiableLocation()[1] += 0.1*(RandomNumberGenerator::Instance()->ranf() - 0.5);
+        }
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+
+        MAKE_PTR(ConstantTargetAreaModifier<2>, p_growth_modifier);
+        p_growth_modifier->UpdateTargetAreas(cell_population);
+
+        LenneForce<2> force;
+        force.SetLineTensionParameter(1.0);
+        force.SetBoundaryLineTensionParameter(0.3);
+
+        // The default profile multiplies the line tension of edges closer to the y axis by 1.5
+        TS_ASSERT_EQUALS(force.rGetOrientationTensionProfile().size(), 2u);
+        TS_ASSERT_DELTA(force.rGetOrientationTensionProfile()[1], 1.5, 1e-12);
+
+        // Remove the line tension energy by setting a zero profile
+        force.SetOrientationTensionProfile(std::vector<double>(2, 0.0));
+        double energy_without_line_tension = force.ComputeTotalEnergy(cell_population);
+
+        std::vector<double> default_profile(2);
+        default_profile[0] = 1.0;
+        default_profile[1] = 1.5;
+
+        std::vector<double> four_bin_profile(4);
+        four_bin_profile[0] = 1.0;
+        four_bin_profile[1] = 2.0;
+        four_bin_profile[2] = 0.5;
+        four_bin_profile[3] = 3.0;
+
+        for (unsigned i=0; i<2; i++)
+        {
+            const std::vector<double>& r_profile = (i == 0) ? default_profile : four_bin_profile;
+            force.SetOrientationTensionProfile(r_profile);
+            double line_tension_energy = force.ComputeTotalEnergy(cell_population) - energy_without_line_tension;
+            TS_ASSERT_DELTA(line_tension_energy, ComputeReferenceLineTensionEnergy(cell_population, r_profile), 1e-10);
+        }
+
+        TS_ASSERT_THROWS_THIS(force.SetOrientationTensionProfile(std::vector<double>()),
+                              "The orientation tension profile must have at least one bin");
+    }
+
     void TestVertexBasedDifferentialAdhesionSimulation() throw (Exception)
     {
         // Create regular mesh
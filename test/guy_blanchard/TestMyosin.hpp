@@ -21,6 +21,63 @@ class TestMyosin : public AbstractCellBasedWithTimingsTestSuite
 {
 public:
 
+    void TestLabelCacheAgreesWithDirectEvaluation() throw (Exception)
+    {
+        HoneycombMeshGenerator generator(6, 6);
+        MutableMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumNodes());
+
+        // Label every third cell so that all three spring classes occur
+        for (unsigned i=0; i<cells.size(); i+=3)
+        {
+            cells[i]->AddCellProperty(CellPropertyRegistry::Instance()->Get<CellLabel>());
+        }
+
+        MeshBasedCellPopulationWithoutRemeshing<2> cell_population(*p_mesh, cells);
+
+        // Perturb the nodes so that no spring is at its rest length
+        for (unsigned i=0; i<p_mesh->GetNumNodes(); i++)
+        {
+            p_mesh->GetNode(i)->rGetModifiableLocation()[0] += 0.01*(i%5);
+            p_mesh->GetNode(i)->rGetModifiableLocation()[1] -= 0.02*(i%3);
+        }
+
+        MyosinWeightedSpringForce<2> force;
+        force.SetMyosinSpringStiffness(100.0);
+        force.SetMyosinSpringNaturalLength(0.5);
+        force.SetNonMyosinSpringStiffness(1.0);
+        force.SetNonMyosinSpringNaturalLength(1.0);
+
+        // Accumulate the expected forces one spring at a time, looking up labels directly
+        std::vector<c_vector<double,2> > expected_forces(p_mesh->GetNumNodes(), zero_vector<double>(2));
+        for (MeshBasedCellPopulation<2>::SpringIterator spring_iter = cell_population.SpringsBegin();
+             spring_iter != cell_population.SpringsEnd();
+             ++spring_iter)
+        {
+            unsigned node_a_index = spring_iter.GetNodeA()->GetIndex();
+            unsigned node_b_index = spring_iter.GetNodeB()->GetIndex();
+            c_vector<double,2> spring_force = force.CalculateForceBetweenNodes(node_a_index, node_b_index, cell_population);
+            expected_forces[node_a_index] += spring_force;
+            expected_forces[node_b_index] -= spring_force;
+        }
+
+        for (unsigned i=0; i<p_mesh->GetNumNodes(); i++)
+        {
+            p_mesh->GetNode(i)->ClearAppliedForce();
+        }
+        force.AddForceContribution(cell_population);
+
+        for (unsigned i=0; i<p_mesh->GetNumNodes(); i++)
+        {
+            c_vector<double,2> applied_force = p_mesh->GetNode(i)->rGetAppliedForce();
+            TS_ASSERT_DELTA(applied_force[0], expected_forces[i][0], 1e-10);
+            TS_ASSERT_DELTA(applied_force[1], expected_forces[i][1], 1e-10);
+        }
+    }
+
     void TestSimulation() throw (Exception)
     {
         // Specify mechanical parameters
@@ -0,0 +1,252 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTMYOSINSPRINGFORCE_HPP_
+#define TESTMYOSINSPRINGFORCE_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+#include "HoneycombVertexMeshGenerator.hpp"
+#include "CellsGenerator.hpp"
+#include "NoCellCycleModel.hpp"
+#include "CellLabel.hpp"
+#include "VertexBasedCellPopulation.hpp"
+#include "MyosinSpringForce.hpp"
+#include "BlanchardForce.hpp"
+#include "OffLatticeSimulation.hpp"
+#include "SimulationTime.hpp"
+#include "ConstantTargetAreaModifier.hpp"
+#include "RandomNumberGenerator.hpp"
+#include "Timer.hpp"
+#include "SmartPointers.hpp"
+#include "FakePetscSetup.hpp"
+
+#include <cfloat>
+#include <map>
+
+class TestMyosinSpringForce : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * Label every third cell, so that all three classes of junction occur, and perturb
+     * the nodes so that no junction is at its rest length.
+     */
+    void SetUpLabelledPopulation(VertexBasedCellPopulation<2>& rCellPopulation)
+    {
+        boost::shared_ptr<AbstractCellProperty> p_label = CellPropertyRegistry::Instance()->Get<CellLabel>();
+        for (unsigned i=0; i<rCellPopulation.GetNumElements(); i+=3)
+        {
+            rCellPopulation.GetCellUsingLocationIndex(i)->AddCellProperty(p_label);
+        }
+
+        for (unsigned i=0; i<rCellPopulation.GetNumNodes(); i++)
+        {
+            Node<2>* p_node = rCellPopulation.GetNode(i);
+            p_node->rGetModifiableLocation()[0] += 0.05*(RandomNumberGenerator::Instance()->ranf() - 0.5);
+            p_node->rGetModifiableLocation()[1] += 0.05*(RandomNumberGenerator::Instance()->ranf() - 0.5);
+        }
+    }
+
+    /**
+     * Compute the junction spring forces directly from the mesh, finding the cells on
+     * either side of each junction by visiting every element's edges in turn.
+     */
+    std::vector<c_vector<double, 2> > ComputeReferenceForces(MyosinSpringForce<2>& rForce,
+                                                             VertexBasedCellPopulation<2>& rCellPopulation)
+    {
+        MutableVertexMesh<2,2>& r_mesh = rCellPopulation.rGetMesh();
+
+        std::map<std::pair<unsigned, unsigned>, std::vector<unsigned> > edge_elements;
+        for (VertexMesh<2,2>::VertexElementIterator elem_iter = r_mesh.GetElementIteratorBegin();
+             elem_iter != r_mesh.GetElementIteratorEnd();
+             ++elem_iter)
+        {
+            unsigned num_nodes_elem = elem_iter->GetNumNodes();
+            for (unsigned local_index=0; local_index<num_nodes_elem; local_index++)
+            {
+                unsigned node_a = elem_iter->GetNodeGlobalIndex(local_index);
+                unsigned node_b = elem_iter->GetNodeGlobalIndex((local_index+1)%num_nodes_elem);
+                edge_elements[std::make_pair(std::min(node_a, node_b), std::max(node_a, node_b))].push_back(elem_iter->GetIndex());
+            }
+        }
+
+        std::vector<c_vector<double, 2> > forces(rCellPopulation.GetNumNodes(), zero_vector<double>(2));
+        for (std::map<std::pair<unsigned, unsigned>, std::vector<unsigned> >::iterator edge_iter = edge_elements.begin();
+             edge_iter != edge_elements.end();
+             ++edge_iter)
+        {
+            unsigned num_labelled = 0;
+            for (unsigned i=0; i<2; i++)
+            {
+                unsigned elem_index = edge_iter->second[std::min(i, (unsigned)edge_iter->second.size() - 1)];
+                if (rCellPopulation.GetCellUsingLocationIndex(elem_index)->HasCellProperty<CellLabel>())
+                {
+                    num_labelled++;
+                }
+            }
+
+            double spring_constant = rForce.GetNonMyosinSpringConstant();
+            double rest_length = rForce.GetNonMyosinSpringRestLength();
+            if (num_labelled == 2)
+            {
+                spring_constant = rForce.GetMyosinSpringConstant();
+                rest_length = rForce.GetMyosinSpringRestLength();
+            }
+            else if (num_labelled == 1)
+            {
+                spring_constant = sqrt(rForce.GetMyosinSpringConstant()*rForce.GetNonMyosinSpringConstant());
+                rest_length = sqrt(rForce.GetMyosinSpringRestLength()*rForce.GetNonMyosinSpringRestLength());
+            }
+
+            unsigned node_a = edge_iter->first.first;
+            unsigned node_b = edge_iter->first.second;
+            c_vector<double, 2> edge_vector = r_mesh.GetVectorFromAtoB(r_mesh.GetNode(node_a)->rGetLocation(),
+                                                                       r_mesh.GetNode(node_b)->rGetLocation());
+            double length = norm_2(edge_vector);
+            c_vector<double, 2> spring_force = spring_constant*(length - rest_length)*edge_vector/length;
+            forces[node_a] += spring_force;
+            forces[node_b] -= spring_force;
+        }
+        return forces;
+    }
+
+    /**
+     * Run a simulation with a BlanchardForce on a striped and labelled 30x30 mesh, optionally
+     * adding a MyosinSpringForce.
+     *
+     * @return the wall time per time step.
+     */
+    double TimeSimulationStep(bool addMyosinSpringForce)
+    {
+        SimulationTime::Destroy();
+        SimulationTime::Instance()->SetStartTime(0.0);
+
+        HoneycombVertexMeshGenerator generator(30, 30);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+        SetUpLabelledPopulation(cell_population);
+        for (unsigned i=0; i<cell_population.GetNumElements(); i++)
+        {
+            cell_population.GetCellUsingLocationIndex(i)->GetCellData()->SetItem("stripe", 1 + (i%30)%4);
+        }
+
+        unsigned num_steps = 20;
+        OffLatticeSimulation<2> simulation(cell_population);
+        simulation.SetOutputDirectory("TestMyosinSpringForce/Overhead");
+        simulation.SetDt(0.01);
+        simulation.SetEndTime(num_steps*0.01);
+        simulation.SetSamplingTimestepMultiple(num_steps);
+
+        MAKE_PTR(BlanchardForce<2>, p_blanchard_force);
+        simulation.AddForce(p_blanchard_force);
+        if (addMyosinSpringForce)
+        {
+            MAKE_PTR(MyosinSpringForce<2>, p_myosin_force);
+            simulation.AddForce(p_myosin_force);
+        }
+        MAKE_PTR(ConstantTargetAreaModifier<2>, p_growth_modifier);
+        simulation.AddSimulationModifier(p_growth_modifier);
+
+        Timer::Reset();
+        simulation.Solve();
+        return Timer::GetElapsedTime()/num_steps;
+    }
+
+public:
+
+    void TestForceAgreesWithReference() throw (Exception)
+    {
+        HoneycombVertexMeshGenerator generator(6, 6);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+        SetUpLabelledPopulation(cell_population);
+
+        MyosinSpringForce<2> force;
+        force.SetMyosinSpringConstant(10.0);
+        force.SetMyosinSpringRestLength(0.3);
+        force.SetNonMyosinSpringConstant(1.0);
+        force.SetNonMyosinSpringRestLength(0.6);
+
+        std::vector<c_vector<double, 2> > reference_forces = ComputeReferenceForces(force, cell_population);
+
+        for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+        {
+            cell_population.GetNode(i)->ClearAppliedForce();
+        }
+        force.AddForceContribution(cell_population);
+
+        for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+        {
+            TS_ASSERT_DELTA(cell_population.GetNode(i)->rGetAppliedForce()[0], reference_forces[i][0], 1e-10);
+            TS_ASSERT_DELTA(cell_population.GetNode(i)->rGetAppliedForce()[1], reference_forces[i][1], 1e-10);
+        }
+
+        // The spring forces are internal, so they sum to zero
+        c_vector<double, 2> total_force = zero_vector<double>(2);
+        for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+        {
+            total_force += cell_population.GetNode(i)->rGetAppliedForce();
+        }
+        TS_ASSERT_DELTA(total_force[0], 0.0, 1e-10);
+        TS_ASSERT_DELTA(total_force[1], 0.0, 1e-10);
+    }
+
+    void TestOverheadWhenAddedToBlanchardForce() throw (Exception)
+    {
+        // Alternate the two runs and keep the fastest of each, to reduce the effect of timing noise
+        double blanchard_time = DBL_MAX;
+        double combined_time = DBL_MAX;
+        for (unsigned run=0; run<3; run++)
+        {
+            blanchard_time = std::min(blanchard_time, TimeSimulationStep(false));
+            combined_time = std::min(combined_time, TimeSimulationStep(true));
+        }
+
+        // Adding the junction springs should cost less than 10% of the time step (plus 5% for timing noise)
+        TS_ASSERT_LESS_THAN(combined_time, 1.15*blanchard_time);
+    }
+};
+
+#endif /*TESTMYOSINSPRINGFORCE_HPP_*/
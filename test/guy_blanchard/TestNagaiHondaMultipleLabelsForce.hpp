@@ -0,0 +1,514 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTNAGAIHONDAMULTIPLELABELSFORCE_HPP_
+#define TESTNAGAIHONDAMULTIPLELABELSFORCE_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <algorithm>
+#include <iterator>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+#include "HoneycombVertexMeshGenerator.hpp"
+#include "CellsGenerator.hpp"
+#include "NoCellCycleModel.hpp"
+#include "CellLabel.hpp"
+#include "VertexBasedCellPopulation.hpp"
+#include "NagaiHondaMultipleLabelsForce.hpp"
+#include "ConstantTargetAreaModifier.hpp"
+#include "RandomNumberGenerator.hpp"
+#include "Timer.hpp"
+#include "SmartPointers.hpp"
+#include "FakePetscSetup.hpp"
+
+class TestNagaiHondaMultipleLabelsForce : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * Give each cell a label colour from 1 to 3 by column, perturb the interior nodes
+     * so that the forces are not trivially zero, and set the target areas.
+     */
+    void SetUpLabelledPopulation(VertexBasedCellPopulation<2>& rCellPopulation, unsigned numCellsWide)
+    {
+        MAKE_PTR_ARGS(CellLabel, p_label_1, (1));
+        MAKE_PTR_ARGS(CellLabel, p_label_2, (2));
+        MAKE_PTR_ARGS(CellLabel, p_label_3, (3));
+        for (unsigned i=0; i<rCellPopulation.GetNumElements(); i++)
+        {
+            CellPtr p_cell = rCellPopulation.GetCellUsingLocationIndex(i);
+            switch ((i%numCellsWide)%3)
+            {
+                case 0:
+                    p_cell->AddCellProperty(p_label_1);
+                    break;
+                case 1:
+                    p_cell->AddCellProperty(p_label_2);
+                    break;
+                default:
+                    p_cell->AddCellProperty(p_label_3);
+            }
+        }
+
+        for (unsigned i=0; i<rCellPopulation.GetNumNodes(); i++)
+        {
+            Node<2>* p_node = rCellPopulation.GetNode(i);
+            if (!p_node->IsBoundaryNode())
+            {
+                p_node->rGetModifiableLocation()[0] += 0.05*(RandomNumberGenerator::Instance()->ranf() - 0.5);
+                p_node->rGetModifiableLocation()[1] += 0.05*(RandomNumberGenerator::Instance()->ranf() - 0.5);
+            }
+        }
+
+        MAKE_PTR(ConstantTargetAreaModifier<2>, p_growth_modifier);
+        p_growth_modifier->UpdateTargetAreas(rCellPopulation);
+    }
+
+    /**
+     * Check that the force on each node is minus the central difference of the total energy.
+     */
+    void CheckForceIsMinusGradientOfTotalEnergy(NagaiHondaMultipleLabelsForce<2>& rForce, VertexBasedCellPopulation<2>& rCellPopulation)
+    {
+        for (unsigned i=0; i<rCellPopulation.GetNumNodes(); i++)
+        {
+            rCellPopulation.GetNode(i)->ClearAppliedForce();
+        }
+        rForce.AddForceContribution(rCellPopulation);
+
+        double step = 1e-6;
+        for (unsigned node_index=0; node_index<rCellPopulation.GetNumNodes(); node_index++)
+        {
+            Node<2>* p_node = rCellPopulation.GetNode(node_index);
+            for (unsigned dim=0; dim<2; dim++)
+            {
+                p_node->rGetModifiableLocation()[dim] += step;
+                double energy_plus = rForce.ComputeTotalEnergy(rCellPopulation);
+                p_node->rGetModifiableLocation()[dim] -= 2*step;
+                double energy_minus = rForce.ComputeTotalEnergy(rCellPopulation);
+                p_node->rGetModifiableLocation()[dim] += step;
+
+                TS_ASSERT_DELTA(p_node->rGetAppliedForce()[dim], -(energy_plus - energy_minus)/(2*step), 1e-6);
+            }
+        }
+    }
+
+    /**
+     * @return the colour of the CellLabel of a cell.
+     */
+    unsigned GetLabelColour(CellPtr pCell)
+    {
+        CellPropertyCollection collection = pCell->rGetCellPropertyCollection().GetProperties<CellLabel>();
+        return boost::static_pointer_cast<CellLabel>(collection.GetProperty())->GetColour();
+    }
+
+    /**
+     * @return the adhesion parameter of the edge between two nodes, found from the labels of the
+     * cells sharing the edge as in the original NagaiHondaMultipleLabelsForce::GetAdhesionParameter(),
+     * without using the force's colour cache.
+     */
+    double ComputeReferenceAdhesionParameter(NagaiHondaMultipleLabelsForce<2>& rForce,
+                                             Node<2>* pNodeA,
+                                             Node<2>* pNodeB,
+                                             VertexBasedCellPopulation<2>& rCellPopulation,
+                                             unsigned numColours)
+    {
+        std::set<unsigned> shared_elements;
+        std::set_intersection(pNodeA->rGetContainingElementIndices().begin(), pNodeA->rGetContainingElementIndices().end(),
+                              pNodeB->rGetContainingElementIndices().begin(), pNodeB->rGetContainingElementIndices().end(),
+                              std::inserter(shared_elements, shared_elements.begin()));
+        if ((shared_elements.size() == 1) || pNodeA->IsBoundaryNode() || pNodeB->IsBoundaryNode())
+        {
+            return rForce.GetCellBoundaryAdhesionParameter();
+        }
+
+        unsigned colour_1 = GetLabelColour(rCellPopulation.GetCellUsingLocationIndex(*(shared_elements.begin())))%numColours;
+        unsigned colour_2 = GetLabelColour(rCellPopulation.GetCellUsingLocationIndex(*(shared_elements.rbegin())))%numColours;
+        unsigned difference_in_labels = (colour_1 > colour_2) ? (colour_1 - colour_2) : (colour_2 - colour_1);
+        if (difference_in_labels == 0)
+        {
+            return rForce.GetHomotypicCellAdhesionParameter();
+        }
+
+        // Label numbers wrap around, so take the smallest difference
+        double multiplier = (double)(difference_in_labels);
+        if (multiplier > numColours/2)
+        {
+            multiplier = numColours - multiplier;
+        }
+        return rForce.GetHeterotypicCellAdhesionParameter()*multiplier;
+    }
+
+    /**
+     * Compute the force on each node directly from the mesh, using a separate sweep over the
+     * nodes for the deformation and membrane terms and for the adhesion term, as the force did
+     * before the sweeps were fused.
+     */
+    std::vector<c_vector<double, 2> > ComputeReferenceForces(NagaiHondaMultipleLabelsForce<2>& rForce, VertexBasedCellPopulation<2>& rCellPopulation)
+    {
+        MutableVertexMesh<2,2>& r_mesh = rCellPopulation.rGetMesh();
+        unsigned num_nodes = rCellPopulation.GetNumNodes();
+        std::vector<c_vector<double, 2> > forces(num_nodes, zero_vector<double>(2));
+
+        std::set<unsigned> colours_present;
+        for (AbstractCellPopulation<2>::Iterator cell_iter = rCellPopulation.Begin(); cell_iter != rCellPopulation.End(); ++cell_iter)
+        {
+            colours_present.insert(GetLabelColour(*cell_iter));
+        }
+        unsigned num_colours = colours_present.size();
+
+        for (unsigned node_index=0; node_index<num_nodes; node_index++)
+        {
+            std::set<unsigned> containing_elem_indices = rCellPopulation.GetNode(node_index)->rGetContainingElementIndices();
+            for (std::set<unsigned>::iterator iter = containing_elem_indices.begin(); iter != containing_elem_indices.end(); ++iter)
+            {
+                VertexElement<2,2>* p_element = rCellPopulation.GetElement(*iter);
+                unsigned num_nodes_elem = p_element->GetNumNodes();
+                unsigned local_index = p_element->GetNodeLocalIndex(node_index);
+                unsigned previous_local_index = (num_nodes_elem+local_index-1)%num_nodes_elem;
+                double target_area = rCellPopulation.GetCellUsingLocationIndex(*iter)->GetCellData()->GetItem("target area");
+                double area = r_mesh.GetVolumeOfElement(*iter);
+                double perimeter = r_mesh.GetSurfaceAreaOfElement(*iter);
+
+                c_vector<double, 2> previous_edge_gradient = -r_mesh.GetNextEdgeGradientOfElementAtNode(p_element, previous_local_index);
+                c_vector<double, 2> next_edge_gradient = r_mesh.GetNextEdgeGradientOfElementAtNode(p_element, local_index);
+                forces[node_index] -= 2*rForce.GetNagaiHondaDeformationEnergyParameter()*(area - target_area)*r_mesh.GetAreaGradientOfElementAtNode(p_element, local_index);
+                forces[node_index] -= 2*rForce.GetNagaiHondaMembraneSurfaceEnergyParameter()*(perimeter - 2*sqrt(M_PI*target_area))*(previous_edge_gradient + next_edge_gradient);
+            }
+        }
+
+        for (unsigned node_index=0; node_index<num_nodes; node_index++)
+        {
+            Node<2>* p_this_node = rCellPopulation.GetNode(node_index);
+            std::set<unsigned> containing_elem_indices = p_this_node->rGetContainingElementIndices();
+            for (std::set<unsigned>::iterator iter = containing_elem_indices.begin(); iter != containing_elem_indices.end(); ++iter)
+            {
+                VertexElement<2,2>* p_element = rCellPopulation.GetElement(*iter);
+                unsigned num_nodes_elem = p_element->GetNumNodes();
+                unsigned local_index = p_element->GetNodeLocalIndex(node_index);
+                unsigned previous_local_index = (num_nodes_elem+local_index-1)%num_nodes_elem;
+                Node<2>* p_previous_node = p_element->GetNode(previous_local_index);
+                Node<2>* p_next_node = p_element->GetNode((local_index+1)%num_nodes_elem);
+
+                double previous_edge_adhesion_parameter = ComputeReferenceAdhesionParameter(rForce, p_previous_node, p_this_node, rCellPopulation, num_colours);
+                double next_edge_adhesion_parameter = ComputeReferenceAdhesionParameter(rForce, p_this_node, p_next_node, rCellPopulation, num_colours);
+                if (rForce.GetUseExponentialLineTension())
+                {
+                    double lambda = rForce.GetLambdaParameter();
+                    previous_edge_adhesion_parameter *= lambda*exp(-lambda*norm_2(r_mesh.GetVectorFromAtoB(p_previous_node->rGetLocation(), p_this_node->rGetLocation())));
+                    next_edge_adhesion_parameter *= lambda*exp(-lambda*norm_2(r_mesh.GetVectorFromAtoB(p_this_node->rGetLocation(), p_next_node->rGetLocation())));
+                }
+
+                c_vector<double, 2> previous_edge_gradient = -r_mesh.GetNextEdgeGradientOfElementAtNode(p_element, previous_local_index);
+                c_vector<double, 2> next_edge_gradient = r_mesh.GetNextEdgeGradientOfElementAtNode(p_element, local_index);
+                forces[node_index] -= previous_edge_adhesion_parameter*previous_edge_gradient + next_edge_adhesion_parameter*next_edge_gradient;
+            }
+        }
+        return forces;
+    }
+
+public:
+
+    void TestForceIsMinusGradientOfTotalEnergy() throw (Exception)
+    {
+        HoneycombVertexMeshGenerator generator(6, 6);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+        SetUpLabelledPopulation(cell_population, 6);
+
+        NagaiHondaMultipleLabelsForce<2> force;
+        force.SetNagaiHondaDeformationEnergyParameter(55.0);
+        force.SetNagaiHondaMembraneSurfaceEnergyParameter(0.1);
+        force.SetCellBoundaryAdhesionParameter(2.0);
+        force.SetHomotypicCellAdhesionParameter(0.5);
+        force.SetHeterotypicCellAdhesionParameter(1.5);
+
+        // Linear line tension
+        CheckForceIsMinusGradientOfTotalEnergy(force, cell_population);
+
+        // Exponential line tension
+        force.SetUseExponentialLineTension(true);
+        force.SetLambdaParameter(2.0);
+        CheckForceIsMinusGradientOfTotalEnergy(force, cell_population);
+    }
+    void TestAdhesionParameterMatrix() throw (Exception)
+    {
+        HoneycombVertexMeshGenerator generator(6, 6);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+        SetUpLabelledPopulation(cell_population, 6);
+
+        NagaiHondaMultipleLabelsForce<2> force;
+        force.SetCellBoundaryAdhesionParameter(2.0);
+        force.SetHomotypicCellAdhesionParameter(0.5);
+        force.SetHeterotypicCellAdhesionParameter(1.5);
+
+        // Labels 1, 2 and 3 have colour indices 1, 2 and 0
+        std::vector<std::vector<double> > matrix(3, std::vector<double>(3));
+        matrix[0][0] = 0.1; matrix[0][1] = 0.2; matrix[0][2] = 0.3;
+        matrix[1][0] = 0.2; matrix[1][1] = 0.4; matrix[1][2] = 0.5;
+        matrix[2][0] = 0.3; matrix[2][1] = 0.5; matrix[2][2] = 0.6;
+
+        for (unsigned use_matrix=0; use_matrix<2; use_matrix++)
+        {
+            if (use_matrix == 1)
+            {
+                force.SetAdhesionParameterMatrix(matrix);
+            }
+
+            // Check the adhesion parameter of each edge against its cells' label colours
+            for (unsigned elem_index=0; elem_index<cell_population.GetNumElements(); elem_index++)
+            {
+                VertexElement<2,2>* p_element = cell_population.GetElement(elem_index);
+                unsigned num_nodes = p_element->GetNumNodes();
+                for (unsigned local_index=0; local_index<num_nodes; local_index++)
+                {
+                    Node<2>* p_node_a = p_element->GetNode(local_index);
+                    Node<2>* p_node_b = p_element->GetNode((local_index+1)%num_nodes);
+
+                    std::set<unsigned> shared_elements;
+                    std::set_intersection(p_node_a->rGetContainingElementIndices().begin(), p_node_a->rGetContainingElementIndices().end(),
+                                          p_node_b->rGetContainingElementIndices().begin(), p_node_b->rGetContainingElementIndices().end(),
+                                          std::inserter(shared_elements, shared_elements.begin()));
+
+                    double expected_parameter = 2.0;
+                    if ((shared_elements.size() == 2) && !p_node_a->IsBoundaryNode() && !p_node_b->IsBoundaryNode())
+                    {
+                        unsigned colour_a = (*(shared_elements.begin())%6)%3 + 1;
+                        unsigned colour_b = (*(shared_elements.rbegin())%6)%3 + 1;
+                        if (use_matrix == 1)
+                        {
+                            expected_parameter = matrix[colour_a%3][colour_b%3];
+                        }
+                        else
+                        {
+                            // With three colours, any two different colours are adjacent on the colour wheel
+                            expected_parameter = (colour_a == colour_b) ? 0.5 : 1.5;
+                        }
+                    }
+                    TS_ASSERT_DELTA(force.GetAdhesionParameter(p_node_a, p_node_b, cell_population), expected_parameter, 1e-12);
+                }
+            }
+        }
+
+        // The force is still minus the gradient of the total energy with a user-defined matrix
+        CheckForceIsMinusGradientOfTotalEnergy(force, cell_population);
+
+        // The matrix must be symmetric and match the number of label colours present
+        matrix[0][1] = 0.7;
+        TS_ASSERT_THROWS_THIS(force.SetAdhesionParameterMatrix(matrix), "The adhesion parameter matrix must be symmetric");
+
+        force.SetAdhesionParameterMatrix(std::vector<std::vector<double> >(2, std::vector<double>(2, 1.0)));
+        TS_ASSERT_THROWS_THIS(force.AddForceContribution(cell_population),
+                              "The adhesion parameter matrix must have one row for each of the 3 label colours present");
+    }
+
+    void TestChangeOfLabelIsDetected() throw (Exception)
+    {
+        HoneycombVertexMeshGenerator generator(6, 6);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+        SetUpLabelledPopulation(cell_population, 6);
+
+        NagaiHondaMultipleLabelsForce<2> force;
+        force.SetCellBoundaryAdhesionParameter(2.0);
+        force.SetHomotypicCellAdhesionParameter(0.5);
+        force.SetHeterotypicCellAdhesionParameter(1.5);
+        force.AddForceContribution(cell_population);
+        double energy_before = force.ComputeTotalEnergy(cell_population);
+
+        // Give an interior cell of colour 3 the colour of its left-hand neighbour, without calling ResetLabelColourCache()
+        CellPtr p_cell = cell_population.GetCellUsingLocationIndex(14);
+        p_cell->RemoveCellProperty<CellLabel>();
+        MAKE_PTR_ARGS(CellLabel, p_label, (2));
+        p_cell->AddCellProperty(p_label);
+
+        for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+        {
+            cell_population.GetNode(i)->ClearAppliedForce();
+        }
+        force.AddForceContribution(cell_population);
+        std::vector<c_vector<double, 2> > forces(cell_population.GetNumNodes());
+        for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+        {
+            forces[i] = cell_population.GetNode(i)->rGetAppliedForce();
+        }
+        double energy_after = force.ComputeTotalEnergy(cell_population);
+
+        // The forces and energy must agree with those of a force that has never seen the old label
+        NagaiHondaMultipleLabelsForce<2> fresh_force;
+        fresh_force.SetCellBoundaryAdhesionParameter(2.0);
+        fresh_force.SetHomotypicCellAdhesionParameter(0.5);
+        fresh_force.SetHeterotypicCellAdhesionParameter(1.5);
+        for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+        {
+            cell_population.GetNode(i)->ClearAppliedForce();
+        }
+        fresh_force.AddForceContribution(cell_population);
+
+        for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+        {
+            TS_ASSERT_DELTA(forces[i][0], cell_population.GetNode(i)->rGetAppliedForce()[0], 1e-12);
+            TS_ASSERT_DELTA(forces[i][1], cell_population.GetNode(i)->rGetAppliedForce()[1], 1e-12);
+        }
+        TS_ASSERT_DELTA(energy_after, fresh_force.ComputeTotalEnergy(cell_population), 1e-12);
+
+        // The relabelling changes the adhesion energy
+        TS_ASSERT_LESS_THAN(1e-3, fabs(energy_before - energy_after));
+    }
+
+    void TestTabulatedExponentialLineTension() throw (Exception)
+    {
+        HoneycombVertexMeshGenerator generator(20, 20);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+        SetUpLabelledPopulation(cell_population, 20);
+
+        NagaiHondaMultipleLabelsForce<2> force;
+        force.SetUseExponentialLineTension(true);
+        force.SetLambdaParameter(2.0);
+        TS_ASSERT_EQUALS(force.GetUseTabulatedExponential(), false);
+
+        unsigned num_repeats = 20;
+        std::vector<c_vector<double, 2> > exact_forces(cell_population.GetNumNodes());
+        std::vector<c_vector<double, 2> > tabulated_forces(cell_population.GetNumNodes());
+        double times[2];
+        for (unsigned use_table=0; use_table<2; use_table++)
+        {
+            force.SetUseTabulatedExponential(use_table == 1);
+
+            Timer::Reset();
+            for (unsigned repeat=0; repeat<num_repeats; repeat++)
+            {
+                for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+                {
+                    cell_population.GetNode(i)->ClearAppliedForce();
+                }
+                force.AddForceContribution(cell_population);
+            }
+            times[use_table] = Timer::GetElapsedTime()/num_repeats;
+
+            for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+            {
+                (use_table == 1 ? tabulated_forces : exact_forces)[i] = cell_population.GetNode(i)->rGetAppliedForce();
+            }
+        }
+
+        // The largest force error, relative to the largest force, is bounded by the interpolation error
+        double max_force = 0.0;
+        double max_force_error = 0.0;
+        for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+        {
+            max_force = std::max(max_force, norm_2(exact_forces[i]));
+            max_force_error = std::max(max_force_error, norm_2(tabulated_forces[i] - exact_forces[i]));
+        }
+        TS_ASSERT_LESS_THAN(max_force_error/max_force, 1e-5);
+
+        // The tabulated exponential is within cosh(1/512) - 1 of exp(), relative to exp(), across and beyond the table
+        double max_relative_error = 0.0;
+        for (unsigned i=0; i<=200000; i++)
+        {
+            double x = 20.0*i/200000.0;
+            max_relative_error = std::max(max_relative_error, fabs(force.GetTabulatedExponential(x) - exp(-x))/exp(-x));
+        }
+        TS_ASSERT_LESS_THAN(max_relative_error, 2e-6);
+        TS_ASSERT_LESS_THAN(1e-6, max_relative_error);
+
+        // The table should not make the assembly slower (with slack for timing noise)
+        TS_ASSERT_LESS_THAN(times[1], 1.5*times[0]);
+    }
+
+    void TestForceAgreesWithReferenceOnLargeLabelledMesh() throw (Exception)
+    {
+        HoneycombVertexMeshGenerator generator(50, 50);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+        SetUpLabelledPopulation(cell_population, 50);
+
+        NagaiHondaMultipleLabelsForce<2> force;
+        force.SetUseExponentialLineTension(true);
+        force.SetLambdaParameter(2.0);
+
+        unsigned num_repeats = 10;
+        Timer::Reset();
+        std::vector<c_vector<double, 2> > reference_forces;
+        for (unsigned repeat=0; repeat<num_repeats; repeat++)
+        {
+            reference_forces = ComputeReferenceForces(force, cell_population);
+        }
+        double reference_time = Timer::GetElapsedTime()/num_repeats;
+
+        Timer::Reset();
+        for (unsigned repeat=0; repeat<num_repeats; repeat++)
+        {
+            for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+            {
+                cell_population.GetNode(i)->ClearAppliedForce();
+            }
+            force.AddForceContribution(cell_population);
+        }
+        double fused_time = Timer::GetElapsedTime()/num_repeats;
+
+        for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+        {
+            TS_ASSERT_DELTA(cell_population.GetNode(i)->rGetAppliedForce()[0], reference_forces[i][0], 1e-10);
+            TS_ASSERT_DELTA(cell_population.GetNode(i)->rGetAppliedForce()[1], reference_forces[i][1], 1e-10);
+        }
+
+        // Fusing the sweeps should cut the time per step by at least 40%
+        TS_ASSERT_LESS_THAN(fused_time, 0.6*reference_time);
+    }
+};
+
+#endif /*TESTNAGAIHONDAMULTIPLELABELSFORCE_HPP_*/
@@ -0,0 +1,162 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTPOPULATIONGEOMETRYCACHE_HPP_
+#define TESTPOPULATIONGEOMETRYCACHE_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include "AbstractCellBasedTestSuite.hpp"
+#include "HoneycombVertexMeshGenerator.hpp"
+#include "CellsGenerator.hpp"
+#include "NoCellCycleModel.hpp"
+#include "VertexBasedCellPopulation.hpp"
+#include "PopulationGeometryCache.hpp"
+#include "SimulationTime.hpp"
+#include "FakePetscSetup.hpp"
+
+class TestPopulationGeometryCache : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * @return the global indices of the boundary nodes of a mesh, found by scanning every node.
+     */
+    std::vector<unsigned> FindBoundaryNodeIndices(MutableVertexMesh<2,2>& rMesh)
+    {
+        std::vector<unsigned> boundary_node_indices;
+        for (unsigned node_index=0; node_index<rMesh.GetNumNodes(); node_index++)
+        {
+            if (rMesh.GetNode(node_index)->IsBoundaryNode())
+            {
+                boundary_node_indices.push_back(node_index);
+            }
+        }
+        return boundary_node_indices;
+    }
+
+public:
+
+    void TestBoundaryNodesAndBoundingBox() throw (Exception)
+    {
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 10);
+
+        HoneycombVertexMeshGenerator generator(4, 4);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+
+        PopulationGeometryCache<2> cache;
+
+        // Test that the cache finds the same boundary nodes as a scan of the mesh
+        std::vector<unsigned> boundary_node_indices = FindBoundaryNodeIndices(*p_mesh);
+        TS_ASSERT(!boundary_node_indices.empty());
+        TS_ASSERT(cache.rGetBoundaryNodeIndices(cell_population) == boundary_node_indices);
+
+        // Test that the bounding box agrees with that of the mesh
+        ChasteCuboid<2> bounds = p_mesh->CalculateBoundingBox();
+        ChasteCuboid<2> cached_bounds = cache.GetBoundingBox(cell_population);
+        for (unsigned dim=0; dim<2; dim++)
+        {
+            TS_ASSERT_DELTA(cached_bounds.rGetLowerCorner()[dim], bounds.rGetLowerCorner()[dim], 1e-12);
+            TS_ASSERT_DELTA(cached_bounds.rGetUpperCorner()[dim], bounds.rGetUpperCorner()[dim], 1e-12);
+        }
+
+        // Test that the bounding box is reused within a time step, unless invalidated
+        c_vector<double, 2> old_location = p_mesh->GetNode(boundary_node_indices[0])->rGetLocation();
+        ChastePoint<2> far_away(100.0, 100.0);
+        p_mesh->SetNode(boundary_node_indices[0], far_away);
+        TS_ASSERT_DELTA(cache.GetBoundingBox(cell_population).rGetUpperCorner()[0], bounds.rGetUpperCorner()[0], 1e-12);
+
+        cache.InvalidateBoundingBox();
+        TS_ASSERT_DELTA(cache.GetBoundingBox(cell_population).rGetUpperCorner()[0], 100.0, 1e-12);
+
+        ChastePoint<2> old_point(old_location);
+        p_mesh->SetNode(boundary_node_indices[0], old_point);
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        TS_ASSERT_DELTA(cache.GetBoundingBox(cell_population).rGetUpperCorner()[0], bounds.rGetUpperCorner()[0], 1e-12);
+    }
+
+    void TestChangesOfBoundaryNodesAreDetected() throw (Exception)
+    {
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 10);
+
+        HoneycombVertexMeshGenerator generator(4, 4);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+
+        PopulationGeometryCache<2> cache;
+        std::vector<unsigned> boundary_node_indices = cache.rGetBoundaryNodeIndices(cell_population);
+
+        // Find an interior node
+        unsigned interior_node_index = UNSIGNED_UNSET;
+        for (unsigned node_index=0; node_index<p_mesh->GetNumNodes(); node_index++)
+        {
+            if (!p_mesh->GetNode(node_index)->IsBoundaryNode())
+            {
+                interior_node_index = node_index;
+                break;
+            }
+        }
+        TS_ASSERT_DIFFERS(interior_node_index, UNSIGNED_UNSET);
+
+        /*
+         * A T1 swap on the boundary of the population puts an interior node on the boundary
+         * without changing the number of nodes or cells. Rearrangements take place when the
+         * population is updated between time steps, so the cache finds the new boundary node
+         * in the next time step.
+         */
+        p_mesh->GetNode(interior_node_index)->SetAsBoundaryNode(true);
+        SimulationTime::Instance()->IncrementTimeOneStep();
+
+        std::vector<unsigned> new_boundary_node_indices = cache.rGetBoundaryNodeIndices(cell_population);
+        TS_ASSERT_EQUALS(new_boundary_node_indices.size(), boundary_node_indices.size() + 1);
+        TS_ASSERT(new_boundary_node_indices == FindBoundaryNodeIndices(*p_mesh));
+
+        // Within a time step, a change of boundary node is only found once the cache is reset
+        p_mesh->GetNode(interior_node_index)->SetAsBoundaryNode(false);
+        TS_ASSERT(cache.rGetBoundaryNodeIndices(cell_population) == new_boundary_node_indices);
+        cache.Reset();
+        TS_ASSERT(cache.rGetBoundaryNodeIndices(cell_population) == boundary_node_indices);
+    }
+};
+
+#endif /*TESTPOPULATIONGEOMETRYCACHE_HPP_*/
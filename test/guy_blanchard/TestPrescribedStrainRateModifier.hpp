@@ -0,0 +1,307 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTPRESCRIBEDSTRAINRATEMODIFIER_HPP_
+#define TESTPRESCRIBEDSTRAINRATEMODIFIER_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+#include "HoneycombVertexMeshGenerator.hpp"
+#include "ToroidalHoneycombVertexMeshGenerator.hpp"
+#include "CellsGenerator.hpp"
+#include "NoCellCycleModel.hpp"
+#include "VertexBasedCellPopulation.hpp"
+#include "PrescribedStrainRateModifier.hpp"
+#include "Toroidal2dVertexMeshStretchModifier.hpp"
+#include "FollicularEpitheliumStretchModifier.hpp"
+#include "FarhadifarForce.hpp"
+#include "ConstantTargetAreaModifier.hpp"
+#include "AdaptiveTimestepOffLatticeSimulation.hpp"
+#include "SmartPointers.hpp"
+#include "FakePetscSetup.hpp"
+
+#include <cfloat>
+
+/**
+ * The original Toroidal2dVertexMeshStretchModifier, which grew the periodic box while leaving the
+ * nodes in place, kept to measure the gain in usable time step from moving the nodes with the box.
+ */
+class OriginalToroidal2dVertexMeshStretchModifier : public AbstractCellBasedSimulationModifier<2>
+{
+private:
+
+    friend class boost::serialization::access;
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractCellBasedSimulationModifier<2> >(*this);
+    }
+
+public:
+
+    void UpdateAtEndOfTimeStep(AbstractCellPopulation<2,2>& rCellPopulation)
+    {
+        Toroidal2dVertexMesh* p_mesh = static_cast<Toroidal2dVertexMesh*>(&(rCellPopulation.rGetMesh()));
+        double dt = SimulationTime::Instance()->GetTimeStep();
+        p_mesh->SetWidth(0, p_mesh->GetWidth(0) + dt);
+        p_mesh->SetWidth(1, p_mesh->GetWidth(1) + dt/sqrt(3.0));
+    }
+
+    void SetupSolve(AbstractCellPopulation<2,2>& rCellPopulation, std::string outputDirectory)
+    {
+    }
+
+    void OutputSimulationModifierParameters(out_stream& rParamsFile)
+    {
+        AbstractCellBasedSimulationModifier<2>::OutputSimulationModifierParameters(rParamsFile);
+    }
+};
+
+// The class must be registered to write its parameters when a simulation is run
+#include "SerializationExportWrapper.hpp"
+CHASTE_CLASS_EXPORT(OriginalToroidal2dVertexMeshStretchModifier)
+#include "SerializationExportWrapperForCpp.hpp"
+CHASTE_CLASS_EXPORT(OriginalToroidal2dVertexMeshStretchModifier)
+
+class TestPrescribedStrainRateModifier : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * Stretch a toroidal honeycomb with a given modifier, using adaptive substeps within a
+     * coarse time step, and return the number of substeps taken.
+     */
+    unsigned RunToroidalStretch(boost::shared_ptr<AbstractCellBasedSimulationModifier<2> > pStretchModifier, std::string outputDirectory)
+    {
+        SimulationTime::Destroy();
+        SimulationTime::Instance()->SetStartTime(0.0);
+
+        ToroidalHoneycombVertexMeshGenerator generator(6, 6);
+        Toroidal2dVertexMesh* p_mesh = generator.GetToroidalMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+
+        AdaptiveTimestepOffLatticeSimulation<2> simulation(cell_population);
+        simulation.SetOutputDirectory(outputDirectory);
+        simulation.SetEndTime(2.0);
+        simulation.SetDt(0.1);
+        simulation.SetSamplingTimestepMultiple(20);
+
+        MAKE_PTR(FarhadifarForce<2>, p_force);
+        simulation.AddForce(p_force);
+        MAKE_PTR(ConstantTargetAreaModifier<2>, p_growth_modifier);
+        simulation.AddSimulationModifier(p_growth_modifier);
+        simulation.AddSimulationModifier(pStretchModifier);
+
+        simulation.Solve();
+
+        // Both modifiers grow the periodic box at the same rate
+        TS_ASSERT_DELTA(p_mesh->GetWidth(0), 6.0 + 2.0, 1e-6);
+
+        return simulation.GetNumSubsteps();
+    }
+
+public:
+
+    void TestAffineDeformationWithPinnedRegion() throw (Exception)
+    {
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 10);
+
+        HoneycombVertexMeshGenerator generator(5, 5);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+
+        std::vector<c_vector<double, 2> > old_locations;
+        for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+        {
+            old_locations.push_back(cell_population.GetNode(i)->rGetLocation());
+        }
+
+        // Stretch along x with a little shear, holding fixed a point and any node with x <= 1
+        c_matrix<double, 2, 2> strain_rate = zero_matrix<double>(2, 2);
+        strain_rate(0,0) = 0.2;
+        strain_rate(0,1) = 0.05;
+        strain_rate(1,1) = -0.1;
+        c_vector<double, 2> fixed_point;
+        fixed_point[0] = 1.0;
+        fixed_point[1] = 2.0;
+        c_vector<double, 2> pinned_lower_corner;
+        pinned_lower_corner[0] = -DBL_MAX;
+        pinned_lower_corner[1] = -DBL_MAX;
+        c_vector<double, 2> pinned_upper_corner;
+        pinned_upper_corner[0] = 1.0;
+        pinned_upper_corner[1] = DBL_MAX;
+
+        PrescribedStrainRateModifier<2> modifier;
+        modifier.SetStrainRate(strain_rate);
+        modifier.SetFixedPoint(fixed_point);
+        modifier.AddPinnedRegion(pinned_lower_corner, pinned_upper_corner);
+        TS_ASSERT_DELTA(modifier.GetStrainRate()(0,1), 0.05, 1e-12);
+
+        modifier.UpdateAtEndOfTimeStep(cell_population);
+
+        double dt = SimulationTime::Instance()->GetTimeStep();
+        for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+        {
+            c_vector<double, 2> expected_location = old_locations[i];
+            if (old_locations[i][0] > 1.0)
+            {
+                expected_location += dt*prod(strain_rate, old_locations[i] - fixed_point);
+            }
+            TS_ASSERT_DELTA(cell_population.GetNode(i)->rGetLocation()[0], expected_location[0], 1e-12);
+            TS_ASSERT_DELTA(cell_population.GetNode(i)->rGetLocation()[1], expected_location[1], 1e-12);
+        }
+    }
+
+    void TestToroidalStretchMovesNodesWithPeriodicBox() throw (Exception)
+    {
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 10);
+
+        ToroidalHoneycombVertexMeshGenerator generator(4, 4);
+        Toroidal2dVertexMesh* p_mesh = generator.GetToroidalMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+
+        double old_width = p_mesh->GetWidth(0);
+        double old_height = p_mesh->GetWidth(1);
+        std::vector<c_vector<double, 2> > old_locations;
+        for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+        {
+            old_locations.push_back(cell_population.GetNode(i)->rGetLocation());
+        }
+
+        Toroidal2dVertexMeshStretchModifier modifier;
+        modifier.SetSpeed(0.5);
+        modifier.UpdateAtEndOfTimeStep(cell_population);
+
+        // The periodic box grows as before...
+        double dt = SimulationTime::Instance()->GetTimeStep();
+        double new_width = p_mesh->GetWidth(0);
+        double new_height = p_mesh->GetWidth(1);
+        TS_ASSERT_DELTA(new_width, old_width + 0.5*dt, 1e-12);
+        TS_ASSERT_DELTA(new_height, old_height + 0.5*dt/sqrt(3.0), 1e-12);
+
+        // ...and the nodes are stretched with it, so their locations relative to the box are unchanged
+        for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+        {
+            TS_ASSERT_DELTA(cell_population.GetNode(i)->rGetLocation()[0]/new_width, old_locations[i][0]/old_width, 1e-12);
+            TS_ASSERT_DELTA(cell_population.GetNode(i)->rGetLocation()[1]/new_height, old_locations[i][1]/old_height, 1e-12);
+        }
+
+        // A periodic box cannot be sheared
+        c_matrix<double, 2, 2> shear = zero_matrix<double>(2, 2);
+        shear(0,1) = 0.1;
+        PrescribedStrainRateModifier<2> shear_modifier;
+        shear_modifier.SetStrainRate(shear);
+        TS_ASSERT_THROWS_THIS(shear_modifier.UpdateAtEndOfTimeStep(cell_population),
+                              "Only a diagonal strain rate may be applied to a Toroidal2dVertexMesh");
+    }
+
+    void TestFollicularEpitheliumStretchModifierPinsAnteriorMostCells() throw (Exception)
+    {
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 10);
+
+        HoneycombVertexMeshGenerator generator(5, 5);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+
+        ChasteCuboid<2> bounds = p_mesh->CalculateBoundingBox();
+        double x_min = bounds.rGetLowerCorner()[0];
+        double x_max = bounds.rGetUpperCorner()[0];
+
+        std::vector<c_vector<double, 2> > old_locations;
+        for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+        {
+            old_locations.push_back(cell_population.GetNode(i)->rGetLocation());
+        }
+
+        FollicularEpitheliumStretchModifier<2> modifier;
+        modifier.SetSpeed(0.5);
+        modifier.PinAnteriorMostCells(true);
+        modifier.UpdateAtEndOfTimeStep(cell_population);
+
+        // Nodes within one cell width of the anterior edge do not move, and the posterior edge moves at the given speed
+        double dt = SimulationTime::Instance()->GetTimeStep();
+        unsigned num_pinned = 0;
+        for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+        {
+            c_vector<double, 2> location = cell_population.GetNode(i)->rGetLocation();
+            if (old_locations[i][0] <= x_min + 1.0)
+            {
+                TS_ASSERT_DELTA(location[0], old_locations[i][0], 1e-12);
+                num_pinned++;
+            }
+            else
+            {
+                TS_ASSERT_DELTA(location[0], old_locations[i][0] + 0.5*dt*(old_locations[i][0] - x_min)/(x_max - x_min), 1e-12);
+            }
+            TS_ASSERT_DELTA(location[1], old_locations[i][1], 1e-12);
+        }
+        TS_ASSERT_LESS_THAN(0u, num_pinned);
+    }
+
+    void TestTimeStepGainOfMovingNodesWithPeriodicBox() throw (Exception)
+    {
+        MAKE_PTR(OriginalToroidal2dVertexMeshStretchModifier, p_original_modifier);
+        unsigned original_num_substeps = RunToroidalStretch(p_original_modifier, "TestPrescribedStrainRateModifier/Original");
+
+        MAKE_PTR(Toroidal2dVertexMeshStretchModifier, p_modifier);
+        unsigned num_substeps = RunToroidalStretch(p_modifier, "TestPrescribedStrainRateModifier/Affine");
+
+        /*
+         * Growing the box alone stretches only the edges that cross its seams, and the resulting
+         * large forces there limit the substep. Stretching the nodes with the box spreads the
+         * deformation over every edge, so the same stretch needs fewer substeps.
+         */
+        TS_ASSERT_LESS_THAN(num_substeps, original_num_substeps);
+    }
+};
+
+#endif /*TESTPRESCRIBEDSTRAINRATEMODIFIER_HPP_*/
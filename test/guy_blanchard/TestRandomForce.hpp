@@ -0,0 +1,175 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTRANDOMFORCE_HPP_
+#define TESTRANDOMFORCE_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+#include "HoneycombVertexMeshGenerator.hpp"
+#include "CellsGenerator.hpp"
+#include "NoCellCycleModel.hpp"
+#include "VertexBasedCellPopulation.hpp"
+#include "RandomForce.hpp"
+#include "PhiloxRandomNumberGenerator.hpp"
+#include "SimulationTime.hpp"
+#include "FakePetscSetup.hpp"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+class TestRandomForce : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * @return the applied force on each node after clearing the forces and adding the random force.
+     */
+    std::vector<c_vector<double, 2> > ComputeForces(RandomForce<2>& rForce, VertexBasedCellPopulation<2>& rCellPopulation)
+    {
+        for (unsigned i=0; i<rCellPopulation.GetNumNodes(); i++)
+        {
+            rCellPopulation.GetNode(i)->ClearAppliedForce();
+        }
+        rForce.AddForceContribution(rCellPopulation);
+
+        std::vector<c_vector<double, 2> > forces;
+        for (unsigned i=0; i<rCellPopulation.GetNumNodes(); i++)
+        {
+            forces.push_back(rCellPopulation.GetNode(i)->rGetAppliedForce());
+        }
+        return forces;
+    }
+
+public:
+
+    void TestPhiloxKnownAnswers() throw (Exception)
+    {
+        // Known-answer vectors for Philox4x32-10 from the Random123 library
+        uint32_t result[4];
+
+        uint32_t zero_counter[4] = {0u, 0u, 0u, 0u};
+        uint32_t zero_key[2] = {0u, 0u};
+        PhiloxRandomNumberGenerator::Philox4x32(zero_counter, zero_key, result);
+        TS_ASSERT_EQUALS(result[0], 0x6627e8d5u);
+        TS_ASSERT_EQUALS(result[1], 0xe169c58du);
+        TS_ASSERT_EQUALS(result[2], 0xbc57ac4cu);
+        TS_ASSERT_EQUALS(result[3], 0x9b00dbd8u);
+
+        uint32_t pi_counter[4] = {0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u};
+        uint32_t pi_key[2] = {0xa4093822u, 0x299f31d0u};
+        PhiloxRandomNumberGenerator::Philox4x32(pi_counter, pi_key, result);
+        TS_ASSERT_EQUALS(result[0], 0xd16cfe09u);
+        TS_ASSERT_EQUALS(result[1], 0x94fdccebu);
+        TS_ASSERT_EQUALS(result[2], 0x5001e420u);
+        TS_ASSERT_EQUALS(result[3], 0x24126ea1u);
+    }
+
+    void TestCounterBasedRandomForceIsReproducible() throw (Exception)
+    {
+        HoneycombVertexMeshGenerator generator(50, 50);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+
+        double diffusion_constant = 0.02;
+        double dt = 0.01;
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 100);
+
+        RandomForce<2> force(diffusion_constant);
+        force.SetUseCounterBasedRandomNumbers(true);
+        force.SetCounterBasedSeed(7);
+
+        std::vector<c_vector<double, 2> > forces = ComputeForces(force, cell_population);
+
+        // Each node's force depends only on (seed, time step, node index), whatever the number of threads
+#ifdef _OPENMP
+        int max_threads = omp_get_max_threads();
+        for (int num_threads=1; num_threads<=max_threads; num_threads*=2)
+        {
+            omp_set_num_threads(num_threads);
+            std::vector<c_vector<double, 2> > forces_with_threads = ComputeForces(force, cell_population);
+            for (unsigned i=0; i<forces.size(); i++)
+            {
+                TS_ASSERT_EQUALS(forces_with_threads[i][0], forces[i][0]);
+                TS_ASSERT_EQUALS(forces_with_threads[i][1], forces[i][1]);
+            }
+        }
+        omp_set_num_threads(max_threads);
+#endif // _OPENMP
+
+        PhiloxRandomNumberGenerator philox(7);
+        double noise_scale = sqrt(2.0*diffusion_constant/dt);
+        for (unsigned i=0; i<forces.size(); i+=97)
+        {
+            double xi[4];
+            philox.GetStandardNormalDeviates(0, i, xi);
+            double nu = cell_population.GetDampingConstant(i);
+            TS_ASSERT_EQUALS(forces[i][0], nu*noise_scale*xi[0]);
+            TS_ASSERT_EQUALS(forces[i][1], nu*noise_scale*xi[1]);
+        }
+
+        // The forces change from one time step to the next, and have the expected mean and variance
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        std::vector<c_vector<double, 2> > next_forces = ComputeForces(force, cell_population);
+        TS_ASSERT_DIFFERS(next_forces[0][0], forces[0][0]);
+
+        double sum = 0.0;
+        double sum_of_squares = 0.0;
+        unsigned num_samples = 0;
+        for (unsigned i=0; i<next_forces.size(); i++)
+        {
+            double nu = cell_population.GetDampingConstant(i);
+            for (unsigned dim=0; dim<2; dim++)
+            {
+                double xi = next_forces[i][dim]/(nu*noise_scale);
+                sum += xi;
+                sum_of_squares += xi*xi;
+                num_samples++;
+            }
+        }
+        double mean = sum/num_samples;
+        double variance = sum_of_squares/num_samples - mean*mean;
+        TS_ASSERT_DELTA(mean, 0.0, 5.0/sqrt((double)num_samples));
+        TS_ASSERT_DELTA(variance, 1.0, 5.0*sqrt(2.0/num_samples));
+    }
+};
+
+#endif /*TESTRANDOMFORCE_HPP_*/
@@ -45,7 +45,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "VertexBasedCellPopulation.hpp"
 #include "StripeStatisticsWriter.hpp"
 #include "ForceForScenario2.hpp"
+#include "StripeIdentityModifier.hpp"
 #include "ConstantTargetAreaModifier.hpp"
+#include "FireRelaxationSolver.hpp"
 #include "OffLatticeSimulation.hpp"
 #include "SmartPointers.hpp"
 #include "FakePetscSetup.hpp"
@@ -74,8 +76,7 @@ public:
         // Diffusion constant is only used if include_random_jiggling == true
         double diffusion_constant = 0.01;
 
-        // Specify pre-stripe mechanical relaxation time and stripe simulation time
-        double relaxation_time = 200.0;
+        // Specify stripe simulation time (the pre-stripe mechanical relaxation is done by FireRelaxationSolver)
         double stripe_simulation_time = 500.0;
 
         // Specify tissue geometry
@@ -117,7 +118,7 @@ public:
         // Create a simulation using the cell population
         OffLatticeSimulation<2> simulation(cell_population);
         simulation.SetOutputDirectory("Scenario2");
-        simulation.SetEndTime(relaxation_time);
+        simulation.SetEndTime(stripe_simulation_time);
 
         simulation.SetDt(time_step);
         unsigned output_time_step_multiple = (unsigned) (output_time_step/time_step);
@@ -136,6 +137,11 @@ public:
 
         simulation.AddForce(p_force);
 
+        // Let the force read stripe identities from a dense array; it is rebuilt when each Solve() starts
+        MAKE_PTR(StripeIdentityModifier<2>, p_stripe_modifier);
+        simulation.AddSimulationModifier(p_stripe_modifier);
+        p_force->SetStripeIdentityModifier(p_stripe_modifier);
+
         if (include_random_jiggling)
         {
             MAKE_PTR(RandomForce<2>, p_random_force);
@@ -147,8 +153,11 @@ public:
         MAKE_PTR(ConstantTargetAreaModifier<2>, p_growth_modifier);
         simulation.AddSimulationModifier(p_growth_modifier);
 
-        // Run simulation
-        simulation.Solve();
+        // Relax the honeycomb mechanically before bestowing stripe identities
+        p_growth_modifier->UpdateTargetAreas(cell_population);
+        FireRelaxationSolver<2> relaxation_solver(cell_population);
+        relaxation_solver.AddForce(p_force);
+        TS_ASSERT(relaxation_solver.Relax());
 
         // Bestow cell stripe identities
         for (unsigned i=0; i<simulation.rGetCellPopulation().GetNumRealCells(); i++)
@@ -190,7 +199,7 @@ public:
         p_force->SetUseCombinedInterfacesForLineTension(use_combined_interfaces_for_line_tension);
         p_force->SetUseDistinctStripeMismatchesForCombinedInterfaces(use_distinct_stripe_mismatches_for_combined_interfaces);
 
-        simulation.SetEndTime(stripe_simulation_time + relaxation_time);
+        // Run simulation
         simulation.Solve();
     }
 };
@@ -14,6 +14,7 @@
 #include "VertexBasedCellPopulation.hpp"
 #include "SidekickForce.hpp"
 #include "ConstantTargetAreaModifier.hpp"
+#include "FireRelaxationSolver.hpp"
 #include "OffLatticeSimulation.hpp"
 #include "SmartPointers.hpp"
 #include "FakePetscSetup.hpp"
@@ -266,6 +267,7 @@ public:
         MAKE_PTR(ExtrinsicPullModifier<2>, p_modifier);
         p_modifier->ApplyExtrinsicPullToAllNodes(true);
         p_modifier->SetSpeed(0.1);
+        p_modifier->SetGeometryCache(p_bc->GetGeometryCache());
         p_simulator->AddSimulationModifier(p_modifier);
 
         p_simulator->Solve();
@@ -313,7 +315,7 @@ public:
         // Create a simulation using the cell population
         OffLatticeSimulation<2> simulation(cell_population);
         simulation.SetOutputDirectory("TestAllInOnego");
-        simulation.SetEndTime(M_RELAXATION_TIME);
+        simulation.SetEndTime(M_EXTENSION_TIME);
 
         simulation.SetDt(M_DT);
         unsigned output_time_step_multiple = (unsigned) (0.1*M_RELAXATION_TIME/M_DT);
@@ -336,10 +338,11 @@ public:
         MAKE_PTR(ConstantTargetAreaModifier<2>, p_growth_modifier);
         simulation.AddSimulationModifier(p_growth_modifier);
 
-        // Run simulation
-        simulation.Solve();
-
-        simulation.SetEndTime(M_RELAXATION_TIME + M_EXTENSION_TIME);
+        // Relax the honeycomb mechanically before bestowing stripe identities
+        p_growth_modifier->UpdateTargetAreas(cell_population);
+        FireRelaxationSolver<2> relaxation_solver(cell_population);
+        relaxation_solver.AddForce(p_force);
+        TS_ASSERT(relaxation_solver.Relax());
 
         // Bestow cell stripe identities
         for (unsigned i=0; i<simulation.rGetCellPopulation().GetNumRealCells(); i++)
@@ -389,6 +392,7 @@ public:
         MAKE_PTR(ExtrinsicPullModifier<2>, p_modifier);
         p_modifier->ApplyExtrinsicPullToAllNodes(true);
         p_modifier->SetSpeed(0.1);
+        p_modifier->SetGeometryCache(p_bc->GetGeometryCache());
         simulation.AddSimulationModifier(p_modifier);
 
         simulation.Solve();
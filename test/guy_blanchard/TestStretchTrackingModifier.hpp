@@ -0,0 +1,122 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTSTRETCHTRACKINGMODIFIER_HPP_
+#define TESTSTRETCHTRACKINGMODIFIER_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+#include "HoneycombVertexMeshGenerator.hpp"
+#include "CellsGenerator.hpp"
+#include "NoCellCycleModel.hpp"
+#include "VertexBasedCellPopulation.hpp"
+#include "StretchTrackingModifier.hpp"
+#include "RandomNumberGenerator.hpp"
+#include "FakePetscSetup.hpp"
+
+class TestStretchTrackingModifier : public AbstractCellBasedTestSuite
+{
+public:
+
+    void TestCalculateDiameter() throw (Exception)
+    {
+        // Compare with every pairwise distance for random sets of points, including repeated and collinear points
+        for (unsigned trial=0; trial<1000; trial++)
+        {
+            unsigned num_points = 1 + RandomNumberGenerator::Instance()->randMod(10);
+            std::vector<c_vector<double, 2> > points(num_points);
+            for (unsigned i=0; i<num_points; i++)
+            {
+                points[i][0] = 0.5*RandomNumberGenerator::Instance()->randMod(5);
+                points[i][1] = (trial%3 == 0) ? 1.0 : 0.5*RandomNumberGenerator::Instance()->randMod(5);
+            }
+
+            double expected_diameter = 0.0;
+            for (unsigned i=0; i<num_points; i++)
+            {
+                for (unsigned j=i+1; j<num_points; j++)
+                {
+                    expected_diameter = std::max(expected_diameter, norm_2(points[j] - points[i]));
+                }
+            }
+
+            TS_ASSERT_DELTA(StretchTrackingModifier<2>::CalculateDiameter(points), expected_diameter, 1e-12);
+        }
+    }
+
+    void TestUpdateInterval() throw (Exception)
+    {
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 10);
+
+        HoneycombVertexMeshGenerator generator(3, 3);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+
+        StretchTrackingModifier<2> modifier;
+        TS_ASSERT_THROWS_THIS(modifier.SetUpdateInterval(0), "The update interval of a StretchTrackingModifier must be positive");
+        modifier.SetUpdateInterval(2);
+        TS_ASSERT_EQUALS(modifier.GetUpdateInterval(), 2u);
+
+        // Each cell is a regular hexagon with sides of length 1/sqrt(3)
+        modifier.SetupSolve(cell_population, "TestStretchTrackingModifier");
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            TS_ASSERT_DELTA(cell_iter->GetCellData()->GetItem("stretch"), 2.0/sqrt(3.0), 1e-6);
+        }
+
+        // Stretch the mesh; the cell data are only updated on every second time step
+        for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+        {
+            cell_population.GetNode(i)->rGetModifiableLocation()[0] *= 2.0;
+        }
+
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        modifier.UpdateAtEndOfTimeStep(cell_population);
+        TS_ASSERT_DELTA(cell_population.Begin()->GetCellData()->GetItem("stretch"), 2.0/sqrt(3.0), 1e-6);
+
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        modifier.UpdateAtEndOfTimeStep(cell_population);
+        TS_ASSERT_DELTA(cell_population.Begin()->GetCellData()->GetItem("stretch"), sqrt(4.0 + 1.0/3.0), 1e-6);
+    }
+};
+
+#endif /*TESTSTRETCHTRACKINGMODIFIER_HPP_*/
@@ -0,0 +1,779 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTSTRIPELINETENSIONFORCE_HPP_
+#define TESTSTRIPELINETENSIONFORCE_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+#include "HoneycombVertexMeshGenerator.hpp"
+#include "CellsGenerator.hpp"
+#include "NoCellCycleModel.hpp"
+#include "VertexBasedCellPopulation.hpp"
+#include "FarhadifarForce.hpp"
+#include "BlanchardForce.hpp"
+#include "ForceForScenario2.hpp"
+#include "LenneForce.hpp"
+#include "ConstantTargetAreaModifier.hpp"
+#include "StripeIdentityModifier.hpp"
+#include "StripeInterfaceTable.hpp"
+#include "RandomNumberGenerator.hpp"
+#include "SmartPointers.hpp"
+#include "Timer.hpp"
+#include "FakePetscSetup.hpp"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/**
+ * Reference implementation of the stripe line tension of ForceForScenario2 as it was before
+ * StripeInterfaceTable was introduced: the line tension of each edge is worked out from scratch
+ * on every call, with combined interfaces found by walking around each element from the edge.
+ * FarhadifarForce calls GetLineTensionParameter() for every edge visit during assembly.
+ */
+class PerEdgeStripeLineTensionForce : public FarhadifarForce<2>
+{
+public:
+
+    /** Line tension parameter for edges within a stripe. */
+    double mHomotypicLineTensionParameter;
+
+    /** Line tension parameter for edges between stripes whose identities differ by one. */
+    double mHeterotypicLineTensionParameter;
+
+    /** Line tension parameter for edges between stripes whose identities differ by two. */
+    double mSupercontractileLineTensionParameter;
+
+    /** Whether the line tension of an edge between stripes is scaled by its combined interfaces. */
+    bool mUseCombinedInterfacesForLineTension;
+
+    PerEdgeStripeLineTensionForce()
+        : FarhadifarForce<2>(),
+          mHomotypicLineTensionParameter(1.0),
+          mHeterotypicLineTensionParameter(1.0),
+          mSupercontractileLineTensionParameter(1.0),
+          mUseCombinedInterfacesForLineTension(false)
+    {
+    }
+
+    /**
+     * Walk around the element from the given node in each direction for as long as consecutive
+     * edges qualify, and return the total length walked. Unlike the original, the walk stops once
+     * it has gone right round the perimeter.
+     */
+    static double GetCombinedInterfaceLengthByWalk(Node<2>* pNode,
+                                                   unsigned elemIndex,
+                                                   unsigned cell1StripeIdentity,
+                                                   unsigned cell2StripeIdentity,
+                                                   bool useDistinctStripeMismatches,
+                                                   VertexBasedCellPopulation<2>& rCellPopulation)
+    {
+        VertexElement<2,2>* p_elem = rCellPopulation.GetElement(elemIndex);
+        unsigned num_nodes = p_elem->GetNumNodes();
+        unsigned start_local_index = p_elem->GetNodeLocalIndex(pNode->GetIndex());
+
+        double combined_interface_length = 0.0;
+        unsigned num_edges_walked = 0;
+        for (unsigned direction=0; direction<2; direction++)
+        {
+            unsigned this_local_index = start_local_index;
+            bool part_of_combined_interface = true;
+            while (part_of_combined_interface && (num_edges_walked < num_nodes))
+            {
+                unsigned next_local_index = (direction == 0) ? (this_local_index + num_nodes - 1)%num_nodes : (this_local_index + 1)%num_nodes;
+                Node<2>* p_this_node = p_elem->GetNode(this_local_index);
+                Node<2>* p_next_node = p_elem->GetNode(next_local_index);
+
+                std::set<unsigned> shared_elems;
+                std::set_intersection(p_this_node->rGetContainingElementIndices().begin(), p_this_node->rGetContainingElementIndices().end(),
+                                      p_next_node->rGetContainingElementIndices().begin(), p_next_node->rGetContainingElementIndices().end(),
+                                      std::inserter(shared_elems, shared_elems.begin()));
+
+                part_of_combined_interface = false;
+                if (shared_elems.size() == 2)
+                {
+                    unsigned stripe_1 = rCellPopulation.GetCellUsingLocationIndex(*(shared_elems.begin()))->GetCellData()->GetItem("stripe");
+                    unsigned stripe_2 = rCellPopulation.GetCellUsingLocationIndex(*(++(shared_elems.begin())))->GetCellData()->GetItem("stripe");
+                    if (useDistinctStripeMismatches)
+                    {
+                        part_of_combined_interface = ((stripe_1 == cell1StripeIdentity) && (stripe_2 == cell2StripeIdentity))
+                                                  || ((stripe_1 == cell2StripeIdentity) && (stripe_2 == cell1StripeIdentity));
+                    }
+                    else
+                    {
+                        part_of_combined_interface = (stripe_1 != stripe_2);
+                    }
+                }
+
+                if (part_of_combined_interface)
+                {
+                    combined_interface_length += rCellPopulation.rGetMesh().GetDistanceBetweenNodes(p_this_node->GetIndex(), p_next_node->GetIndex());
+                    num_edges_walked++;
+                }
+                this_local_index = next_local_index;
+            }
+        }
+        return combined_interface_length;
+    }
+
+    double GetLineTensionParameter(Node<2>* pNodeA, Node<2>* pNodeB, VertexBasedCellPopulation<2>& rVertexCellPopulation)
+    {
+        if (pNodeA->IsBoundaryNode() || pNodeB->IsBoundaryNode())
+        {
+            return GetBoundaryLineTensionParameter();
+        }
+
+        std::set<unsigned> shared_elements;
+        std::set_intersection(pNodeA->rGetContainingElementIndices().begin(), pNodeA->rGetContainingElementIndices().end(),
+                              pNodeB->rGetContainingElementIndices().begin(), pNodeB->rGetContainingElementIndices().end(),
+                              std::inserter(shared_elements, shared_elements.begin()));
+        if (shared_elements.size() == 1)
+        {
+            return GetBoundaryLineTensionParameter();
+        }
+
+        unsigned elem_1_index = *(shared_elements.begin());
+        unsigned elem_2_index = *(++(shared_elements.begin()));
+        unsigned stripe_1 = rVertexCellPopulation.GetCellUsingLocationIndex(elem_1_index)->GetCellData()->GetItem("stripe");
+        unsigned stripe_2 = rVertexCellPopulation.GetCellUsingLocationIndex(elem_2_index)->GetCellData()->GetItem("stripe");
+        if (stripe_1 == stripe_2)
+        {
+            return 0.5*mHomotypicLineTensionParameter;
+        }
+
+        // Label numbers wrap around over four stripes
+        unsigned mismatch = abs((int)stripe_1 - (int)stripe_2);
+        if (mismatch > 2)
+        {
+            mismatch = 4 - mismatch;
+        }
+        double line_tension = (mismatch == 1) ? 0.5*mHeterotypicLineTensionParameter : 0.5*mSupercontractileLineTensionParameter;
+        line_tension /= rVertexCellPopulation.rGetMesh().GetDistanceBetweenNodes(pNodeA->GetIndex(), pNodeB->GetIndex());
+
+        if (mUseCombinedInterfacesForLineTension)
+        {
+            double length_1 = GetCombinedInterfaceLengthByWalk(pNodeA, elem_1_index, stripe_1, stripe_2, false, rVertexCellPopulation);
+            double length_2 = GetCombinedInterfaceLengthByWalk(pNodeA, elem_2_index, stripe_1, stripe_2, false, rVertexCellPopulation);
+            line_tension /= std::min(length_1, length_2);
+        }
+        return line_tension;
+    }
+};
+
+class TestStripeLineTensionForce : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * Give each cell a stripe identity from 1 to 4 by column, perturb the interior nodes
+     * so that the forces are not trivially zero, and set the target areas.
+     */
+    void SetUpStripedPopulation(VertexBasedCellPopulation<2>& rCellPopulation, unsigned numCellsWide)
+    {
+        for (unsigned i=0; i<rCellPopulation.GetNumElements(); i++)
+        {
+            rCellPopulation.GetCellUsingLocationIndex(i)->GetCellData()->SetItem("stripe", 1 + (i%numCellsWide)%4);
+        }
+
+        for (unsigned i=0; i<rCellPopulation.GetNumNodes(); i++)
+        {
+            Node<2>* p_node = rCellPopulation.GetNode(i);
+            if (!p_node->IsBoundaryNode())
+            {
+                p_node->rGetModifiableLocation()[0] += 0.05*(RandomNumberGenerator::Instance()->ranf() - 0.5);
+                p_node->rGetModifiableLocation()[1] += 0.05*(RandomNumberGenerator::Instance()->ranf() - 0.5);
+            }
+        }
+
+        MAKE_PTR(ConstantTargetAreaModifier<2>, p_growth_modifier);
+        p_growth_modifier->UpdateTargetAreas(rCellPopulation);
+    }
+
+    /**
+     * Clear the applied forces on every node of a cell population.
+     */
+    void ClearForces(VertexBasedCellPopulation<2>& rCellPopulation)
+    {
+        for (unsigned i=0; i<rCellPopulation.GetNumNodes(); i++)
+        {
+            rCellPopulation.GetNode(i)->ClearAppliedForce();
+        }
+    }
+
+public:
+
+    void TestForceAgreesWithFarhadifarForce() throw (Exception)
+    {
+        HoneycombVertexMeshGenerator generator(6, 6);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+        SetUpStripedPopulation(cell_population, 6);
+
+        /*
+         * With equal line tension parameters for every stripe mismatch, and a boundary line
+         * tension of half the internal one, the stripe force reduces to the FarhadifarForce.
+         */
+        FarhadifarForce<2> farhadifar_force;
+        farhadifar_force.SetLineTensionParameter(0.12);
+        farhadifar_force.SetBoundaryLineTensionParameter(0.06);
+
+        BlanchardForce<2> stripe_force;
+        stripe_force.SetHomotypicLineTensionParameter(0.12);
+        stripe_force.SetHeterotypicLineTensionParameter(0.12);
+        stripe_force.SetSupercontractileLineTensionParameter(0.12);
+        stripe_force.SetBoundaryLineTensionParameter(0.06);
+
+        farhadifar_force.AddForceContribution(cell_population);
+        std::vector<c_vector<double, 2> > farhadifar_forces;
+        for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+        {
+            farhadifar_forces.push_back(cell_population.GetNode(i)->rGetAppliedForce());
+        }
+
+        ClearForces(cell_population);
+        stripe_force.AddForceContribution(cell_population);
+        for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+        {
+            TS_ASSERT_DELTA(cell_population.GetNode(i)->rGetAppliedForce()[0], farhadifar_forces[i][0], 1e-12);
+            TS_ASSERT_DELTA(cell_population.GetNode(i)->rGetAppliedForce()[1], farhadifar_forces[i][1], 1e-12);
+        }
+    }
+
+    void TestAssemblyAgreesWithPerEdgeLineTensionFormula() throw (Exception)
+    {
+        HoneycombVertexMeshGenerator generator(8, 6);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+        SetUpStripedPopulation(cell_population, 8);
+
+        // GetLineTensionParameter() only reuses the assembly's table within a simulation time step
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 1);
+
+        ForceForScenario2<2> force;
+        force.SetHomotypicLineTensionParameter(0.05);
+        force.SetHeterotypicLineTensionParameter(0.1);
+        force.SetSupercontractileLineTensionParameter(0.2);
+        force.SetBoundaryLineTensionParameter(0.0025);
+
+        PerEdgeStripeLineTensionForce reference_force;
+        reference_force.mHomotypicLineTensionParameter = 0.05;
+        reference_force.mHeterotypicLineTensionParameter = 0.1;
+        reference_force.mSupercontractileLineTensionParameter = 0.2;
+        reference_force.SetBoundaryLineTensionParameter(0.0025);
+
+        for (unsigned use_combined_interfaces=0; use_combined_interfaces<2; use_combined_interfaces++)
+        {
+            force.SetUseCombinedInterfacesForLineTension(use_combined_interfaces == 1);
+            reference_force.mUseCombinedInterfacesForLineTension = (use_combined_interfaces == 1);
+
+            ClearForces(cell_population);
+            reference_force.AddForceContribution(cell_population);
+            std::vector<c_vector<double, 2> > reference_forces;
+            for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+            {
+                reference_forces.push_back(cell_population.GetNode(i)->rGetAppliedForce());
+            }
+
+            // Combined interface lengths are summed in a different order, so allow for rounding
+            ClearForces(cell_population);
+            force.AddForceContribution(cell_population);
+            for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+            {
+                TS_ASSERT_DELTA(cell_population.GetNode(i)->rGetAppliedForce()[0], reference_forces[i][0], 1e-10);
+                TS_ASSERT_DELTA(cell_population.GetNode(i)->rGetAppliedForce()[1], reference_forces[i][1], 1e-10);
+            }
+
+            // The line tension of each edge, read back from the table built by the assembly, should match too
+            for (unsigned elem_index=0; elem_index<p_mesh->GetNumElements(); elem_index++)
+            {
+                VertexElement<2,2>* p_element = p_mesh->GetElement(elem_index);
+                for (unsigned local_index=0; local_index<p_element->GetNumNodes(); local_index++)
+                {
+                    Node<2>* p_node_a = p_element->GetNode(local_index);
+                    Node<2>* p_node_b = p_element->GetNode((local_index + 1)%p_element->GetNumNodes());
+                    TS_ASSERT_DELTA(force.GetLineTensionParameter(p_node_a, p_node_b, cell_population),
+                                    reference_force.GetLineTensionParameter(p_node_a, p_node_b, cell_population), 1e-10);
+                }
+            }
+        }
+
+        // A change of parameter should be reflected without another assembly
+        force.SetHeterotypicLineTensionParameter(0.3);
+        reference_force.mHeterotypicLineTensionParameter = 0.3;
+        VertexElement<2,2>* p_element = p_mesh->GetElement(19);
+        for (unsigned local_index=0; local_index<p_element->GetNumNodes(); local_index++)
+        {
+            Node<2>* p_node_a = p_element->GetNode(local_index);
+            Node<2>* p_node_b = p_element->GetNode((local_index + 1)%p_element->GetNumNodes());
+            TS_ASSERT_DELTA(force.GetLineTensionParameter(p_node_a, p_node_b, cell_population),
+                            reference_force.GetLineTensionParameter(p_node_a, p_node_b, cell_population), 1e-10);
+        }
+    }
+
+    void TestEdgeBasedAssemblyAgreesWithNodeBasedAssembly() throw (Exception)
+    {
+        HoneycombVertexMeshGenerator generator(8, 6);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+        SetUpStripedPopulation(cell_population, 8);
+
+        ForceForScenario2<2> force;
+        force.SetHomotypicLineTensionParameter(0.05);
+        force.SetHeterotypicLineTensionParameter(0.1);
+        force.SetSupercontractileLineTensionParameter(0.2);
+        force.SetBoundaryLineTensionParameter(0.0025);
+
+        for (unsigned use_combined_interfaces=0; use_combined_interfaces<2; use_combined_interfaces++)
+        {
+            force.SetUseCombinedInterfacesForLineTension(use_combined_interfaces == 1);
+
+            ClearForces(cell_population);
+            force.SetUseEdgeBasedAssembly(false);
+            force.AddForceContribution(cell_population);
+            std::vector<c_vector<double, 2> > node_based_forces;
+            for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+            {
+                node_based_forces.push_back(cell_population.GetNode(i)->rGetAppliedForce());
+            }
+
+            ClearForces(cell_population);
+            force.SetUseEdgeBasedAssembly(true);
+            force.AddForceContribution(cell_population);
+            for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+            {
+                TS_ASSERT_DELTA(cell_population.GetNode(i)->rGetAppliedForce()[0], node_based_forces[i][0], 1e-12);
+                TS_ASSERT_DELTA(cell_population.GetNode(i)->rGetAppliedForce()[1], node_based_forces[i][1], 1e-12);
+            }
+        }
+    }
+
+    void TestCombinedInterfacesAgreeWithPerimeterWalkAfterT1Swaps() throw (Exception)
+    {
+        HoneycombVertexMeshGenerator generator(8, 6);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+        SetUpStripedPopulation(cell_population, 8);
+
+        /*
+         * Shrink a few well separated interior edges below the rearrangement threshold and
+         * remesh, so that the element perimeters no longer have the honeycomb ordering.
+         */
+        p_mesh->SetCellRearrangementThreshold(0.1);
+        std::set<unsigned> used_node_indices;
+        unsigned num_swaps = 0;
+        for (unsigned elem_index=0; (elem_index<p_mesh->GetNumElements()) && (num_swaps<4); elem_index++)
+        {
+            VertexElement<2,2>* p_element = p_mesh->GetElement(elem_index);
+            Node<2>* p_node_a = p_element->GetNode(0);
+            Node<2>* p_node_b = p_element->GetNode(1);
+            if (p_node_a->IsBoundaryNode() || p_node_b->IsBoundaryNode()
+                || used_node_indices.count(p_node_a->GetIndex()) || used_node_indices.count(p_node_b->GetIndex()))
+            {
+                continue;
+            }
+
+            // Mark every node of the elements around the edge, so that swaps do not interact
+            std::set<unsigned> containing_elements = p_node_a->rGetContainingElementIndices();
+            containing_elements.insert(p_node_b->rGetContainingElementIndices().begin(), p_node_b->rGetContainingElementIndices().end());
+            for (std::set<unsigned>::iterator iter = containing_elements.begin(); iter != containing_elements.end(); ++iter)
+            {
+                VertexElement<2,2>* p_neighbour = p_mesh->GetElement(*iter);
+                for (unsigned local_index=0; local_index<p_neighbour->GetNumNodes(); local_index++)
+                {
+                    used_node_indices.insert(p_neighbour->GetNodeGlobalIndex(local_index));
+                }
+            }
+
+            c_vector<double, 2> midpoint = 0.5*(p_node_a->rGetLocation() + p_node_b->rGetLocation());
+            c_vector<double, 2> direction = p_node_b->rGetLocation() - p_node_a->rGetLocation();
+            direction /= norm_2(direction);
+            p_node_a->rGetModifiableLocation() = midpoint - 0.025*direction;
+            p_node_b->rGetModifiableLocation() = midpoint + 0.025*direction;
+            num_swaps++;
+        }
+        TS_ASSERT_EQUALS(num_swaps, 4u);
+
+        p_mesh->ReMesh();
+        TS_ASSERT_EQUALS(p_mesh->rGetLocationsOfT1Swaps().size(), num_swaps);
+
+        for (unsigned use_distinct=0; use_distinct<2; use_distinct++)
+        {
+            StripeInterfaceTable<2> table;
+            table.Build(cell_population, 4, true, (use_distinct == 1));
+
+            unsigned num_interface_edges = 0;
+            const VertexMeshEdgeTable<2>& r_edge_table = table.rGetEdgeTable();
+            for (unsigned edge_index=0; edge_index<table.GetNumEdges(); edge_index++)
+            {
+                unsigned mismatch = table.GetMismatchClass(edge_index);
+                if ((mismatch == 0) || (mismatch == UNSIGNED_UNSET))
+                {
+                    continue;
+                }
+                num_interface_edges++;
+
+                Node<2>* p_node_a = p_mesh->GetNode(r_edge_table.GetEdgeNodeIndex(edge_index, 0));
+                unsigned elem_1_index = r_edge_table.GetEdgeElementIndex(edge_index, 0);
+                unsigned elem_2_index = r_edge_table.GetEdgeElementIndex(edge_index, 1);
+                unsigned stripe_1 = cell_population.GetCellUsingLocationIndex(elem_1_index)->GetCellData()->GetItem("stripe");
+                unsigned stripe_2 = cell_population.GetCellUsingLocationIndex(elem_2_index)->GetCellData()->GetItem("stripe");
+
+                double length_1 = PerEdgeStripeLineTensionForce::GetCombinedInterfaceLengthByWalk(p_node_a, elem_1_index, stripe_1, stripe_2, (use_distinct == 1), cell_population);
+                double length_2 = PerEdgeStripeLineTensionForce::GetCombinedInterfaceLengthByWalk(p_node_a, elem_2_index, stripe_1, stripe_2, (use_distinct == 1), cell_population);
+                TS_ASSERT_DELTA(table.GetCombinedInterfaceScaleFactor(edge_index), 1.0/std::min(length_1, length_2), 1e-12);
+            }
+            TS_ASSERT_LESS_THAN(0u, num_interface_edges);
+        }
+    }
+
+    void TestForceIsMinusGradientOfTotalEnergy() throw (Exception)
+    {
+        HoneycombVertexMeshGenerator generator(6, 6);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+        SetUpStripedPopulation(cell_population, 6);
+
+        BlanchardForce<2> force;
+        force.SetHomotypicLineTensionParameter(0.05);
+        force.SetHeterotypicLineTensionParameter(0.1);
+        force.SetSupercontractileLineTensionParameter(0.2);
+        force.SetBoundaryLineTensionParameter(0.0025);
+
+        force.AddForceContribution(cell_population);
+
+        // Compare each force component with a central difference of the total energy
+        double step = 1e-6;
+        for (unsigned node_index=0; node_index<cell_population.GetNumNodes(); node_index++)
+        {
+            Node<2>* p_node = cell_population.GetNode(node_index);
+            for (unsigned dim=0; dim<2; dim++)
+            {
+                p_node->rGetModifiableLocation()[dim] += step;
+                double energy_plus = force.ComputeTotalEnergy(cell_population);
+                p_node->rGetModifiableLocation()[dim] -= 2*step;
+                double energy_minus = force.ComputeTotalEnergy(cell_population);
+                p_node->rGetModifiableLocation()[dim] += step;
+
+                TS_ASSERT_DELTA(p_node->rGetAppliedForce()[dim], -(energy_plus - energy_minus)/(2*step), 1e-6);
+            }
+        }
+    }
+
+    void TestTotalEnergyReusesSnapshotWithinTimeStep() throw (Exception)
+    {
+        HoneycombVertexMeshGenerator generator(6, 6);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+        SetUpStripedPopulation(cell_population, 6);
+
+        // The snapshot and slot line tensions are only reused within a time step
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 1);
+
+        BlanchardForce<2> force;
+        force.SetHomotypicLineTensionParameter(0.05);
+        force.SetHeterotypicLineTensionParameter(0.1);
+        force.SetSupercontractileLineTensionParameter(0.2);
+        force.SetBoundaryLineTensionParameter(0.0025);
+        force.AddForceContribution(cell_population);
+
+        BlanchardForce<2> fresh_force;
+        fresh_force.SetHomotypicLineTensionParameter(0.05);
+        fresh_force.SetHeterotypicLineTensionParameter(0.1);
+        fresh_force.SetSupercontractileLineTensionParameter(0.2);
+        fresh_force.SetBoundaryLineTensionParameter(0.0025);
+
+        // Reusing the assembly's snapshot gives the same energy as building it afresh
+        double energy = force.ComputeTotalEnergy(cell_population);
+        TS_ASSERT_DELTA(energy, fresh_force.ComputeTotalEnergy(cell_population), 1e-12);
+        TS_ASSERT_DELTA(force.ComputeTotalEnergy(cell_population), energy, 1e-12);
+
+        // Changing a stripe line tension parameter is seen without moving any node
+        force.SetHomotypicLineTensionParameter(0.5);
+        fresh_force.SetHomotypicLineTensionParameter(0.5);
+        double new_energy = force.ComputeTotalEnergy(cell_population);
+        TS_ASSERT_DELTA(new_energy, fresh_force.ComputeTotalEnergy(cell_population), 1e-12);
+        TS_ASSERT_LESS_THAN(energy + 1e-6, new_energy);
+
+        // Moving a node is seen too
+        cell_population.GetNode(10)->rGetModifiableLocation()[0] += 0.05;
+        TS_ASSERT_DELTA(force.ComputeTotalEnergy(cell_population), fresh_force.ComputeTotalEnergy(cell_population), 1e-12);
+    }
+
+    void TestStripeIdentityModifier() throw (Exception)
+    {
+        HoneycombVertexMeshGenerator generator(6, 6);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+        SetUpStripedPopulation(cell_population, 6);
+
+        // The dense array should match the cells' CellData
+        MAKE_PTR(StripeIdentityModifier<2>, p_modifier);
+        p_modifier->SetupSolve(cell_population, "TestStripeIdentityModifier");
+        const std::vector<uint16_t>& r_stripes = p_modifier->rGetStripeIdentities(cell_population);
+        TS_ASSERT_EQUALS(r_stripes.size(), 36u);
+        for (unsigned i=0; i<r_stripes.size(); i++)
+        {
+            TS_ASSERT_EQUALS(r_stripes[i], 1 + (i%6)%4);
+        }
+
+        // The force should be unchanged by reading stripe identities from the modifier
+        BlanchardForce<2> force;
+        force.SetHeterotypicLineTensionParameter(2.0);
+        force.SetSupercontractileLineTensionParameter(4.0);
+        force.AddForceContribution(cell_population);
+        std::vector<c_vector<double, 2> > cell_data_forces;
+        for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+        {
+            cell_data_forces.push_back(cell_population.GetNode(i)->rGetAppliedForce());
+        }
+
+        ClearForces(cell_population);
+        force.SetStripeIdentityModifier(p_modifier);
+        force.AddForceContribution(cell_population);
+        for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+        {
+            TS_ASSERT_DELTA(cell_population.GetNode(i)->rGetAppliedForce()[0], cell_data_forces[i][0], 1e-12);
+            TS_ASSERT_DELTA(cell_population.GetNode(i)->rGetAppliedForce()[1], cell_data_forces[i][1], 1e-12);
+        }
+
+        // Until the mesh is updated, the removed cell's element is only marked as deleted
+        cell_population.GetCellUsingLocationIndex(14)->Kill();
+        cell_population.RemoveDeadCells();
+        TS_ASSERT_EQUALS(cell_population.GetNumElements(), 35u);
+        const std::vector<uint16_t>& r_sparse_stripes = p_modifier->rGetStripeIdentities(cell_population);
+        TS_ASSERT_EQUALS(r_sparse_stripes.size(), 36u);
+        for (unsigned i=0; i<r_sparse_stripes.size(); i++)
+        {
+            if (i != 14)
+            {
+                double stripe = cell_population.GetCellUsingLocationIndex(i)->GetCellData()->GetItem("stripe");
+                TS_ASSERT_EQUALS(r_sparse_stripes[i], stripe);
+            }
+        }
+
+        // Updating the mesh re-indexes the elements, so the array should be rebuilt
+        cell_population.Update();
+        const std::vector<uint16_t>& r_new_stripes = p_modifier->rGetStripeIdentities(cell_population);
+        TS_ASSERT_EQUALS(r_new_stripes.size(), 35u);
+        for (unsigned i=0; i<r_new_stripes.size(); i++)
+        {
+            double stripe = cell_population.GetCellUsingLocationIndex(i)->GetCellData()->GetItem("stripe");
+            TS_ASSERT_EQUALS(r_new_stripes[i], stripe);
+        }
+
+        // In a simulation the population is only checked on the first read in each time step...
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 10);
+        TS_ASSERT_EQUALS(p_modifier->rGetStripeIdentities(cell_population).size(), 35u);
+        cell_population.GetCellUsingLocationIndex(3)->Kill();
+        cell_population.RemoveDeadCells();
+        cell_population.Update();
+        TS_ASSERT_EQUALS(p_modifier->rGetStripeIdentities(cell_population).size(), 35u);
+
+        // ...or after UpdateAtEndOfTimeStep(), as cells are only born and removed at the start of a time step
+        p_modifier->UpdateAtEndOfTimeStep(cell_population);
+        const std::vector<uint16_t>& r_stepped_stripes = p_modifier->rGetStripeIdentities(cell_population);
+        TS_ASSERT_EQUALS(r_stepped_stripes.size(), 34u);
+        for (unsigned i=0; i<r_stepped_stripes.size(); i++)
+        {
+            double stripe = cell_population.GetCellUsingLocationIndex(i)->GetCellData()->GetItem("stripe");
+            TS_ASSERT_EQUALS(r_stepped_stripes[i], stripe);
+        }
+    }
+
+    void TestPerformanceOnLargeHoneycomb() throw (Exception)
+    {
+        unsigned num_cells_wide = 100;
+        unsigned num_repetitions = 10;
+
+        HoneycombVertexMeshGenerator generator(num_cells_wide, 100);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+        SetUpStripedPopulation(cell_population, num_cells_wide);
+
+        // Time the FarhadifarForce, which makes a virtual GetLineTensionParameter() call for every edge visit
+        FarhadifarForce<2> farhadifar_force;
+        Timer::Reset();
+        for (unsigned i=0; i<num_repetitions; i++)
+        {
+            farhadifar_force.AddForceContribution(cell_population);
+        }
+        double farhadifar_time = Timer::GetElapsedTime();
+
+        // Time the stripe force
+        BlanchardForce<2> stripe_force;
+        stripe_force.SetHeterotypicLineTensionParameter(2.0);
+        stripe_force.SetSupercontractileLineTensionParameter(4.0);
+        Timer::Reset();
+        for (unsigned i=0; i<num_repetitions; i++)
+        {
+            stripe_force.AddForceContribution(cell_population);
+        }
+        double stripe_time = Timer::GetElapsedTime();
+
+        // Time the stripe force with edge-based assembly
+        stripe_force.SetUseEdgeBasedAssembly(true);
+        Timer::Reset();
+        for (unsigned i=0; i<num_repetitions; i++)
+        {
+            stripe_force.AddForceContribution(cell_population);
+        }
+        double edge_based_time = Timer::GetElapsedTime();
+
+        // Resolving each edge once per step should beat a virtual line tension lookup on every edge visit
+        TS_ASSERT_LESS_THAN(stripe_time, farhadifar_time);
+        TS_ASSERT_LESS_THAN(edge_based_time, farhadifar_time);
+    }
+
+    void TestThreadScalingOnLargeHoneycomb() throw (Exception)
+    {
+        unsigned num_cells_wide = 100;
+        unsigned num_repetitions = 10;
+
+        HoneycombVertexMeshGenerator generator(num_cells_wide, 100);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+        SetUpStripedPopulation(cell_population, num_cells_wide);
+
+        // Scale from one thread to the maximum available, in powers of two
+        unsigned max_num_threads = 1;
+#ifdef _OPENMP
+        max_num_threads = omp_get_max_threads();
+#endif
+        std::vector<unsigned> thread_counts;
+        for (unsigned num_threads=1; num_threads<max_num_threads; num_threads*=2)
+        {
+            thread_counts.push_back(num_threads);
+        }
+        thread_counts.push_back(max_num_threads);
+
+        BlanchardForce<2> stripe_force;
+        stripe_force.SetHeterotypicLineTensionParameter(2.0);
+        stripe_force.SetSupercontractileLineTensionParameter(4.0);
+
+        LenneForce<2> lenne_force;
+
+        std::vector<c_vector<double, 2> > serial_stripe_forces;
+        std::vector<c_vector<double, 2> > serial_lenne_forces;
+        double serial_time = 0.0;
+
+        for (unsigned run=0; run<thread_counts.size(); run++)
+        {
+            unsigned num_threads = thread_counts[run];
+            stripe_force.SetNumThreads(num_threads);
+            lenne_force.SetNumThreads(num_threads);
+
+            // The forces must not depend on the number of threads, to the last bit
+            ClearForces(cell_population);
+            lenne_force.AddForceContribution(cell_population);
+            for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+            {
+                c_vector<double, 2> force = cell_population.GetNode(i)->rGetAppliedForce();
+                if (run == 0)
+                {
+                    serial_lenne_forces.push_back(force);
+                }
+                TS_ASSERT_EQUALS(force[0], serial_lenne_forces[i][0]);
+                TS_ASSERT_EQUALS(force[1], serial_lenne_forces[i][1]);
+            }
+
+            ClearForces(cell_population);
+            stripe_force.AddForceContribution(cell_population);
+            for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+            {
+                c_vector<double, 2> force = cell_population.GetNode(i)->rGetAppliedForce();
+                if (run == 0)
+                {
+                    serial_stripe_forces.push_back(force);
+                }
+                TS_ASSERT_EQUALS(force[0], serial_stripe_forces[i][0]);
+                TS_ASSERT_EQUALS(force[1], serial_stripe_forces[i][1]);
+            }
+
+            Timer::Reset();
+            for (unsigned i=0; i<num_repetitions; i++)
+            {
+                stripe_force.AddForceContribution(cell_population);
+            }
+            double time = Timer::GetElapsedTime();
+            if (run == 0)
+            {
+                serial_time = time;
+            }
+
+            // Adding threads should never make the assembly much slower than in serial
+            TS_ASSERT_LESS_THAN(time, 1.5*serial_time);
+        }
+    }
+};
+
+#endif /*TESTSTRIPELINETENSIONFORCE_HPP_*/
@@ -0,0 +1,162 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTVERTEXGEOMETRYSNAPSHOT_HPP_
+#define TESTVERTEXGEOMETRYSNAPSHOT_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include "AbstractCellBasedTestSuite.hpp"
+#include "HoneycombVertexMeshGenerator.hpp"
+#include "CylindricalHoneycombVertexMeshGenerator.hpp"
+#include "VertexGeometrySnapshot.hpp"
+#include "RandomNumberGenerator.hpp"
+#include "FakePetscSetup.hpp"
+
+class TestVertexGeometrySnapshot : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * Check the snapshot of a mesh against the geometric methods of the mesh itself.
+     */
+    void CheckSnapshotAgreesWithMesh(MutableVertexMesh<2,2>& rMesh)
+    {
+        VertexGeometrySnapshot<2> snapshot;
+        snapshot.Build(rMesh);
+
+        unsigned num_slots = 0;
+        for (unsigned elem_index=0; elem_index<rMesh.GetNumElements(); elem_index++)
+        {
+            VertexElement<2,2>* p_element = rMesh.GetElement(elem_index);
+            unsigned num_nodes_elem = p_element->GetNumNodes();
+            TS_ASSERT_EQUALS(snapshot.GetNumElementSlots(elem_index), num_nodes_elem);
+            num_slots += num_nodes_elem;
+
+            TS_ASSERT_DELTA(snapshot.GetElementArea(elem_index), rMesh.GetVolumeOfElement(elem_index), 1e-12);
+            TS_ASSERT_DELTA(snapshot.GetElementPerimeter(elem_index), rMesh.GetSurfaceAreaOfElement(elem_index), 1e-12);
+
+            for (unsigned local_index=0; local_index<num_nodes_elem; local_index++)
+            {
+                unsigned slot = snapshot.GetElementSlotOffset(elem_index) + local_index;
+                TS_ASSERT_EQUALS(snapshot.GetSlotNode(slot), p_element->GetNodeGlobalIndex(local_index));
+                TS_ASSERT_EQUALS(snapshot.GetSlotElement(slot), elem_index);
+                TS_ASSERT_EQUALS(snapshot.GetSlotNode(snapshot.GetNextSlot(slot)), p_element->GetNodeGlobalIndex((local_index + 1)%num_nodes_elem));
+                TS_ASSERT_EQUALS(snapshot.GetSlotNode(snapshot.GetPreviousSlot(slot)), p_element->GetNodeGlobalIndex((local_index + num_nodes_elem - 1)%num_nodes_elem));
+
+                c_vector<double, 2> area_gradient = rMesh.GetAreaGradientOfElementAtNode(p_element, local_index);
+                TS_ASSERT_DELTA(snapshot.GetAreaGradientX(slot), area_gradient[0], 1e-12);
+                TS_ASSERT_DELTA(snapshot.GetAreaGradientY(slot), area_gradient[1], 1e-12);
+
+                c_vector<double, 2> next_edge_gradient = rMesh.GetNextEdgeGradientOfElementAtNode(p_element, local_index);
+                TS_ASSERT_DELTA(snapshot.GetEdgeUnitX(slot), -next_edge_gradient[0], 1e-12);
+                TS_ASSERT_DELTA(snapshot.GetEdgeUnitY(slot), -next_edge_gradient[1], 1e-12);
+
+                unsigned next_node_index = p_element->GetNodeGlobalIndex((local_index + 1)%num_nodes_elem);
+                TS_ASSERT_DELTA(snapshot.GetEdgeLength(slot), rMesh.GetDistanceBetweenNodes(p_element->GetNodeGlobalIndex(local_index), next_node_index), 1e-12);
+            }
+        }
+        TS_ASSERT_EQUALS(snapshot.GetNumSlots(), num_slots);
+
+        // Each node occupies one slot in each of its containing elements, in increasing order of element index
+        for (unsigned node_index=0; node_index<rMesh.GetNumNodes(); node_index++)
+        {
+            const std::set<unsigned>& r_containing_elements = rMesh.GetNode(node_index)->rGetContainingElementIndices();
+            TS_ASSERT_EQUALS(snapshot.GetNumNodeSlots(node_index), r_containing_elements.size());
+
+            unsigned i = 0;
+            for (std::set<unsigned>::const_iterator iter = r_containing_elements.begin();
+                 iter != r_containing_elements.end();
+                 ++iter, ++i)
+            {
+                unsigned slot = snapshot.GetNodeSlot(node_index, i);
+                TS_ASSERT_EQUALS(snapshot.GetSlotElement(slot), *iter);
+                TS_ASSERT_EQUALS(snapshot.GetSlotNode(slot), node_index);
+            }
+        }
+    }
+
+public:
+
+    void TestSnapshotOfPerturbedHoneycomb() throw (Exception)
+    {
+        HoneycombVertexMeshGenerator generator(5, 4);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+        for (unsigned i=0; i<p_mesh->GetNumNodes(); i++)
+        {
+            p_mesh->GetNode(i)->rGetModifiableLocation()[0] += 0.1*(RandomNumberGenerator::Instance()->ranf() - 0.5);
+            p_mesh->GetNode(i)->rGetModifiableLocation()[1] += 0.1*(RandomNumberGenerator::Instance()->ranf() - 0.5);
+        }
+
+        CheckSnapshotAgreesWithMesh(*p_mesh);
+    }
+
+    void TestSnapshotOfCylindricalMesh() throw (Exception)
+    {
+        // Edges crossing the periodic boundary must be found by the mesh
+        CylindricalHoneycombVertexMeshGenerator generator(4, 4);
+        Cylindrical2dVertexMesh* p_mesh = generator.GetCylindricalMesh();
+
+        CheckSnapshotAgreesWithMesh(*p_mesh);
+    }
+
+    void TestIsCurrent() throw (Exception)
+    {
+        HoneycombVertexMeshGenerator generator(4, 4);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        VertexGeometrySnapshot<2> snapshot;
+        TS_ASSERT_EQUALS(snapshot.IsCurrent(*p_mesh), false);
+
+        snapshot.Build(*p_mesh);
+        TS_ASSERT_EQUALS(snapshot.IsCurrent(*p_mesh), true);
+
+        // Moving any node makes the snapshot stale
+        p_mesh->GetNode(7)->rGetModifiableLocation()[1] += 1e-9;
+        TS_ASSERT_EQUALS(snapshot.IsCurrent(*p_mesh), false);
+        snapshot.Build(*p_mesh);
+        TS_ASSERT_EQUALS(snapshot.IsCurrent(*p_mesh), true);
+
+        // So does removing a node from an element, or putting it back so the element's local indices are rotated
+        VertexElement<2,2>* p_element = p_mesh->GetElement(5);
+        unsigned num_nodes_elem = p_element->GetNumNodes();
+        Node<2>* p_first_node = p_element->GetNode(0);
+        p_element->DeleteNode(0);
+        TS_ASSERT_EQUALS(snapshot.IsCurrent(*p_mesh), false);
+        p_element->AddNode(p_first_node, num_nodes_elem - 2);
+        TS_ASSERT_EQUALS(snapshot.IsCurrent(*p_mesh), false);
+    }
+};
+
+#endif /*TESTVERTEXGEOMETRYSNAPSHOT_HPP_*/
@@ -0,0 +1,141 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef HEAPALLOCATIONCOUNTER_HPP_
+#define HEAPALLOCATIONCOUNTER_HPP_
+
+#include <cstdlib>
+#include <new>
+
+/**
+ * Replaces the global operator new and operator delete so that a test can measure the heap memory
+ * used by a block of code. Each allocation is prefixed with its size, so that the number of bytes
+ * currently allocated, and the peak since the last call to Reset(), are known exactly.
+ *
+ * The replacement applies to the whole test executable, so this header should only be included
+ * by one test suite. The counters are updated atomically, as OpenMP threads may also allocate.
+ */
+class HeapAllocationCounter
+{
+public:
+
+    /** The number of bytes currently allocated. */
+    static std::size_t msCurrentBytes;
+
+    /** The largest value of msCurrentBytes since the last call to Reset(). */
+    static std::size_t msPeakBytes;
+
+    /** The number of allocations since the last call to Reset(). */
+    static std::size_t msNumAllocations;
+
+    /**
+     * Start a new measurement from the memory currently allocated.
+     */
+    static void Reset()
+    {
+        msPeakBytes = msCurrentBytes;
+        msNumAllocations = 0;
+    }
+
+    /**
+     * @return the peak number of bytes allocated since the last call to Reset(), above those
+     * allocated at the time of that call
+     *
+     * @param baselineBytes the value of msCurrentBytes when Reset() was called
+     */
+    static std::size_t GetPeakBytesAbove(std::size_t baselineBytes)
+    {
+        return msPeakBytes - baselineBytes;
+    }
+};
+
+std::size_t HeapAllocationCounter::msCurrentBytes = 0;
+std::size_t HeapAllocationCounter::msPeakBytes = 0;
+std::size_t HeapAllocationCounter::msNumAllocations = 0;
+
+/** Exception specifications of the replaced operators, which must match the standard library's. */
+#if __cplusplus >= 201103L
+#define HEAP_ALLOCATION_THROWS_BAD_ALLOC
+#define HEAP_ALLOCATION_NO_THROW noexcept
+#else
+#define HEAP_ALLOCATION_THROWS_BAD_ALLOC throw (std::bad_alloc)
+#define HEAP_ALLOCATION_NO_THROW throw ()
+#endif
+
+/** The size of the prefix storing the size of each allocation, chosen to keep the maximum alignment. */
+static const std::size_t HEAP_ALLOCATION_PREFIX = 16;
+
+void* operator new(std::size_t size) HEAP_ALLOCATION_THROWS_BAD_ALLOC
+{
+    char* p_block = static_cast<char*>(std::malloc(size + HEAP_ALLOCATION_PREFIX));
+    if (p_block == NULL)
+    {
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<std::size_t*>(p_block) = size;
+
+    std::size_t current_bytes = __sync_add_and_fetch(&HeapAllocationCounter::msCurrentBytes, size);
+    __sync_add_and_fetch(&HeapAllocationCounter::msNumAllocations, 1);
+    std::size_t peak_bytes = HeapAllocationCounter::msPeakBytes;
+    while (current_bytes > peak_bytes)
+    {
+        std::size_t old_peak_bytes = __sync_val_compare_and_swap(&HeapAllocationCounter::msPeakBytes, peak_bytes, current_bytes);
+        if (old_peak_bytes == peak_bytes)
+        {
+            break;
+        }
+        peak_bytes = old_peak_bytes;
+    }
+    return p_block + HEAP_ALLOCATION_PREFIX;
+}
+
+void operator delete(void* pMemory) HEAP_ALLOCATION_NO_THROW
+{
+    if (pMemory != NULL)
+    {
+        char* p_block = static_cast<char*>(pMemory) - HEAP_ALLOCATION_PREFIX;
+        __sync_sub_and_fetch(&HeapAllocationCounter::msCurrentBytes, *reinterpret_cast<std::size_t*>(p_block));
+        std::free(p_block);
+    }
+}
+
+#if __cpp_sized_deallocation >= 201309L
+void operator delete(void* pMemory, std::size_t /*size*/) noexcept
+{
+    operator delete(pMemory);
+}
+#endif
+
+#endif /*HEAPALLOCATIONCOUNTER_HPP_*/
@@ -0,0 +1,152 @@
+/*
+
+Copyright (c) 2005-2016, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTAPICALEDGESFORCE_HPP_
+#define TESTAPICALEDGESFORCE_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+#include "CellsGenerator.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+#include "NoCellCycleModel.hpp"
+#include "VertexBasedCellPopulation.hpp"
+#include "HexagonalPrism3dVertexMeshGenerator.hpp"
+#include "ApicalEdgesForce.hpp"
+#include "RandomNumberGenerator.hpp"
+#include "SmartPointers.hpp"
+#include "FakePetscSetup.hpp"
+
+#include <algorithm>
+
+class TestApicalEdgesForce : public AbstractCellBasedTestSuite
+{
+public:
+
+    void TestForceAgreesWithHexagonalPrismCalculation() throw (Exception)
+    {
+        HexagonalPrism3dVertexMeshGenerator generator(4, 4, 1.0, 2.0);
+        MutableVertexMesh<3,3>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_type);
+        CellsGenerator<NoCellCycleModel, 3> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements(), std::vector<unsigned>(), p_type);
+        VertexBasedCellPopulation<3> cell_population(*p_mesh, cells);
+
+        // Perturb the nodes so that the apical edges are not all the same length
+        for (unsigned i=0; i<p_mesh->GetNumNodes(); i++)
+        {
+            for (unsigned dim=0; dim<3; dim++)
+            {
+                p_mesh->GetNode(i)->rGetModifiableLocation()[dim] += 0.05*(RandomNumberGenerator::Instance()->ranf() - 0.5);
+            }
+            p_mesh->GetNode(i)->ClearAppliedForce();
+        }
+
+        ApicalEdgesForce<3> force;
+        force.SetLambda(0.7);
+        force.AddForceContribution(cell_population);
+
+        // Every upper node of the mesh is apical
+        unsigned num_apical_nodes = 0;
+        for (unsigned i=0; i<p_mesh->GetNumNodes(); i++)
+        {
+            num_apical_nodes += p_mesh->GetNode(i)->HasNodeAttributes() ? 1 : 0;
+        }
+        TS_ASSERT_EQUALS(force.rGetApicalNodeIndices().size(), num_apical_nodes);
+
+        /*
+         * Compare with the force obtained by ordering the apical nodes of each element
+         * by angle about their centroid, which does not rely on the face connectivity.
+         */
+        for (unsigned node_index=0; node_index<p_mesh->GetNumNodes(); node_index++)
+        {
+            Node<3>* p_node = p_mesh->GetNode(node_index);
+            c_vector<double, 3> expected_force = zero_vector<double>(3);
+
+            std::set<unsigned> containing_elem_indices = p_node->rGetContainingElementIndices();
+            if (p_node->HasNodeAttributes() && (containing_elem_indices.size() > 2))
+            {
+                for (std::set<unsigned>::iterator iter = containing_elem_indices.begin();
+                     iter != containing_elem_indices.end();
+                     ++iter)
+                {
+                    VertexElement<3,3>* p_element = p_mesh->GetElement(*iter);
+
+                    std::vector<Node<3>*> apical_nodes;
+                    c_vector<double, 3> centroid = zero_vector<double>(3);
+                    for (unsigned local_index=0; local_index<p_element->GetNumNodes(); local_index++)
+                    {
+                        if (p_element->GetNode(local_index)->HasNodeAttributes())
+                        {
+                            apical_nodes.push_back(p_element->GetNode(local_index));
+                            centroid += p_element->GetNode(local_index)->rGetLocation();
+                        }
+                    }
+                    centroid /= apical_nodes.size();
+
+                    std::vector<std::pair<double, Node<3>*> > angles;
+                    for (unsigned i=0; i<apical_nodes.size(); i++)
+                    {
+                        c_vector<double, 3> offset = apical_nodes[i]->rGetLocation() - centroid;
+                        angles.push_back(std::make_pair(atan2(offset[1], offset[0]), apical_nodes[i]));
+                    }
+                    std::sort(angles.begin(), angles.end());
+
+                    unsigned num_apical_nodes_elem = angles.size();
+                    unsigned position = 0;
+                    while (angles[position].second != p_node)
+                    {
+                        position++;
+                    }
+                    Node<3>* p_previous_node = angles[(position + num_apical_nodes_elem - 1)%num_apical_nodes_elem].second;
+                    Node<3>* p_next_node = angles[(position + 1)%num_apical_nodes_elem].second;
+
+                    c_vector<double, 3> previous_edge = p_node->rGetLocation() - p_previous_node->rGetLocation();
+                    c_vector<double, 3> next_edge = p_next_node->rGetLocation() - p_node->rGetLocation();
+                    expected_force += 0.7*(next_edge/norm_2(next_edge) - previous_edge/norm_2(previous_edge));
+                }
+            }
+
+            for (unsigned dim=0; dim<3; dim++)
+            {
+                TS_ASSERT_DELTA(p_node->rGetAppliedForce()[dim], expected_force[dim], 1e-10);
+            }
+        }
+    }
+};
+
+#endif /*TESTAPICALEDGESFORCE_HPP_*/
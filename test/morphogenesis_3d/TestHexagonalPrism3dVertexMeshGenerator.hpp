@@ -41,6 +41,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "AbstractCellBasedTestSuite.hpp"
 #include "FakePetscSetup.hpp"
 #include "HexagonalPrism3dVertexMeshGenerator.hpp"
+#include "OriginalHexagonalPrism3dVertexMeshGenerator.hpp"
+#include "HeapAllocationCounter.hpp"
+#include "Timer.hpp"
 #include "Debug.hpp"
 
 class TestHexagonalPrism3dVertexMeshGenerator : public AbstractCellBasedTestSuite
@@ -500,6 +503,133 @@ public:
             }
         }
     }
+
+    void TestSameMeshAsOriginalGenerator() throw (Exception)
+    {
+        for (unsigned num_columns=2; num_columns<=7; num_columns++)
+        {
+            for (unsigned num_rows=1; num_rows<=7; num_rows++)
+            {
+                HexagonalPrism3dVertexMeshGenerator generator(num_columns, num_rows, 1.0, 2.0);
+                MutableVertexMesh<3,3>* p_mesh = generator.GetMesh();
+
+                OriginalHexagonalPrism3dVertexMeshGenerator original_generator(num_columns, num_rows, 1.0, 2.0);
+                MutableVertexMesh<3,3>* p_original_mesh = original_generator.GetMesh();
+
+                // Test that the nodes have the same locations, boundary flags, attributes and containing elements
+                TS_ASSERT_EQUALS(p_mesh->GetNumNodes(), p_original_mesh->GetNumNodes());
+                for (unsigned node_index=0; node_index<p_original_mesh->GetNumNodes(); node_index++)
+                {
+                    Node<3>* p_node = p_mesh->GetNode(node_index);
+                    Node<3>* p_original_node = p_original_mesh->GetNode(node_index);
+
+                    TS_ASSERT_EQUALS(p_node->GetIndex(), p_original_node->GetIndex());
+                    for (unsigned i=0; i<3; i++)
+                    {
+                        TS_ASSERT_DELTA(p_node->rGetLocation()[i], p_original_node->rGetLocation()[i], 1e-12);
+                    }
+                    TS_ASSERT_EQUALS(p_node->IsBoundaryNode(), p_original_node->IsBoundaryNode());
+                    TS_ASSERT_EQUALS(p_node->GetNumNodeAttributes(), p_original_node->GetNumNodeAttributes());
+                    TS_ASSERT(p_node->rGetContainingElementIndices() == p_original_node->rGetContainingElementIndices());
+                }
+
+                // Test that the faces have the same nodes in the same order
+                TS_ASSERT_EQUALS(p_mesh->GetNumFaces(), p_original_mesh->GetNumFaces());
+                for (unsigned face_index=0; face_index<p_original_mesh->GetNumFaces(); face_index++)
+                {
+                    VertexElement<2,3>* p_face = p_mesh->GetFace(face_index);
+                    VertexElement<2,3>* p_original_face = p_original_mesh->GetFace(face_index);
+
+                    TS_ASSERT_EQUALS(p_face->GetIndex(), p_original_face->GetIndex());
+                    TS_ASSERT_EQUALS(p_face->GetNumNodes(), p_original_face->GetNumNodes());
+                    for (unsigned local_index=0; local_index<p_original_face->GetNumNodes(); local_index++)
+                    {
+                        TS_ASSERT_EQUALS(p_face->GetNodeGlobalIndex(local_index), p_original_face->GetNodeGlobalIndex(local_index));
+                    }
+                }
+
+                // Test that the elements have the same nodes and faces, in the same order and orientation
+                TS_ASSERT_EQUALS(p_mesh->GetNumElements(), p_original_mesh->GetNumElements());
+                for (unsigned elem_index=0; elem_index<p_original_mesh->GetNumElements(); elem_index++)
+                {
+                    VertexElement<3,3>* p_element = p_mesh->GetElement(elem_index);
+                    VertexElement<3,3>* p_original_element = p_original_mesh->GetElement(elem_index);
+
+                    TS_ASSERT_EQUALS(p_element->GetIndex(), p_original_element->GetIndex());
+                    TS_ASSERT_EQUALS(p_element->GetNumNodes(), p_original_element->GetNumNodes());
+                    for (unsigned local_index=0; local_index<p_original_element->GetNumNodes(); local_index++)
+                    {
+                        TS_ASSERT_EQUALS(p_element->GetNodeGlobalIndex(local_index), p_original_element->GetNodeGlobalIndex(local_index));
+                    }
+
+                    TS_ASSERT_EQUALS(p_element->GetNumFaces(), p_original_element->GetNumFaces());
+                    for (unsigned local_index=0; local_index<p_original_element->GetNumFaces(); local_index++)
+                    {
+                        TS_ASSERT_EQUALS(p_element->GetFace(local_index)->GetIndex(), p_original_element->GetFace(local_index)->GetIndex());
+                        TS_ASSERT_EQUALS(p_element->FaceIsOrientatedClockwise(local_index), p_original_element->FaceIsOrientatedClockwise(local_index));
+                    }
+                }
+            }
+        }
+    }
+
+    void TestGenerationTimeForLargeSheet() throw (Exception)
+    {
+        unsigned num_rows = 200;
+        unsigned num_columns = 200;
+
+        Timer::Reset();
+        HexagonalPrism3dVertexMeshGenerator generator(num_columns, num_rows, 1.0, 2.0);
+        MutableVertexMesh<3,3>* p_mesh = generator.GetMesh();
+        double generation_time = Timer::GetElapsedTime();
+
+        Timer::Reset();
+        OriginalHexagonalPrism3dVertexMeshGenerator original_generator(num_columns, num_rows, 1.0, 2.0);
+        double original_generation_time = Timer::GetElapsedTime();
+
+        // Test that the mesh has the correct number of nodes, faces and elements
+        unsigned num_lower_nodes = 2*(num_columns + num_columns*num_rows + num_rows);
+        TS_ASSERT_EQUALS(p_mesh->GetNumNodes(), 2*num_lower_nodes);
+        TS_ASSERT_EQUALS(p_mesh->GetNumFaces(), 5*num_columns*num_rows + 2*(num_columns + num_rows) - 1);
+        TS_ASSERT_EQUALS(p_mesh->GetNumElements(), num_columns*num_rows);
+
+        // Building from flat index arrays avoids a temporary vector for every face and element
+        TS_ASSERT_LESS_THAN(generation_time, original_generation_time);
+    }
+
+    void TestMemoryUseAgainstOriginalGenerator() throw (Exception)
+    {
+        unsigned num_rows = 100;
+        unsigned num_columns = 100;
+
+        // Measure the heap used while generating, and then holding, the mesh with each generator
+        std::size_t baseline_bytes = HeapAllocationCounter::msCurrentBytes;
+        HeapAllocationCounter::Reset();
+        std::size_t mesh_bytes = 0;
+        {
+            HexagonalPrism3dVertexMeshGenerator generator(num_columns, num_rows, 1.0, 2.0);
+            mesh_bytes = HeapAllocationCounter::msCurrentBytes - baseline_bytes;
+        }
+        std::size_t peak_bytes = HeapAllocationCounter::GetPeakBytesAbove(baseline_bytes);
+        std::size_t num_allocations = HeapAllocationCounter::msNumAllocations;
+
+        baseline_bytes = HeapAllocationCounter::msCurrentBytes;
+        HeapAllocationCounter::Reset();
+        std::size_t original_mesh_bytes = 0;
+        {
+            OriginalHexagonalPrism3dVertexMeshGenerator original_generator(num_columns, num_rows, 1.0, 2.0);
+            original_mesh_bytes = HeapAllocationCounter::msCurrentBytes - baseline_bytes;
+        }
+        std::size_t original_peak_bytes = HeapAllocationCounter::GetPeakBytesAbove(baseline_bytes);
+        std::size_t original_num_allocations = HeapAllocationCounter::msNumAllocations;
+
+        // The meshes themselves are identical, so take about the same memory
+        TS_ASSERT_DELTA(mesh_bytes, original_mesh_bytes, 0.01*original_mesh_bytes);
+
+        // The flat index arrays make far fewer allocations, and add little to the peak memory use
+        TS_ASSERT_LESS_THAN(num_allocations, original_num_allocations);
+        TS_ASSERT_LESS_THAN(peak_bytes, 1.1*original_peak_bytes);
+    }
 };
 
 #endif /*TESTHEXAGONALPRISM3DVERTEXMESHGENERATOR_HPP_*/
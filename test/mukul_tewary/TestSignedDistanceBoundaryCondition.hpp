@@ -0,0 +1,274 @@
+/*
+
+Copyright (c) 2005-2017, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTSIGNEDDISTANCEBOUNDARYCONDITION_HPP_
+#define TESTSIGNEDDISTANCEBOUNDARYCONDITION_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+#include "CellsGenerator.hpp"
+#include "NoCellCycleModel.hpp"
+#include "NodesOnlyMesh.hpp"
+#include "NodeBasedCellPopulation.hpp"
+#include "SignedDistanceBoundaryCondition.hpp"
+#include "OutputFileHandler.hpp"
+#include "RandomNumberGenerator.hpp"
+#include "FakePetscSetup.hpp"
+
+class TestSignedDistanceBoundaryCondition : public AbstractCellBasedTestSuite
+{
+public:
+
+    void TestGridFromPolygon() throw (Exception)
+    {
+        // A 4x4 square
+        std::vector<c_vector<double, 2> > vertices(4);
+        vertices[0][0] = 0.0; vertices[0][1] = 0.0;
+        vertices[1][0] = 4.0; vertices[1][1] = 0.0;
+        vertices[2][0] = 4.0; vertices[2][1] = 4.0;
+        vertices[3][0] = 0.0; vertices[3][1] = 4.0;
+
+        SignedDistanceGrid<2> grid;
+        grid.BuildFromPolygon(vertices, 0.1, 1.0);
+        TS_ASSERT_EQUALS(grid.rGetNumPoints()[0], 61u);
+        TS_ASSERT_EQUALS(grid.rGetNumPoints()[1], 61u);
+        TS_ASSERT_DELTA(grid.rGetOrigin()[0], -1.0, 1e-12);
+
+        c_vector<double, 2> point;
+        point[0] = 2.0; point[1] = 2.0;
+        TS_ASSERT_DELTA(grid.GetSignedDistance(point), -2.0, 1e-10);
+        point[0] = 1.0; point[1] = 2.05;
+        TS_ASSERT_DELTA(grid.GetSignedDistance(point), -1.0, 1e-10);
+        point[0] = 4.5; point[1] = 2.0;
+        TS_ASSERT_DELTA(grid.GetSignedDistance(point), 0.5, 1e-10);
+        point[0] = 2.0; point[1] = 4.0;
+        TS_ASSERT_DELTA(grid.GetSignedDistance(point), 0.0, 1e-10);
+
+        vertices.resize(2);
+        TS_ASSERT_THROWS_THIS(grid.BuildFromPolygon(vertices, 0.1, 1.0), "A polygon must have at least three vertices");
+
+        SignedDistanceGrid<3> grid_3d;
+        std::vector<c_vector<double, 3> > vertices_3d(3, zero_vector<double>(3));
+        TS_ASSERT_THROWS_THIS(grid_3d.BuildFromPolygon(vertices_3d, 0.1, 1.0), "A SignedDistanceGrid may only be built from a polygon in 2D");
+    }
+
+    void TestGridFromFile() throw (Exception)
+    {
+        // The half-space z > 1 in 3D, on a 3x3x3 grid of unit spacing
+        OutputFileHandler handler("TestSignedDistanceBoundaryCondition");
+        out_stream p_file = handler.OpenOutputFile("half_space.dat");
+        *p_file << "# num points, origin, spacing, values\n";
+        *p_file << "3 3 3\n";
+        *p_file << "0 0 0\n";
+        *p_file << "1\n";
+        for (unsigned k=0; k<3; k++)
+        {
+            for (unsigned i=0; i<9; i++)
+            {
+                *p_file << 1.0 - k << " ";
+            }
+            *p_file << "\n";
+        }
+        p_file->close();
+
+        SignedDistanceGrid<3> grid;
+        grid.LoadFromFile(handler.FindFile("half_space.dat"));
+
+        c_vector<double, 3> point;
+        point[0] = 0.3; point[1] = 1.7; point[2] = 0.25;
+        TS_ASSERT_DELTA(grid.GetSignedDistance(point), 0.75, 1e-12);
+
+        // Values are extrapolated outside the grid
+        point[2] = -1.0;
+        TS_ASSERT_DELTA(grid.GetSignedDistance(point), 2.0, 1e-12);
+
+        p_file = handler.OpenOutputFile("short_grid.dat");
+        *p_file << "3 3 3\n0 0 0\n1\n0 1 2\n";
+        p_file->close();
+        TS_ASSERT_THROWS_THIS(grid.LoadFromFile(handler.FindFile("short_grid.dat")), "A SignedDistanceGrid with 27 grid points was given 3 values");
+        TS_ASSERT_THROWS_CONTAINS(grid.LoadFromFile(handler.FindFile("missing.dat")), "Unable to open signed distance grid file");
+    }
+
+    void TestBoundaryConditionOnDisk() throw (Exception)
+    {
+        // Approximate a disk of radius 5 by a polygon
+        double radius = 5.0;
+        unsigned num_vertices = 256;
+        std::vector<c_vector<double, 2> > vertices(num_vertices);
+        for (unsigned i=0; i<num_vertices; i++)
+        {
+            double angle = 2.0*M_PI*i/(double)num_vertices;
+            vertices[i][0] = radius*cos(angle);
+            vertices[i][1] = radius*sin(angle);
+        }
+        boost::shared_ptr<SignedDistanceGrid<2> > p_grid(new SignedDistanceGrid<2>());
+        p_grid->BuildFromPolygon(vertices, 0.1, 2.0);
+
+        // Scatter nodes over a larger disk
+        std::vector<Node<2>*> nodes;
+        for (unsigned i=0; i<500; i++)
+        {
+            double node_radius = 7.0*sqrt(RandomNumberGenerator::Instance()->ranf());
+            double angle = 2.0*M_PI*RandomNumberGenerator::Instance()->ranf();
+            nodes.push_back(new Node<2>(i, false, node_radius*cos(angle), node_radius*sin(angle)));
+        }
+
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(nodes, 1.5);
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, mesh.GetNumNodes());
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+        std::vector<double> old_radii(cell_population.GetNumNodes());
+        for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+        {
+            old_radii[i] = norm_2(cell_population.GetNode(i)->rGetLocation());
+        }
+
+        SignedDistanceBoundaryCondition<2> boundary_condition(&cell_population, p_grid);
+        TS_ASSERT_EQUALS(boundary_condition.VerifyBoundaryCondition(), false);
+
+        std::map<Node<2>*, c_vector<double, 2> > old_locations;
+        boundary_condition.ImposeBoundaryCondition(old_locations);
+        TS_ASSERT_EQUALS(boundary_condition.VerifyBoundaryCondition(), true);
+
+        /*
+         * Nodes inside the disk do not move, and those outside are moved radially onto its
+         * boundary, up to the interpolation error of the grid, which is O(h^2) for spacing h.
+         */
+        for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+        {
+            c_vector<double, 2> location = cell_population.GetNode(i)->rGetLocation();
+            TS_ASSERT_DELTA(norm_2(location), std::min(old_radii[i], radius), 5e-3);
+        }
+
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+    }
+
+    void TestBoundaryConditionAfterCellsDieAndDivide() throw (Exception)
+    {
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 1);
+
+        // The square [0,4]x[0,4]
+        std::vector<c_vector<double, 2> > vertices(4);
+        vertices[0][0] = 0.0; vertices[0][1] = 0.0;
+        vertices[1][0] = 4.0; vertices[1][1] = 0.0;
+        vertices[2][0] = 4.0; vertices[2][1] = 4.0;
+        vertices[3][0] = 0.0; vertices[3][1] = 4.0;
+        boost::shared_ptr<SignedDistanceGrid<2> > p_grid(new SignedDistanceGrid<2>());
+        p_grid->BuildFromPolygon(vertices, 0.1, 2.0);
+
+        // A 7x7 lattice of nodes over [-1,5]x[-1,5], so that the outer ring lies outside the square
+        std::vector<Node<2>*> nodes;
+        for (unsigned j=0; j<7; j++)
+        {
+            for (unsigned i=0; i<7; i++)
+            {
+                nodes.push_back(new Node<2>(7*j + i, false, -1.0 + i, -1.0 + j));
+            }
+        }
+
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(nodes, 1.5);
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, mesh.GetNumNodes());
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+        // Kill three cells, inside and outside the square, leaving gaps in the node indices
+        cell_population.GetCellUsingLocationIndex(0)->Kill();
+        cell_population.GetCellUsingLocationIndex(24)->Kill();
+        cell_population.GetCellUsingLocationIndex(30)->Kill();
+        cell_population.RemoveDeadCells();
+        cell_population.Update();
+        TS_ASSERT_EQUALS(cell_population.GetNumNodes(), 46u);
+
+        // Divide a cell outside the square, placing its daughter further out
+        std::vector<CellPtr> new_cells;
+        cells_generator.GenerateBasic(new_cells, 1);
+        Node<2>* p_new_node = new Node<2>(0u, false, 5.5, 2.0);
+        unsigned new_node_index = mesh.AddNode(p_new_node);
+        cell_population.rGetCells().push_back(new_cells[0]);
+        cell_population.AddCellUsingLocationIndex(new_node_index, new_cells[0]);
+        TS_ASSERT_EQUALS(cell_population.GetNumNodes(), 47u);
+
+        // The node indices are no longer contiguous
+        unsigned max_node_index = 0;
+        for (AbstractMesh<2,2>::NodeIterator node_iter = mesh.GetNodeIteratorBegin();
+             node_iter != mesh.GetNodeIteratorEnd();
+             ++node_iter)
+        {
+            max_node_index = std::max(max_node_index, node_iter->GetIndex());
+        }
+        TS_ASSERT_LESS_THAN_EQUALS(cell_population.GetNumNodes(), max_node_index);
+
+        SignedDistanceBoundaryCondition<2> boundary_condition(&cell_population, p_grid);
+        TS_ASSERT_EQUALS(boundary_condition.VerifyBoundaryCondition(), false);
+
+        std::map<Node<2>*, c_vector<double, 2> > old_locations;
+        boundary_condition.ImposeBoundaryCondition(old_locations);
+        TS_ASSERT_EQUALS(boundary_condition.VerifyBoundaryCondition(), true);
+
+        // Every node, including the new one, now lies in the square, and nodes inside it have not moved
+        for (AbstractMesh<2,2>::NodeIterator node_iter = mesh.GetNodeIteratorBegin();
+             node_iter != mesh.GetNodeIteratorEnd();
+             ++node_iter)
+        {
+            c_vector<double, 2> location = node_iter->rGetLocation();
+            TS_ASSERT_LESS_THAN(-5e-3, location[0]);
+            TS_ASSERT_LESS_THAN(location[0], 4.0 + 5e-3);
+            TS_ASSERT_LESS_THAN(-5e-3, location[1]);
+            TS_ASSERT_LESS_THAN(location[1], 4.0 + 5e-3);
+        }
+        TS_ASSERT_DELTA(mesh.GetNode(new_node_index)->rGetLocation()[0], 4.0, 5e-3);
+        TS_ASSERT_DELTA(mesh.GetNode(new_node_index)->rGetLocation()[1], 2.0, 5e-3);
+        TS_ASSERT_DELTA(mesh.GetNode(16)->rGetLocation()[0], 1.0, 1e-12);
+        TS_ASSERT_DELTA(mesh.GetNode(16)->rGetLocation()[1], 1.0, 1e-12);
+
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+    }
+};
+
+#endif /*TESTSIGNEDDISTANCEBOUNDARYCONDITION_HPP_*/